@@ -20,6 +20,7 @@ conan_cmake_run(
   spdlog/1.5.0
   glm/0.9.9.7
   tinyobjloader/1.0.6@_/_ 
+  stb/20200203
   sdl2/2.0.10@bincrafters/stable
   OPTIONS
   ${CONAN_EXTRA_OPTIONS}
@@ -1,6 +1,8 @@
 #pragma once
 #include "ResourceManagerAPI.h"
 #include "RenderEngineAPI.h"
+#include "DetachedTask.h"
+#include "Executor.h"
 
 
 class Application
@@ -11,7 +13,11 @@ public:
 
 	void run();
 private:
+	DetachedTask spawnWhenLoaded(std::string name, std::string modelName);
 
+	QueuedExecutor m_frameExecutor;
+	// Tasks waiting for something to be posted to m_frameExecutor, which stops running once the loop exits.
+	TaskScope m_tasks;
 	ResourceManagerAPIPtr m_resourceManager;
 	RenderEngineAPIPtr m_renderEngine;
 	bool m_isExiting;
@@ -0,0 +1,62 @@
+#pragma once
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <vector>
+
+class TaskScope;
+
+// A coroutine nobody waits for. It does not run before it is handed to a TaskScope, which owns it from then on.
+class DetachedTask
+{
+public:
+	struct promise_type
+	{
+		DetachedTask get_return_object() { return DetachedTask(std::coroutine_handle<promise_type>::from_promise(*this)); }
+		std::suspend_always initial_suspend() noexcept { return {}; }
+		std::suspend_never final_suspend() noexcept;
+		void return_void() {}
+		void unhandled_exception() { std::terminate(); }
+
+		TaskScope *scope = nullptr;
+	};
+
+	DetachedTask(DetachedTask &&other) noexcept;
+	DetachedTask &operator=(DetachedTask &&other) = delete;
+	DetachedTask(const DetachedTask &) = delete;
+	DetachedTask &operator=(const DetachedTask &) = delete;
+	// A task that was never spawned is destroyed without running.
+	~DetachedTask();
+
+private:
+	friend class TaskScope;
+	explicit DetachedTask(std::coroutine_handle<promise_type> handle);
+
+	std::coroutine_handle<promise_type> m_handle;
+};
+
+// Keeps track of the detached tasks started through it. Finished tasks remove themselves, the frames of tasks that are
+// still suspended are destroyed by destroyAll, which runs the destructors of their locals.
+class TaskScope
+{
+public:
+	TaskScope() = default;
+	~TaskScope();
+
+	TaskScope(const TaskScope &) = delete;
+	TaskScope &operator=(const TaskScope &) = delete;
+
+	// Runs task until it first suspends or finishes.
+	void spawn(DetachedTask task);
+	// Only safe once nothing can resume the tasks anymore, resuming a destroyed frame is undefined.
+	void destroyAll();
+	size_t suspendedCount() const;
+
+private:
+	friend struct DetachedTask::promise_type;
+	void forget(std::coroutine_handle<> task);
+
+	mutable std::mutex m_mutex;
+	std::vector<std::coroutine_handle<>> m_tasks;
+};
@@ -0,0 +1,29 @@
+#pragma once
+#include <functional>
+#include <mutex>
+#include <vector>
+
+class Executor
+{
+public:
+	virtual ~Executor() = default;
+
+	virtual void post(std::function<void()> task) = 0;
+};
+
+class InlineExecutor : public Executor
+{
+public:
+	void post(std::function<void()> task) override;
+};
+
+class QueuedExecutor : public Executor
+{
+public:
+	void post(std::function<void()> task) override;
+	void runPending();
+
+private:
+	std::mutex m_mutex;
+	std::vector<std::function<void()>> m_tasks;
+};
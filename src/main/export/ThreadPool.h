@@ -0,0 +1,55 @@
+#pragma once
+#include "Executor.h"
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+class ThreadPool : public Executor
+{
+public:
+	explicit ThreadPool(size_t threadCount);
+	~ThreadPool() override;
+
+	ThreadPool(const ThreadPool &) = delete;
+	ThreadPool &operator=(const ThreadPool &) = delete;
+	ThreadPool(ThreadPool &&) = delete;
+	ThreadPool &operator=(ThreadPool &&) = delete;
+
+	static ThreadPool &shared();
+
+	void post(std::function<void()> task) override;
+
+	template<typename Task>
+	auto submit(Task &&task) -> std::future<std::invoke_result_t<Task>>
+	{
+		using Result = std::invoke_result_t<Task>;
+
+		auto packagedTask = std::make_shared<std::packaged_task<Result()>>(std::forward<Task>(task));
+		auto result = packagedTask->get_future();
+		post([packagedTask]() { (*packagedTask)(); });
+
+		return result;
+	}
+
+	// Calls body(begin, end) for consecutive ranges of at most chunkSize covering [0, count) and returns once all are done.
+	// The calling thread processes chunks too and only waits on chunks other threads already started,
+	// so this is safe to use from inside a task running on the pool.
+	void parallelFor(size_t count, size_t chunkSize, const std::function<void(size_t begin, size_t end)> &body);
+
+	size_t threadCount() const;
+
+private:
+	void workerLoop();
+
+	std::vector<std::thread> m_workers;
+	std::deque<std::function<void()>> m_tasks;
+	std::mutex m_mutex;
+	std::condition_variable m_taskAvailable;
+	bool m_stopping;
+};
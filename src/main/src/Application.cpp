@@ -8,26 +8,51 @@ Application::Application() :
 	m_renderEngine{RenderEngineAPI::createInstance()},
 	m_isExiting{ false }
 {
-	m_resourceManager->LoadResources();
+	m_resourceManager->LoadResourcesAsync([](const LoadProgress &progress)
+	{
+		if (progress.failed != 0)
+		{
+			LoggerAPI::getLogger()->logWarning(std::to_string(progress.failed) + " resources failed to load");
+		}
+	});
 	assert(m_renderEngine->init(m_resourceManager));
 }
 
 void Application::run()
 {
-	m_renderEngine->createObject("DUMMY", "rectangle");
-	m_renderEngine->createObject("TestTriangle", "triangle");
+	const auto rectangle = m_resourceManager->findModel("rectangle");
+	const auto triangle = m_resourceManager->findModel("triangle");
+
+	m_renderEngine->createObject("DUMMY", rectangle);
+	m_renderEngine->createObject("TestTriangle", triangle);
+	m_tasks.spawn(spawnWhenLoaded("TestCube", "cube"));
 
 	while (!m_isExiting)
 	{
 		m_isExiting = m_renderEngine->pollForWindowClose();
+		m_frameExecutor.runPending();
 		m_renderEngine->drawScene();
 	}
 
 	m_renderEngine->waitForRendererToFinish();
 }
 
+DetachedTask Application::spawnWhenLoaded(std::string name, std::string modelName)
+{
+	const auto model = co_await m_resourceManager->getModelAsync(modelName, m_frameExecutor);
+	if (model.empty())
+	{
+		LoggerAPI::getLogger()->logWarning("Model " + modelName + " is not available, skipping " + name);
+		co_return;
+	}
+
+	m_renderEngine->createObject(std::move(name), m_resourceManager->findModel(modelName));
+}
+
 Application::~Application()
 {
+	// Nothing resumes them anymore, so their frames have to go before the engines they point into.
+	m_tasks.destroyAll();
 	m_renderEngine->cleanUp();
 	m_resourceManager->cleanUp();
 }
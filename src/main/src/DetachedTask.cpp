@@ -0,0 +1,73 @@
+#include "DetachedTask.h"
+
+#include <algorithm>
+#include <utility>
+
+std::suspend_never DetachedTask::promise_type::final_suspend() noexcept
+{
+	if (scope != nullptr)
+	{
+		scope->forget(std::coroutine_handle<promise_type>::from_promise(*this));
+	}
+	return {};
+}
+
+DetachedTask::DetachedTask(std::coroutine_handle<promise_type> handle) :
+	m_handle{ handle }
+{
+}
+
+DetachedTask::DetachedTask(DetachedTask &&other) noexcept :
+	m_handle{ std::exchange(other.m_handle, nullptr) }
+{
+}
+
+DetachedTask::~DetachedTask()
+{
+	if (m_handle)
+	{
+		m_handle.destroy();
+	}
+}
+
+TaskScope::~TaskScope()
+{
+	destroyAll();
+}
+
+void TaskScope::spawn(DetachedTask task)
+{
+	const auto handle = std::exchange(task.m_handle, nullptr);
+	handle.promise().scope = this;
+	{
+		std::lock_guard lock(m_mutex);
+		m_tasks.push_back(handle);
+	}
+	handle.resume();
+}
+
+void TaskScope::destroyAll()
+{
+	std::vector<std::coroutine_handle<>> tasks;
+	{
+		std::lock_guard lock(m_mutex);
+		tasks.swap(m_tasks);
+	}
+
+	for (auto task : tasks)
+	{
+		task.destroy();
+	}
+}
+
+size_t TaskScope::suspendedCount() const
+{
+	std::lock_guard lock(m_mutex);
+	return m_tasks.size();
+}
+
+void TaskScope::forget(std::coroutine_handle<> task)
+{
+	std::lock_guard lock(m_mutex);
+	m_tasks.erase(std::remove(m_tasks.begin(), m_tasks.end(), task), m_tasks.end());
+}
@@ -0,0 +1,26 @@
+#include "Executor.h"
+
+void InlineExecutor::post(std::function<void()> task)
+{
+	task();
+}
+
+void QueuedExecutor::post(std::function<void()> task)
+{
+	std::lock_guard lock(m_mutex);
+	m_tasks.push_back(std::move(task));
+}
+
+void QueuedExecutor::runPending()
+{
+	std::vector<std::function<void()>> tasks;
+	{
+		std::lock_guard lock(m_mutex);
+		tasks.swap(m_tasks);
+	}
+
+	for (auto &task : tasks)
+	{
+		task();
+	}
+}
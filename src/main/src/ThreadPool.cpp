@@ -0,0 +1,117 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <atomic>
+
+ThreadPool::ThreadPool(size_t threadCount) :
+	m_stopping{ false }
+{
+	threadCount = std::max<size_t>(1, threadCount);
+	m_workers.reserve(threadCount);
+
+	for (size_t i = 0; i < threadCount; ++i)
+	{
+		m_workers.emplace_back([this]() { workerLoop(); });
+	}
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard lock(m_mutex);
+		m_stopping = true;
+	}
+	m_taskAvailable.notify_all();
+
+	for (auto &worker : m_workers)
+	{
+		worker.join();
+	}
+}
+
+ThreadPool &ThreadPool::shared()
+{
+	static ThreadPool pool(std::thread::hardware_concurrency());
+	return pool;
+}
+
+void ThreadPool::post(std::function<void()> task)
+{
+	{
+		std::lock_guard lock(m_mutex);
+		m_tasks.push_back(std::move(task));
+	}
+	m_taskAvailable.notify_one();
+}
+
+void ThreadPool::parallelFor(size_t count, size_t chunkSize, const std::function<void(size_t begin, size_t end)> &body)
+{
+	struct ParallelForState
+	{
+		std::atomic<size_t> nextChunk{ 0 };
+		std::atomic<size_t> finishedChunks{ 0 };
+		std::mutex mutex;
+		std::condition_variable finished;
+	};
+
+	chunkSize = std::max<size_t>(1, chunkSize);
+	const auto chunkCount = (count + chunkSize - 1) / chunkSize;
+	if (chunkCount == 0)
+	{
+		return;
+	}
+
+	auto state = std::make_shared<ParallelForState>();
+	// Helpers that start after every chunk was claimed return without touching body, so it may go out of scope by then.
+	auto work = [state, count, chunkSize, chunkCount, &body]()
+	{
+		for (auto chunk = state->nextChunk++; chunk < chunkCount; chunk = state->nextChunk++)
+		{
+			const auto begin = chunk * chunkSize;
+			body(begin, std::min(begin + chunkSize, count));
+
+			if (++state->finishedChunks == chunkCount)
+			{
+				std::lock_guard lock(state->mutex);
+				state->finished.notify_all();
+			}
+		}
+	};
+
+	const auto helperCount = std::min(threadCount(), chunkCount - 1);
+	for (size_t i = 0; i < helperCount; ++i)
+	{
+		post(work);
+	}
+	work();
+
+	std::unique_lock lock(state->mutex);
+	state->finished.wait(lock, [&state, chunkCount]() { return state->finishedChunks == chunkCount; });
+}
+
+size_t ThreadPool::threadCount() const
+{
+	return m_workers.size();
+}
+
+void ThreadPool::workerLoop()
+{
+	for (;;)
+	{
+		std::function<void()> task;
+		{
+			std::unique_lock lock(m_mutex);
+			m_taskAvailable.wait(lock, [this]() { return m_stopping || !m_tasks.empty(); });
+
+			if (m_stopping && m_tasks.empty())
+			{
+				return;
+			}
+
+			task = std::move(m_tasks.front());
+			m_tasks.pop_front();
+		}
+
+		task();
+	}
+}
@@ -0,0 +1,24 @@
+#pragma once
+#include "glm/glm.hpp"
+
+struct Camera
+{
+	glm::vec3 position{ 0.0F, 0.0F, -1.0F };
+	// Both normalized and perpendicular to each other. By default world space is oriented like clip space, x to the right,
+	// y down and z into the screen, the way scenes were laid out before there was a camera.
+	glm::vec3 forward{ 0.0F, 0.0F, 1.0F };
+	glm::vec3 up{ 0.0F, -1.0F, 0.0F };
+	// Vertical field of view in radians.
+	float verticalFov = 1.0471976F;
+	// Height of the render target in pixels, LOD selection measures projected errors against it.
+	// Set by the engine from the swapchain, like aspectRatio.
+	float viewportHeight = 720.0F;
+	// Width over height of the render target.
+	float aspectRatio = 16.0F / 9.0F;
+	float nearPlane = 0.01F;
+	float farPlane = 1000.0F;
+
+	// World to Vulkan clip space: x to the right, y down the screen and depth in [0, 1] between the near and far plane.
+	// The view is a rotation of world space, so triangles keep their winding.
+	glm::mat4 viewProjection() const;
+};
@@ -1,6 +1,9 @@
 #pragma once
 #include "ResourceManagerAPI.h"
 #include "RenderObjectAPI.h"
+#include "Camera.h"
+#include "Heightmap.h"
+#include "TerrainSettings.h"
 
 class RenderEngineAPI;
 using RenderEngineAPIPtr = std::shared_ptr<RenderEngineAPI>;
@@ -12,12 +15,28 @@ public:
 	virtual void drawScene() = 0;
 
 	virtual bool pollForWindowClose() = 0;
+
+	virtual void setCamera(const Camera &camera) = 0;
 	
 	virtual void waitForRendererToFinish() = 0;
 	virtual void cleanUp() = 0;
 
 	virtual RenderableObjectAPIPtr createObject(std::string id, const std::string &modelName) = 0;
 	virtual RenderableObjectAPIPtr createObject(std::string id, const std::string &modelName, glm::vec3 position) = 0;
+	virtual RenderableObjectAPIPtr createObject(std::string id, ModelHandle model) = 0;
+	virtual RenderableObjectAPIPtr createObject(std::string id, ModelHandle model, glm::vec3 position) = 0;
+
+	// Makes a loaded texture resident on the GPU, returns false if it is missing or could not be uploaded.
+	virtual bool uploadTexture(const std::string &textureName) = 0;
+
+	// Spawns every object of a scene file written by saveScene. Objects whose model is not loaded are skipped.
+	virtual bool loadScene(const std::string &path) = 0;
+	// Writes the name, model, position and static flag of every object created so far.
+	virtual bool saveScene(const std::string &path) const = 0;
+
+	// Replaces the current terrain, if any. Returns false if the settings do not fit the heightmap,
+	// or if there is no room for the terrain's geometry, in which case the previous terrain is gone as well.
+	virtual bool createTerrain(Heightmap heightmap, const TerrainSettings &settings) = 0;
 
 	static RenderEngineAPIPtr createInstance();
 };
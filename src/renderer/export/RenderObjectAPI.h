@@ -7,6 +7,9 @@ class RenderableObjectAPI
 public:
 	virtual bool isActive() = 0;
 	virtual void updatePosition(glm::vec3 newPostion) = 0;
+	// Static objects are merged with the other static objects drawn by the same pipeline into a few large draws.
+	// Moving one rebuilds its whole batch, so only mark objects that stay where they are.
+	virtual void setStatic(bool isStatic) = 0;
 
 	virtual ~RenderableObjectAPI() = default;
 };
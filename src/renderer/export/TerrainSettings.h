@@ -0,0 +1,22 @@
+#pragma once
+#include <cstdint>
+
+struct TerrainSettings
+{
+	// Quads along one side of a chunk at full detail, a power of two.
+	uint32_t chunkQuads = 64;
+	// Every LOD halves the quads per side, so chunkQuads >> (lodCount - 1) has to stay at least 1.
+	uint32_t lodCount = 4;
+	// World units between two neighbouring heightmap samples.
+	float horizontalScale = 1.0F;
+	// World height of a sample of 1.
+	float heightScale = 50.0F;
+	// Chunks whose centre is closer than this to the camera, measured on the ground plane, are streamed in.
+	float streamingRadius = 500.0F;
+	// Chunks closer than this use full detail, every doubling of the distance beyond it drops one LOD.
+	float lodDistance = 100.0F;
+	// Size of the GPU buffer pool. Chunks beyond it are not streamed in until others leave.
+	uint32_t maxResidentChunks = 256;
+	// Upper bound on chunk uploads per frame, finished chunks beyond it wait for the next frames.
+	uint32_t uploadsPerFrame = 4;
+};
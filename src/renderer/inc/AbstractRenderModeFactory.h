@@ -2,6 +2,7 @@
 #include "SimpleRenderMode.h"
 #include "GPU.h"
 #include "Scene.h"
+#include <optional>
 
 class AbstractRenderModeFactory
 {
@@ -9,6 +10,10 @@ public:
 	virtual ~AbstractRenderModeFactory() = default;
 
 	virtual SimpleRenderMode createRenderMode(vk::Format swapchainFormat, vk::Extent2D extent, const std::vector<vk::PipelineShaderStageCreateInfo> &shaders) = 0;
+	// Empty when any pipeline fails to build, the caller keeps drawing with the pipelines it has.
+	virtual std::optional<PipelineSet> rebuildPipelines(const SimpleRenderMode &mode, vk::Extent2D extent, const std::vector<vk::PipelineShaderStageCreateInfo> &shaders) const = 0;
+	// Records the frame from the scene as it is now, into mode.frames[frameIndex].primary. The frame must not be in flight.
+	virtual void recordFrame(SimpleRenderMode &mode, size_t frameIndex, uint32_t imageIndex) = 0;
 };
 
 using RenderModeFactoryPtr = std::shared_ptr<AbstractRenderModeFactory>;
@@ -0,0 +1,82 @@
+#pragma once
+#include "TlsfAllocator.h"
+#include <array>
+#include <cstddef>
+#include <mutex>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+// Buffers and linear images are never placed next to optimal tiling images, so bufferImageGranularity does not matter.
+enum class MemoryKind : uint32_t
+{
+	Linear = 0,
+	Optimal = 1
+};
+
+struct MemoryAllocation
+{
+	vk::DeviceMemory memory;
+	vk::DeviceSize offset = 0;
+	vk::DeviceSize size = 0;
+	// The allocation in the persistently mapped block, null for memory the host can not access.
+	std::byte *mapped = nullptr;
+	uint32_t pool = 0;
+	uint32_t block = 0;
+	uint32_t node = TlsfAllocator::INVALID_NODE;
+
+	bool isValid() const
+	{
+		return node != TlsfAllocator::INVALID_NODE;
+	}
+};
+
+struct MemoryUsage
+{
+	vk::DeviceSize reservedBytes = 0;
+	vk::DeviceSize usedBytes = 0;
+	uint32_t blockCount = 0;
+	uint32_t allocationCount = 0;
+	// 0 when the free memory of every block is one range, close to 1 when it is spread over many small ones.
+	float fragmentation = 0.0F;
+};
+
+// Takes large blocks of device memory per memory type and hands out aligned ranges of them.
+// Keeps the number of vkAllocateMemory calls far below maxMemoryAllocationCount. Host visible blocks stay mapped.
+class DeviceMemoryAllocator
+{
+public:
+	static constexpr vk::DeviceSize BLOCK_SIZE = vk::DeviceSize{ 64 } << 20;
+
+	void init(vk::Device device, vk::PhysicalDevice physicalDevice);
+	void cleanUp();
+
+	// The memory type is the first one that has all of properties. Returns an invalid allocation if there is none or it is full.
+	MemoryAllocation allocate(const vk::MemoryRequirements &requirements, vk::MemoryPropertyFlags properties, MemoryKind kind);
+	void free(const MemoryAllocation &allocation);
+
+	MemoryUsage usage() const;
+
+private:
+	struct Block
+	{
+		vk::DeviceMemory memory;
+		std::byte *mapped;
+		TlsfAllocator ranges;
+	};
+
+	struct Pool
+	{
+		uint32_t memoryType;
+		// Freed blocks stay as empty entries, allocations refer to blocks by index.
+		std::vector<Block> blocks;
+	};
+
+	uint32_t findMemoryType(uint32_t typeFilter, vk::MemoryPropertyFlags properties) const;
+	bool createBlock(Pool &pool, uint32_t blockIndex, vk::DeviceSize size);
+
+	vk::Device m_device;
+	vk::PhysicalDeviceMemoryProperties m_memoryProperties;
+	// Indexed by memory type * 2 + MemoryKind.
+	std::array<Pool, VK_MAX_MEMORY_TYPES * 2> m_pools;
+	mutable std::mutex m_mutex;
+};
@@ -0,0 +1,24 @@
+#pragma once
+#include "RenderableObject.h"
+#include "Scene.h"
+#include <functional>
+#include <vector>
+
+// One draw call, instanceCount instances of object's mesh starting at firstInstance in the frame's instance data.
+struct InstancedDraw
+{
+	const RenderableObject *object;
+	uint32_t firstInstance;
+	uint32_t instanceCount;
+};
+
+class DrawCollector
+{
+public:
+	using UploadCompleteFunction = std::function<bool(UploadToken token)>;
+
+	// Objects that share a mesh and have the same ranges of it visible are drawn together, one instance each.
+	// Static batches and terrain chunks have their positions baked into their vertices and are drawn once at the origin.
+	// Objects without visible ranges or whose upload is not complete are left out. The instance data of every draw is appended to instances.
+	static std::vector<InstancedDraw> collect(const Scene &scene, const UploadCompleteFunction &isUploadComplete, std::vector<InstanceData> &instances);
+};
@@ -0,0 +1,17 @@
+#pragma once
+#include "glm/glm.hpp"
+#include <array>
+
+class Frustum
+{
+public:
+	// Culls against exactly what viewProjection puts on screen.
+	explicit Frustum(const glm::mat4 &viewProjection);
+
+	// Conservative, spheres close to a corner may pass without touching the frustum.
+	bool intersectsSphere(glm::vec3 center, float radius) const;
+
+private:
+	// xyz is the inward facing unit normal, w the offset so that dot(normal, point) + w >= 0 inside.
+	std::array<glm::vec4, 6> m_planes;
+};
@@ -1,7 +1,12 @@
 #pragma once
+#include "DeviceMemoryAllocator.h"
+#include "GeometryBuffer.h"
 #include "RenderableObject.h"
 #include "ResourceDefs.h"
+#include "TextureResource.h"
 #include "SimpleRenderMode.h"
+#include "UploadQueue.h"
+#include <mutex>
 
 
 struct QueueFamilies {
@@ -10,6 +15,14 @@ struct QueueFamilies {
 	int transferFamilyIndex = -1;
 };
 
+struct GPUTexture
+{
+	vk::Image image;
+	MemoryAllocation memory;
+	vk::ImageView view;
+	vk::Sampler sampler;
+};
+
 class GPU
 {
 public:
@@ -20,24 +33,63 @@ public:
 	
 	void waitForFence(vk::Fence *fence) const;
 	void resetFence(const vk::Fence *fence) const;
-	void acquireNextImage(const vk::Semaphore &semaphore) const;
-	void submitToGraphicsQueue(const vk::SubmitInfo *submitInfo, vk::Fence fence) const;
+	// Returns the index of the swapchain image to render into.
+	uint32_t acquireNextImage(const vk::Semaphore &semaphore) const;
+	// Frames are numbered from 1 in the order they are submitted, the submitted frame's number is returned.
+	uint64_t submitFrame(const vk::SubmitInfo *submitInfo, vk::Fence fence) const;
+	// Called once the frame's fence has signalled. Geometry freed while earlier frames could still draw it is reused after that.
+	void completeFrame(uint64_t frame) const;
+	bool isFrameComplete(uint64_t frame) const;
+	uint64_t submittedFrame() const;
 	void submitToPresentationQueue(const vk::PresentInfoKHR &presentInfo) const;
 
 	uint32_t findMemoryType(uint32_t typeFilter, vk::MemoryPropertyFlags properties) const;
+	MemoryUsage getMemoryUsage() const;
 
 	void deleteRenderMode(SimpleRenderMode && mode) const;
 	
-	void loadROToMemory(const ModelData &model, RenderableObjectPtr &renderObject) const;
+	// Places a mesh in the shared geometry buffers. The copies go out with the next submitUploads(), uploadToken tells when they are done.
+	GeometryRange loadMesh(std::span<const std::byte> verticies, std::span<const std::byte> indicies, MeshEncoding encoding,
+		VertexLayoutKind layout, vk::IndexType indexType, UploadToken &uploadToken) const;
+	// For geometry that belongs to a single object, such as static batches. renderObject's layout and index type have to be set already.
+	void loadROToMemory(std::span<const std::byte> verticies, std::span<const std::byte> indicies, RenderableObjectPtr &renderObject) const;
 	void unloadROFromMemory(const RenderableObjectPtr &renderObject) const;
 
+	// Every mesh is drawn from these two, bound at offset 0. Growing the buffers replaces them, which only happens
+	// while geometry is allocated, so they are fetched again for every frame.
+	vk::Buffer getVertexBuffer() const;
+	vk::Buffer getIndexBuffer() const;
+
+	// Space in the geometry buffers for data streamed in later, such as terrain chunks.
+	GeometryRange allocateGeometry(vk::DeviceSize vertexBytes, uint32_t vertexStride, vk::DeviceSize indexBytes, vk::IndexType indexType) const;
+	// The space is reused once uploads that may still write to it and frames that may still draw it are done.
+	void freeGeometry(const GeometryRange &range) const;
+	// Written from the command buffer itself, no staging memory is used. offset and data.size() have to be multiples of 4.
+	UploadToken updateVerticies(const GeometryRange &range, vk::DeviceSize offset, std::span<const std::byte> data) const;
+	UploadToken updateIndices(const GeometryRange &range, std::span<const std::byte> data) const;
+
+	// Sends the uploads collected since the last call in one submission, once per frame. Never waits for the GPU.
+	// The next submitFrame waits for them on the device before vertex input.
+	void submitUploads() const;
+	// True once the upload is done and covered by a semaphore the next frame waits for, so it may be drawn.
+	bool isUploadComplete(UploadToken token) const;
+
+	// Room for count instances in a host visible buffer of the frame in flight, replaced by a larger one when count does not fit.
+	// Only written while the frame is recorded, after its fence has signalled.
+	std::span<InstanceData> mapInstanceBuffer(size_t frameIndex, size_t count) const;
+	vk::Buffer getInstanceBuffer(size_t frameIndex) const;
+
+	// Uploads every mip of the texture into a device local sampled image. Fails for BC formats the device can not sample.
+	bool createTexture(const TextureResource &texture, GPUTexture &gpuTexture) const;
+	void deleteTexture(const GPUTexture &gpuTexture) const;
+
 	void createRenderPass(vk::RenderPassCreateInfo &createInfo, vk::RenderPass &renderPass) const;
 	void deleteRenderPass(const vk::RenderPass &renderPass) const;
 
 	void createPipelineLayout(vk::PipelineLayoutCreateInfo &createInfo, vk::PipelineLayout &layout) const;
 	void deletePipelineLayout(const vk::PipelineLayout &pipelineLayout) const;
 
-	void createPipeline(const vk::GraphicsPipelineCreateInfo &createInfo, vk::Pipeline &pipeline) const;
+	bool createPipeline(const vk::GraphicsPipelineCreateInfo &createInfo, vk::Pipeline &pipeline) const;
 	void deletePipeline(const vk::Pipeline &pipeline) const;
 
 	void createFramebuffer(vk::FramebufferCreateInfo &createInfo, int index, vk::Framebuffer &framebuffer) const;
@@ -47,6 +99,8 @@ public:
 	void deleteShaderModule(const vk::ShaderModule &shaderModule) const;
 
 	void createGraphicsCommandPool(vk::CommandPool &commandPool) const;
+	// Returns every command buffer of the pool to the initial state, they stay allocated.
+	void resetCommandPool(const vk::CommandPool &commandPool) const;
 	void deleteCommandPool(const vk::CommandPool &commandPool) const;
 
 	void createCommandBuffers(const vk::CommandBufferAllocateInfo &allocateInfo, vk::CommandBuffer *buffer) const;
@@ -67,20 +121,72 @@ public:
 	struct QueueFamilies* queueIndexes;
 
 private:
+	struct RetiredGeometry
+	{
+		UploadToken upload;
+		uint64_t frame;
+		GeometryRange range;
+	};
+
+	struct UploadSemaphore
+	{
+		vk::Semaphore semaphore;
+		uint64_t frame;
+	};
+
+	struct InstanceBuffer
+	{
+		vk::Buffer buffer;
+		MemoryAllocation memory;
+		size_t capacity = 0;
+	};
+
 	GPU() = default;
 
+	// sharedWithGraphics is for buffers written on the transfer queue and read on the graphics queue.
 	void createBuffer(const vk::DeviceSize bufferSize, const vk::BufferUsageFlags bufferUsageFlags,
-		const vk::MemoryPropertyFlags memoryPropertyFlags, vk::Buffer &buffer, vk::DeviceMemory &deviceMemory) const;
-	void copyBuffer(const vk::Buffer &sourceBuffer, const vk::Buffer &destBuffer, const vk::DeviceSize bufferSize) const;
-	void allocateMemoryForBuffer(const vk::Buffer &buffer, vk::DeviceMemory &deviceMemory) const;
-
-	void createSharedBuffer(const std::vector<Vertex>& verticies, const std::vector<uint32_t>& indicies, vk::Buffer &buffer, vk::DeviceMemory &deviceMemory) const;
+		const vk::MemoryPropertyFlags memoryPropertyFlags, vk::Buffer &buffer, MemoryAllocation &allocation, bool sharedWithGraphics = false) const;
+	vk::CommandBuffer beginTransferCommands() const;
+	void submitTransferCommands(vk::CommandBuffer &commandBuffer) const;
+	void allocateMemoryForBuffer(const vk::Buffer &buffer, const vk::MemoryPropertyFlags memoryPropertyFlags, MemoryAllocation &allocation) const;
+
+	bool createGeometryBuffers();
+	void deleteGeometryBuffers();
+	bool createUploadQueue();
+	void deleteUploadQueue();
+	void releaseRetiredGeometry() const;
+	vk::Semaphore acquireUploadSemaphore() const;
+	// Replaces both buffers with larger copies if the range does not fit, m_geometryMutex has to be locked.
+	GeometryRange allocateGeometryLocked(vk::DeviceSize vertexBytes, uint32_t vertexStride, vk::DeviceSize indexBytes, uint32_t indexSize) const;
 
 	vk::Device m_device;
 	vk::PhysicalDevice physicalDevice;
 	std::vector<vk::Image> m_swapchainImages;
 	std::vector<vk::ImageView> m_swapchainImageViews;
 	vk::CommandPool m_transferCommandPool;
+	// Allocating is not a change to the GPU as callers see it, so the const member functions may do it.
+	mutable DeviceMemoryAllocator m_memoryAllocator;
+
+	mutable std::mutex m_geometryMutex;
+	mutable GeometryBuffer m_geometry{ 0, 0 };
+	mutable vk::Buffer m_vertexBuffer;
+	mutable vk::Buffer m_indexBuffer;
+	mutable MemoryAllocation m_vertexBufferMemory;
+	mutable MemoryAllocation m_indexBufferMemory;
+	// Ranges freed while uploads or frames could still use them.
+	mutable std::vector<RetiredGeometry> m_retiredGeometry;
+	// Also guarded by m_geometryMutex, every upload goes into the geometry buffers.
+	mutable UploadQueue m_uploads;
+	// Signalled by submitUploads for the next frame to wait on, and reused once the frame that waited has completed.
+	mutable std::vector<vk::Semaphore> m_signaledUploadSemaphores;
+	mutable std::vector<UploadSemaphore> m_waitedUploadSemaphores;
+	mutable std::vector<vk::Semaphore> m_freeUploadSemaphores;
+	vk::Buffer m_stagingRing;
+	MemoryAllocation m_stagingRingMemory;
+	// One per frame in flight, created on first use.
+	mutable std::vector<InstanceBuffer> m_instanceBuffers;
+	mutable uint64_t m_submittedFrame = 0;
+	mutable uint64_t m_completedFrame = 0;
 
 	vk::Format m_swapchainFormat = vk::Format::eUndefined;
 	vk::Extent2D m_swapchainExtent = vk::Extent2D(0, 0);
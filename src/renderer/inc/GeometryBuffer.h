@@ -0,0 +1,45 @@
+#pragma once
+#include "TlsfAllocator.h"
+#include <cstdint>
+
+// Where a mesh lives in the shared vertex and index buffers.
+struct GeometryRange
+{
+	// In vertices and indices of the mesh's own formats, as vkCmdDrawIndexed takes them.
+	int32_t vertexOffset = 0;
+	uint32_t firstIndex = 0;
+	uint64_t vertexByteOffset = 0;
+	uint64_t indexByteOffset = 0;
+	uint32_t vertexNode = TlsfAllocator::INVALID_NODE;
+	uint32_t indexNode = TlsfAllocator::INVALID_NODE;
+
+	// False for ranges that do not own their space, such as a slot inside another range.
+	bool isValid() const
+	{
+		return vertexNode != TlsfAllocator::INVALID_NODE && indexNode != TlsfAllocator::INVALID_NODE;
+	}
+};
+
+// Hands out ranges of one vertex buffer and one index buffer, so all meshes are drawn from the same two bindings.
+// A vertex range starts at a multiple of its stride and an index range at a multiple of its index size, which is what
+// lets layouts and index types share buffers bound at offset 0. Only the bookkeeping is done here, the GPU owns the buffers.
+class GeometryBuffer
+{
+public:
+	GeometryBuffer(uint64_t vertexCapacity, uint64_t indexCapacity);
+
+	// Returns an invalid range if either buffer is too full, nothing is allocated then.
+	GeometryRange allocate(uint64_t vertexBytes, uint32_t vertexStride, uint64_t indexBytes, uint32_t indexSize);
+	void free(const GeometryRange &range);
+	// Capacities only grow, allocated ranges keep their offsets.
+	void grow(uint64_t vertexCapacity, uint64_t indexCapacity);
+
+	uint64_t vertexCapacity() const;
+	uint64_t indexCapacity() const;
+	uint64_t usedBytes() const;
+	uint32_t rangeCount() const;
+
+private:
+	TlsfAllocator m_verticies;
+	TlsfAllocator m_indices;
+};
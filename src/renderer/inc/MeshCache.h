@@ -0,0 +1,42 @@
+#pragma once
+#include "GeometryBuffer.h"
+#include "ResourceDefs.h"
+#include "ResourceHandle.h"
+#include "UploadQueue.h"
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+
+// A model's mesh as uploaded to the geometry buffers.
+struct GpuMesh
+{
+	GeometryRange geometry;
+	UploadToken uploadToken = 0;
+	uint32_t references = 0;
+};
+
+// Uploads every model once, all objects of a model share its mesh. The mesh is freed when the last of them releases it.
+class MeshCache
+{
+public:
+	// Places a model's mesh in the geometry buffers, as GPU::loadMesh does. An invalid range if that failed.
+	using UploadFunction = std::function<GeometryRange(const ModelData &model, vk::IndexType indexType, UploadToken &uploadToken)>;
+	using FreeFunction = std::function<void(const GeometryRange &geometry)>;
+
+	MeshCache(UploadFunction upload, FreeFunction free);
+
+	// Uploads the model on first use. layout and index type are taken from model.
+	// Returns nullptr if the upload fails, nothing is kept for the model then and the next acquire tries again.
+	const GpuMesh *acquire(ModelHandle handle, const ModelData &model);
+	void release(ModelHandle handle);
+
+private:
+	static uint64_t keyOf(ModelHandle handle);
+
+	UploadFunction m_upload;
+	FreeFunction m_free;
+	std::unordered_map<uint64_t, GpuMesh> m_meshes;
+};
+
+using MeshCachePtr = std::unique_ptr<MeshCache>;
@@ -2,7 +2,13 @@
 #include "Renderer.h"
 #include "RenderEngineAPI.h"
 #include "ResourceManagerAPI.h"
+#include "Frustum.h"
 #include "GPU.h"
+#include "MeshCache.h"
+#include "Terrain.h"
+#include <array>
+#include <future>
+#include <optional>
 #include <unordered_map>
 #include "SDL2/SDL.h"
 
@@ -16,11 +22,22 @@ public:
 	void drawScene() override;
 	bool pollForWindowClose() override;
 
+	void setCamera(const Camera &camera) override;
+
 	void waitForRendererToFinish() override;
 	void cleanUp() override;
 
 	RenderableObjectAPIPtr createObject(std::string name, const std::string &modelName) override;
 	RenderableObjectAPIPtr createObject(std::string id, const std::string &modelName, glm::vec3 position) override;
+	RenderableObjectAPIPtr createObject(std::string id, ModelHandle model) override;
+	RenderableObjectAPIPtr createObject(std::string id, ModelHandle model, glm::vec3 position) override;
+
+	bool uploadTexture(const std::string &textureName) override;
+
+	bool loadScene(const std::string &path) override;
+	bool saveScene(const std::string &path) const override;
+
+	bool createTerrain(Heightmap heightmap, const TerrainSettings &settings) override;
 
 	static std::vector<const char *> getValidationLayers();
 
@@ -31,17 +48,51 @@ private:
 
 	std::vector<const char*> getExtensions() const;
 	std::vector<vk::PipelineShaderStageCreateInfo> createShaderStages();
-	vk::ShaderModule* createShaderModule(const std::vector<char> &code, const std::string &shaderName);
+	vk::ShaderModule* createShaderModule(std::span<const char> code, const std::string &shaderName);
+	void reloadChangedShaders();
+	void rebuildPipelineIfDirty();
+	void destroyRetiredShaderModules();
+	// nullptr if the model's mesh could not be uploaded.
+	RenderableObjectPtr makeObject(std::string name, ModelHandle modelHandle, const ModelData &model, glm::vec3 position);
+	void bakeStaticBatches();
+	void rebuildStaticBatches(VertexLayoutKind layout);
+	void swapUploadedStaticBatches();
+	void selectLods();
+	void cullObjects();
+	void cullObject(const Frustum &frustum, RenderableObject &object) const;
+
+	struct PipelineShader
+	{
+		ShaderHandle handle;
+		vk::ShaderStageFlagBits stage;
+	};
 
 	bool m_isExiting;
+	bool m_pipelineDirty;
+	uint32_t m_nextObjectId;
+	Camera m_camera;
+	std::vector<PipelineShader> m_pipelineShaders;
 	std::unordered_map<std::string, vk::ShaderModule*> m_loadedShaders;
+	std::unordered_map<std::string, GPUTexture> m_textures;
+	std::vector<vk::ShaderModule*> m_retiredShaderModules;
+	std::future<std::optional<PipelineSet>> m_pipelineRebuild;
+	struct PendingStaticBatches
+	{
+		std::vector<RenderableObjectPtr> batches;
+		// Drawn on their own until the batches are in the scene.
+		std::vector<RenderableObjectPtr> members;
+	};
+	// Rebuilt batches per layout, they replace the scene's once all of them are uploaded.
+	std::array<std::optional<PendingStaticBatches>, VERTEX_LAYOUT_COUNT> m_pendingStaticBatches;
 	RendererPtr m_renderer;
 	RenderModeFactoryPtr m_renderModeFactory;
 	ScenePtr m_scene;
+	TerrainPtr m_terrain;
 	SDL_Window *m_window;
 	vk::Instance m_vulcanInstance;
 	vk::SurfaceKHR m_surface;
 	GPUPtr m_gpu;
+	MeshCachePtr m_meshes;
 	ResourceManagerAPIPtr m_resourceManager;
 };
 
@@ -1,11 +1,32 @@
 #pragma once
+#include <compare>
 #include <memory>
 #include <vulkan/vulkan.hpp>
 
+#include "GeometryBuffer.h"
+#include "UploadQueue.h"
 #include "RenderObjectAPI.h"
+#include "ResourceDefs.h"
+#include "ResourceHandle.h"
 #include "glm/glm.hpp"
 
 
+struct DrawRange
+{
+	uint32_t firstIndex;
+	uint32_t indexCount;
+
+	friend bool operator==(const DrawRange &lhs, const DrawRange &rhs) = default;
+	friend auto operator<=>(const DrawRange &lhs, const DrawRange &rhs) = default;
+};
+
+// Per instance vertex input, objects are only translated.
+struct InstanceData
+{
+	glm::vec3 position;
+	uint32_t objectId;
+};
+
 class RenderableObject : public RenderableObjectAPI
 {
 public:
@@ -13,11 +34,38 @@ public:
 
 	bool isActive() override;
 	void updatePosition(glm::vec3 newPosition) override;
+	void setStatic(bool isStatic) override;
+	bool isStatic() const;
+	// True while a static batch in the scene draws the object, it is not drawn on its own then.
+	bool isDrawnByStaticBatch() const;
+	const std::string &name() const;
+
+	void selectLod(uint32_t lod);
+	// Objects are only translated, so the world bounds are the model bounds moved to m_position.
+	Bounds worldBounds() const;
 
-	vk::Buffer sharedBuffer;
-	vk::DeviceMemory sharedBufferMemory;
+	ModelHandle model;
+	// Where the mesh is in the GPU's geometry buffers, draw ranges are relative to it.
+	GeometryRange geometry;
+	// The object is not recorded before the copies that fill geometry are complete.
+	UploadToken uploadToken;
+	uint32_t firstIndex;
 	uint32_t indexCount;
-	vk::DeviceSize vertexOffset;
+	vk::IndexType indexType;
+	VertexLayoutKind vertexLayout;
+	VertexQuantization quantization;
+	std::vector<MeshLod> lods;
+	uint32_t currentLod;
+	Bounds localBounds;
+	std::vector<Meshlet> meshlets;
+	// What is recorded for this object, empty when it is culled entirely.
+	std::vector<DrawRange> drawRanges;
+	// Set when the static batch this object belongs to, or belonged to, has to be rebuilt.
+	bool staticBatchDirty;
+	// Set when a batch this object was merged into replaces the scene's, cleared when one without it does.
+	bool inStaticBatch;
+	// Passed to the shaders with the instance data, 0 for static batches and terrain.
+	uint32_t objectId;
 
 	glm::vec3 m_position;
 
@@ -26,6 +74,7 @@ public:
 private:
 	const std::string m_name;
 	bool m_active;
+	bool m_static;
 };
 
 using RenderableObjectPtr = std::shared_ptr<RenderableObject>;
\ No newline at end of file
@@ -12,7 +12,11 @@ public:
 
 	bool init(const GPUPtr &gpu, const ResourceManagerAPIPtr &resMan, SimpleRenderMode renderMode);
 
-	void draw();
+	// Records the frame through factory from the scene as it is now and submits it.
+	void draw(AbstractRenderModeFactory &factory);
+
+	const SimpleRenderMode &getRenderMode() const;
+	void swapPipelines(const PipelineSet &pipelines);
 
 private:
 	bool createSyncObjects();
@@ -22,6 +26,8 @@ private:
 	std::vector<vk::Semaphore> m_imageAvailableSemaphores;
 	std::vector<vk::Semaphore> m_renderFinishedSemaphores;
 	std::vector<vk::Fence> m_frameFences;
+	// The GPU's number of the frame last submitted with each fence.
+	std::vector<uint64_t> m_submittedFrames;
 
 	SimpleRenderMode m_renderMode;
 	GPUPtr m_gpu;
@@ -1,4 +1,5 @@
 #pragma once
+#include <array>
 #include <memory>
 #include <vector>
 
@@ -7,7 +8,14 @@
 
 struct Scene
 {
+	// Objects of the same model share one mesh, owned by the engine's MeshCache.
 	std::vector<RenderableObjectPtr> renderableObjects;
+	// Merged static objects, indexed by VertexLayoutKind. Static objects are drawn through these and not on their own.
+	std::array<std::vector<RenderableObjectPtr>, VERTEX_LAYOUT_COUNT> staticBatches;
+	// Resident terrain chunks, owned by Terrain. Their geometry is a slot in its range of the geometry buffers.
+	std::vector<RenderableObjectPtr> terrainChunks;
+	// The camera's, set every frame before culling and recording.
+	glm::mat4 viewProjection{ 1.0F };
 };
 
 using ScenePtr = std::shared_ptr<Scene>;
@@ -0,0 +1,55 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+namespace scenefile {
+constexpr uint32_t MAGIC = 0x4353414E; // "NASC"
+constexpr uint32_t VERSION = 1;
+constexpr uint64_t ARRAY_ALIGNMENT = 16;
+constexpr size_t MAX_NAME_LENGTH = 64;
+
+// Bits of an object's flags.
+constexpr uint32_t OBJECT_STATIC = 1;
+
+struct ModelName
+{
+	char name[MAX_NAME_LENGTH];
+};
+
+struct Position
+{
+	float x;
+	float y;
+	float z;
+};
+
+// Where an object's name is in the names array, names are not null terminated.
+struct NameRange
+{
+	uint32_t offset;
+	uint32_t length;
+};
+
+// Every array starts at an ARRAY_ALIGNMENT boundary and is used in place.
+// models holds modelCount ModelNames, the object arrays hold objectCount elements each:
+// objectModels an index into models, objectFlags the object flags, positions a Position and nameRanges a NameRange.
+struct Header
+{
+	uint32_t magic;
+	uint32_t version;
+	uint32_t modelCount;
+	uint32_t objectCount;
+	uint64_t modelsOffset;
+	uint64_t objectModelsOffset;
+	uint64_t objectFlagsOffset;
+	uint64_t positionsOffset;
+	uint64_t nameRangesOffset;
+	uint64_t namesOffset;
+	uint64_t namesSize;
+	uint64_t padding;
+};
+
+static_assert(sizeof(Header) % ARRAY_ALIGNMENT == 0);
+static_assert(sizeof(ModelName) % ARRAY_ALIGNMENT == 0);
+static_assert(sizeof(Position) == 3 * sizeof(float));
+}
@@ -0,0 +1,62 @@
+#pragma once
+#include "MappedFile.h"
+#include "SceneFormat.h"
+#include "glm/glm.hpp"
+
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// A scene file mapped into memory. Every array is read in place, nothing is copied on open.
+class SceneSnapshot
+{
+public:
+	bool open(const std::string &path);
+	void close();
+	bool isOpen() const;
+
+	uint32_t objectCount() const;
+	std::span<const scenefile::ModelName> models() const;
+	std::span<const uint32_t> objectModels() const;
+	std::span<const uint32_t> objectFlags() const;
+	std::span<const scenefile::Position> positions() const;
+	std::string_view objectName(uint32_t object) const;
+
+	static std::string_view modelName(const scenefile::ModelName &model);
+
+private:
+	bool validate(const std::string &path) const;
+
+	template<typename T>
+	std::span<const T> view(uint64_t offset, uint32_t count) const
+	{
+		return { reinterpret_cast<const T *>(m_file.data().data() + offset), count };
+	}
+
+	MappedFile m_file;
+	std::span<const scenefile::ModelName> m_models;
+	std::span<const uint32_t> m_objectModels;
+	std::span<const uint32_t> m_objectFlags;
+	std::span<const scenefile::Position> m_positions;
+	std::span<const scenefile::NameRange> m_nameRanges;
+	std::span<const char> m_names;
+};
+
+class SceneSnapshotWriter
+{
+public:
+	void addObject(std::string_view name, std::string_view modelName, glm::vec3 position, bool isStatic);
+
+	bool write(const std::string &path) const;
+
+private:
+	std::vector<scenefile::ModelName> m_models;
+	std::unordered_map<std::string, uint32_t> m_modelIndices;
+	std::vector<uint32_t> m_objectModels;
+	std::vector<uint32_t> m_objectFlags;
+	std::vector<scenefile::Position> m_positions;
+	std::vector<scenefile::NameRange> m_nameRanges;
+	std::vector<char> m_names;
+};
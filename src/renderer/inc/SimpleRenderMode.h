@@ -1,14 +1,30 @@
 #pragma once
 #include "vulkan\vulkan.hpp"
+#include "VertexLayout.h"
+#include <array>
+#include <vector>
+
+constexpr size_t NUMBER_OF_FRAMES_IN_FLIGHT = 3;
+
+// One pipeline per VertexLayoutKind, they only differ in their vertex input state.
+using PipelineSet = std::array<vk::Pipeline, VERTEX_LAYOUT_COUNT>;
+
+// What one frame in flight is recorded into. The pools are reset, not freed, once the frame's fence has signalled.
+struct FrameCommands
+{
+	vk::CommandPool primaryPool;
+	vk::CommandBuffer primary;
+	// One pool and secondary buffer per recording thread, each records a consecutive part of the frame's draws.
+	std::vector<vk::CommandPool> secondaryPools;
+	std::vector<vk::CommandBuffer> secondaries;
+};
 
 struct SimpleRenderMode
 {
-	vk::Pipeline pipeline;
+	PipelineSet pipelines;
 	vk::RenderPass renderPass;
 	vk::PipelineLayout pipelineLayout;
 
-	vk::CommandPool commandPool;
-
-	std::vector<vk::CommandBuffer> commandBuffers;
+	std::array<FrameCommands, NUMBER_OF_FRAMES_IN_FLIGHT> frames;
 	std::vector<vk::Framebuffer> swapchainFramebuffers;
 };
\ No newline at end of file
@@ -9,16 +9,18 @@ public:
 	~SimpleRenderModeFactory() override = default;
 
 	SimpleRenderMode createRenderMode(vk::Format swapchainFormat, vk::Extent2D extent, const std::vector<vk::PipelineShaderStageCreateInfo> &shaders) override;
+	std::optional<PipelineSet> rebuildPipelines(const SimpleRenderMode &mode, vk::Extent2D extent, const std::vector<vk::PipelineShaderStageCreateInfo> &shaders) const override;
+	void recordFrame(SimpleRenderMode &mode, size_t frameIndex, uint32_t imageIndex) override;
 
 protected:
-	void recordCommandBuffers();
 	bool createRenderPass(vk::Format swapchainFormat);
 	void createPipelineLayout();
-	bool createPipeline(const std::vector<vk::PipelineShaderStageCreateInfo> &shaders, const vk::Viewport &viewport, const vk::Rect2D &scissors);
+	bool createPipelines(const SimpleRenderMode &mode, const std::vector<vk::PipelineShaderStageCreateInfo> &shaders, vk::Extent2D extent, PipelineSet &pipelines) const;
+	bool createPipeline(const SimpleRenderMode &mode, const std::vector<vk::PipelineShaderStageCreateInfo> &shaders, const vk::Viewport &viewport, const vk::Rect2D &scissors, VertexLayoutKind layout, vk::Pipeline &pipeline) const;
 
 
 	bool createSwapchain(vk::Extent2D extent);
-	void createCommandPool();
+	void createFrameCommands();
 
 	SimpleRenderMode m_result;
 	GPUPtr m_gpu;
@@ -0,0 +1,34 @@
+#pragma once
+#include "RenderableObject.h"
+#include "ResourceManagerAPI.h"
+#include <cstddef>
+#include <vector>
+
+// Geometry of one static batch, ready to be uploaded like a model.
+struct StaticBatchData
+{
+	std::vector<std::byte> verticies;
+	std::vector<std::byte> indicies;
+	IndexType indexType;
+	uint32_t indexCount;
+	VertexQuantization quantization;
+	Bounds bounds;
+	// The objects merged into the batch, members whose model was not available are left out.
+	std::vector<RenderableObjectPtr> members;
+};
+
+class StaticBatcher
+{
+public:
+	// Keeps batches small enough for 16 bit indices. A model larger than this gets a batch of its own.
+	static constexpr size_t MAX_BATCH_VERTICES = 65536;
+	// Largest side of a quantized batch's bounds, in world units. Its positions are snorm16 across the bounds, so this keeps
+	// their rounding error below MAX_QUANTIZED_BATCH_EXTENT / 65534 however far apart the static objects are.
+	// A model larger than this gets a batch of its own.
+	static constexpr float MAX_QUANTIZED_BATCH_EXTENT = 64.0F;
+
+	// Appends the full mesh of every member, moved to the member's position, into as few batches as fit.
+	// All members must share layout, the batches use it too so they are drawn with the same pipeline.
+	// Quantized members are grouped by position, so their batches stay within MAX_QUANTIZED_BATCH_EXTENT.
+	static std::vector<StaticBatchData> build(VertexLayoutKind layout, const std::vector<RenderableObjectPtr> &members, ResourceManagerAPI &resourceManager);
+};
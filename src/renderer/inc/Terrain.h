@@ -0,0 +1,83 @@
+#pragma once
+#include "Camera.h"
+#include "GPU.h"
+#include "Scene.h"
+#include "TerrainMesher.h"
+#include <future>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+// Splits a heightmap into square chunks and keeps the ones around the camera in scene->terrainChunks.
+// Chunk meshes are built on the shared thread pool and written into one range of the GPU's geometry buffers,
+// which has a slot per resident chunk. All chunks share the indices of every LOD with every combination of stitched sides.
+class Terrain
+{
+public:
+	// Null when the range for the chunks and their indices can not be allocated. The settings have to be validated first.
+	static std::unique_ptr<Terrain> create(GPUPtr gpu, ScenePtr scene, Heightmap heightmap, const TerrainSettings &settings);
+
+	// Logs what is wrong with the settings, if anything.
+	static bool validate(const Heightmap &heightmap, const TerrainSettings &settings);
+
+	// Streams chunks in and out and picks their LODs.
+	// Evicted chunks keep their slots until the frames that may still draw them have completed.
+	void update(const Camera &camera);
+	// Waits for chunks still being built and removes them from the scene. Their geometry is freed once no frame draws it.
+	void cleanUp();
+
+private:
+	using ChunkKey = uint64_t;
+
+	struct Chunk
+	{
+		uint32_t x;
+		uint32_t z;
+		uint32_t slot;
+		uint32_t lod;
+		uint32_t stitchMask;
+		RenderableObjectPtr object;
+	};
+
+	struct RetiredSlot
+	{
+		uint32_t slot;
+		UploadToken upload;
+		uint64_t frame;
+	};
+
+	struct PendingChunk
+	{
+		uint32_t x;
+		uint32_t z;
+		std::future<TerrainChunkMesh> mesh;
+	};
+
+	Terrain(GPUPtr gpu, ScenePtr scene, Heightmap heightmap, const TerrainSettings &settings);
+
+	static ChunkKey keyOf(uint32_t x, uint32_t z);
+	float groundDistance(const Camera &camera, uint32_t x, uint32_t z) const;
+	uint32_t targetLod(const Camera &camera, const Chunk &chunk) const;
+
+	void evictChunks(const Camera &camera);
+	void requestChunks(const Camera &camera);
+	void uploadChunks(const Camera &camera);
+	void selectLods(const Camera &camera);
+
+	GPUPtr m_gpu;
+	ScenePtr m_scene;
+	std::shared_ptr<const Heightmap> m_heightmap;
+	TerrainSettings m_settings;
+	uint32_t m_chunksX;
+	uint32_t m_chunksZ;
+	std::vector<DrawRange> m_indexVariants;
+	vk::IndexType m_indexType;
+	uint32_t m_chunkVertexCount;
+	GeometryRange m_geometry;
+	std::vector<uint32_t> m_freeSlots;
+	std::vector<RetiredSlot> m_retiredSlots;
+	std::unordered_map<ChunkKey, Chunk> m_chunks;
+	std::vector<PendingChunk> m_pending;
+};
+
+using TerrainPtr = std::unique_ptr<Terrain>;
@@ -0,0 +1,42 @@
+#pragma once
+#include "Heightmap.h"
+#include "RenderableObject.h"
+#include "TerrainSettings.h"
+#include <cstddef>
+#include <vector>
+
+// Vertices of one chunk, ready to be written to a pool buffer.
+struct TerrainChunkMesh
+{
+	std::vector<std::byte> verticies;
+	VertexQuantization quantization;
+	Bounds bounds;
+};
+
+// Index lists shared by every chunk, one per LOD and stitch mask.
+struct TerrainIndices
+{
+	std::vector<std::byte> indicies;
+	IndexType indexType;
+	// Indexed by lod * STITCH_MASK_COUNT + stitch mask.
+	std::vector<DrawRange> variants;
+};
+
+class TerrainMesher
+{
+public:
+	// Stitch mask bits, set for every side whose neighbour uses the next coarser LOD.
+	static constexpr uint32_t STITCH_NEGATIVE_Z = 1;
+	static constexpr uint32_t STITCH_POSITIVE_X = 2;
+	static constexpr uint32_t STITCH_POSITIVE_Z = 4;
+	static constexpr uint32_t STITCH_NEGATIVE_X = 8;
+	static constexpr uint32_t STITCH_MASK_COUNT = 16;
+
+	// Full detail grid of (chunkQuads + 1)^2 quantized vertices in world space, every LOD draws a subset of it.
+	// Samples past the heightmap edge are clamped, so the last chunks in a row may contain degenerate quads.
+	static TerrainChunkMesh buildChunk(const Heightmap &heightmap, const TerrainSettings &settings, uint32_t chunkX, uint32_t chunkZ);
+
+	// On a stitched side every other edge vertex is moved onto its even neighbour, which makes the edge match the
+	// coarser chunk next to it exactly. The triangles that collapse on the way are left out.
+	static TerrainIndices buildIndices(const TerrainSettings &settings);
+};
@@ -0,0 +1,74 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <vector>
+
+// Two level segregated fit allocator for ranges of a fixed size space, it only does the bookkeeping.
+// Free ranges are kept in lists by size class, a class covers 1/32 of a power of two. Allocation and free are O(1):
+// two bitmap scans find a list whose ranges all fit, and freed ranges are merged with free neighbours right away.
+class TlsfAllocator
+{
+public:
+	static constexpr uint32_t INVALID_NODE = ~0U;
+
+	struct Allocation
+	{
+		uint64_t offset = 0;
+		// Identifies the allocation to free(), INVALID_NODE when allocate failed.
+		uint32_t node = INVALID_NODE;
+	};
+
+	explicit TlsfAllocator(uint64_t size);
+
+	// alignment has to be a power of two.
+	Allocation allocate(uint64_t size, uint64_t alignment);
+	void free(uint32_t node);
+	// Adds the space between the current size and size at the end. Allocations keep their offsets.
+	void grow(uint64_t size);
+
+	uint64_t size() const;
+	uint64_t usedBytes() const;
+	uint32_t allocationCount() const;
+	uint64_t largestFreeRange() const;
+
+private:
+	static constexpr uint32_t SL_BITS = 5;
+	static constexpr uint32_t SL_COUNT = 1U << SL_BITS;
+	static constexpr uint32_t FL_COUNT = 64;
+
+	struct Node
+	{
+		uint64_t offset;
+		uint64_t size;
+		uint32_t previousPhysical;
+		uint32_t nextPhysical;
+		uint32_t previousFree;
+		uint32_t nextFree;
+		bool isFree;
+	};
+
+	struct SizeClass
+	{
+		uint32_t fl;
+		uint32_t sl;
+	};
+
+	static SizeClass sizeClass(uint64_t size);
+
+	uint32_t createNode(uint64_t offset, uint64_t size);
+	void releaseNode(uint32_t node);
+	void insertFree(uint32_t node);
+	void removeFree(uint32_t node);
+	uint32_t findFree(uint64_t size, uint64_t alignment) const;
+	// Cuts the first size bytes off node into a node of their own, returns that node.
+	uint32_t splitFront(uint32_t node, uint64_t size);
+
+	uint64_t m_size;
+	uint64_t m_usedBytes;
+	uint32_t m_allocationCount;
+	std::vector<Node> m_nodes;
+	std::vector<uint32_t> m_unusedNodes;
+	uint64_t m_flBitmap;
+	std::array<uint32_t, FL_COUNT> m_slBitmaps;
+	std::array<std::array<uint32_t, SL_COUNT>, FL_COUNT> m_freeHeads;
+};
@@ -0,0 +1,88 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <span>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+// Identifies the batch an upload goes out with, batches complete in order. 0 is never handed out and counts as complete.
+using UploadToken = uint64_t;
+
+// Staging memory for the batch being collected.
+struct StagingRegion
+{
+	// Null when the data does not fit in the ring at all.
+	std::byte *data = nullptr;
+	vk::DeviceSize offset = 0;
+};
+
+// Collects the copies of a frame into one transfer submission that is tracked by a fence, nothing waits for the queue to go idle.
+// Data is staged in a persistently mapped ring buffer whose space is reclaimed as the fences of the batches using it signal.
+// Fences only tell the host that a batch is done. Queues that read the uploaded data wait for a semaphore from submitAndSignal.
+// Not thread safe, the GPU serializes access to it.
+class UploadQueue
+{
+public:
+	void init(vk::Device device, vk::Queue queue, uint32_t queueFamily, vk::Buffer stagingBuffer, std::byte *stagingData, vk::DeviceSize stagingSize);
+	// Waits for every batch, the staging buffer is left to its owner.
+	void cleanUp();
+
+	// Only waits for older batches when the ring is full of them.
+	StagingRegion stage(vk::DeviceSize size, vk::DeviceSize alignment);
+	void copy(vk::DeviceSize stagingOffset, vk::Buffer destination, vk::DeviceSize destinationOffset, vk::DeviceSize size);
+	// Copies from a buffer other than the staging ring, whoever owns it keeps it alive until the batch is complete.
+	void copy(vk::Buffer source, vk::DeviceSize sourceOffset, vk::Buffer destination, vk::DeviceSize destinationOffset, vk::DeviceSize size);
+	// Writes data from the command buffer itself, for small updates that need no staging. offset and data.size() have to be multiples of 4.
+	void update(vk::Buffer destination, vk::DeviceSize offset, std::span<const std::byte> data);
+
+	// The token of the newest upload, whether it is still being collected or already submitted.
+	UploadToken latestToken() const;
+	bool isComplete(UploadToken token) const;
+
+	// Submits the batch being collected, if anything was recorded into it.
+	void submit();
+	// Like submit, and signals semaphore once every batch submitted so far has executed. Returns false without signalling
+	// when nothing was submitted since the last semaphore, the semaphore can be reused right away then.
+	bool submitAndSignal(vk::Semaphore semaphore);
+	// The newest token a semaphore from submitAndSignal covers.
+	UploadToken signaledToken() const;
+	// Retires the batches whose fences have signalled. Returns true if there were any.
+	bool poll();
+	// Submits the batch being collected and waits for all of them.
+	void waitIdle();
+
+private:
+	struct Batch
+	{
+		vk::CommandBuffer commandBuffer;
+		vk::Fence fence;
+		UploadToken token = 0;
+		// Ring position up to which the batch staged data.
+		uint64_t ringEnd = 0;
+	};
+
+	void begin();
+	void submitBatch(const vk::Semaphore *signalSemaphore);
+	void retireOldest();
+
+	vk::Device m_device;
+	vk::Queue m_queue;
+	vk::CommandPool m_commandPool;
+	vk::Buffer m_stagingBuffer;
+	std::byte *m_stagingData = nullptr;
+	vk::DeviceSize m_stagingSize = 0;
+	// Positions in the ring only grow while batches are in flight, the offset in the buffer is position % m_stagingSize.
+	uint64_t m_head = 0;
+	uint64_t m_tail = 0;
+	// Has no command buffer while nothing was recorded since the last submit.
+	Batch m_current;
+	std::deque<Batch> m_inFlight;
+	// Command buffers and fences of retired batches, for reuse.
+	std::vector<Batch> m_retired;
+	UploadToken m_nextToken = 1;
+	// Read while recording command buffers, which does not take the GPU's lock.
+	std::atomic<UploadToken> m_completedToken{ 0 };
+	std::atomic<UploadToken> m_signaledToken{ 0 };
+};
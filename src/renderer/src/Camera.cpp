@@ -0,0 +1,27 @@
+#include "Camera.h"
+
+#include <cmath>
+
+glm::mat4 Camera::viewProjection() const
+{
+	// View space rows are right, down and forward. right = down x forward keeps the basis right handed.
+	const auto down = -up;
+	const auto right = glm::cross(down, forward);
+
+	auto view = glm::mat4(1.0F);
+	for (int column = 0; column < 3; ++column)
+	{
+		view[column] = glm::vec4(right[column], down[column], forward[column], 0.0F);
+	}
+	view[3] = glm::vec4(-glm::dot(right, position), -glm::dot(down, position), -glm::dot(forward, position), 1.0F);
+
+	const auto focalLength = 1.0F / std::tan(verticalFov * 0.5F);
+	auto projection = glm::mat4(0.0F);
+	projection[0][0] = focalLength / aspectRatio;
+	projection[1][1] = focalLength;
+	projection[2][2] = farPlane / (farPlane - nearPlane);
+	projection[2][3] = 1.0F;
+	projection[3][2] = -nearPlane * farPlane / (farPlane - nearPlane);
+
+	return projection * view;
+}
@@ -0,0 +1,192 @@
+#include "DeviceMemoryAllocator.h"
+#include "LoggerAPI.h"
+
+#include <algorithm>
+#include <fmt/core.h>
+
+namespace {
+constexpr uint32_t NO_MEMORY_TYPE = ~0U;
+// Blocks take at most this share of their heap, small heaps such as a resizable BAR window get smaller blocks.
+constexpr vk::DeviceSize HEAP_SHARE = 8;
+constexpr double MEBIBYTE = 1024.0 * 1024.0;
+}
+
+void DeviceMemoryAllocator::init(vk::Device device, vk::PhysicalDevice physicalDevice)
+{
+	m_device = device;
+	m_memoryProperties = physicalDevice.getMemoryProperties();
+	for (uint32_t i = 0; i < m_pools.size(); ++i)
+	{
+		m_pools[i].memoryType = i / 2;
+	}
+}
+
+void DeviceMemoryAllocator::cleanUp()
+{
+	const auto lock = std::lock_guard(m_mutex);
+	for (auto &pool : m_pools)
+	{
+		for (auto &block : pool.blocks)
+		{
+			if (!block.memory)
+			{
+				continue;
+			}
+			if (block.ranges.allocationCount() != 0)
+			{
+				LoggerAPI::getLogger()->logWarning(fmt::format("{} allocations in memory type {} were never freed", block.ranges.allocationCount(), pool.memoryType));
+			}
+			m_device.freeMemory(block.memory);
+		}
+		pool.blocks.clear();
+	}
+}
+
+MemoryAllocation DeviceMemoryAllocator::allocate(const vk::MemoryRequirements &requirements, vk::MemoryPropertyFlags properties, MemoryKind kind)
+{
+	const auto memoryType = findMemoryType(requirements.memoryTypeBits, properties);
+	if (memoryType == NO_MEMORY_TYPE)
+	{
+		LoggerAPI::getLogger()->logError("No memory type has the requested properties");
+		return {};
+	}
+
+	const auto lock = std::lock_guard(m_mutex);
+	const auto poolIndex = memoryType * 2 + static_cast<uint32_t>(kind);
+	auto &pool = m_pools[poolIndex];
+
+	const auto allocateFrom = [&](uint32_t blockIndex)
+	{
+		auto &block = pool.blocks[blockIndex];
+		const auto range = block.ranges.allocate(requirements.size, requirements.alignment);
+		auto allocation = MemoryAllocation();
+		if (range.node != TlsfAllocator::INVALID_NODE)
+		{
+			allocation = { block.memory, range.offset, requirements.size, block.mapped != nullptr ? block.mapped + range.offset : nullptr, poolIndex, blockIndex, range.node };
+		}
+		return allocation;
+	};
+
+	auto emptySlot = static_cast<uint32_t>(pool.blocks.size());
+	for (uint32_t blockIndex = 0; blockIndex < pool.blocks.size(); ++blockIndex)
+	{
+		if (!pool.blocks[blockIndex].memory)
+		{
+			emptySlot = std::min(emptySlot, blockIndex);
+			continue;
+		}
+
+		auto allocation = allocateFrom(blockIndex);
+		if (allocation.isValid())
+		{
+			return allocation;
+		}
+	}
+
+	// Resources larger than a block get a block of their own.
+	const auto heapSize = m_memoryProperties.memoryHeaps[m_memoryProperties.memoryTypes[memoryType].heapIndex].size;
+	const auto blockSize = std::max(std::min(BLOCK_SIZE, heapSize / HEAP_SHARE), requirements.size);
+	if (!createBlock(pool, emptySlot, blockSize))
+	{
+		return {};
+	}
+	return allocateFrom(emptySlot);
+}
+
+void DeviceMemoryAllocator::free(const MemoryAllocation &allocation)
+{
+	if (!allocation.isValid())
+	{
+		return;
+	}
+
+	const auto lock = std::lock_guard(m_mutex);
+	auto &pool = m_pools[allocation.pool];
+	auto &block = pool.blocks[allocation.block];
+	block.ranges.free(allocation.node);
+
+	// One empty block per pool is kept, so a pool that is emptied and refilled does not allocate every time.
+	// Blocks made for a single large resource are not worth keeping.
+	const auto liveBlocks = std::count_if(pool.blocks.begin(), pool.blocks.end(), [](const Block &candidate)
+	{
+		return static_cast<bool>(candidate.memory);
+	});
+	if (block.ranges.allocationCount() == 0 && (liveBlocks > 1 || block.ranges.size() > BLOCK_SIZE))
+	{
+		m_device.freeMemory(block.memory);
+		block = Block{ vk::DeviceMemory(), nullptr, TlsfAllocator(0) };
+	}
+}
+
+MemoryUsage DeviceMemoryAllocator::usage() const
+{
+	const auto lock = std::lock_guard(m_mutex);
+	auto result = MemoryUsage();
+	auto freeBytes = vk::DeviceSize{ 0 };
+	auto largestFreeRanges = vk::DeviceSize{ 0 };
+
+	for (const auto &pool : m_pools)
+	{
+		for (const auto &block : pool.blocks)
+		{
+			if (!block.memory)
+			{
+				continue;
+			}
+			result.reservedBytes += block.ranges.size();
+			result.usedBytes += block.ranges.usedBytes();
+			result.allocationCount += block.ranges.allocationCount();
+			++result.blockCount;
+			freeBytes += block.ranges.size() - block.ranges.usedBytes();
+			largestFreeRanges += block.ranges.largestFreeRange();
+		}
+	}
+
+	result.fragmentation = freeBytes == 0 ? 0.0F : 1.0F - static_cast<float>(static_cast<double>(largestFreeRanges) / static_cast<double>(freeBytes));
+	return result;
+}
+
+uint32_t DeviceMemoryAllocator::findMemoryType(uint32_t typeFilter, vk::MemoryPropertyFlags properties) const
+{
+	for (uint32_t i = 0; i < m_memoryProperties.memoryTypeCount; ++i)
+	{
+		if ((typeFilter & (1U << i)) != 0 && (m_memoryProperties.memoryTypes[i].propertyFlags & properties) == properties)
+		{
+			return i;
+		}
+	}
+	return NO_MEMORY_TYPE;
+}
+
+bool DeviceMemoryAllocator::createBlock(Pool &pool, uint32_t blockIndex, vk::DeviceSize size)
+{
+	auto memoryAllocateInfo = vk::MemoryAllocateInfo();
+	memoryAllocateInfo.setAllocationSize(size);
+	memoryAllocateInfo.setMemoryTypeIndex(pool.memoryType);
+
+	vk::DeviceMemory memory;
+	if (vk::Result::eSuccess != m_device.allocateMemory(&memoryAllocateInfo, nullptr, &memory))
+	{
+		LoggerAPI::getLogger()->logError(fmt::format("Failed to allocate a {:.1f} MiB block of memory type {}", static_cast<double>(size) / MEBIBYTE, pool.memoryType));
+		return false;
+	}
+
+	std::byte *mapped = nullptr;
+	if (m_memoryProperties.memoryTypes[pool.memoryType].propertyFlags & vk::MemoryPropertyFlagBits::eHostVisible)
+	{
+		mapped = static_cast<std::byte *>(m_device.mapMemory(memory, 0, VK_WHOLE_SIZE, vk::MemoryMapFlags()));
+	}
+
+	auto block = Block{ memory, mapped, TlsfAllocator(size) };
+	if (blockIndex == pool.blocks.size())
+	{
+		pool.blocks.push_back(std::move(block));
+	}
+	else
+	{
+		pool.blocks[blockIndex] = std::move(block);
+	}
+
+	LoggerAPI::getLogger()->logInfo(fmt::format("Allocated a {:.1f} MiB block of memory type {}", static_cast<double>(size) / MEBIBYTE, pool.memoryType));
+	return true;
+}
@@ -0,0 +1,63 @@
+#include "DrawCollector.h"
+
+#include <algorithm>
+#include <tuple>
+
+std::vector<InstancedDraw> DrawCollector::collect(const Scene &scene, const UploadCompleteFunction &isUploadComplete, std::vector<InstanceData> &instances)
+{
+	const auto isDrawable = [&isUploadComplete](const RenderableObject &object)
+	{
+		return !object.drawRanges.empty() && isUploadComplete(object.uploadToken);
+	};
+
+	auto objects = std::vector<const RenderableObject *>();
+	for (const auto &object : scene.renderableObjects)
+	{
+		if (!object->isDrawnByStaticBatch() && isDrawable(*object))
+		{
+			objects.push_back(object.get());
+		}
+	}
+	// Sorted by layout first, so the pipeline changes as rarely as possible.
+	const auto drawKey = [](const RenderableObject *object)
+	{
+		return std::tie(object->vertexLayout, object->geometry.vertexOffset, object->geometry.firstIndex, object->drawRanges);
+	};
+	std::sort(objects.begin(), objects.end(), [&drawKey](const RenderableObject *lhs, const RenderableObject *rhs)
+	{
+		return drawKey(lhs) < drawKey(rhs);
+	});
+
+	auto draws = std::vector<InstancedDraw>();
+	for (const auto *object : objects)
+	{
+		if (draws.empty() || drawKey(draws.back().object) != drawKey(object))
+		{
+			draws.push_back({ object, static_cast<uint32_t>(instances.size()), 0 });
+		}
+		++draws.back().instanceCount;
+		instances.push_back({ object->m_position, object->objectId });
+	}
+
+	const auto addSingle = [&](const RenderableObject *object)
+	{
+		if (isDrawable(*object))
+		{
+			draws.push_back({ object, static_cast<uint32_t>(instances.size()), 1 });
+			instances.push_back({ glm::vec3(0.0F), 0 });
+		}
+	};
+	for (const auto &batches : scene.staticBatches)
+	{
+		for (const auto &batch : batches)
+		{
+			addSingle(batch.get());
+		}
+	}
+	for (const auto &chunk : scene.terrainChunks)
+	{
+		addSingle(chunk.get());
+	}
+
+	return draws;
+}
@@ -0,0 +1,37 @@
+#include "Frustum.h"
+
+namespace {
+glm::vec4 normalizePlane(glm::vec4 plane)
+{
+	return plane / glm::length(glm::vec3(plane));
+}
+}
+
+Frustum::Frustum(const glm::mat4 &viewProjection)
+{
+	// Gribb, Hartmann - "Fast Extraction of Viewing Frustum Planes from the World-View-Projection Matrix".
+	// A point is inside when -w <= x <= w, -w <= y <= w and 0 <= z <= w in clip space.
+	const auto row = [&viewProjection](int index)
+	{
+		return glm::vec4(viewProjection[0][index], viewProjection[1][index], viewProjection[2][index], viewProjection[3][index]);
+	};
+
+	m_planes[0] = normalizePlane(row(2));
+	m_planes[1] = normalizePlane(row(3) - row(2));
+	m_planes[2] = normalizePlane(row(3) + row(1));
+	m_planes[3] = normalizePlane(row(3) - row(1));
+	m_planes[4] = normalizePlane(row(3) + row(0));
+	m_planes[5] = normalizePlane(row(3) - row(0));
+}
+
+bool Frustum::intersectsSphere(glm::vec3 center, float radius) const
+{
+	for (const auto &plane : m_planes)
+	{
+		if (glm::dot(glm::vec3(plane), center) + plane.w < -radius)
+		{
+			return false;
+		}
+	}
+	return true;
+}
@@ -2,6 +2,7 @@
 #include "LoggerAPI.h"
 #include "RenderEngine.h"
 
+#include <fmt/core.h>
 #include <set>
 #include <algorithm>
 
@@ -14,8 +15,40 @@ const auto stagingBufferUsageFlags = vk::BufferUsageFlagBits::eIndexBuffer | vk:
 const auto stagingBufferMemoryProperties = vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent;
 
 const auto targetBufferUsageFlags = vk::BufferUsageFlagBits::eIndexBuffer | vk::BufferUsageFlagBits::eVertexBuffer | vk::BufferUsageFlagBits::eTransferDst;
+// Geometry buffers are also the source when they are copied into larger ones.
+const auto geometryBufferUsageFlags = targetBufferUsageFlags | vk::BufferUsageFlagBits::eTransferSrc;
 const auto targetBufferMemoryProperties = vk::MemoryPropertyFlagBits::eDeviceLocal;
 
+namespace {
+constexpr vk::DeviceSize STAGING_RING_SIZE = 64 * 1024 * 1024;
+// Compressed meshes are decoded into staging memory a word at a time.
+constexpr vk::DeviceSize STAGING_ALIGNMENT = 16;
+constexpr vk::DeviceSize INITIAL_VERTEX_BUFFER_SIZE = 32 * 1024 * 1024;
+constexpr vk::DeviceSize INITIAL_INDEX_BUFFER_SIZE = 16 * 1024 * 1024;
+constexpr size_t MIN_INSTANCE_CAPACITY = 1024;
+
+uint32_t indexSizeOf(vk::IndexType indexType)
+{
+	return indexType == vk::IndexType::eUint16 ? sizeof(uint16_t) : sizeof(uint32_t);
+}
+
+vk::Format toVkFormat(TextureFormat format)
+{
+	switch (format)
+	{
+	case TextureFormat::Bc1:
+		return vk::Format::eBc1RgbaUnormBlock;
+	case TextureFormat::Bc3:
+		return vk::Format::eBc3UnormBlock;
+	case TextureFormat::Bc7:
+		return vk::Format::eBc7UnormBlock;
+	case TextureFormat::Rgba8:
+	default:
+		return vk::Format::eR8G8B8A8Unorm;
+	}
+}
+}
+
 const auto waitForFenceTimer = std::numeric_limits<uint64_t>::max();
 const auto imageAquirementTimer = 2;
 
@@ -34,14 +67,57 @@ void GPU::resetFence(const vk::Fence * fence) const
 	m_device.resetFences(1, fence);
 }
 
-void GPU::acquireNextImage(const vk::Semaphore &semaphore) const
+uint32_t GPU::acquireNextImage(const vk::Semaphore &semaphore) const
+{
+	uint32_t imageIndex{ 0 };
+	m_device.acquireNextImageKHR(swapchain, imageAquirementTimer, semaphore, nullptr, &imageIndex);
+	return imageIndex;
+}
+
+uint64_t GPU::submitFrame(const vk::SubmitInfo *submitInfo, vk::Fence fence) const
+{
+	const auto lock = std::lock_guard(m_geometryMutex);
+
+	// The transfer queue's writes only become visible to vertex input through these, a host side fence wait is not enough.
+	auto waitSemaphores = std::vector<vk::Semaphore>(submitInfo->pWaitSemaphores, submitInfo->pWaitSemaphores + submitInfo->waitSemaphoreCount);
+	auto waitStages = std::vector<vk::PipelineStageFlags>(submitInfo->pWaitDstStageMask, submitInfo->pWaitDstStageMask + submitInfo->waitSemaphoreCount);
+	for (const auto &semaphore : m_signaledUploadSemaphores)
+	{
+		waitSemaphores.push_back(semaphore);
+		waitStages.push_back(vk::PipelineStageFlagBits::eVertexInput);
+	}
+
+	auto frameSubmitInfo = *submitInfo;
+	frameSubmitInfo.setWaitSemaphoreCount(static_cast<uint32_t>(waitSemaphores.size()));
+	frameSubmitInfo.setPWaitSemaphores(waitSemaphores.data());
+	frameSubmitInfo.setPWaitDstStageMask(waitStages.data());
+	graphicsQueue.submit(1, &frameSubmitInfo, fence);
+
+	++m_submittedFrame;
+	for (const auto &semaphore : m_signaledUploadSemaphores)
+	{
+		m_waitedUploadSemaphores.push_back({ semaphore, m_submittedFrame });
+	}
+	m_signaledUploadSemaphores.clear();
+	return m_submittedFrame;
+}
+
+void GPU::completeFrame(const uint64_t frame) const
 {
-	m_device.acquireNextImageKHR(swapchain, imageAquirementTimer, semaphore, nullptr);
+	const auto lock = std::lock_guard(m_geometryMutex);
+	// Fences that were never submitted report frame 0.
+	m_completedFrame = std::max(m_completedFrame, frame);
+	releaseRetiredGeometry();
 }
 
-void GPU::submitToGraphicsQueue(const vk::SubmitInfo *submitInfo, vk::Fence fence) const
+bool GPU::isFrameComplete(const uint64_t frame) const
 {
-	graphicsQueue.submit(1, submitInfo, fence);
+	return frame <= m_completedFrame;
+}
+
+uint64_t GPU::submittedFrame() const
+{
+	return m_submittedFrame;
 }
 
 void GPU::submitToPresentationQueue(const vk::PresentInfoKHR &presentInfo) const
@@ -64,12 +140,22 @@ uint32_t GPU::findMemoryType(uint32_t typeFilter, vk::MemoryPropertyFlags proper
 
 void GPU::deleteRenderMode(SimpleRenderMode&& mode) const
 {
-	deletePipeline(mode.pipeline);
+	for (const auto &pipeline : mode.pipelines)
+	{
+		deletePipeline(pipeline);
+	}
 	deleteRenderPass(mode.renderPass);
 	deletePipelineLayout(mode.pipelineLayout);
 
-	deleteCommandBuffer(mode.commandPool, mode.commandBuffers);
-	deleteCommandPool(mode.commandPool);
+	// Destroying the pools frees the command buffers allocated from them.
+	for (const auto &frame : mode.frames)
+	{
+		deleteCommandPool(frame.primaryPool);
+		for (const auto &pool : frame.secondaryPools)
+		{
+			deleteCommandPool(pool);
+		}
+	}
 
 	for(auto& framebuffer : mode.swapchainFramebuffers)
 	{
@@ -115,6 +201,21 @@ void GPU::waitForRender() const
 
 void GPU::cleanUp()
 {
+	deleteUploadQueue();
+	const auto usage = m_memoryAllocator.usage();
+	LoggerAPI::getLogger()->logInfo(fmt::format("GPU memory at shutdown: {} allocations using {} of {} bytes in {} blocks, {:.0f}% fragmented",
+		usage.allocationCount, usage.usedBytes, usage.reservedBytes, usage.blockCount, usage.fragmentation * 100.0F));
+	LoggerAPI::getLogger()->logInfo(fmt::format("Geometry buffers at shutdown: {} meshes using {} of {} bytes",
+		m_geometry.rangeCount(), m_geometry.usedBytes(), m_geometry.vertexCapacity() + m_geometry.indexCapacity()));
+	deleteGeometryBuffers();
+	for (const auto &instanceBuffer : m_instanceBuffers)
+	{
+		m_device.destroyBuffer(instanceBuffer.buffer);
+		m_memoryAllocator.free(instanceBuffer.memory);
+	}
+	m_instanceBuffers.clear();
+	m_memoryAllocator.cleanUp();
+
 	m_device.destroyCommandPool(m_transferCommandPool);
 	for (auto &imageView : m_swapchainImageViews)
 		m_device.destroyImageView(imageView);
@@ -137,15 +238,390 @@ size_t GPU::getSwapchainImagesCount() const
 	return m_swapchainImageViews.size();
 }
 
-void GPU::loadROToMemory(const ModelData & model, RenderableObjectPtr &renderObject) const
+void GPU::loadROToMemory(std::span<const std::byte> verticies, std::span<const std::byte> indicies, RenderableObjectPtr &renderObject) const
 {
-	createSharedBuffer(model.verticies, model.indicies, renderObject->sharedBuffer, renderObject->sharedBufferMemory);
+	renderObject->geometry = loadMesh(verticies, indicies, MeshEncoding::Raw, renderObject->vertexLayout, renderObject->indexType, renderObject->uploadToken);
 }
 
 void GPU::unloadROFromMemory(const RenderableObjectPtr & renderObject) const
 {
-	m_device.destroyBuffer(renderObject->sharedBuffer);
-	m_device.freeMemory(renderObject->sharedBufferMemory);
+	freeGeometry(renderObject->geometry);
+	renderObject->geometry = GeometryRange();
+}
+
+vk::Buffer GPU::getVertexBuffer() const
+{
+	const auto lock = std::lock_guard(m_geometryMutex);
+	return m_vertexBuffer;
+}
+
+vk::Buffer GPU::getIndexBuffer() const
+{
+	const auto lock = std::lock_guard(m_geometryMutex);
+	return m_indexBuffer;
+}
+
+GeometryRange GPU::allocateGeometry(const vk::DeviceSize vertexBytes, const uint32_t vertexStride, const vk::DeviceSize indexBytes, const vk::IndexType indexType) const
+{
+	const auto lock = std::lock_guard(m_geometryMutex);
+	return allocateGeometryLocked(vertexBytes, vertexStride, indexBytes, indexSizeOf(indexType));
+}
+
+void GPU::freeGeometry(const GeometryRange &range) const
+{
+	if (!range.isValid())
+	{
+		return;
+	}
+
+	const auto lock = std::lock_guard(m_geometryMutex);
+	// The range is no longer in the scene, so only frames submitted before now may still draw it.
+	m_retiredGeometry.push_back({ m_uploads.latestToken(), m_submittedFrame, range });
+	releaseRetiredGeometry();
+}
+
+UploadToken GPU::updateVerticies(const GeometryRange &range, const vk::DeviceSize offset, std::span<const std::byte> data) const
+{
+	const auto lock = std::lock_guard(m_geometryMutex);
+	m_uploads.update(m_vertexBuffer, range.vertexByteOffset + offset, data);
+	return m_uploads.latestToken();
+}
+
+UploadToken GPU::updateIndices(const GeometryRange &range, std::span<const std::byte> data) const
+{
+	const auto lock = std::lock_guard(m_geometryMutex);
+	m_uploads.update(m_indexBuffer, range.indexByteOffset, data);
+	return m_uploads.latestToken();
+}
+
+void GPU::submitUploads() const
+{
+	const auto lock = std::lock_guard(m_geometryMutex);
+	const auto semaphore = acquireUploadSemaphore();
+	if (m_uploads.submitAndSignal(semaphore))
+	{
+		m_signaledUploadSemaphores.push_back(semaphore);
+	}
+	else
+	{
+		m_freeUploadSemaphores.push_back(semaphore);
+	}
+	m_uploads.poll();
+	releaseRetiredGeometry();
+}
+
+vk::Semaphore GPU::acquireUploadSemaphore() const
+{
+	// A binary semaphore may be signalled again once the wait of the frame that consumed it has executed.
+	std::erase_if(m_waitedUploadSemaphores, [this](const UploadSemaphore &waited)
+	{
+		if (!isFrameComplete(waited.frame))
+		{
+			return false;
+		}
+		m_freeUploadSemaphores.push_back(waited.semaphore);
+		return true;
+	});
+
+	if (m_freeUploadSemaphores.empty())
+	{
+		return m_device.createSemaphore(vk::SemaphoreCreateInfo());
+	}
+
+	const auto semaphore = m_freeUploadSemaphores.back();
+	m_freeUploadSemaphores.pop_back();
+	return semaphore;
+}
+
+bool GPU::isUploadComplete(UploadToken token) const
+{
+	return token <= m_uploads.signaledToken() && m_uploads.isComplete(token);
+}
+
+std::span<InstanceData> GPU::mapInstanceBuffer(const size_t frameIndex, const size_t count) const
+{
+	if (frameIndex >= m_instanceBuffers.size())
+	{
+		m_instanceBuffers.resize(frameIndex + 1);
+	}
+
+	// Created on first use even without instances, the pipelines always have the instance binding.
+	auto &instanceBuffer = m_instanceBuffers[frameIndex];
+	if (instanceBuffer.capacity == 0 || count > instanceBuffer.capacity)
+	{
+		m_device.destroyBuffer(instanceBuffer.buffer);
+		m_memoryAllocator.free(instanceBuffer.memory);
+
+		instanceBuffer.capacity = std::max({ count, instanceBuffer.capacity * 2, MIN_INSTANCE_CAPACITY });
+		createBuffer(instanceBuffer.capacity * sizeof(InstanceData), vk::BufferUsageFlagBits::eVertexBuffer, stagingBufferMemoryProperties, instanceBuffer.buffer, instanceBuffer.memory);
+		if (!instanceBuffer.memory.isValid())
+		{
+			LoggerAPI::getLogger()->logError(fmt::format("No memory for {} instances", instanceBuffer.capacity));
+			m_device.destroyBuffer(instanceBuffer.buffer);
+			instanceBuffer = {};
+			return {};
+		}
+	}
+
+	return { reinterpret_cast<InstanceData *>(instanceBuffer.memory.mapped), count };
+}
+
+vk::Buffer GPU::getInstanceBuffer(const size_t frameIndex) const
+{
+	return m_instanceBuffers.at(frameIndex).buffer;
+}
+
+MemoryUsage GPU::getMemoryUsage() const
+{
+	return m_memoryAllocator.usage();
+}
+
+bool GPU::createGeometryBuffers()
+{
+	m_geometry = GeometryBuffer(INITIAL_VERTEX_BUFFER_SIZE, INITIAL_INDEX_BUFFER_SIZE);
+	createBuffer(INITIAL_VERTEX_BUFFER_SIZE, geometryBufferUsageFlags, targetBufferMemoryProperties, m_vertexBuffer, m_vertexBufferMemory, true);
+	createBuffer(INITIAL_INDEX_BUFFER_SIZE, geometryBufferUsageFlags, targetBufferMemoryProperties, m_indexBuffer, m_indexBufferMemory, true);
+	return m_vertexBufferMemory.isValid() && m_indexBufferMemory.isValid();
+}
+
+bool GPU::createUploadQueue()
+{
+	createBuffer(STAGING_RING_SIZE, stagingBufferUsageFlags, stagingBufferMemoryProperties, m_stagingRing, m_stagingRingMemory);
+	if (!m_stagingRingMemory.isValid())
+	{
+		return false;
+	}
+
+	m_uploads.init(m_device, transferQueue, static_cast<uint32_t>(queueIndexes->transferFamilyIndex), m_stagingRing, m_stagingRingMemory.mapped, STAGING_RING_SIZE);
+	return true;
+}
+
+void GPU::deleteUploadQueue()
+{
+	m_uploads.cleanUp();
+	releaseRetiredGeometry();
+	for (const auto &semaphore : m_signaledUploadSemaphores)
+	{
+		m_device.destroySemaphore(semaphore);
+	}
+	for (const auto &waited : m_waitedUploadSemaphores)
+	{
+		m_device.destroySemaphore(waited.semaphore);
+	}
+	for (const auto &semaphore : m_freeUploadSemaphores)
+	{
+		m_device.destroySemaphore(semaphore);
+	}
+	m_signaledUploadSemaphores.clear();
+	m_waitedUploadSemaphores.clear();
+	m_freeUploadSemaphores.clear();
+	m_device.destroyBuffer(m_stagingRing);
+	m_memoryAllocator.free(m_stagingRingMemory);
+}
+
+void GPU::releaseRetiredGeometry() const
+{
+	std::erase_if(m_retiredGeometry, [this](const RetiredGeometry &retired)
+	{
+		if (!m_uploads.isComplete(retired.upload) || !isFrameComplete(retired.frame))
+		{
+			return false;
+		}
+		m_geometry.free(retired.range);
+		return true;
+	});
+}
+
+void GPU::deleteGeometryBuffers()
+{
+	m_device.destroyBuffer(m_vertexBuffer);
+	m_device.destroyBuffer(m_indexBuffer);
+	m_memoryAllocator.free(m_vertexBufferMemory);
+	m_memoryAllocator.free(m_indexBufferMemory);
+	m_vertexBuffer = nullptr;
+	m_indexBuffer = nullptr;
+}
+
+GeometryRange GPU::allocateGeometryLocked(const vk::DeviceSize vertexBytes, const uint32_t vertexStride, const vk::DeviceSize indexBytes, const uint32_t indexSize) const
+{
+	const auto range = m_geometry.allocate(vertexBytes, vertexStride, indexBytes, indexSize);
+	if (range.isValid())
+	{
+		return range;
+	}
+
+	// Doubling keeps the number of copies logarithmic in the final size, the padding covers alignment in the new space.
+	const auto vertexCapacity = std::max(m_geometry.vertexCapacity() * 2, m_geometry.vertexCapacity() + vertexBytes + vertexStride);
+	const auto indexCapacity = std::max(m_geometry.indexCapacity() * 2, m_geometry.indexCapacity() + indexBytes + 4);
+
+	vk::Buffer vertexBuffer;
+	vk::Buffer indexBuffer;
+	MemoryAllocation vertexBufferMemory;
+	MemoryAllocation indexBufferMemory;
+	createBuffer(vertexCapacity, geometryBufferUsageFlags, targetBufferMemoryProperties, vertexBuffer, vertexBufferMemory, true);
+	createBuffer(indexCapacity, geometryBufferUsageFlags, targetBufferMemoryProperties, indexBuffer, indexBufferMemory, true);
+	if (!vertexBufferMemory.isValid() || !indexBufferMemory.isValid())
+	{
+		LoggerAPI::getLogger()->logError("Could not grow the geometry buffers");
+		m_device.destroyBuffer(vertexBuffer);
+		m_device.destroyBuffer(indexBuffer);
+		m_memoryAllocator.free(vertexBufferMemory);
+		m_memoryAllocator.free(indexBufferMemory);
+		return {};
+	}
+
+	// Uploads still collected or in flight write to the old buffers. The copies go out as an upload of their own,
+	// so the next frame waits for them like for any other.
+	m_uploads.waitIdle();
+	m_uploads.copy(m_vertexBuffer, 0, vertexBuffer, 0, m_geometry.vertexCapacity());
+	m_uploads.copy(m_indexBuffer, 0, indexBuffer, 0, m_geometry.indexCapacity());
+	m_uploads.waitIdle();
+
+	// Frames in flight may still read the old buffers.
+	waitForRender();
+	m_device.destroyBuffer(m_vertexBuffer);
+	m_device.destroyBuffer(m_indexBuffer);
+	m_memoryAllocator.free(m_vertexBufferMemory);
+	m_memoryAllocator.free(m_indexBufferMemory);
+
+	m_vertexBuffer = vertexBuffer;
+	m_indexBuffer = indexBuffer;
+	m_vertexBufferMemory = vertexBufferMemory;
+	m_indexBufferMemory = indexBufferMemory;
+	m_geometry.grow(vertexCapacity, indexCapacity);
+
+	LoggerAPI::getLogger()->logInfo(fmt::format("Geometry buffers grown to {} vertex and {} index bytes", vertexCapacity, indexCapacity));
+	return m_geometry.allocate(vertexBytes, vertexStride, indexBytes, indexSize);
+}
+
+bool GPU::createTexture(const TextureResource &texture, GPUTexture &gpuTexture) const
+{
+	if (TextureResource::isBlockCompressed(texture.format()) && !physicalDevice.getFeatures().textureCompressionBC)
+	{
+		LoggerAPI::getLogger()->logError("Device can not sample BC textures, skipping " + texture.name.str());
+		return false;
+	}
+
+	const auto data = texture.data();
+	const auto mips = texture.mips();
+	const auto mipCount = static_cast<uint32_t>(mips.size());
+	const auto format = toVkFormat(texture.format());
+
+	vk::Buffer stagingBuffer;
+	MemoryAllocation stagingBufferMemory;
+	createBuffer(data.size(), vk::BufferUsageFlagBits::eTransferSrc, stagingBufferMemoryProperties, stagingBuffer, stagingBufferMemory);
+	if (!stagingBufferMemory.isValid())
+	{
+		LoggerAPI::getLogger()->logError("No staging memory for texture " + texture.name.str());
+		m_device.destroyBuffer(stagingBuffer);
+		return false;
+	}
+
+	memcpy(stagingBufferMemory.mapped, data.data(), data.size());
+
+	// Written on the transfer queue and sampled on the graphics queue.
+	const uint32_t queueFamilies[] = { static_cast<uint32_t>(queueIndexes->transferFamilyIndex), static_cast<uint32_t>(queueIndexes->graphicsFamilyIndex) };
+
+	auto imageCreateInfo = vk::ImageCreateInfo();
+	imageCreateInfo.setImageType(vk::ImageType::e2D);
+	imageCreateInfo.setFormat(format);
+	imageCreateInfo.setExtent(vk::Extent3D(texture.width(), texture.height(), 1));
+	imageCreateInfo.setMipLevels(mipCount);
+	imageCreateInfo.setArrayLayers(1);
+	imageCreateInfo.setSamples(vk::SampleCountFlagBits::e1);
+	imageCreateInfo.setTiling(vk::ImageTiling::eOptimal);
+	imageCreateInfo.setUsage(vk::ImageUsageFlagBits::eTransferDst | vk::ImageUsageFlagBits::eSampled);
+	imageCreateInfo.setInitialLayout(vk::ImageLayout::eUndefined);
+	if (queueFamilies[0] != queueFamilies[1])
+	{
+		imageCreateInfo.setSharingMode(vk::SharingMode::eConcurrent);
+		imageCreateInfo.setQueueFamilyIndexCount(2);
+		imageCreateInfo.setPQueueFamilyIndices(queueFamilies);
+	}
+	else
+	{
+		imageCreateInfo.setSharingMode(vk::SharingMode::eExclusive);
+	}
+
+	gpuTexture.image = m_device.createImage(imageCreateInfo);
+
+	const auto memoryRequirements = m_device.getImageMemoryRequirements(gpuTexture.image);
+	gpuTexture.memory = m_memoryAllocator.allocate(memoryRequirements, vk::MemoryPropertyFlagBits::eDeviceLocal, MemoryKind::Optimal);
+	if (!gpuTexture.memory.isValid())
+	{
+		LoggerAPI::getLogger()->logError("No device memory for texture " + texture.name.str());
+		m_device.destroyImage(gpuTexture.image);
+		m_device.destroyBuffer(stagingBuffer);
+		m_memoryAllocator.free(stagingBufferMemory);
+		gpuTexture = GPUTexture();
+		return false;
+	}
+	m_device.bindImageMemory(gpuTexture.image, gpuTexture.memory.memory, gpuTexture.memory.offset);
+
+	const auto subresourceRange = vk::ImageSubresourceRange(vk::ImageAspectFlagBits::eColor, 0, mipCount, 0, 1);
+
+	auto regions = vector<vk::BufferImageCopy>();
+	regions.reserve(mips.size());
+	for (uint32_t level = 0; level < mipCount; ++level)
+	{
+		auto region = vk::BufferImageCopy();
+		region.setBufferOffset(mips[level].offset);
+		region.setImageSubresource(vk::ImageSubresourceLayers(vk::ImageAspectFlagBits::eColor, level, 0, 1));
+		region.setImageExtent(vk::Extent3D(mips[level].width, mips[level].height, 1));
+		regions.push_back(region);
+	}
+
+	auto toTransferDestination = vk::ImageMemoryBarrier();
+	toTransferDestination.setOldLayout(vk::ImageLayout::eUndefined);
+	toTransferDestination.setNewLayout(vk::ImageLayout::eTransferDstOptimal);
+	toTransferDestination.setSrcQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED);
+	toTransferDestination.setDstQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED);
+	toTransferDestination.setDstAccessMask(vk::AccessFlagBits::eTransferWrite);
+	toTransferDestination.setImage(gpuTexture.image);
+	toTransferDestination.setSubresourceRange(subresourceRange);
+
+	auto toShaderRead = toTransferDestination;
+	toShaderRead.setOldLayout(vk::ImageLayout::eTransferDstOptimal);
+	toShaderRead.setNewLayout(vk::ImageLayout::eShaderReadOnlyOptimal);
+	toShaderRead.setSrcAccessMask(vk::AccessFlagBits::eTransferWrite);
+	toShaderRead.setDstAccessMask(vk::AccessFlags());
+
+	auto transferCommandBuffer = beginTransferCommands();
+	transferCommandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTopOfPipe, vk::PipelineStageFlagBits::eTransfer, vk::DependencyFlags(), nullptr, nullptr, toTransferDestination);
+	transferCommandBuffer.copyBufferToImage(stagingBuffer, gpuTexture.image, vk::ImageLayout::eTransferDstOptimal, regions);
+	// The queue is waited on before the texture is handed out, so nothing later in this submission has to wait.
+	transferCommandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eBottomOfPipe, vk::DependencyFlags(), nullptr, nullptr, toShaderRead);
+	submitTransferCommands(transferCommandBuffer);
+
+	m_device.destroyBuffer(stagingBuffer);
+	m_memoryAllocator.free(stagingBufferMemory);
+
+	auto viewCreateInfo = vk::ImageViewCreateInfo();
+	viewCreateInfo.setImage(gpuTexture.image);
+	viewCreateInfo.setViewType(vk::ImageViewType::e2D);
+	viewCreateInfo.setFormat(format);
+	viewCreateInfo.setSubresourceRange(subresourceRange);
+	gpuTexture.view = m_device.createImageView(viewCreateInfo);
+
+	auto samplerCreateInfo = vk::SamplerCreateInfo();
+	samplerCreateInfo.setMagFilter(vk::Filter::eLinear);
+	samplerCreateInfo.setMinFilter(vk::Filter::eLinear);
+	samplerCreateInfo.setMipmapMode(vk::SamplerMipmapMode::eLinear);
+	samplerCreateInfo.setAddressModeU(vk::SamplerAddressMode::eRepeat);
+	samplerCreateInfo.setAddressModeV(vk::SamplerAddressMode::eRepeat);
+	samplerCreateInfo.setAddressModeW(vk::SamplerAddressMode::eRepeat);
+	samplerCreateInfo.setMaxLod(static_cast<float>(mipCount));
+	gpuTexture.sampler = m_device.createSampler(samplerCreateInfo);
+
+	return true;
+}
+
+void GPU::deleteTexture(const GPUTexture &gpuTexture) const
+{
+	m_device.destroySampler(gpuTexture.sampler);
+	m_device.destroyImageView(gpuTexture.view);
+	m_device.destroyImage(gpuTexture.image);
+	m_memoryAllocator.free(gpuTexture.memory);
 }
 
 void GPU::createRenderPass(vk::RenderPassCreateInfo &createInfo, vk::RenderPass &renderPass) const
@@ -168,9 +644,9 @@ void GPU::deletePipelineLayout(const vk::PipelineLayout & pipelineLayout) const
 	m_device.destroyPipelineLayout(pipelineLayout);
 }
 
-void GPU::createPipeline(const vk::GraphicsPipelineCreateInfo & createInfo, vk::Pipeline &pipeline) const
+bool GPU::createPipeline(const vk::GraphicsPipelineCreateInfo & createInfo, vk::Pipeline &pipeline) const
 {
-	pipeline = m_device.createGraphicsPipeline(nullptr, createInfo, nullptr);
+	return vk::Result::eSuccess == m_device.createGraphicsPipelines(nullptr, 1, &createInfo, nullptr, &pipeline);
 }
 
 void GPU::deletePipeline(const vk::Pipeline & pipeline) const
@@ -210,25 +686,46 @@ void GPU::createGraphicsCommandPool(vk::CommandPool &commandPool) const
 
 }
 
+void GPU::resetCommandPool(const vk::CommandPool &commandPool) const
+{
+	m_device.resetCommandPool(commandPool, vk::CommandPoolResetFlags());
+}
+
 void GPU::deleteCommandPool(const vk::CommandPool & commandPool) const
 {
 	m_device.destroyCommandPool(commandPool);
 }
 
-void GPU::createBuffer(const vk::DeviceSize bufferSize, const vk::BufferUsageFlags bufferUsageFlags, const vk::MemoryPropertyFlags /*memoryPropertyFlags*/, vk::Buffer &buffer, vk::DeviceMemory &deviceMemory) const
+void GPU::createBuffer(const vk::DeviceSize bufferSize, const vk::BufferUsageFlags bufferUsageFlags, const vk::MemoryPropertyFlags memoryPropertyFlags, vk::Buffer &buffer, MemoryAllocation &allocation, const bool sharedWithGraphics) const
 {
 	auto bufferCreateInfo = vk::BufferCreateInfo();
 	bufferCreateInfo.setSize(bufferSize);
 	bufferCreateInfo.setUsage(bufferUsageFlags);
-	bufferCreateInfo.setSharingMode(vk::SharingMode::eExclusive);
+
+	// Concurrent sharing spares the ownership transfers an exclusive buffer would need between the two families.
+	const uint32_t queueFamilies[] = { static_cast<uint32_t>(queueIndexes->transferFamilyIndex), static_cast<uint32_t>(queueIndexes->graphicsFamilyIndex) };
+	if (sharedWithGraphics && queueFamilies[0] != queueFamilies[1])
+	{
+		bufferCreateInfo.setSharingMode(vk::SharingMode::eConcurrent);
+		bufferCreateInfo.setQueueFamilyIndexCount(2);
+		bufferCreateInfo.setPQueueFamilyIndices(queueFamilies);
+	}
+	else
+	{
+		bufferCreateInfo.setSharingMode(vk::SharingMode::eExclusive);
+	}
 
 	buffer = m_device.createBuffer(bufferCreateInfo);
 
-	allocateMemoryForBuffer(buffer, deviceMemory);
-	m_device.bindBufferMemory(buffer, deviceMemory, 0);
+	allocateMemoryForBuffer(buffer, memoryPropertyFlags, allocation);
+	// A failed allocation leaves the buffer unbound for the caller to destroy.
+	if (allocation.isValid())
+	{
+		m_device.bindBufferMemory(buffer, allocation.memory, allocation.offset);
+	}
 }
 
-void GPU::copyBuffer(const vk::Buffer & sourceBuffer, const vk::Buffer & destBuffer, const vk::DeviceSize bufferSize) const
+vk::CommandBuffer GPU::beginTransferCommands() const
 {
 	auto commandBufferAlloccateInfo = vk::CommandBufferAllocateInfo{};
 	commandBufferAlloccateInfo.setCommandBufferCount(1);
@@ -242,64 +739,112 @@ void GPU::copyBuffer(const vk::Buffer & sourceBuffer, const vk::Buffer & destBuf
 	commandBufferBegin.setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit);
 	transferCommandBuffer.begin(&commandBufferBegin);
 
-	auto bufferCopy = vk::BufferCopy{};
-	bufferCopy.setDstOffset(0);
-	bufferCopy.setSrcOffset(0);
-	bufferCopy.setSize(bufferSize);
+	return transferCommandBuffer;
+}
 
-	transferCommandBuffer.copyBuffer(sourceBuffer, destBuffer, 1, &bufferCopy);
-	transferCommandBuffer.end();
+void GPU::submitTransferCommands(vk::CommandBuffer &commandBuffer) const
+{
+	commandBuffer.end();
 
 	auto submitInfo = vk::SubmitInfo{};
 	submitInfo.setCommandBufferCount(1);
-	submitInfo.setPCommandBuffers(&transferCommandBuffer);
+	submitInfo.setPCommandBuffers(&commandBuffer);
 
 	transferQueue.submit(1, &submitInfo, nullptr);
 	transferQueue.waitIdle();
 
-	m_device.freeCommandBuffers(m_transferCommandPool, 1, &transferCommandBuffer);
+	m_device.freeCommandBuffers(m_transferCommandPool, 1, &commandBuffer);
 }
 
-void GPU::allocateMemoryForBuffer(const vk::Buffer & buffer, vk::DeviceMemory & deviceMemory) const
+void GPU::allocateMemoryForBuffer(const vk::Buffer & buffer, const vk::MemoryPropertyFlags memoryPropertyFlags, MemoryAllocation & allocation) const
 {
 	vk::MemoryRequirements memReq;
 	m_device.getBufferMemoryRequirements(buffer, &memReq);
 
-	vk::MemoryAllocateInfo memoryAllocateInfo;
-	memoryAllocateInfo.setAllocationSize(memReq.size);
-	memoryAllocateInfo.setMemoryTypeIndex(findMemoryType(memReq.memoryTypeBits, vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent));
-
-	if (vk::Result::eSuccess != m_device.allocateMemory(&memoryAllocateInfo, nullptr, &deviceMemory))
+	allocation = m_memoryAllocator.allocate(memReq, memoryPropertyFlags, MemoryKind::Linear);
+	if (!allocation.isValid())
 		LoggerAPI::getLogger()->logError("Failed to allocate memory for buffer");
-
-
 }
 
-void GPU::createSharedBuffer(const std::vector<Vertex>& verticies, const std::vector<uint32_t>& indicies, vk::Buffer & buffer, vk::DeviceMemory & deviceMemory) const
+GeometryRange GPU::loadMesh(std::span<const std::byte> verticies, std::span<const std::byte> indicies, MeshEncoding encoding,
+	VertexLayoutKind layout, vk::IndexType indexType, UploadToken &uploadToken) const
 {
-	vk::DeviceSize verticiesSize = sizeof(Vertex) * verticies.size();
-	vk::DeviceSize indiciesSize = sizeof(uint32_t) * indicies.size();
+	const bool compressed = encoding == MeshEncoding::Compressed;
+	vk::DeviceSize verticiesSize = compressed ? MeshCodec::decodedSize(verticies) : verticies.size();
+	vk::DeviceSize indiciesSize = compressed ? MeshCodec::decodedSize(indicies) : indicies.size();
+	if (verticiesSize == 0 || indiciesSize == 0)
+	{
+		LoggerAPI::getLogger()->logError("Could not load an empty or malformed mesh");
+		return {};
+	}
 
 	vk::DeviceSize bufferSize = verticiesSize + indiciesSize;
 
-	vk::Buffer stagingBuffer;
-	vk::DeviceMemory stagingBufferMemory;
-
-	createBuffer(bufferSize, stagingBufferUsageFlags, stagingBufferMemoryProperties, stagingBuffer, stagingBufferMemory);
+	const auto lock = std::lock_guard(m_geometryMutex);
+	const auto geometry = allocateGeometryLocked(verticiesSize, VertexLayout::get(layout).stride, indiciesSize, indexSizeOf(indexType));
+	if (!geometry.isValid())
+	{
+		LoggerAPI::getLogger()->logError("No room for a mesh in the geometry buffers");
+		return geometry;
+	}
 
-	void *data;
-	data = m_device.mapMemory(stagingBufferMemory, 0, verticiesSize, vk::MemoryMapFlags());
-	memcpy(data, verticies.data(), verticiesSize);
-	m_device.unmapMemory(stagingBufferMemory);
+	auto staging = m_uploads.stage(bufferSize, STAGING_ALIGNMENT);
+	vk::Buffer stagingBuffer;
+	MemoryAllocation stagingBufferMemory;
+	if (staging.data == nullptr)
+	{
+		// Larger than the whole ring, so it gets a staging buffer of its own that is copied from right away.
+		createBuffer(bufferSize, stagingBufferUsageFlags, stagingBufferMemoryProperties, stagingBuffer, stagingBufferMemory);
+		if (!stagingBufferMemory.isValid())
+		{
+			m_geometry.free(geometry);
+			m_device.destroyBuffer(stagingBuffer);
+			return {};
+		}
+		staging = { stagingBufferMemory.mapped, 0 };
+	}
 
-	data = m_device.mapMemory(stagingBufferMemory, verticiesSize, indiciesSize, vk::MemoryMapFlags());
-	memcpy(data, indicies.data(), indiciesSize);
-	m_device.unmapMemory(stagingBufferMemory);
+	auto data = staging.data;
+	if (compressed)
+	{
+		// Decoded straight into the staging buffer, the uncompressed mesh never exists anywhere else in CPU memory.
+		const auto vertexCount = verticiesSize / VertexLayout::get(layout).stride;
+		if (!MeshCodec::decodeVerticies(verticies, { data, verticiesSize }) || !MeshCodec::decodeIndices(indicies, { data + verticiesSize, indiciesSize }, vertexCount))
+		{
+			LoggerAPI::getLogger()->logError("Could not decode a compressed mesh");
+			// Nothing was copied into the range yet and nothing draws it, so it is reused right away.
+			// Ring space staged for it is reclaimed with the batch being collected.
+			m_geometry.free(geometry);
+			if (stagingBuffer)
+			{
+				m_device.destroyBuffer(stagingBuffer);
+				m_memoryAllocator.free(stagingBufferMemory);
+			}
+			return {};
+		}
+	}
+	else
+	{
+		memcpy(data, verticies.data(), verticiesSize);
+		memcpy(data + verticiesSize, indicies.data(), indiciesSize);
+	}
 
-	createBuffer(bufferSize, targetBufferUsageFlags, targetBufferMemoryProperties, buffer, deviceMemory);
+	if (!stagingBuffer)
+	{
+		m_uploads.copy(staging.offset, m_vertexBuffer, geometry.vertexByteOffset, verticiesSize);
+		m_uploads.copy(staging.offset + verticiesSize, m_indexBuffer, geometry.indexByteOffset, indiciesSize);
+		uploadToken = m_uploads.latestToken();
+		return geometry;
+	}
 
-	copyBuffer(stagingBuffer, buffer, bufferSize);
+	// Recorded into the batch being collected all the same, so the frames drawing the mesh wait for it.
+	m_uploads.copy(stagingBuffer, 0, m_vertexBuffer, geometry.vertexByteOffset, verticiesSize);
+	m_uploads.copy(stagingBuffer, verticiesSize, m_indexBuffer, geometry.indexByteOffset, indiciesSize);
+	uploadToken = m_uploads.latestToken();
+	m_uploads.waitIdle();
 
 	m_device.destroyBuffer(stagingBuffer);
-	m_device.freeMemory(stagingBufferMemory);
+	m_memoryAllocator.free(stagingBufferMemory);
+
+	return geometry;
 }
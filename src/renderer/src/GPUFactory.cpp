@@ -33,8 +33,14 @@ GPUPtr GPUFactory::createGPU(const vk::Instance & vulkanInstance, const vk::Surf
 
 	createDevice(gpu, enabledValidationLayers);
 	acquireQueueHandles(gpu);
+	gpu->m_memoryAllocator.init(gpu->m_device, gpu->physicalDevice);
 
 	createTransferCommandPool(gpu);
+	if (!gpu->createGeometryBuffers() || !gpu->createUploadQueue())
+	{
+		LoggerAPI::getLogger()->logCritical("Could not allocate the geometry and staging buffers");
+		return nullptr;
+	}
 
 	getSwapChainSupportDetails(gpu, surface);
 	if (gpu->m_swapchainDetails.surfaceFormats.empty() || gpu->m_swapchainDetails.presentModes.empty())
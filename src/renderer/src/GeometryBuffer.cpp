@@ -0,0 +1,78 @@
+#include "GeometryBuffer.h"
+
+#include <algorithm>
+
+namespace {
+// vkCmdUpdateBuffer only writes to multiples of 4 bytes, index ranges start at one so they can be streamed too.
+constexpr uint64_t MIN_INDEX_ALIGNMENT = 4;
+}
+
+GeometryBuffer::GeometryBuffer(uint64_t vertexCapacity, uint64_t indexCapacity) :
+	m_verticies{ vertexCapacity },
+	m_indices{ indexCapacity }
+{
+}
+
+GeometryRange GeometryBuffer::allocate(uint64_t vertexBytes, uint32_t vertexStride, uint64_t indexBytes, uint32_t indexSize)
+{
+	// Strides are not powers of two, so the range gets room to start at the next multiple of the stride.
+	const auto vertex = m_verticies.allocate(vertexBytes + vertexStride - 1, 1);
+	if (vertex.node == TlsfAllocator::INVALID_NODE)
+	{
+		return {};
+	}
+
+	const auto index = m_indices.allocate(indexBytes, std::max<uint64_t>(indexSize, MIN_INDEX_ALIGNMENT));
+	if (index.node == TlsfAllocator::INVALID_NODE)
+	{
+		m_verticies.free(vertex.node);
+		return {};
+	}
+
+	auto range = GeometryRange();
+	range.vertexOffset = static_cast<int32_t>((vertex.offset + vertexStride - 1) / vertexStride);
+	range.firstIndex = static_cast<uint32_t>(index.offset / indexSize);
+	range.vertexByteOffset = uint64_t{ static_cast<uint32_t>(range.vertexOffset) } * vertexStride;
+	range.indexByteOffset = index.offset;
+	range.vertexNode = vertex.node;
+	range.indexNode = index.node;
+
+	return range;
+}
+
+void GeometryBuffer::free(const GeometryRange &range)
+{
+	if (!range.isValid())
+	{
+		return;
+	}
+
+	m_verticies.free(range.vertexNode);
+	m_indices.free(range.indexNode);
+}
+
+void GeometryBuffer::grow(uint64_t vertexCapacity, uint64_t indexCapacity)
+{
+	m_verticies.grow(vertexCapacity);
+	m_indices.grow(indexCapacity);
+}
+
+uint64_t GeometryBuffer::vertexCapacity() const
+{
+	return m_verticies.size();
+}
+
+uint64_t GeometryBuffer::indexCapacity() const
+{
+	return m_indices.size();
+}
+
+uint64_t GeometryBuffer::usedBytes() const
+{
+	return m_verticies.usedBytes() + m_indices.usedBytes();
+}
+
+uint32_t GeometryBuffer::rangeCount() const
+{
+	return m_indices.allocationCount();
+}
@@ -0,0 +1,50 @@
+#include "MeshCache.h"
+#include "LoggerAPI.h"
+
+MeshCache::MeshCache(UploadFunction upload, FreeFunction free) :
+	m_upload{ std::move(upload) },
+	m_free{ std::move(free) }
+{
+}
+
+const GpuMesh *MeshCache::acquire(ModelHandle handle, const ModelData &model)
+{
+	const auto key = keyOf(handle);
+	auto it = m_meshes.find(key);
+	if (it == m_meshes.end())
+	{
+		auto mesh = GpuMesh();
+		const auto indexType = model.indexType == IndexType::Uint16 ? vk::IndexType::eUint16 : vk::IndexType::eUint32;
+		mesh.geometry = m_upload(model, indexType, mesh.uploadToken);
+		if (!mesh.geometry.isValid())
+		{
+			LoggerAPI::getLogger()->logError("Could not upload a mesh");
+			return nullptr;
+		}
+		it = m_meshes.emplace(key, mesh).first;
+	}
+	++it->second.references;
+
+	return &it->second;
+}
+
+void MeshCache::release(ModelHandle handle)
+{
+	const auto it = m_meshes.find(keyOf(handle));
+	if (it == m_meshes.end())
+	{
+		LoggerAPI::getLogger()->logWarning("Released a mesh that was never acquired");
+		return;
+	}
+
+	if (--it->second.references == 0)
+	{
+		m_free(it->second.geometry);
+		m_meshes.erase(it);
+	}
+}
+
+uint64_t MeshCache::keyOf(ModelHandle handle)
+{
+	return (uint64_t{ handle.index } << 32) | handle.generation;
+}
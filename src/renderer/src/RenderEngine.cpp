@@ -1,9 +1,17 @@
 #include "RenderEngine.h"
 #include "GPUFactory.h"
 #include "LoggerAPI.h"
+#include "SceneSnapshot.h"
 #include "SimpleRenderModeFactory.h"
+#include "StaticBatcher.h"
+#include "ThreadPool.h"
 #include "SDL2/SDL_vulkan.h"
 #include <fmt/core.h>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <iterator>
 
 #pragma warning(disable : 4201)
 #define GLM_ENABLE_EXPERIMENTAL
@@ -20,6 +28,11 @@ namespace {
 constexpr int XResolution = 1280;
 constexpr int YResolution = 720;
 
+// Largest on screen deviation in pixels a LOD may have, and the band around it in which the current LOD is kept.
+constexpr float LOD_PIXEL_ERROR = 1.0F;
+constexpr float LOD_HYSTERESIS = 0.25F;
+constexpr float MIN_LOD_DISTANCE = 0.001F;
+
 vk::ApplicationInfo getApplicationInfo()
 {
   // vk::ApplicationInfo allows the programmer to specifiy some basic information about the
@@ -37,6 +50,8 @@ RenderEngineAPIPtr RenderEngineAPI::createInstance()
 }
 
 RenderEngine::RenderEngine() : m_isExiting(false),
+                               m_pipelineDirty(false),
+                               m_nextObjectId(1),
                                m_renderer(std::make_shared<Renderer>()),
                                m_scene{ std::make_shared<Scene>() },
                                m_window(nullptr),
@@ -63,11 +78,29 @@ int RenderEngine::init(const ResourceManagerAPIPtr &resourceManager)
     return 3;
 
   m_gpu = GPUFactory::createGPU(m_vulcanInstance, m_surface, getValidationLayers());
+  if (!m_gpu)
+    return 4;
+
+  m_meshes = std::make_unique<MeshCache>(
+    [gpu = m_gpu](const ModelData &model, vk::IndexType indexType, UploadToken &uploadToken) {
+      return gpu->loadMesh(model.verticies, model.indicies, model.encoding, model.layout, indexType, uploadToken);
+    },
+    [gpu = m_gpu](const GeometryRange &geometry) { gpu->freeGeometry(geometry); });
   m_renderModeFactory = std::make_unique<SimpleRenderModeFactory>(m_gpu, m_scene);
 
+  m_pipelineShaders = {
+    { m_resourceManager->findShader("vert"), vk::ShaderStageFlagBits::eVertex },
+    { m_resourceManager->findShader("frag"), vk::ShaderStageFlagBits::eFragment }
+  };
+
   auto shaders = createShaderStages();
+  if (shaders.empty())
+    return 4;
+
   auto swapchainFormat = m_gpu->getSwapchanFormat();
   auto viewportExtent = m_gpu->getPresentationExtent();
+  m_camera.viewportHeight = static_cast<float>(viewportExtent.height);
+  m_camera.aspectRatio = static_cast<float>(viewportExtent.width) / static_cast<float>(viewportExtent.height);
 
   auto result = m_renderer->init(m_gpu, resourceManager, m_renderModeFactory->createRenderMode(swapchainFormat, viewportExtent, shaders));
 
@@ -79,7 +112,20 @@ int RenderEngine::init(const ResourceManagerAPIPtr &resourceManager)
 
 void RenderEngine::drawScene()
 {
-  m_renderer->draw();
+  reloadChangedShaders();
+  rebuildPipelineIfDirty();
+
+  bakeStaticBatches();
+  selectLods();
+  if (m_terrain) {
+    m_terrain->update(m_camera);
+  }
+  m_scene->viewProjection = m_camera.viewProjection();
+  cullObjects();
+  // Everything uploaded this frame goes out in one submission, objects are recorded once their uploads are done.
+  m_gpu->submitUploads();
+
+  m_renderer->draw(*m_renderModeFactory);
 }
 
 void RenderEngine::waitForRendererToFinish()
@@ -89,15 +135,45 @@ void RenderEngine::waitForRendererToFinish()
 
 void RenderEngine::cleanUp()
 {
+  if (m_terrain) {
+    m_terrain->cleanUp();
+    m_terrain.reset();
+  }
   for (auto &object : m_scene->renderableObjects) {
-    m_gpu->unloadROFromMemory(object);
+    m_meshes->release(object->model);
+  }
+  for (auto &batches : m_scene->staticBatches) {
+    for (auto &batch : batches) {
+      m_gpu->unloadROFromMemory(batch);
+    }
+    batches.clear();
   }
+  for (auto &pending : m_pendingStaticBatches) {
+    if (pending) {
+      for (auto &batch : pending->batches) {
+        m_gpu->unloadROFromMemory(batch);
+      }
+      pending.reset();
+    }
+  }
+
+  if (m_pipelineRebuild.valid()) {
+    for (const auto &pipeline : m_pipelineRebuild.get()) {
+      m_gpu->deletePipeline(pipeline);
+    }
+  }
+  destroyRetiredShaderModules();
 
   for (auto shaderModule : m_loadedShaders) {
     m_gpu->deleteShaderModule(*shaderModule.second);
   }
   m_loadedShaders.clear();
 
+  for (const auto &texture : m_textures) {
+    m_gpu->deleteTexture(texture.second);
+  }
+  m_textures.clear();
+
   m_resourceManager->cleanUp();
   m_gpu->cleanUp();
   m_vulcanInstance.destroySurfaceKHR(m_surface);
@@ -126,38 +202,174 @@ bool RenderEngine::pollForWindowClose()
   return false;
 }
 
+void RenderEngine::setCamera(const Camera &camera)
+{
+  // The viewport is the swapchain's, whatever the caller assumed.
+  const auto viewportHeight = m_camera.viewportHeight;
+  const auto aspectRatio = m_camera.aspectRatio;
+
+  m_camera = camera;
+  m_camera.viewportHeight = viewportHeight;
+  m_camera.aspectRatio = aspectRatio;
+}
+
 RenderableObjectAPIPtr RenderEngine::createObject(std::string name, const std::string &modelName)
 {
-  LoggerAPI::getLogger()->logInfo(fmt::format("Creating object {} with model {}", name, modelName));
-  auto model = m_resourceManager->getModel(std::move(modelName));
-  auto object = std::make_shared<RenderableObject>(name);
+  return createObject(std::move(name), modelName, glm::vec3{});
+}
+
+RenderableObjectAPIPtr RenderEngine::createObject(std::string name, const std::string &modelName, glm::vec3 position)
+{
+  LoggerAPI::getLogger()->logInfo(fmt::format("Creating object {} with model {} at {}", name, modelName, glm::to_string(position)));
+  return createObject(std::move(name), m_resourceManager->findModel(modelName), position);
+}
 
-  object->indexCount = static_cast<uint32_t>(model.indicies.size());
-  object->vertexOffset = model.verticies.size() * sizeof(Vertex);
+RenderableObjectAPIPtr RenderEngine::createObject(std::string name, ModelHandle modelHandle)
+{
+  return createObject(std::move(name), modelHandle, glm::vec3{});
+}
+
+RenderableObjectAPIPtr RenderEngine::createObject(std::string name, ModelHandle modelHandle, glm::vec3 position)
+{
+  auto model = m_resourceManager->getModel(modelHandle);
+  if (model.empty()) {
+    return nullptr;
+  }
 
-  m_gpu->loadROToMemory(model, object);
+  auto object = makeObject(std::move(name), modelHandle, model, position);
+  if (!object) {
+    return nullptr;
+  }
 
   m_scene->renderableObjects.emplace_back(object);
 
   return object;
 }
 
-RenderableObjectAPIPtr RenderEngine::createObject(std::string name, const std::string &modelName, glm::vec3 position)
+bool RenderEngine::loadScene(const std::string &path)
 {
-  LoggerAPI::getLogger()->logInfo(fmt::format("Creating object {} with model {} at ", name, modelName, glm::to_string(position)));
-  auto model = m_resourceManager->getModel(modelName);
-  auto object = std::make_shared<RenderableObject>(std::move(name), std::move(position));
+  auto snapshot = SceneSnapshot();
+  if (!snapshot.open(path)) {
+    return false;
+  }
 
-  object->indexCount = static_cast<uint32_t>(model.indicies.size());
-  object->vertexOffset = model.verticies.size() * sizeof(Vertex);
+  const auto objectModels = snapshot.objectModels();
+  const auto objectFlags = snapshot.objectFlags();
+  const auto positions = snapshot.positions();
 
-  m_gpu->loadROToMemory(model, object);
+  // Objects are grouped by model so every model is looked up and fetched once, not once per object.
+  auto objectsByModel = std::vector<std::vector<uint32_t>>(snapshot.models().size());
+  for (uint32_t object = 0; object < snapshot.objectCount(); ++object) {
+    objectsByModel[objectModels[object]].push_back(object);
+  }
 
-  m_scene->renderableObjects.emplace_back(object);
+  auto objects = std::vector<RenderableObjectPtr>(snapshot.objectCount());
+  for (size_t modelIndex = 0; modelIndex < objectsByModel.size(); ++modelIndex) {
+    const auto modelName = SceneSnapshot::modelName(snapshot.models()[modelIndex]);
+    const auto handle = m_resourceManager->findModel(modelName);
+    if (!handle.isValid() || m_resourceManager->getModelStatus(handle).get() != LoadStatus::Loaded) {
+      LoggerAPI::getLogger()->logWarning(fmt::format("Model {} is not available, skipping {} objects of {}", modelName, objectsByModel[modelIndex].size(), path));
+      continue;
+    }
+
+    const auto model = m_resourceManager->getModel(handle);
+    if (model.empty()) {
+      continue;
+    }
+
+    for (const auto object : objectsByModel[modelIndex]) {
+      const auto &position = positions[object];
+      objects[object] = makeObject(std::string(snapshot.objectName(object)), handle, model, { position.x, position.y, position.z });
+      if (!objects[object]) {
+        LoggerAPI::getLogger()->logWarning(fmt::format("Model {} could not be uploaded, skipping {} objects of {}", modelName, objectsByModel[modelIndex].size(), path));
+        break;
+      }
+      objects[object]->setStatic((objectFlags[object] & scenefile::OBJECT_STATIC) != 0);
+    }
+  }
+
+  auto &sceneObjects = m_scene->renderableObjects;
+  sceneObjects.reserve(sceneObjects.size() + objects.size());
+  std::copy_if(objects.begin(), objects.end(), std::back_inserter(sceneObjects), [](const RenderableObjectPtr &object) {
+    return object != nullptr;
+  });
+
+  LoggerAPI::getLogger()->logInfo(fmt::format("Loaded scene {} with {} objects", path, snapshot.objectCount()));
+  return true;
+}
+
+bool RenderEngine::saveScene(const std::string &path) const
+{
+  auto writer = SceneSnapshotWriter();
+  for (const auto &object : m_scene->renderableObjects) {
+    writer.addObject(object->name(), m_resourceManager->getModelName(object->model), object->m_position, object->isStatic());
+  }
+
+  return writer.write(path);
+}
+
+RenderableObjectPtr RenderEngine::makeObject(std::string name, ModelHandle modelHandle, const ModelData &model, glm::vec3 position)
+{
+  // Objects of the same model share its mesh and are drawn instanced.
+  const auto *mesh = m_meshes->acquire(modelHandle, model);
+  if (mesh == nullptr) {
+    return nullptr;
+  }
+
+  auto object = std::make_shared<RenderableObject>(std::move(name), std::move(position));
+
+  object->model = modelHandle;
+  object->lods.assign(model.lods.begin(), model.lods.end());
+  object->selectLod(0);
+  object->indexType = model.indexType == IndexType::Uint16 ? vk::IndexType::eUint16 : vk::IndexType::eUint32;
+  object->vertexLayout = model.layout;
+  object->quantization = model.quantization;
+  object->localBounds = model.bounds;
+  object->meshlets.assign(model.meshlets.begin(), model.meshlets.end());
+
+  object->geometry = mesh->geometry;
+  object->uploadToken = mesh->uploadToken;
+  object->objectId = m_nextObjectId++;
 
   return object;
 }
 
+bool RenderEngine::uploadTexture(const std::string &textureName)
+{
+  if (m_textures.contains(textureName)) {
+    return true;
+  }
+
+  const auto handle = m_resourceManager->findTexture(textureName);
+  if (!handle.isValid() || m_resourceManager->getTextureStatus(handle).get() != LoadStatus::Loaded) {
+    LoggerAPI::getLogger()->logError(fmt::format("Texture {} is not loaded", textureName));
+    return false;
+  }
+
+  const auto *resource = m_resourceManager->getTexture(handle);
+  auto texture = GPUTexture();
+  if (resource == nullptr || !m_gpu->createTexture(*resource, texture)) {
+    return false;
+  }
+
+  m_textures.emplace(textureName, texture);
+  return true;
+}
+
+bool RenderEngine::createTerrain(Heightmap heightmap, const TerrainSettings &settings)
+{
+  if (!Terrain::validate(heightmap, settings)) {
+    return false;
+  }
+
+  if (m_terrain) {
+    m_terrain->cleanUp();
+  }
+  m_terrain = Terrain::create(m_gpu, m_scene, std::move(heightmap), settings);
+
+  return m_terrain != nullptr;
+}
+
 bool RenderEngine::initSDL()
 {
   // Create an SDL window that supports Vulkan rendering.
@@ -275,27 +487,264 @@ vector<vk::PipelineShaderStageCreateInfo> RenderEngine::createShaderStages()
 {
   auto result = vector<vk::PipelineShaderStageCreateInfo>();
 
-  const std::vector<char> &vertShaderCode = m_resourceManager->getShader("vert").shader;
-  auto vertShaderModule = createShaderModule(vertShaderCode, "vert");
-  auto vertShaderInfo = vk::PipelineShaderStageCreateInfo();
-  vertShaderInfo.setModule(*vertShaderModule);
-  vertShaderInfo.setPName("main");
-  vertShaderInfo.setStage(vk::ShaderStageFlagBits::eVertex);
+  for (const auto &pipelineShader : m_pipelineShaders) {
+    const auto shader = m_resourceManager->getShader(pipelineShader.handle);
+    if (shader == nullptr) {
+      // A pipeline missing a stage cannot be built, so report no stages at all.
+      return {};
+    }
+    const auto shaderName = shader->name.str();
 
-  const std::vector<char> &fragShaderCode = m_resourceManager->getShader("frag").shader;
-  auto fragShaderModule = createShaderModule(fragShaderCode, "frag");
-  auto fragShaderInfo = vk::PipelineShaderStageCreateInfo();
-  fragShaderInfo.setModule(*fragShaderModule);
-  fragShaderInfo.setPName("main");
-  fragShaderInfo.setStage(vk::ShaderStageFlagBits::eFragment);
+    // Modules are created once and then only replaced by reloadChangedShaders().
+    auto loaded = m_loadedShaders.find(shaderName);
+    auto shaderModule = loaded != m_loadedShaders.end() ? loaded->second : createShaderModule(shader->code(), shaderName);
 
-  result.push_back(vertShaderInfo);
-  result.push_back(fragShaderInfo);
+    auto shaderInfo = vk::PipelineShaderStageCreateInfo();
+    shaderInfo.setModule(*shaderModule);
+    shaderInfo.setPName("main");
+    shaderInfo.setStage(pipelineShader.stage);
+
+    result.push_back(shaderInfo);
+  }
 
   return result;
 }
 
-vk::ShaderModule *RenderEngine::createShaderModule(const std::vector<char> &code, const std::string &shaderName)
+void RenderEngine::reloadChangedShaders()
+{
+  for (const auto changed : m_resourceManager->pollShaderChanges()) {
+    auto isUsed = std::any_of(m_pipelineShaders.begin(), m_pipelineShaders.end(), [changed](const PipelineShader &pipelineShader) {
+      return pipelineShader.handle == changed;
+    });
+    if (!isUsed) {
+      continue;
+    }
+
+    const auto shader = m_resourceManager->getShader(changed);
+    if (shader == nullptr) {
+      continue;
+    }
+    const auto shaderName = shader->name.str();
+    LoggerAPI::getLogger()->logInfo(fmt::format("Reloading shader {}", shaderName));
+
+    // The running pipeline (or a rebuild in flight) may still reference the old module.
+    auto loaded = m_loadedShaders.find(shaderName);
+    if (loaded != m_loadedShaders.end()) {
+      m_retiredShaderModules.push_back(loaded->second);
+    }
+    createShaderModule(shader->code(), shaderName);
+
+    m_pipelineDirty = true;
+  }
+}
+
+void RenderEngine::rebuildPipelineIfDirty()
+{
+  if (m_pipelineRebuild.valid()) {
+    if (m_pipelineRebuild.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+      return;
+    }
+    // Swapping at the frame boundary keeps the previous pipeline drawing until the new one is compiled.
+    const auto pipelines = m_pipelineRebuild.get();
+    if (pipelines) {
+      m_renderer->swapPipelines(*pipelines);
+    } else {
+      LoggerAPI::getLogger()->logError("Could not rebuild the pipelines, keeping the current ones");
+    }
+  }
+
+  if (!m_pipelineDirty) {
+    return;
+  }
+  m_pipelineDirty = false;
+  destroyRetiredShaderModules();
+
+  auto factory = m_renderModeFactory;
+  auto mode = m_renderer->getRenderMode();
+  auto extent = m_gpu->getPresentationExtent();
+  auto shaders = createShaderStages();
+  if (shaders.empty()) {
+    LoggerAPI::getLogger()->logError("A pipeline shader is not available, keeping the current pipelines");
+    return;
+  }
+
+  m_pipelineRebuild = ThreadPool::shared().submit([factory, mode, extent, shaders = std::move(shaders)]() {
+    return factory->rebuildPipelines(mode, extent, shaders);
+  });
+}
+
+void RenderEngine::selectLods()
+{
+  // Pixels covered by one unit of model space one unit away from the camera.
+  const auto pixelsPerUnit = m_camera.viewportHeight / (2.0F * std::tan(m_camera.verticalFov * 0.5F));
+
+  for (auto &object : m_scene->renderableObjects) {
+    if (object->lods.size() < 2 || object->isDrawnByStaticBatch()) {
+      continue;
+    }
+
+    const auto distance = std::max(glm::distance(object->m_position, m_camera.position), MIN_LOD_DISTANCE);
+    const auto projectedError = [&](size_t lod) {
+      return object->lods[lod].error * pixelsPerUnit / distance;
+    };
+
+    auto lod = size_t{ object->currentLod };
+    while (lod > 0 && projectedError(lod) > LOD_PIXEL_ERROR * (1.0F + LOD_HYSTERESIS)) {
+      --lod;
+    }
+    while (lod + 1 < object->lods.size() && projectedError(lod + 1) < LOD_PIXEL_ERROR * (1.0F - LOD_HYSTERESIS)) {
+      ++lod;
+    }
+
+    if (lod != object->currentLod) {
+      object->selectLod(static_cast<uint32_t>(lod));
+    }
+  }
+}
+
+void RenderEngine::bakeStaticBatches()
+{
+  auto dirty = std::array<bool, VERTEX_LAYOUT_COUNT>();
+  for (auto &object : m_scene->renderableObjects) {
+    if (object->staticBatchDirty) {
+      dirty[static_cast<size_t>(object->vertexLayout)] = true;
+      object->staticBatchDirty = false;
+    }
+  }
+
+  for (uint32_t layout = 0; layout < VERTEX_LAYOUT_COUNT; ++layout) {
+    if (dirty[layout]) {
+      rebuildStaticBatches(static_cast<VertexLayoutKind>(layout));
+    }
+  }
+  swapUploadedStaticBatches();
+}
+
+void RenderEngine::rebuildStaticBatches(VertexLayoutKind layout)
+{
+  auto members = std::vector<RenderableObjectPtr>();
+  std::copy_if(m_scene->renderableObjects.begin(), m_scene->renderableObjects.end(), std::back_inserter(members), [layout](const RenderableObjectPtr &object) {
+    return object->isStatic() && object->vertexLayout == layout;
+  });
+
+  // The scene keeps drawing the current batches until these are uploaded. A rebuild that never got that far is dropped.
+  auto &pending = m_pendingStaticBatches[static_cast<size_t>(layout)];
+  if (pending) {
+    for (auto &batch : pending->batches) {
+      m_gpu->unloadROFromMemory(batch);
+    }
+  }
+  auto &[batches, batchedMembers] = pending.emplace();
+
+  for (auto &data : StaticBatcher::build(layout, members, *m_resourceManager)) {
+    batchedMembers.insert(batchedMembers.end(), data.members.begin(), data.members.end());
+    auto batch = std::make_shared<RenderableObject>(fmt::format("StaticBatch{}", batches.size()));
+    batch->lods = { MeshLod{ 0, data.indexCount, 0.0F } };
+    batch->selectLod(0);
+    batch->indexType = data.indexType == IndexType::Uint16 ? vk::IndexType::eUint16 : vk::IndexType::eUint32;
+    batch->vertexLayout = layout;
+    batch->quantization = data.quantization;
+    batch->localBounds = data.bounds;
+
+    m_gpu->loadROToMemory(data.verticies, data.indicies, batch);
+    batches.push_back(std::move(batch));
+  }
+}
+
+void RenderEngine::swapUploadedStaticBatches()
+{
+  const auto isUploaded = [this](const RenderableObjectPtr &batch) {
+    return m_gpu->isUploadComplete(batch->uploadToken);
+  };
+
+  for (size_t layout = 0; layout < VERTEX_LAYOUT_COUNT; ++layout) {
+    auto &pending = m_pendingStaticBatches[layout];
+    if (!pending || !std::all_of(pending->batches.begin(), pending->batches.end(), isUploaded)) {
+      continue;
+    }
+
+    // Frames in flight may still draw the old batches, their geometry is reused once those are done.
+    auto &batches = m_scene->staticBatches[layout];
+    for (auto &batch : batches) {
+      m_gpu->unloadROFromMemory(batch);
+    }
+    batches = std::move(pending->batches);
+
+    // Objects made static since the last swap were drawn on their own so far, from now on the batches draw them.
+    for (auto &object : m_scene->renderableObjects) {
+      if (static_cast<size_t>(object->vertexLayout) == layout) {
+        object->inStaticBatch = false;
+      }
+    }
+    for (auto &member : pending->members) {
+      member->inStaticBatch = true;
+    }
+    pending.reset();
+  }
+}
+
+void RenderEngine::cullObjects()
+{
+  const auto frustum = Frustum(m_scene->viewProjection);
+
+  for (auto &object : m_scene->renderableObjects) {
+    if (!object->isDrawnByStaticBatch()) {
+      cullObject(frustum, *object);
+    }
+  }
+  for (const auto &batches : m_scene->staticBatches) {
+    for (const auto &batch : batches) {
+      cullObject(frustum, *batch);
+    }
+  }
+  for (const auto &chunk : m_scene->terrainChunks) {
+    cullObject(frustum, *chunk);
+  }
+}
+
+void RenderEngine::cullObject(const Frustum &frustum, RenderableObject &object) const
+{
+  auto ranges = std::vector<DrawRange>();
+
+  const auto bounds = object.worldBounds();
+  if (!frustum.intersectsSphere(bounds.sphere.center, bounds.sphere.radius)) {
+    // Nothing of it is visible, leave ranges empty.
+  }
+  else if (object.currentLod != 0 || object.meshlets.empty()) {
+    // Meshlets are only built for the full mesh.
+    ranges.push_back({ object.firstIndex, object.indexCount });
+  }
+  else {
+    // Meshlet cones are in model space, objects are only translated.
+    const auto eye = m_camera.position - object.m_position;
+    for (const auto &meshlet : object.meshlets) {
+      if (meshlet.isBackFacing(eye) || !frustum.intersectsSphere(meshlet.center + object.m_position, meshlet.radius)) {
+        continue;
+      }
+
+      // Meshlets are consecutive in the index buffer, so neighbouring survivors share one draw.
+      if (!ranges.empty() && ranges.back().firstIndex + ranges.back().indexCount == meshlet.firstIndex) {
+        ranges.back().indexCount += meshlet.indexCount;
+      }
+      else {
+        ranges.push_back({ meshlet.firstIndex, meshlet.indexCount });
+      }
+    }
+  }
+
+  object.drawRanges.swap(ranges);
+}
+
+void RenderEngine::destroyRetiredShaderModules()
+{
+  for (auto shaderModule : m_retiredShaderModules) {
+    m_gpu->deleteShaderModule(*shaderModule);
+    delete shaderModule;
+  }
+  m_retiredShaderModules.clear();
+}
+
+vk::ShaderModule *RenderEngine::createShaderModule(std::span<const char> code, const std::string &shaderName)
 {
   auto shaderCreateInfo = vk::ShaderModuleCreateInfo{};
   shaderCreateInfo.setCodeSize(code.size());
@@ -1,11 +1,19 @@
 #include "RenderableObject.h"
 
 RenderableObject::RenderableObject(std::string name, glm::vec3 position) :
+	uploadToken{0},
+	firstIndex{0},
 	indexCount{0},
-	vertexOffset{0},
+	indexType{vk::IndexType::eUint32},
+	vertexLayout{VertexLayoutKind::Float},
+	currentLod{0},
+	staticBatchDirty{false},
+	inStaticBatch{false},
+	objectId{0},
 	m_position{std::move(position)},
 	m_name{std::move(name)},
-	m_active{true}
+	m_active{true},
+	m_static{false}
 {
 
 }
@@ -13,8 +21,43 @@ RenderableObject::RenderableObject(std::string name, glm::vec3 position) :
 void RenderableObject::updatePosition(glm::vec3 newPosition)
 {
 	m_position = newPosition;
+	staticBatchDirty |= m_static;
 }
 
+void RenderableObject::setStatic(bool isStatic)
+{
+	staticBatchDirty |= m_static != isStatic;
+	m_static = isStatic;
+}
+
+bool RenderableObject::isStatic() const
+{
+	return m_static;
+}
+
+bool RenderableObject::isDrawnByStaticBatch() const
+{
+	return m_static && inStaticBatch;
+}
+
+const std::string &RenderableObject::name() const
+{
+	return m_name;
+}
+
+
+void RenderableObject::selectLod(uint32_t lod)
+{
+	currentLod = lod;
+	firstIndex = lods[lod].firstIndex;
+	indexCount = lods[lod].indexCount;
+	drawRanges.assign(1, { firstIndex, indexCount });
+}
+
+Bounds RenderableObject::worldBounds() const
+{
+	return localBounds.translated(m_position);
+}
 
 bool RenderableObject::isActive()
 { 
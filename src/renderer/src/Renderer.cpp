@@ -6,10 +6,6 @@ using std::make_unique;
 using std::vector;
 using std::array;
 
-namespace{
-constexpr int NUMBER_OF_FRAMES_IN_FLIGHT = 3;
-}
-
 Renderer::Renderer() :
 	m_currentFrameIndex(0),
 	m_renderMode{},
@@ -31,7 +27,7 @@ Renderer::~Renderer()
 {
 	m_gpu->deleteRenderMode(std::move(m_renderMode));
 
-	for (auto i = 0; i < NUMBER_OF_FRAMES_IN_FLIGHT; i++)
+	for (size_t i = 0; i < NUMBER_OF_FRAMES_IN_FLIGHT; i++)
 	{
 		m_gpu->deleteSemaphore(m_renderFinishedSemaphores[i]);
 		m_gpu->deleteSemaphore(m_imageAvailableSemaphores[i]);
@@ -39,13 +35,16 @@ Renderer::~Renderer()
 	}
 }
 
-void Renderer::draw()
+void Renderer::draw(AbstractRenderModeFactory &factory)
 {
 	m_gpu->waitForFence(&m_frameFences[m_currentFrameIndex]);
 	m_gpu->resetFence(&m_frameFences[m_currentFrameIndex]);
+	m_gpu->completeFrame(m_submittedFrames[m_currentFrameIndex]);
+
+	const auto imageIndex = m_gpu->acquireNextImage(m_imageAvailableSemaphores[m_currentFrameIndex]);
 
-	uint32_t imageIndex{ 0 };
-	m_gpu->acquireNextImage(m_imageAvailableSemaphores[m_currentFrameIndex]);
+	// The fence has signalled, so the frame's command buffers and instance data are free to be recorded again.
+	factory.recordFrame(m_renderMode, m_currentFrameIndex, imageIndex);
 
 	vk::Semaphore waitSemaphores[] = { m_imageAvailableSemaphores[m_currentFrameIndex] };
 	vk::PipelineStageFlags waitStages[] = { vk::PipelineStageFlags(vk::PipelineStageFlagBits::eColorAttachmentOutput) };
@@ -56,11 +55,11 @@ void Renderer::draw()
 		waitSemaphores,
 		waitStages,
 		1, 
-		&m_renderMode.commandBuffers[m_currentFrameIndex],
+		&m_renderMode.frames[m_currentFrameIndex].primary,
 		1, signalSemaphores
 	};
 
-	m_gpu->submitToGraphicsQueue(&submitInfo, m_frameFences[m_currentFrameIndex]);
+	m_submittedFrames[m_currentFrameIndex] = m_gpu->submitFrame(&submitInfo, m_frameFences[m_currentFrameIndex]);
 
 	auto presentInfo = vk::PresentInfoKHR();
 	presentInfo.setWaitSemaphoreCount(1);
@@ -75,18 +74,36 @@ void Renderer::draw()
 
 }
 
+const SimpleRenderMode &Renderer::getRenderMode() const
+{
+	return m_renderMode;
+}
+
+void Renderer::swapPipelines(const PipelineSet &pipelines)
+{
+	// Frames in flight may still be using the old pipelines, the next frame is recorded with the new ones.
+	m_gpu->waitForRender();
+
+	for (const auto &pipeline : m_renderMode.pipelines)
+	{
+		m_gpu->deletePipeline(pipeline);
+	}
+	m_renderMode.pipelines = pipelines;
+}
+
 bool Renderer::createSyncObjects()
 {
 	m_imageAvailableSemaphores.resize(NUMBER_OF_FRAMES_IN_FLIGHT);
 	m_renderFinishedSemaphores.resize(NUMBER_OF_FRAMES_IN_FLIGHT);
 	m_frameFences.resize(NUMBER_OF_FRAMES_IN_FLIGHT);
+	m_submittedFrames.assign(NUMBER_OF_FRAMES_IN_FLIGHT, 0);
 
 
 	auto semaphoreInfo = vk::SemaphoreCreateInfo();
 	auto fenceInfo = vk::FenceCreateInfo();
 	fenceInfo.setFlags(vk::FenceCreateFlags(vk::FenceCreateFlagBits::eSignaled));
 
-	for (auto i = 0; i < NUMBER_OF_FRAMES_IN_FLIGHT; ++i)
+	for (size_t i = 0; i < NUMBER_OF_FRAMES_IN_FLIGHT; ++i)
 	{
 		m_gpu->createSemaphore(semaphoreInfo, m_imageAvailableSemaphores[i]);
 		m_gpu->createSemaphore(semaphoreInfo, m_renderFinishedSemaphores[i]);
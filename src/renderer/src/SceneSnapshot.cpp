@@ -0,0 +1,212 @@
+#include "SceneSnapshot.h"
+#include "LoggerAPI.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+namespace {
+uint64_t alignUp(uint64_t value)
+{
+	return (value + scenefile::ARRAY_ALIGNMENT - 1) & ~(scenefile::ARRAY_ALIGNMENT - 1);
+}
+
+bool arrayInBounds(uint64_t offset, uint64_t size, uint64_t fileSize)
+{
+	return offset <= fileSize && size <= fileSize - offset && offset % scenefile::ARRAY_ALIGNMENT == 0;
+}
+
+template<typename T>
+uint64_t appendArray(std::vector<std::byte> &file, const std::vector<T> &array)
+{
+	const auto offset = alignUp(file.size());
+	const auto bytes = std::as_bytes(std::span(array));
+	file.resize(offset + bytes.size());
+	std::copy(bytes.begin(), bytes.end(), file.begin() + static_cast<std::ptrdiff_t>(offset));
+
+	return offset;
+}
+}
+
+bool SceneSnapshot::open(const std::string &path)
+{
+	close();
+
+	if (!m_file.open(path))
+	{
+		return false;
+	}
+
+	if (!validate(path))
+	{
+		close();
+		return false;
+	}
+
+	scenefile::Header header;
+	std::memcpy(&header, m_file.data().data(), sizeof(header));
+
+	m_models = view<scenefile::ModelName>(header.modelsOffset, header.modelCount);
+	m_objectModels = view<uint32_t>(header.objectModelsOffset, header.objectCount);
+	m_objectFlags = view<uint32_t>(header.objectFlagsOffset, header.objectCount);
+	m_positions = view<scenefile::Position>(header.positionsOffset, header.objectCount);
+	m_nameRanges = view<scenefile::NameRange>(header.nameRangesOffset, header.objectCount);
+	m_names = { reinterpret_cast<const char *>(m_file.data().data() + header.namesOffset), header.namesSize };
+	LoggerAPI::getLogger()->logInfo("Mapped scene " + path + " with " + std::to_string(header.objectCount) + " objects");
+
+	return true;
+}
+
+void SceneSnapshot::close()
+{
+	m_models = {};
+	m_objectModels = {};
+	m_objectFlags = {};
+	m_positions = {};
+	m_nameRanges = {};
+	m_names = {};
+	m_file.close();
+}
+
+bool SceneSnapshot::isOpen() const
+{
+	return m_file.isOpen();
+}
+
+uint32_t SceneSnapshot::objectCount() const
+{
+	return static_cast<uint32_t>(m_objectModels.size());
+}
+
+std::span<const scenefile::ModelName> SceneSnapshot::models() const
+{
+	return m_models;
+}
+
+std::span<const uint32_t> SceneSnapshot::objectModels() const
+{
+	return m_objectModels;
+}
+
+std::span<const uint32_t> SceneSnapshot::objectFlags() const
+{
+	return m_objectFlags;
+}
+
+std::span<const scenefile::Position> SceneSnapshot::positions() const
+{
+	return m_positions;
+}
+
+std::string_view SceneSnapshot::objectName(uint32_t object) const
+{
+	const auto &range = m_nameRanges[object];
+	return { m_names.data() + range.offset, range.length };
+}
+
+std::string_view SceneSnapshot::modelName(const scenefile::ModelName &model)
+{
+	return { model.name, strnlen(model.name, scenefile::MAX_NAME_LENGTH) };
+}
+
+bool SceneSnapshot::validate(const std::string &path) const
+{
+	const auto bytes = m_file.data();
+	const auto fileSize = static_cast<uint64_t>(bytes.size());
+
+	scenefile::Header header;
+	if (fileSize < sizeof(header))
+	{
+		LoggerAPI::getLogger()->logError("Scene " + path + " is truncated");
+		return false;
+	}
+	std::memcpy(&header, bytes.data(), sizeof(header));
+
+	if (header.magic != scenefile::MAGIC || header.version != scenefile::VERSION)
+	{
+		LoggerAPI::getLogger()->logError("Scene " + path + " has unsupported format");
+		return false;
+	}
+
+	const uint64_t objectCount = header.objectCount;
+	const bool arraysValid = arrayInBounds(header.modelsOffset, header.modelCount * uint64_t{ sizeof(scenefile::ModelName) }, fileSize) &&
+		arrayInBounds(header.objectModelsOffset, objectCount * sizeof(uint32_t), fileSize) &&
+		arrayInBounds(header.objectFlagsOffset, objectCount * sizeof(uint32_t), fileSize) &&
+		arrayInBounds(header.positionsOffset, objectCount * sizeof(scenefile::Position), fileSize) &&
+		arrayInBounds(header.nameRangesOffset, objectCount * sizeof(scenefile::NameRange), fileSize) &&
+		arrayInBounds(header.namesOffset, header.namesSize, fileSize);
+	if (!arraysValid)
+	{
+		LoggerAPI::getLogger()->logError("Scene " + path + " has corrupted arrays");
+		return false;
+	}
+
+	const auto objectModels = view<uint32_t>(header.objectModelsOffset, header.objectCount);
+	const auto nameRanges = view<scenefile::NameRange>(header.nameRangesOffset, header.objectCount);
+	const auto modelsValid = std::all_of(objectModels.begin(), objectModels.end(), [&](uint32_t model)
+	{
+		return model < header.modelCount;
+	});
+	const auto namesValid = std::all_of(nameRanges.begin(), nameRanges.end(), [&](const scenefile::NameRange &range)
+	{
+		return range.offset <= header.namesSize && range.length <= header.namesSize - range.offset;
+	});
+	if (!modelsValid || !namesValid)
+	{
+		LoggerAPI::getLogger()->logError("Scene " + path + " has corrupted objects");
+		return false;
+	}
+
+	return true;
+}
+
+void SceneSnapshotWriter::addObject(std::string_view name, std::string_view modelName, glm::vec3 position, bool isStatic)
+{
+	auto [it, inserted] = m_modelIndices.try_emplace(std::string(modelName), static_cast<uint32_t>(m_models.size()));
+	if (inserted)
+	{
+		if (modelName.size() >= scenefile::MAX_NAME_LENGTH)
+		{
+			LoggerAPI::getLogger()->logWarning("Model name " + it->first + " is too long and will be truncated in the scene");
+		}
+
+		auto &model = m_models.emplace_back();
+		std::memset(&model, 0, sizeof(model));
+		modelName.copy(model.name, scenefile::MAX_NAME_LENGTH - 1);
+	}
+
+	m_objectModels.push_back(it->second);
+	m_objectFlags.push_back(isStatic ? scenefile::OBJECT_STATIC : 0);
+	m_positions.push_back({ position.x, position.y, position.z });
+	m_nameRanges.push_back({ static_cast<uint32_t>(m_names.size()), static_cast<uint32_t>(name.size()) });
+	m_names.insert(m_names.end(), name.begin(), name.end());
+}
+
+bool SceneSnapshotWriter::write(const std::string &path) const
+{
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	if (!file.is_open())
+	{
+		LoggerAPI::getLogger()->logError("Could not open " + path + " for writing");
+		return false;
+	}
+
+	auto bytes = std::vector<std::byte>(sizeof(scenefile::Header));
+	scenefile::Header header{};
+	header.magic = scenefile::MAGIC;
+	header.version = scenefile::VERSION;
+	header.modelCount = static_cast<uint32_t>(m_models.size());
+	header.objectCount = static_cast<uint32_t>(m_objectModels.size());
+	header.modelsOffset = appendArray(bytes, m_models);
+	header.objectModelsOffset = appendArray(bytes, m_objectModels);
+	header.objectFlagsOffset = appendArray(bytes, m_objectFlags);
+	header.positionsOffset = appendArray(bytes, m_positions);
+	header.nameRangesOffset = appendArray(bytes, m_nameRanges);
+	header.namesOffset = appendArray(bytes, m_names);
+	header.namesSize = m_names.size();
+	std::memcpy(bytes.data(), &header, sizeof(header));
+
+	file.write(reinterpret_cast<const char *>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+
+	return file.good();
+}
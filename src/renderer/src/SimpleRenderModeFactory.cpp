@@ -1,26 +1,28 @@
 #include "SimpleRenderModeFactory.h"
+#include "DrawCollector.h"
 #include "LoggerAPI.h"
-#include "Vertex.h"
+#include "ThreadPool.h"
+#include "VertexLayout.h"
 
+#include <algorithm>
 #include <array>
 #include <cassert>
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <tuple>
 
 using std::array;
 
-SimpleRenderModeFactory::SimpleRenderModeFactory(GPUPtr &gpu, const ScenePtr &scene) :
-	m_gpu(gpu),
-	m_scene(scene)
-{
-} 
+namespace {
+// Below this a secondary command buffer costs more to set up than recording its draws takes.
+constexpr size_t MIN_DRAWS_PER_SECONDARY = 64;
+// The vertex shader's push constants hold the VertexQuantization of the draw followed by the view projection.
+constexpr uint32_t VIEW_PROJECTION_OFFSET = sizeof(VertexQuantization);
+constexpr uint32_t PUSH_CONSTANTS_SIZE = VIEW_PROJECTION_OFFSET + sizeof(glm::mat4);
 
-SimpleRenderMode SimpleRenderModeFactory::createRenderMode(vk::Format swapchainFormat, vk::Extent2D extent, const std::vector<vk::PipelineShaderStageCreateInfo> &shaders)
+vk::Viewport createViewport(vk::Extent2D extent)
 {
-
-	bool succeed = createRenderPass(swapchainFormat);
-	assert(succeed);
-
-	createPipelineLayout();
-
 	auto viewport = vk::Viewport();
 	viewport.setWidth((float)extent.width);
 	viewport.setHeight((float)extent.height);
@@ -29,70 +31,200 @@ SimpleRenderMode SimpleRenderModeFactory::createRenderMode(vk::Format swapchainF
 	viewport.setMinDepth(0.0f);
 	viewport.setMaxDepth(1.0f);
 
+	return viewport;
+}
+
+vk::Rect2D createScissors(vk::Extent2D extent)
+{
 	auto scissors = vk::Rect2D();
 	scissors.setOffset({ 0,0 });
 	scissors.setExtent(extent);
 
-	succeed = createPipeline(shaders, viewport, scissors);
+	return scissors;
+}
+
+vk::Format toVkFormat(VertexFormat format)
+{
+	switch (format)
+	{
+	case VertexFormat::Float32x3:
+		return vk::Format::eR32G32B32Sfloat;
+	case VertexFormat::Float32x4:
+		return vk::Format::eR32G32B32A32Sfloat;
+	case VertexFormat::Snorm16x4:
+		return vk::Format::eR16G16B16A16Snorm;
+	case VertexFormat::Unorm8x4:
+		return vk::Format::eR8G8B8A8Unorm;
+	default:
+		return vk::Format::eUndefined;
+	}
+}
+
+struct DrawBuffers
+{
+	std::array<vk::Buffer, 2> vertexBuffers;
+	vk::Buffer indexBuffer;
+};
+
+// Records draws into a secondary command buffer that continues the render pass.
+void recordDraws(const SimpleRenderMode &mode, vk::Framebuffer framebuffer, const DrawBuffers &buffers, const glm::mat4 &viewProjection, std::span<const InstancedDraw> draws, vk::CommandBuffer commandBuffer)
+{
+	auto inheritanceInfo = vk::CommandBufferInheritanceInfo();
+	inheritanceInfo.setRenderPass(mode.renderPass);
+	inheritanceInfo.setSubpass(0);
+	inheritanceInfo.setFramebuffer(framebuffer);
+
+	auto beginInfo = vk::CommandBufferBeginInfo();
+	beginInfo.setFlags(vk::CommandBufferUsageFlagBits::eRenderPassContinue | vk::CommandBufferUsageFlagBits::eOneTimeSubmit);
+	beginInfo.setPInheritanceInfo(&inheritanceInfo);
+
+	if (vk::Result::eSuccess != commandBuffer.begin(&beginInfo))
+	{
+		LoggerAPI::getLogger()->logCritical("Could not begin record secondary command buffer");
+	}
+
+	// Secondary buffers inherit no state, each binds everything it uses.
+	const auto vertexBufferOffsets = std::array<vk::DeviceSize, 2>{ 0, 0 };
+	commandBuffer.bindVertexBuffers(0, static_cast<uint32_t>(buffers.vertexBuffers.size()), buffers.vertexBuffers.data(), vertexBufferOffsets.data());
+	commandBuffer.pushConstants(mode.pipelineLayout, vk::ShaderStageFlagBits::eVertex, VIEW_PROJECTION_OFFSET, sizeof(glm::mat4), &viewProjection);
+
+	vk::Pipeline boundPipeline;
+	std::optional<vk::IndexType> boundIndexType;
+	for (const auto &draw : draws)
+	{
+		const auto *ro = draw.object;
+		const auto &pipeline = mode.pipelines[static_cast<size_t>(ro->vertexLayout)];
+		if (pipeline != boundPipeline)
+		{
+			commandBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, pipeline);
+			boundPipeline = pipeline;
+		}
+		commandBuffer.pushConstants(mode.pipelineLayout, vk::ShaderStageFlagBits::eVertex, 0, sizeof(VertexQuantization), &ro->quantization);
+
+		if (ro->indexType != boundIndexType)
+		{
+			commandBuffer.bindIndexBuffer(buffers.indexBuffer, 0, ro->indexType);
+			boundIndexType = ro->indexType;
+		}
+		for (const auto &range : ro->drawRanges)
+		{
+			commandBuffer.drawIndexed(range.indexCount, draw.instanceCount, ro->geometry.firstIndex + range.firstIndex, ro->geometry.vertexOffset, draw.firstInstance);
+		}
+	}
+
+	commandBuffer.end();
+}
+}
+
+SimpleRenderModeFactory::SimpleRenderModeFactory(GPUPtr &gpu, const ScenePtr &scene) :
+	m_gpu(gpu),
+	m_scene(scene)
+{
+} 
+
+SimpleRenderMode SimpleRenderModeFactory::createRenderMode(vk::Format swapchainFormat, vk::Extent2D extent, const std::vector<vk::PipelineShaderStageCreateInfo> &shaders)
+{
+
+	bool succeed = createRenderPass(swapchainFormat);
 	assert(succeed);
 
-	succeed = createSwapchain(extent);
+	createPipelineLayout();
+
+	succeed = createPipelines(m_result, shaders, extent, m_result.pipelines);
 	assert(succeed);
 
-	createCommandPool();
+	succeed = createSwapchain(extent);
+	assert(succeed);
 
-	recordCommandBuffers();
+	createFrameCommands();
 
 	return m_result;
 }
 
-void SimpleRenderModeFactory::recordCommandBuffers()
+std::optional<PipelineSet> SimpleRenderModeFactory::rebuildPipelines(const SimpleRenderMode &mode, vk::Extent2D extent, const std::vector<vk::PipelineShaderStageCreateInfo> &shaders) const
 {
-	m_result.commandBuffers.resize(m_result.swapchainFramebuffers.size());
-
-	auto commandBufferAllocInfo = vk::CommandBufferAllocateInfo();
-	commandBufferAllocInfo.setCommandBufferCount(static_cast<uint32_t>(m_result.commandBuffers.size()));
-	commandBufferAllocInfo.setCommandPool(m_result.commandPool);
-	commandBufferAllocInfo.setLevel(vk::CommandBufferLevel::ePrimary);
+	PipelineSet pipelines{};
+	if (!createPipelines(mode, shaders, extent, pipelines))
+	{
+		for (const auto &pipeline : pipelines)
+		{
+			if (pipeline)
+			{
+				m_gpu->deletePipeline(pipeline);
+			}
+		}
+		return std::nullopt;
+	}
 
+	return pipelines;
+}
 
-	m_gpu->createCommandBuffers(commandBufferAllocInfo, m_result.commandBuffers.data());
+void SimpleRenderModeFactory::recordFrame(SimpleRenderMode &mode, size_t frameIndex, uint32_t imageIndex)
+{
+	auto &frame = mode.frames[frameIndex];
+	const auto framebuffer = mode.swapchainFramebuffers[imageIndex];
 
-	for (size_t i = 0; i < m_result.commandBuffers.size(); ++i)
+	auto instances = std::vector<InstanceData>();
+	auto draws = DrawCollector::collect(*m_scene, [this](UploadToken token) { return m_gpu->isUploadComplete(token); }, instances);
+	const auto mappedInstances = m_gpu->mapInstanceBuffer(frameIndex, instances.size());
+	if (mappedInstances.size() < instances.size())
 	{
-		auto beginInfo = vk::CommandBufferBeginInfo();
-		beginInfo.setFlags(vk::CommandBufferUsageFlagBits::eSimultaneousUse);
+		// Without instance data nothing can be drawn, the frame is only cleared.
+		draws.clear();
+	}
+	else
+	{
+		std::copy(instances.begin(), instances.end(), mappedInstances.begin());
+	}
 
-		if (vk::Result::eSuccess != m_result.commandBuffers[i].begin(&beginInfo))
+	// Every mesh lives in the same two buffers, only a change of index type needs another bind.
+	const auto buffers = DrawBuffers{ { m_gpu->getVertexBuffer(), m_gpu->getInstanceBuffer(frameIndex) }, m_gpu->getIndexBuffer() };
+
+	// A few draws are not worth a thread, every secondary buffer gets at least MIN_DRAWS_PER_SECONDARY of them.
+	const auto maxSecondaries = std::min(frame.secondaries.size(), (draws.size() + MIN_DRAWS_PER_SECONDARY - 1) / MIN_DRAWS_PER_SECONDARY);
+	const auto drawsPerSecondary = maxSecondaries == 0 ? 0 : (draws.size() + maxSecondaries - 1) / maxSecondaries;
+	const auto secondaryCount = drawsPerSecondary == 0 ? 0 : (draws.size() + drawsPerSecondary - 1) / drawsPerSecondary;
+
+	// Each secondary buffer has its own pool, so no pool is used by two threads at once.
+	ThreadPool::shared().parallelFor(secondaryCount, 1, [&](size_t begin, size_t end)
+	{
+		for (auto secondary = begin; secondary < end; ++secondary)
 		{
-			LoggerAPI::getLogger()->logCritical("Could not begin record command buffer");
+			const auto first = secondary * drawsPerSecondary;
+			const auto count = std::min(drawsPerSecondary, draws.size() - first);
+
+			m_gpu->resetCommandPool(frame.secondaryPools[secondary]);
+			recordDraws(mode, framebuffer, buffers, m_scene->viewProjection, std::span(draws).subspan(first, count), frame.secondaries[secondary]);
 		}
+	});
 
-		auto renderPassBeginInfo = vk::RenderPassBeginInfo();
-		renderPassBeginInfo.setRenderPass(m_result.renderPass);
-		renderPassBeginInfo.setFramebuffer(m_result.swapchainFramebuffers[i]);
-		auto renderArea = vk::Rect2D({ 0,0 }, m_gpu->getPresentationExtent());
-		renderPassBeginInfo.setRenderArea(renderArea);
-		renderPassBeginInfo.setClearValueCount(1);
-		vk::ClearValue clearValues[] = { 0.0, 0.0, 0.0, 1.0 };
-		renderPassBeginInfo.setPClearValues(clearValues);
-
-		m_result.commandBuffers[i].beginRenderPass(renderPassBeginInfo, vk::SubpassContents::eInline);
-		m_result.commandBuffers[i].bindPipeline(vk::PipelineBindPoint::eGraphics, m_result.pipeline);
-		for (const auto &ro : m_scene->renderableObjects)
-		{
-			vk::DeviceSize offset[] = { 0 };
+	m_gpu->resetCommandPool(frame.primaryPool);
 
-			m_result.commandBuffers[i].bindVertexBuffers(0, 1, &ro->sharedBuffer, offset);
-			m_result.commandBuffers[i].bindIndexBuffer(ro->sharedBuffer, ro->vertexOffset, vk::IndexType::eUint32);
-			m_result.commandBuffers[i].drawIndexed(ro->indexCount, 1, 0, 0, 0);
+	auto beginInfo = vk::CommandBufferBeginInfo();
+	beginInfo.setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit);
 
-		}
-		m_result.commandBuffers[i].endRenderPass();
+	if (vk::Result::eSuccess != frame.primary.begin(&beginInfo))
+	{
+		LoggerAPI::getLogger()->logCritical("Could not begin record command buffer");
+	}
 
-		m_result.commandBuffers[i].end();
+	auto renderPassBeginInfo = vk::RenderPassBeginInfo();
+	renderPassBeginInfo.setRenderPass(mode.renderPass);
+	renderPassBeginInfo.setFramebuffer(framebuffer);
+	auto renderArea = vk::Rect2D({ 0,0 }, m_gpu->getPresentationExtent());
+	renderPassBeginInfo.setRenderArea(renderArea);
+	renderPassBeginInfo.setClearValueCount(1);
+	vk::ClearValue clearValues[] = { 0.0, 0.0, 0.0, 1.0 };
+	renderPassBeginInfo.setPClearValues(clearValues);
+
+	frame.primary.beginRenderPass(renderPassBeginInfo, vk::SubpassContents::eSecondaryCommandBuffers);
+	if (secondaryCount > 0)
+	{
+		frame.primary.executeCommands(static_cast<uint32_t>(secondaryCount), frame.secondaries.data());
 	}
+	frame.primary.endRenderPass();
 
+	frame.primary.end();
 }
 
 bool SimpleRenderModeFactory::createRenderPass(vk::Format swapchainFormat)
@@ -140,40 +272,72 @@ bool SimpleRenderModeFactory::createRenderPass(vk::Format swapchainFormat)
 
 void SimpleRenderModeFactory::createPipelineLayout()
 {
+	auto pushConstantRange = vk::PushConstantRange();
+	pushConstantRange.setStageFlags(vk::ShaderStageFlagBits::eVertex);
+	pushConstantRange.setOffset(0);
+	pushConstantRange.setSize(PUSH_CONSTANTS_SIZE);
+
 	auto layoutCreateInfo = vk::PipelineLayoutCreateInfo();
 	layoutCreateInfo.setSetLayoutCount(0);
-	layoutCreateInfo.setPushConstantRangeCount(0);
+	layoutCreateInfo.setPushConstantRangeCount(1);
+	layoutCreateInfo.setPPushConstantRanges(&pushConstantRange);
 
 	m_gpu->createPipelineLayout(layoutCreateInfo, m_result.pipelineLayout);
 }
 
-bool SimpleRenderModeFactory::createPipeline(const std::vector<vk::PipelineShaderStageCreateInfo> &shaders, const vk::Viewport &viewport, const vk::Rect2D &scissors)
+bool SimpleRenderModeFactory::createPipelines(const SimpleRenderMode &mode, const std::vector<vk::PipelineShaderStageCreateInfo> &shaders, vk::Extent2D extent, PipelineSet &pipelines) const
+{
+	const auto viewport = createViewport(extent);
+	const auto scissors = createScissors(extent);
+
+	bool succeed = true;
+	for (uint32_t layout = 0; layout < VERTEX_LAYOUT_COUNT; ++layout)
+	{
+		succeed &= createPipeline(mode, shaders, viewport, scissors, static_cast<VertexLayoutKind>(layout), pipelines[layout]);
+	}
+
+	return succeed;
+}
+
+bool SimpleRenderModeFactory::createPipeline(const SimpleRenderMode &mode, const std::vector<vk::PipelineShaderStageCreateInfo> &shaders, const vk::Viewport &viewport, const vk::Rect2D &scissors, VertexLayoutKind layout, vk::Pipeline &pipeline) const
 {
 	auto pipelineCreateInfo = vk::GraphicsPipelineCreateInfo();
 	pipelineCreateInfo.setStageCount(static_cast<uint32_t>(shaders.size()));
 	pipelineCreateInfo.setPStages(shaders.data());
 
-	auto bindingDescription = new vk::VertexInputBindingDescription();
-	bindingDescription->setBinding(0);
-	bindingDescription->setInputRate(vk::VertexInputRate::eVertex);
-	bindingDescription->setStride(sizeof(Vertex));
+	const auto vertexLayout = VertexLayout::get(layout);
 
-	auto attributeDescriptions = array<vk::VertexInputAttributeDescription, 2>();
-	attributeDescriptions.at(0).setBinding(0);
-	attributeDescriptions.at(0).setFormat(vk::Format::eR32G32B32Sfloat);
-	attributeDescriptions.at(0).setLocation(0);
-	attributeDescriptions.at(0).setOffset(offsetof(Vertex, Vertex::postion));
+	auto bindingDescriptions = array<vk::VertexInputBindingDescription, 2>();
+	bindingDescriptions.at(0).setBinding(0);
+	bindingDescriptions.at(0).setInputRate(vk::VertexInputRate::eVertex);
+	bindingDescriptions.at(0).setStride(vertexLayout.stride);
+	bindingDescriptions.at(1).setBinding(1);
+	bindingDescriptions.at(1).setInputRate(vk::VertexInputRate::eInstance);
+	bindingDescriptions.at(1).setStride(sizeof(InstanceData));
 
-	attributeDescriptions.at(1).setBinding(0);
-	attributeDescriptions.at(1).setFormat(vk::Format::eR32G32B32A32Sfloat);
-	attributeDescriptions.at(1).setLocation(1);
-	attributeDescriptions.at(1).setOffset(offsetof(Vertex, Vertex::color));
+	constexpr auto vertexAttributeCount = std::tuple_size_v<decltype(vertexLayout.attributes)>;
+	auto attributeDescriptions = array<vk::VertexInputAttributeDescription, vertexAttributeCount + 2>();
+	for (size_t i = 0; i < vertexAttributeCount; ++i)
+	{
+		attributeDescriptions.at(i).setBinding(0);
+		attributeDescriptions.at(i).setFormat(toVkFormat(vertexLayout.attributes.at(i).format));
+		attributeDescriptions.at(i).setLocation(vertexLayout.attributes.at(i).location);
+		attributeDescriptions.at(i).setOffset(vertexLayout.attributes.at(i).offset);
+	}
+	attributeDescriptions.at(vertexAttributeCount).setBinding(1);
+	attributeDescriptions.at(vertexAttributeCount).setFormat(vk::Format::eR32G32B32Sfloat);
+	attributeDescriptions.at(vertexAttributeCount).setLocation(2);
+	attributeDescriptions.at(vertexAttributeCount).setOffset(offsetof(InstanceData, position));
+	attributeDescriptions.at(vertexAttributeCount + 1).setBinding(1);
+	attributeDescriptions.at(vertexAttributeCount + 1).setFormat(vk::Format::eR32Uint);
+	attributeDescriptions.at(vertexAttributeCount + 1).setLocation(3);
+	attributeDescriptions.at(vertexAttributeCount + 1).setOffset(offsetof(InstanceData, objectId));
 
 	auto vertexInputState = vk::PipelineVertexInputStateCreateInfo();
 	vertexInputState.setPVertexAttributeDescriptions(attributeDescriptions.data());
-	vertexInputState.setPVertexBindingDescriptions(bindingDescription);
+	vertexInputState.setPVertexBindingDescriptions(bindingDescriptions.data());
 	vertexInputState.setVertexAttributeDescriptionCount(static_cast<uint32_t>(attributeDescriptions.size()));
-	vertexInputState.setVertexBindingDescriptionCount(1);
+	vertexInputState.setVertexBindingDescriptionCount(static_cast<uint32_t>(bindingDescriptions.size()));
 
 	pipelineCreateInfo.setPVertexInputState(&vertexInputState);
 
@@ -233,13 +397,11 @@ bool SimpleRenderModeFactory::createPipeline(const std::vector<vk::PipelineShade
 
 
 	pipelineCreateInfo.setPDynamicState(nullptr); //not supported
-	pipelineCreateInfo.setLayout(m_result.pipelineLayout);
-	pipelineCreateInfo.setRenderPass(m_result.renderPass);
+	pipelineCreateInfo.setLayout(mode.pipelineLayout);
+	pipelineCreateInfo.setRenderPass(mode.renderPass);
 	pipelineCreateInfo.setSubpass(0);
 
-	m_gpu->createPipeline(pipelineCreateInfo, m_result.pipeline);
-
-	return true;
+	return m_gpu->createPipeline(pipelineCreateInfo, pipeline);
 }
 
 bool SimpleRenderModeFactory::createSwapchain(vk::Extent2D extent)
@@ -262,9 +424,32 @@ bool SimpleRenderModeFactory::createSwapchain(vk::Extent2D extent)
 	return true;
 }
 
-void SimpleRenderModeFactory::createCommandPool()
+void SimpleRenderModeFactory::createFrameCommands()
 {
-	m_gpu->createGraphicsCommandPool(m_result.commandPool);
+	// The calling thread records too while it waits for the pool's workers.
+	const auto recordingThreads = ThreadPool::shared().threadCount() + 1;
+
+	for (auto &frame : m_result.frames)
+	{
+		m_gpu->createGraphicsCommandPool(frame.primaryPool);
+		auto primaryAllocInfo = vk::CommandBufferAllocateInfo();
+		primaryAllocInfo.setCommandBufferCount(1);
+		primaryAllocInfo.setCommandPool(frame.primaryPool);
+		primaryAllocInfo.setLevel(vk::CommandBufferLevel::ePrimary);
+		m_gpu->createCommandBuffers(primaryAllocInfo, &frame.primary);
+
+		frame.secondaryPools.resize(recordingThreads);
+		frame.secondaries.resize(recordingThreads);
+		for (size_t i = 0; i < recordingThreads; ++i)
+		{
+			m_gpu->createGraphicsCommandPool(frame.secondaryPools[i]);
+			auto secondaryAllocInfo = vk::CommandBufferAllocateInfo();
+			secondaryAllocInfo.setCommandBufferCount(1);
+			secondaryAllocInfo.setCommandPool(frame.secondaryPools[i]);
+			secondaryAllocInfo.setLevel(vk::CommandBufferLevel::eSecondary);
+			m_gpu->createCommandBuffers(secondaryAllocInfo, &frame.secondaries[i]);
+		}
+	}
 }
 
 bool createCommandBuffers()
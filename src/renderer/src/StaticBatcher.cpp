@@ -0,0 +1,169 @@
+#include "StaticBatcher.h"
+#include "LoggerAPI.h"
+#include "VertexEncoder.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fmt/core.h>
+#include <tuple>
+
+namespace {
+uint32_t readIndex(std::span<const std::byte> indicies, IndexType indexType, size_t index)
+{
+	if (indexType == IndexType::Uint16)
+	{
+		uint16_t value;
+		std::memcpy(&value, indicies.data() + index * sizeof(uint16_t), sizeof(uint16_t));
+		return value;
+	}
+
+	uint32_t value;
+	std::memcpy(&value, indicies.data() + index * sizeof(uint32_t), sizeof(uint32_t));
+	return value;
+}
+
+template<typename Index>
+std::vector<std::byte> writeIndices(const std::vector<uint32_t> &indices)
+{
+	auto result = std::vector<std::byte>(indices.size() * sizeof(Index));
+	for (size_t i = 0; i < indices.size(); ++i)
+	{
+		const auto value = static_cast<Index>(indices[i]);
+		std::memcpy(result.data() + i * sizeof(Index), &value, sizeof(Index));
+	}
+	return result;
+}
+
+// Batches are rebuilt rarely, so compressed models are simply decoded into temporaries.
+std::vector<std::byte> decodeVerticies(const ModelData &model)
+{
+	if (model.encoding == MeshEncoding::Raw)
+	{
+		return { model.verticies.begin(), model.verticies.end() };
+	}
+
+	auto result = std::vector<std::byte>(model.vertexBytes());
+	return MeshCodec::decodeVerticies(model.verticies, result) ? result : std::vector<std::byte>();
+}
+
+std::vector<std::byte> decodeIndices(const ModelData &model)
+{
+	if (model.encoding == MeshEncoding::Raw)
+	{
+		return { model.indicies.begin(), model.indicies.end() };
+	}
+
+	auto result = std::vector<std::byte>(model.indexBytes());
+	const auto vertexCount = model.vertexBytes() / VertexLayout::get(model.layout).stride;
+	return MeshCodec::decodeIndices(model.indicies, result, vertexCount) ? result : std::vector<std::byte>();
+}
+
+Aabb boundsOf(std::span<const Vertex> verticies)
+{
+	auto box = Aabb{ verticies.front().postion, verticies.front().postion };
+	for (const auto &vertex : verticies)
+	{
+		box.min = glm::min(box.min, vertex.postion);
+		box.max = glm::max(box.max, vertex.postion);
+	}
+	return box;
+}
+
+float largestExtent(const Aabb &box)
+{
+	const auto extent = box.max - box.min;
+	return std::max({ extent.x, extent.y, extent.z });
+}
+
+StaticBatchData finishBatch(VertexLayoutKind layout, const std::vector<Vertex> &verticies, const std::vector<uint32_t> &indices, std::vector<RenderableObjectPtr> members)
+{
+	const auto box = boundsOf(verticies);
+
+	auto batch = StaticBatchData();
+	batch.bounds = { box, { box.center(), glm::length(box.halfExtent()) } };
+	batch.quantization = layout == VertexLayoutKind::Quantized ? VertexEncoder::computeQuantization(box) : VertexQuantization();
+	batch.verticies = VertexEncoder::encode(verticies, layout, batch.quantization);
+	batch.indexCount = static_cast<uint32_t>(indices.size());
+	batch.indexType = verticies.size() <= StaticBatcher::MAX_BATCH_VERTICES ? IndexType::Uint16 : IndexType::Uint32;
+	batch.indicies = batch.indexType == IndexType::Uint16 ? writeIndices<uint16_t>(indices) : writeIndices<uint32_t>(indices);
+	batch.members = std::move(members);
+
+	return batch;
+}
+}
+
+std::vector<StaticBatchData> StaticBatcher::build(VertexLayoutKind layout, const std::vector<RenderableObjectPtr> &members, ResourceManagerAPI &resourceManager)
+{
+	auto result = std::vector<StaticBatchData>();
+	auto verticies = std::vector<Vertex>();
+	auto indices = std::vector<uint32_t>();
+	auto batchMembers = std::vector<RenderableObjectPtr>();
+	auto batchBounds = Aabb();
+
+	// Members of a quantized batch share its position range. Sorted by cell, the members merged into one batch are close together.
+	auto ordered = members;
+	if (layout == VertexLayoutKind::Quantized)
+	{
+		const auto cellOf = [](const RenderableObjectPtr &member)
+		{
+			const auto cell = member->m_position / MAX_QUANTIZED_BATCH_EXTENT;
+			return std::tuple(std::floor(cell.x), std::floor(cell.y), std::floor(cell.z));
+		};
+		std::stable_sort(ordered.begin(), ordered.end(), [&cellOf](const RenderableObjectPtr &lhs, const RenderableObjectPtr &rhs)
+		{
+			return cellOf(lhs) < cellOf(rhs);
+		});
+	}
+
+	for (const auto &member : ordered)
+	{
+		const auto model = resourceManager.getModel(member->model);
+		const auto modelVerticies = decodeVerticies(model);
+		const auto modelIndices = decodeIndices(model);
+		if (modelVerticies.empty() || modelIndices.empty() || model.layout != layout)
+		{
+			LoggerAPI::getLogger()->logError("Could not add a static object to its batch, its model is not available");
+			continue;
+		}
+
+		auto memberVerticies = VertexEncoder::decode(modelVerticies, model.layout, model.quantization);
+		for (auto &vertex : memberVerticies)
+		{
+			vertex.postion += member->m_position;
+		}
+		const auto memberBounds = boundsOf(memberVerticies);
+		const auto mergedBounds = Aabb{ glm::min(batchBounds.min, memberBounds.min), glm::max(batchBounds.max, memberBounds.max) };
+
+		const auto tooManyVerticies = verticies.size() + memberVerticies.size() > MAX_BATCH_VERTICES;
+		const auto tooLarge = layout == VertexLayoutKind::Quantized && largestExtent(mergedBounds) > MAX_QUANTIZED_BATCH_EXTENT;
+		if (!verticies.empty() && (tooManyVerticies || tooLarge))
+		{
+			result.push_back(finishBatch(layout, verticies, indices, std::move(batchMembers)));
+			verticies.clear();
+			indices.clear();
+			batchMembers.clear();
+		}
+		batchBounds = verticies.empty() ? memberBounds : mergedBounds;
+
+		const auto base = static_cast<uint32_t>(verticies.size());
+		verticies.insert(verticies.end(), memberVerticies.begin(), memberVerticies.end());
+
+		// Batches are drawn as one range, so only the full mesh goes in.
+		const auto firstIndex = model.lods.empty() ? 0 : model.lods.front().firstIndex;
+		const auto indexCount = model.lods.empty() ? model.indexCount() : model.lods.front().indexCount;
+		for (size_t i = firstIndex; i < size_t{ firstIndex } + indexCount; ++i)
+		{
+			indices.push_back(base + readIndex(modelIndices, model.indexType, i));
+		}
+		batchMembers.push_back(member);
+	}
+
+	if (!indices.empty())
+	{
+		result.push_back(finishBatch(layout, verticies, indices, std::move(batchMembers)));
+	}
+
+	LoggerAPI::getLogger()->logInfo(fmt::format("Merged {} static objects into {} batches", members.size(), result.size()));
+	return result;
+}
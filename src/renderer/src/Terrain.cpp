@@ -0,0 +1,350 @@
+#include "Terrain.h"
+#include "LoggerAPI.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <fmt/core.h>
+
+namespace {
+// Chunks are only evicted this much past the streaming radius, so they do not flicker in and out at its border.
+constexpr float STREAMING_HYSTERESIS = 0.1F;
+// Builds in flight at most, more would only delay the uploads of the nearest chunks.
+constexpr size_t MAX_PENDING_CHUNKS = 16;
+// Band around each LOD switch distance in which a chunk keeps its current LOD.
+constexpr float LOD_HYSTERESIS = 0.1F;
+constexpr uint32_t INVALID_LOD = ~0U;
+
+// Directions in the order of the TerrainMesher stitch bits: -Z, +X, +Z, -X.
+constexpr int NEIGHBOUR_OFFSETS[4][2] = { { 0, -1 }, { 1, 0 }, { 0, 1 }, { -1, 0 } };
+}
+
+Terrain::Terrain(GPUPtr gpu, ScenePtr scene, Heightmap heightmap, const TerrainSettings &settings) :
+	m_gpu{ std::move(gpu) },
+	m_scene{ std::move(scene) },
+	m_heightmap{ std::make_shared<const Heightmap>(std::move(heightmap)) },
+	m_settings{ settings },
+	m_chunksX{ (m_heightmap->width - 2) / settings.chunkQuads + 1 },
+	m_chunksZ{ (m_heightmap->depth - 2) / settings.chunkQuads + 1 },
+	m_indexType{ vk::IndexType::eUint32 },
+	m_chunkVertexCount{ (settings.chunkQuads + 1) * (settings.chunkQuads + 1) }
+{
+	auto indices = TerrainMesher::buildIndices(m_settings);
+	m_indexVariants = std::move(indices.variants);
+	m_indexType = indices.indexType == IndexType::Uint16 ? vk::IndexType::eUint16 : vk::IndexType::eUint32;
+	// Buffer updates work in multiples of 4 bytes.
+	indices.indicies.resize((indices.indicies.size() + 3) / 4 * 4);
+	const auto vertexBytes = vk::DeviceSize{ m_chunkVertexCount } * sizeof(QuantizedVertex) * m_settings.maxResidentChunks;
+	m_geometry = m_gpu->allocateGeometry(vertexBytes, sizeof(QuantizedVertex), indices.indicies.size(), m_indexType);
+	if (!m_geometry.isValid())
+	{
+		LoggerAPI::getLogger()->logError(fmt::format("No geometry for {} terrain chunks", m_settings.maxResidentChunks));
+		return;
+	}
+	// Chunks are written after the indices, so their upload tokens cover the indices as well.
+	m_gpu->updateIndices(m_geometry, indices.indicies);
+
+	for (auto slot = m_settings.maxResidentChunks; slot > 0; --slot)
+	{
+		m_freeSlots.push_back(slot - 1);
+	}
+
+	LoggerAPI::getLogger()->logInfo(fmt::format("Terrain of {}x{} chunks with {} LODs, {} chunks resident at most", m_chunksX, m_chunksZ, m_settings.lodCount, m_settings.maxResidentChunks));
+}
+
+std::unique_ptr<Terrain> Terrain::create(GPUPtr gpu, ScenePtr scene, Heightmap heightmap, const TerrainSettings &settings)
+{
+	auto terrain = std::unique_ptr<Terrain>(new Terrain(std::move(gpu), std::move(scene), std::move(heightmap), settings));
+	if (!terrain->m_geometry.isValid())
+	{
+		return nullptr;
+	}
+	return terrain;
+}
+
+bool Terrain::validate(const Heightmap &heightmap, const TerrainSettings &settings)
+{
+	auto error = std::string();
+	if (heightmap.width < 2 || heightmap.depth < 2 || heightmap.samples.size() != size_t{ heightmap.width } * heightmap.depth)
+	{
+		error = "the heightmap needs at least 2x2 samples";
+	}
+	else if (!std::has_single_bit(settings.chunkQuads) || settings.lodCount == 0 || (settings.chunkQuads >> (settings.lodCount - 1)) == 0)
+	{
+		error = "chunkQuads has to be a power of two of at least 2^(lodCount - 1)";
+	}
+	else if (settings.maxResidentChunks == 0 || settings.uploadsPerFrame == 0)
+	{
+		error = "maxResidentChunks and uploadsPerFrame have to be at least 1";
+	}
+	else if (!(settings.horizontalScale > 0.0F) || !(settings.streamingRadius > 0.0F) || !(settings.lodDistance > 0.0F))
+	{
+		error = "horizontalScale, streamingRadius and lodDistance have to be positive";
+	}
+
+	if (!error.empty())
+	{
+		LoggerAPI::getLogger()->logError("Invalid terrain: " + error);
+		return false;
+	}
+	return true;
+}
+
+void Terrain::update(const Camera &camera)
+{
+	// A slot is reused once its last write is done and no frame in flight draws the evicted chunk anymore.
+	std::erase_if(m_retiredSlots, [this](const RetiredSlot &retired)
+	{
+		if (!m_gpu->isUploadComplete(retired.upload) || !m_gpu->isFrameComplete(retired.frame))
+		{
+			return false;
+		}
+		m_freeSlots.push_back(retired.slot);
+		return true;
+	});
+
+	evictChunks(camera);
+	requestChunks(camera);
+	uploadChunks(camera);
+	selectLods(camera);
+}
+
+void Terrain::cleanUp()
+{
+	for (auto &pending : m_pending)
+	{
+		pending.mesh.wait();
+	}
+	m_pending.clear();
+	m_chunks.clear();
+	m_scene->terrainChunks.clear();
+
+	m_gpu->freeGeometry(m_geometry);
+	m_geometry = GeometryRange();
+	m_freeSlots.clear();
+	m_retiredSlots.clear();
+}
+
+Terrain::ChunkKey Terrain::keyOf(uint32_t x, uint32_t z)
+{
+	return (ChunkKey{ x } << 32) | z;
+}
+
+float Terrain::groundDistance(const Camera &camera, uint32_t x, uint32_t z) const
+{
+	const auto chunkSize = static_cast<float>(m_settings.chunkQuads) * m_settings.horizontalScale;
+	const auto centerX = (static_cast<float>(x) + 0.5F) * chunkSize;
+	const auto centerZ = (static_cast<float>(z) + 0.5F) * chunkSize;
+	return std::hypot(centerX - camera.position.x, centerZ - camera.position.z);
+}
+
+uint32_t Terrain::targetLod(const Camera &camera, const Chunk &chunk) const
+{
+	const auto &box = chunk.object->localBounds.box;
+	const auto distance = glm::distance(glm::clamp(camera.position, box.min, box.max), camera.position);
+	const auto lodAt = [this](float lodDistance)
+	{
+		if (lodDistance < m_settings.lodDistance)
+		{
+			return 0U;
+		}
+		const auto lod = static_cast<uint32_t>(std::log2(lodDistance / m_settings.lodDistance)) + 1;
+		return std::min(lod, m_settings.lodCount - 1);
+	};
+
+	if (chunk.lod != INVALID_LOD && lodAt(distance * (1.0F - LOD_HYSTERESIS)) <= chunk.lod && chunk.lod <= lodAt(distance * (1.0F + LOD_HYSTERESIS)))
+	{
+		return chunk.lod;
+	}
+	return lodAt(distance);
+}
+
+void Terrain::evictChunks(const Camera &camera)
+{
+	const auto evictionRadius = m_settings.streamingRadius * (1.0F + STREAMING_HYSTERESIS);
+	auto &sceneChunks = m_scene->terrainChunks;
+
+	for (auto it = m_chunks.begin(); it != m_chunks.end();)
+	{
+		if (groundDistance(camera, it->second.x, it->second.z) <= evictionRadius)
+		{
+			++it;
+			continue;
+		}
+
+		sceneChunks.erase(std::find(sceneChunks.begin(), sceneChunks.end(), it->second.object));
+		// Frames submitted so far may still draw the chunk.
+		m_retiredSlots.push_back({ it->second.slot, it->second.object->uploadToken, m_gpu->submittedFrame() });
+		it = m_chunks.erase(it);
+	}
+}
+
+void Terrain::requestChunks(const Camera &camera)
+{
+	const auto capacity = std::min(MAX_PENDING_CHUNKS, size_t{ m_settings.maxResidentChunks } - m_chunks.size());
+	if (m_pending.size() >= capacity)
+	{
+		return;
+	}
+
+	const auto chunkSize = static_cast<float>(m_settings.chunkQuads) * m_settings.horizontalScale;
+	const auto firstChunk = [&](float coordinate, uint32_t count)
+	{
+		return static_cast<uint32_t>(std::clamp(std::floor((coordinate - m_settings.streamingRadius) / chunkSize), 0.0F, static_cast<float>(count - 1)));
+	};
+	const auto lastChunk = [&](float coordinate, uint32_t count)
+	{
+		return static_cast<uint32_t>(std::clamp(std::floor((coordinate + m_settings.streamingRadius) / chunkSize), 0.0F, static_cast<float>(count - 1)));
+	};
+
+	struct Candidate
+	{
+		float distance;
+		uint32_t x;
+		uint32_t z;
+	};
+	auto candidates = std::vector<Candidate>();
+	for (auto z = firstChunk(camera.position.z, m_chunksZ); z <= lastChunk(camera.position.z, m_chunksZ); ++z)
+	{
+		for (auto x = firstChunk(camera.position.x, m_chunksX); x <= lastChunk(camera.position.x, m_chunksX); ++x)
+		{
+			const auto distance = groundDistance(camera, x, z);
+			const auto isPending = std::any_of(m_pending.begin(), m_pending.end(), [x, z](const PendingChunk &pending)
+			{
+				return pending.x == x && pending.z == z;
+			});
+			if (distance <= m_settings.streamingRadius && !m_chunks.contains(keyOf(x, z)) && !isPending)
+			{
+				candidates.push_back({ distance, x, z });
+			}
+		}
+	}
+
+	// Nearest first, so the ground under the camera is there before the horizon.
+	const auto count = std::min(candidates.size(), capacity - m_pending.size());
+	std::partial_sort(candidates.begin(), candidates.begin() + static_cast<ptrdiff_t>(count), candidates.end(), [](const Candidate &lhs, const Candidate &rhs)
+	{
+		return lhs.distance < rhs.distance;
+	});
+	for (size_t i = 0; i < count; ++i)
+	{
+		const auto x = candidates[i].x;
+		const auto z = candidates[i].z;
+		auto mesh = ThreadPool::shared().submit([heightmap = m_heightmap, settings = m_settings, x, z]()
+		{
+			return TerrainMesher::buildChunk(*heightmap, settings, x, z);
+		});
+		m_pending.push_back({ x, z, std::move(mesh) });
+	}
+}
+
+void Terrain::uploadChunks(const Camera &camera)
+{
+	const auto evictionRadius = m_settings.streamingRadius * (1.0F + STREAMING_HYSTERESIS);
+	auto uploads = uint32_t{ 0 };
+
+	for (auto it = m_pending.begin(); it != m_pending.end();)
+	{
+		if (uploads == m_settings.uploadsPerFrame || m_freeSlots.empty())
+		{
+			break;
+		}
+		if (it->mesh.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+		{
+			++it;
+			continue;
+		}
+
+		const auto mesh = it->mesh.get();
+		const auto x = it->x;
+		const auto z = it->z;
+		it = m_pending.erase(it);
+		// The camera moved on while the chunk was built.
+		if (groundDistance(camera, x, z) > evictionRadius)
+		{
+			continue;
+		}
+
+		const auto slot = m_freeSlots.back();
+		m_freeSlots.pop_back();
+		const auto slotVertexBytes = vk::DeviceSize{ m_chunkVertexCount } * sizeof(QuantizedVertex);
+		const auto upload = m_gpu->updateVerticies(m_geometry, slotVertexBytes * slot, mesh.verticies);
+
+		// The chunk does not own its slot, so its range is not valid and never freed on its own.
+		auto object = std::make_shared<RenderableObject>(fmt::format("TerrainChunk{}_{}", x, z));
+		object->geometry.vertexOffset = m_geometry.vertexOffset + static_cast<int32_t>(m_chunkVertexCount * slot);
+		object->geometry.firstIndex = m_geometry.firstIndex;
+		object->uploadToken = upload;
+		object->indexType = m_indexType;
+		object->vertexLayout = VertexLayoutKind::Quantized;
+		object->quantization = mesh.quantization;
+		object->localBounds = mesh.bounds;
+
+		m_scene->terrainChunks.push_back(object);
+		m_chunks.emplace(keyOf(x, z), Chunk{ x, z, slot, INVALID_LOD, 0, std::move(object) });
+		++uploads;
+	}
+}
+
+void Terrain::selectLods(const Camera &camera)
+{
+	auto lods = std::unordered_map<ChunkKey, uint32_t>();
+	for (const auto &[key, chunk] : m_chunks)
+	{
+		lods.emplace(key, targetLod(camera, chunk));
+	}
+
+	const auto neighbourLod = [&](const Chunk &chunk, size_t side) -> const uint32_t *
+	{
+		const auto x = chunk.x + static_cast<uint32_t>(NEIGHBOUR_OFFSETS[side][0]);
+		const auto z = chunk.z + static_cast<uint32_t>(NEIGHBOUR_OFFSETS[side][1]);
+		const auto it = lods.find(keyOf(x, z));
+		return it != lods.end() ? &it->second : nullptr;
+	};
+
+	// Stitching only bridges one LOD step, so refine chunks until no neighbours differ by more.
+	auto relaxed = false;
+	while (!relaxed)
+	{
+		relaxed = true;
+		for (const auto &[key, chunk] : m_chunks)
+		{
+			auto &lod = lods[key];
+			for (size_t side = 0; side < 4; ++side)
+			{
+				const auto *neighbour = neighbourLod(chunk, side);
+				if (neighbour != nullptr && lod > *neighbour + 1)
+				{
+					lod = *neighbour + 1;
+					relaxed = false;
+				}
+			}
+		}
+	}
+
+	for (auto &[key, chunk] : m_chunks)
+	{
+		const auto lod = lods[key];
+		auto stitchMask = uint32_t{ 0 };
+		for (size_t side = 0; side < 4; ++side)
+		{
+			const auto *neighbour = neighbourLod(chunk, side);
+			if (neighbour != nullptr && *neighbour > lod)
+			{
+				stitchMask |= 1U << side;
+			}
+		}
+
+		if (lod != chunk.lod || stitchMask != chunk.stitchMask)
+		{
+			const auto &variant = m_indexVariants[lod * TerrainMesher::STITCH_MASK_COUNT + stitchMask];
+			chunk.lod = lod;
+			chunk.stitchMask = stitchMask;
+			chunk.object->currentLod = lod;
+			chunk.object->firstIndex = variant.firstIndex;
+			chunk.object->indexCount = variant.indexCount;
+		}
+	}
+}
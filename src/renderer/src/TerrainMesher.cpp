@@ -0,0 +1,133 @@
+#include "TerrainMesher.h"
+#include "VertexEncoder.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+const auto LOW_COLOR = glm::vec4(0.25F, 0.45F, 0.2F, 1.0F);
+const auto MID_COLOR = glm::vec4(0.45F, 0.4F, 0.35F, 1.0F);
+const auto HIGH_COLOR = glm::vec4(0.95F, 0.95F, 0.95F, 1.0F);
+
+glm::vec4 heightColor(float height)
+{
+	return height < 0.5F ? glm::mix(LOW_COLOR, MID_COLOR, height * 2.0F) : glm::mix(MID_COLOR, HIGH_COLOR, height * 2.0F - 1.0F);
+}
+
+template<typename Index>
+std::vector<std::byte> writeIndices(const std::vector<uint32_t> &indices)
+{
+	auto result = std::vector<std::byte>(indices.size() * sizeof(Index));
+	for (size_t i = 0; i < indices.size(); ++i)
+	{
+		const auto value = static_cast<Index>(indices[i]);
+		std::memcpy(result.data() + i * sizeof(Index), &value, sizeof(Index));
+	}
+	return result;
+}
+}
+
+TerrainChunkMesh TerrainMesher::buildChunk(const Heightmap &heightmap, const TerrainSettings &settings, uint32_t chunkX, uint32_t chunkZ)
+{
+	const auto quads = settings.chunkQuads;
+	auto verticies = std::vector<Vertex>();
+	verticies.reserve(size_t{ quads + 1 } * (quads + 1));
+
+	for (uint32_t z = 0; z <= quads; ++z)
+	{
+		for (uint32_t x = 0; x <= quads; ++x)
+		{
+			const auto sampleX = std::min(chunkX * quads + x, heightmap.width - 1);
+			const auto sampleZ = std::min(chunkZ * quads + z, heightmap.depth - 1);
+			const auto height = heightmap.at(sampleX, sampleZ);
+
+			auto vertex = Vertex();
+			vertex.postion = { static_cast<float>(sampleX) * settings.horizontalScale, height * settings.heightScale, static_cast<float>(sampleZ) * settings.horizontalScale };
+			vertex.color = heightColor(height);
+			verticies.push_back(vertex);
+		}
+	}
+
+	auto box = Aabb{ verticies.front().postion, verticies.front().postion };
+	for (const auto &vertex : verticies)
+	{
+		box.min = glm::min(box.min, vertex.postion);
+		box.max = glm::max(box.max, vertex.postion);
+	}
+
+	auto mesh = TerrainChunkMesh();
+	mesh.bounds = { box, { box.center(), glm::length(box.halfExtent()) } };
+	mesh.quantization = VertexEncoder::computeQuantization(box);
+	mesh.verticies = VertexEncoder::encode(verticies, VertexLayoutKind::Quantized, mesh.quantization);
+
+	return mesh;
+}
+
+TerrainIndices TerrainMesher::buildIndices(const TerrainSettings &settings)
+{
+	const auto quads = settings.chunkQuads;
+	auto indices = std::vector<uint32_t>();
+	auto result = TerrainIndices();
+
+	for (uint32_t lod = 0; lod < settings.lodCount; ++lod)
+	{
+		const auto step = 1U << lod;
+		const auto coarseStep = step * 2;
+
+		for (uint32_t mask = 0; mask < STITCH_MASK_COUNT; ++mask)
+		{
+			// Neighbours are never coarser than the last LOD, its variants are all unstitched.
+			const auto stitchMask = lod + 1 < settings.lodCount ? mask : 0;
+			const auto vertexIndex = [&](uint32_t x, uint32_t z)
+			{
+				if ((((stitchMask & STITCH_NEGATIVE_Z) != 0 && z == 0) || ((stitchMask & STITCH_POSITIVE_Z) != 0 && z == quads)) && x % coarseStep != 0)
+				{
+					x -= step;
+				}
+				if ((((stitchMask & STITCH_NEGATIVE_X) != 0 && x == 0) || ((stitchMask & STITCH_POSITIVE_X) != 0 && x == quads)) && z % coarseStep != 0)
+				{
+					z -= step;
+				}
+				return z * (quads + 1) + x;
+			};
+			const auto addTriangle = [&](uint32_t a, uint32_t b, uint32_t c)
+			{
+				if (a != b && b != c && c != a)
+				{
+					indices.insert(indices.end(), { a, b, c });
+				}
+			};
+
+			const auto firstIndex = static_cast<uint32_t>(indices.size());
+			for (uint32_t z = 0; z < quads; z += step)
+			{
+				for (uint32_t x = 0; x < quads; x += step)
+				{
+					const auto a = vertexIndex(x, z);
+					const auto b = vertexIndex(x + step, z);
+					const auto c = vertexIndex(x, z + step);
+					const auto d = vertexIndex(x + step, z + step);
+					// Clockwise seen from above, the pipeline culls counter clockwise triangles.
+					// In the corner between two stitched sides both ends of the b-c diagonal move and a ends up on it,
+					// splitting along a-d instead avoids the T-junction.
+					if (b != (z * (quads + 1) + x + step) && c != ((z + step) * (quads + 1) + x))
+					{
+						addTriangle(a, b, d);
+						addTriangle(a, d, c);
+					}
+					else
+					{
+						addTriangle(a, b, c);
+						addTriangle(b, d, c);
+					}
+				}
+			}
+			result.variants.push_back({ firstIndex, static_cast<uint32_t>(indices.size()) - firstIndex });
+		}
+	}
+
+	result.indexType = size_t{ quads + 1 } * (quads + 1) <= 65536 ? IndexType::Uint16 : IndexType::Uint32;
+	result.indicies = result.indexType == IndexType::Uint16 ? writeIndices<uint16_t>(indices) : writeIndices<uint32_t>(indices);
+
+	return result;
+}
@@ -0,0 +1,299 @@
+#include "TlsfAllocator.h"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+
+TlsfAllocator::TlsfAllocator(uint64_t size) :
+	m_size{ size },
+	m_usedBytes{ 0 },
+	m_allocationCount{ 0 },
+	m_flBitmap{ 0 },
+	m_slBitmaps{}
+{
+	for (auto &heads : m_freeHeads)
+	{
+		heads.fill(INVALID_NODE);
+	}
+
+	if (size > 0)
+	{
+		insertFree(createNode(0, size));
+	}
+}
+
+TlsfAllocator::Allocation TlsfAllocator::allocate(uint64_t size, uint64_t alignment)
+{
+	assert(std::has_single_bit(alignment));
+	size = std::max<uint64_t>(size, 1);
+
+	const auto node = findFree(size, alignment);
+	if (node == INVALID_NODE)
+	{
+		return {};
+	}
+	removeFree(node);
+
+	const auto offset = m_nodes[node].offset;
+	const auto padding = ((offset + alignment - 1) & ~(alignment - 1)) - offset;
+	if (padding > 0)
+	{
+		insertFree(splitFront(node, padding));
+	}
+	if (m_nodes[node].size > size)
+	{
+		const auto front = splitFront(node, size);
+		insertFree(node);
+		m_nodes[front].isFree = false;
+		m_usedBytes += size;
+		++m_allocationCount;
+		return { m_nodes[front].offset, front };
+	}
+
+	m_nodes[node].isFree = false;
+	m_usedBytes += m_nodes[node].size;
+	++m_allocationCount;
+	return { m_nodes[node].offset, node };
+}
+
+void TlsfAllocator::free(uint32_t node)
+{
+	assert(node < m_nodes.size() && !m_nodes[node].isFree);
+	m_usedBytes -= m_nodes[node].size;
+	--m_allocationCount;
+
+	const auto next = m_nodes[node].nextPhysical;
+	if (next != INVALID_NODE && m_nodes[next].isFree)
+	{
+		removeFree(next);
+		m_nodes[node].size += m_nodes[next].size;
+		m_nodes[node].nextPhysical = m_nodes[next].nextPhysical;
+		if (m_nodes[node].nextPhysical != INVALID_NODE)
+		{
+			m_nodes[m_nodes[node].nextPhysical].previousPhysical = node;
+		}
+		releaseNode(next);
+	}
+
+	const auto previous = m_nodes[node].previousPhysical;
+	if (previous != INVALID_NODE && m_nodes[previous].isFree)
+	{
+		removeFree(previous);
+		m_nodes[previous].size += m_nodes[node].size;
+		m_nodes[previous].nextPhysical = m_nodes[node].nextPhysical;
+		if (m_nodes[previous].nextPhysical != INVALID_NODE)
+		{
+			m_nodes[m_nodes[previous].nextPhysical].previousPhysical = previous;
+		}
+		releaseNode(node);
+		insertFree(previous);
+		return;
+	}
+
+	insertFree(node);
+}
+
+void TlsfAllocator::grow(uint64_t size)
+{
+	if (size <= m_size)
+	{
+		return;
+	}
+
+	// Nodes are not linked to the end of the space, so the last one is the live node that ends there.
+	auto unused = std::vector<bool>(m_nodes.size(), false);
+	for (const auto node : m_unusedNodes)
+	{
+		unused[node] = true;
+	}
+	auto last = INVALID_NODE;
+	for (uint32_t node = 0; node < m_nodes.size(); ++node)
+	{
+		if (!unused[node] && m_nodes[node].offset + m_nodes[node].size == m_size)
+		{
+			last = node;
+		}
+	}
+
+	const auto added = size - m_size;
+	m_size = size;
+	if (last != INVALID_NODE && m_nodes[last].isFree)
+	{
+		removeFree(last);
+		m_nodes[last].size += added;
+		insertFree(last);
+		return;
+	}
+
+	const auto node = createNode(size - added, added);
+	m_nodes[node].previousPhysical = last;
+	if (last != INVALID_NODE)
+	{
+		m_nodes[last].nextPhysical = node;
+	}
+	insertFree(node);
+}
+
+uint64_t TlsfAllocator::size() const
+{
+	return m_size;
+}
+
+uint64_t TlsfAllocator::usedBytes() const
+{
+	return m_usedBytes;
+}
+
+uint32_t TlsfAllocator::allocationCount() const
+{
+	return m_allocationCount;
+}
+
+uint64_t TlsfAllocator::largestFreeRange() const
+{
+	if (m_flBitmap == 0)
+	{
+		return 0;
+	}
+
+	// The largest range is in the highest non empty list, the ranges within a list differ in size.
+	const auto fl = static_cast<uint32_t>(std::bit_width(m_flBitmap)) - 1;
+	const auto sl = static_cast<uint32_t>(std::bit_width(m_slBitmaps[fl])) - 1;
+	auto largest = uint64_t{ 0 };
+	for (auto node = m_freeHeads[fl][sl]; node != INVALID_NODE; node = m_nodes[node].nextFree)
+	{
+		largest = std::max(largest, m_nodes[node].size);
+	}
+	return largest;
+}
+
+TlsfAllocator::SizeClass TlsfAllocator::sizeClass(uint64_t size)
+{
+	const auto msb = static_cast<uint32_t>(std::bit_width(size)) - 1;
+	if (msb < SL_BITS)
+	{
+		return { 0, static_cast<uint32_t>(size) };
+	}
+	return { msb - SL_BITS + 1, static_cast<uint32_t>(size >> (msb - SL_BITS)) - SL_COUNT };
+}
+
+uint32_t TlsfAllocator::createNode(uint64_t offset, uint64_t size)
+{
+	const auto node = Node{ offset, size, INVALID_NODE, INVALID_NODE, INVALID_NODE, INVALID_NODE, true };
+	if (!m_unusedNodes.empty())
+	{
+		const auto index = m_unusedNodes.back();
+		m_unusedNodes.pop_back();
+		m_nodes[index] = node;
+		return index;
+	}
+
+	m_nodes.push_back(node);
+	return static_cast<uint32_t>(m_nodes.size() - 1);
+}
+
+void TlsfAllocator::releaseNode(uint32_t node)
+{
+	m_unusedNodes.push_back(node);
+}
+
+void TlsfAllocator::insertFree(uint32_t node)
+{
+	const auto [fl, sl] = sizeClass(m_nodes[node].size);
+	auto &head = m_freeHeads[fl][sl];
+
+	m_nodes[node].isFree = true;
+	m_nodes[node].previousFree = INVALID_NODE;
+	m_nodes[node].nextFree = head;
+	if (head != INVALID_NODE)
+	{
+		m_nodes[head].previousFree = node;
+	}
+	head = node;
+
+	m_flBitmap |= uint64_t{ 1 } << fl;
+	m_slBitmaps[fl] |= 1U << sl;
+}
+
+void TlsfAllocator::removeFree(uint32_t node)
+{
+	const auto previous = m_nodes[node].previousFree;
+	const auto next = m_nodes[node].nextFree;
+	if (next != INVALID_NODE)
+	{
+		m_nodes[next].previousFree = previous;
+	}
+	if (previous != INVALID_NODE)
+	{
+		m_nodes[previous].nextFree = next;
+		return;
+	}
+
+	const auto [fl, sl] = sizeClass(m_nodes[node].size);
+	m_freeHeads[fl][sl] = next;
+	if (next == INVALID_NODE)
+	{
+		m_slBitmaps[fl] &= ~(1U << sl);
+		if (m_slBitmaps[fl] == 0)
+		{
+			m_flBitmap &= ~(uint64_t{ 1 } << fl);
+		}
+	}
+}
+
+uint32_t TlsfAllocator::findFree(uint64_t size, uint64_t alignment) const
+{
+	if (size > m_size)
+	{
+		return INVALID_NODE;
+	}
+
+	// Room to align the start of any range, rounded up to the next class boundary, so every range in the list found fits.
+	const auto padded = size + alignment - 1;
+	const auto msb = static_cast<uint32_t>(std::bit_width(padded)) - 1;
+	const auto rounded = msb >= SL_BITS ? padded + (uint64_t{ 1 } << (msb - SL_BITS)) - 1 : padded;
+	if (rounded <= m_size)
+	{
+		auto [fl, sl] = sizeClass(rounded);
+		auto slBitmap = m_slBitmaps[fl] & (~0U << sl);
+		if (slBitmap == 0)
+		{
+			const auto flBitmap = fl + 1 < FL_COUNT ? m_flBitmap & (~uint64_t{ 0 } << (fl + 1)) : 0;
+			fl = flBitmap != 0 ? static_cast<uint32_t>(std::countr_zero(flBitmap)) : fl;
+			slBitmap = flBitmap != 0 ? m_slBitmaps[fl] : 0;
+		}
+		if (slBitmap != 0)
+		{
+			return m_freeHeads[fl][static_cast<uint32_t>(std::countr_zero(slBitmap))];
+		}
+	}
+
+	// Only the class size itself belongs to may still have a range that fits, such as the whole space.
+	const auto [fl, sl] = sizeClass(size);
+	for (auto node = m_freeHeads[fl][sl]; node != INVALID_NODE; node = m_nodes[node].nextFree)
+	{
+		const auto padding = ((m_nodes[node].offset + alignment - 1) & ~(alignment - 1)) - m_nodes[node].offset;
+		if (m_nodes[node].size >= size + padding)
+		{
+			return node;
+		}
+	}
+	return INVALID_NODE;
+}
+
+uint32_t TlsfAllocator::splitFront(uint32_t node, uint64_t size)
+{
+	const auto front = createNode(m_nodes[node].offset, size);
+	m_nodes[front].previousPhysical = m_nodes[node].previousPhysical;
+	m_nodes[front].nextPhysical = node;
+	if (m_nodes[front].previousPhysical != INVALID_NODE)
+	{
+		m_nodes[m_nodes[front].previousPhysical].nextPhysical = front;
+	}
+
+	m_nodes[node].offset += size;
+	m_nodes[node].size -= size;
+	m_nodes[node].previousPhysical = front;
+
+	return front;
+}
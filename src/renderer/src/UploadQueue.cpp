@@ -0,0 +1,232 @@
+#include "UploadQueue.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace {
+constexpr uint64_t NO_TIMEOUT = std::numeric_limits<uint64_t>::max();
+constexpr size_t MAX_UPDATE_BUFFER_SIZE = 65536;
+}
+
+void UploadQueue::init(vk::Device device, vk::Queue queue, uint32_t queueFamily, vk::Buffer stagingBuffer, std::byte *stagingData, vk::DeviceSize stagingSize)
+{
+	m_device = device;
+	m_queue = queue;
+	m_stagingBuffer = stagingBuffer;
+	m_stagingData = stagingData;
+	m_stagingSize = stagingSize;
+
+	const auto poolCreateInfo = vk::CommandPoolCreateInfo(vk::CommandPoolCreateFlagBits::eTransient | vk::CommandPoolCreateFlagBits::eResetCommandBuffer, queueFamily);
+	m_commandPool = m_device.createCommandPool(poolCreateInfo);
+}
+
+void UploadQueue::cleanUp()
+{
+	waitIdle();
+	for (const auto &batch : m_retired)
+	{
+		m_device.destroyFence(batch.fence);
+	}
+	m_retired.clear();
+	m_device.destroyCommandPool(m_commandPool);
+}
+
+StagingRegion UploadQueue::stage(vk::DeviceSize size, vk::DeviceSize alignment)
+{
+	if (size > m_stagingSize || m_stagingData == nullptr)
+	{
+		return {};
+	}
+
+	for (;;)
+	{
+		auto start = (m_head + alignment - 1) / alignment * alignment;
+		// A region never wraps around the end of the ring, the rest of the lap is skipped instead.
+		if (start % m_stagingSize + size > m_stagingSize)
+		{
+			start = (start / m_stagingSize + 1) * m_stagingSize;
+		}
+		if (start + size - m_tail <= m_stagingSize)
+		{
+			begin();
+			m_head = start + size;
+			return { m_stagingData + start % m_stagingSize, start % m_stagingSize };
+		}
+
+		// The ring is full. If the batch being collected holds the space, it has to go out before it can be waited for.
+		if (m_inFlight.empty())
+		{
+			submit();
+		}
+		m_device.waitForFences(1, &m_inFlight.front().fence, true, NO_TIMEOUT);
+		retireOldest();
+	}
+}
+
+void UploadQueue::copy(vk::DeviceSize stagingOffset, vk::Buffer destination, vk::DeviceSize destinationOffset, vk::DeviceSize size)
+{
+	copy(m_stagingBuffer, stagingOffset, destination, destinationOffset, size);
+}
+
+void UploadQueue::copy(vk::Buffer source, vk::DeviceSize sourceOffset, vk::Buffer destination, vk::DeviceSize destinationOffset, vk::DeviceSize size)
+{
+	if (size == 0)
+	{
+		return;
+	}
+
+	begin();
+	const auto region = vk::BufferCopy(sourceOffset, destinationOffset, size);
+	m_current.commandBuffer.copyBuffer(source, destination, 1, &region);
+}
+
+void UploadQueue::update(vk::Buffer destination, vk::DeviceSize offset, std::span<const std::byte> data)
+{
+	if (data.empty())
+	{
+		return;
+	}
+
+	begin();
+	// vkCmdUpdateBuffer takes at most 65536 bytes at a time.
+	for (size_t written = 0; written < data.size(); written += MAX_UPDATE_BUFFER_SIZE)
+	{
+		const auto size = std::min(data.size() - written, MAX_UPDATE_BUFFER_SIZE);
+		m_current.commandBuffer.updateBuffer(destination, offset + written, size, data.data() + written);
+	}
+}
+
+UploadToken UploadQueue::latestToken() const
+{
+	return m_current.commandBuffer ? m_nextToken : m_nextToken - 1;
+}
+
+bool UploadQueue::isComplete(UploadToken token) const
+{
+	return token <= m_completedToken.load(std::memory_order_acquire);
+}
+
+void UploadQueue::submit()
+{
+	if (m_current.commandBuffer)
+	{
+		submitBatch(nullptr);
+	}
+}
+
+bool UploadQueue::submitAndSignal(vk::Semaphore semaphore)
+{
+	if (m_current.commandBuffer)
+	{
+		submitBatch(&semaphore);
+	}
+	else if (m_signaledToken.load(std::memory_order_relaxed) + 1 < m_nextToken)
+	{
+		// Batches went out without a semaphore. A semaphore signal waits for everything submitted to the queue before it,
+		// so an empty submission covers them.
+		auto submitInfo = vk::SubmitInfo();
+		submitInfo.setSignalSemaphoreCount(1);
+		submitInfo.setPSignalSemaphores(&semaphore);
+		m_queue.submit(1, &submitInfo, vk::Fence());
+	}
+	else
+	{
+		return false;
+	}
+
+	m_signaledToken.store(m_nextToken - 1, std::memory_order_release);
+	return true;
+}
+
+UploadToken UploadQueue::signaledToken() const
+{
+	return m_signaledToken.load(std::memory_order_acquire);
+}
+
+void UploadQueue::submitBatch(const vk::Semaphore *signalSemaphore)
+{
+	m_current.commandBuffer.end();
+
+	auto submitInfo = vk::SubmitInfo();
+	submitInfo.setCommandBufferCount(1);
+	submitInfo.setPCommandBuffers(&m_current.commandBuffer);
+	if (signalSemaphore != nullptr)
+	{
+		submitInfo.setSignalSemaphoreCount(1);
+		submitInfo.setPSignalSemaphores(signalSemaphore);
+	}
+	m_queue.submit(1, &submitInfo, m_current.fence);
+
+	m_current.token = m_nextToken++;
+	m_current.ringEnd = m_head;
+	m_inFlight.push_back(m_current);
+	m_current = Batch();
+}
+
+bool UploadQueue::poll()
+{
+	auto retired = false;
+	while (!m_inFlight.empty() && m_device.getFenceStatus(m_inFlight.front().fence) == vk::Result::eSuccess)
+	{
+		retireOldest();
+		retired = true;
+	}
+
+	return retired;
+}
+
+void UploadQueue::waitIdle()
+{
+	submit();
+	while (!m_inFlight.empty())
+	{
+		m_device.waitForFences(1, &m_inFlight.front().fence, true, NO_TIMEOUT);
+		retireOldest();
+	}
+}
+
+void UploadQueue::begin()
+{
+	if (m_current.commandBuffer)
+	{
+		return;
+	}
+
+	if (!m_retired.empty())
+	{
+		m_current = m_retired.back();
+		m_retired.pop_back();
+	}
+	else
+	{
+		auto allocateInfo = vk::CommandBufferAllocateInfo();
+		allocateInfo.setCommandPool(m_commandPool);
+		allocateInfo.setLevel(vk::CommandBufferLevel::ePrimary);
+		allocateInfo.setCommandBufferCount(1);
+		m_device.allocateCommandBuffers(&allocateInfo, &m_current.commandBuffer);
+		m_current.fence = m_device.createFence(vk::FenceCreateInfo());
+	}
+
+	auto beginInfo = vk::CommandBufferBeginInfo();
+	beginInfo.setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit);
+	m_current.commandBuffer.begin(&beginInfo);
+}
+
+void UploadQueue::retireOldest()
+{
+	auto batch = m_inFlight.front();
+	m_inFlight.pop_front();
+
+	m_tail = batch.ringEnd;
+	m_completedToken.store(batch.token, std::memory_order_release);
+	m_device.resetFences(1, &batch.fence);
+	batch.commandBuffer.reset(vk::CommandBufferResetFlags());
+	m_retired.push_back(batch);
+
+	// Nothing left in the ring, the next region may start at its beginning again.
+	if (m_inFlight.empty() && !m_current.commandBuffer)
+	{
+		m_head = 0;
+		m_tail = 0;
+	}
+}
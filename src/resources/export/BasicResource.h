@@ -1,4 +1,5 @@
 #pragma once
+#include "InternedName.h"
 #include <string>
 
 class BasicResource
@@ -6,10 +7,11 @@ class BasicResource
 public:
 	explicit BasicResource(std::string name);
 	virtual ~BasicResource() = default;
-	int resourceID;
-	std::string name;
+	BasicResource(const BasicResource &) = default;
+	BasicResource(BasicResource &&) = default;
+	BasicResource &operator=(const BasicResource &) = default;
+	BasicResource &operator=(BasicResource &&) = default;
 
-private:
-	static int nextID;
+	InternedName name;
 };
 
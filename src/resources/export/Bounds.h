@@ -0,0 +1,36 @@
+#pragma once
+#include "glm/glm.hpp"
+
+struct Aabb
+{
+	glm::vec3 min{ 0.0F };
+	glm::vec3 max{ 0.0F };
+
+	glm::vec3 center() const
+	{
+		return (min + max) * 0.5F;
+	}
+
+	glm::vec3 halfExtent() const
+	{
+		return (max - min) * 0.5F;
+	}
+};
+
+struct BoundingSphere
+{
+	glm::vec3 center{ 0.0F };
+	float radius = 0.0F;
+};
+
+// Covers every vertex of a model, so it also covers each of its LODs.
+struct Bounds
+{
+	Aabb box;
+	BoundingSphere sphere;
+
+	Bounds translated(glm::vec3 offset) const
+	{
+		return { { box.min + offset, box.max + offset }, { sphere.center + offset, sphere.radius } };
+	}
+};
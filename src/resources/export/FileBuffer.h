@@ -0,0 +1,28 @@
+#pragma once
+#include <memory>
+#include <span>
+
+class FileBuffer
+{
+public:
+	FileBuffer() = default;
+	FileBuffer(std::shared_ptr<const void> owner, std::span<const char> data) :
+		m_owner{ std::move(owner) },
+		m_data{ data }
+	{
+	}
+
+	std::span<const char> data() const
+	{
+		return m_data;
+	}
+
+	bool empty() const
+	{
+		return m_data.empty();
+	}
+
+private:
+	std::shared_ptr<const void> m_owner;
+	std::span<const char> m_data;
+};
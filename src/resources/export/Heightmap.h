@@ -0,0 +1,21 @@
+#pragma once
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+struct Heightmap
+{
+	uint32_t width = 0;
+	uint32_t depth = 0;
+	// Row major along z, normalized to [0, 1].
+	std::vector<float> samples;
+
+	float at(uint32_t x, uint32_t z) const
+	{
+		return samples[size_t{ z } * width + x];
+	}
+
+	// Loads an 8 or 16 bit grayscale image, colour images are converted to gray first.
+	static std::optional<Heightmap> load(const std::string &path);
+};
@@ -0,0 +1,34 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+
+class InternedName
+{
+public:
+	InternedName() = default;
+	explicit InternedName(std::string_view name);
+
+	static InternedName find(std::string_view name);
+
+	const std::string &str() const;
+	bool isValid() const;
+	size_t hash() const;
+
+	friend bool operator==(const InternedName &lhs, const InternedName &rhs) = default;
+
+private:
+	explicit InternedName(const std::string *entry);
+
+	const std::string *m_entry = nullptr;
+};
+
+template<>
+struct std::hash<InternedName>
+{
+	size_t operator()(const InternedName &name) const noexcept
+	{
+		return name.hash();
+	}
+};
@@ -0,0 +1,30 @@
+#pragma once
+#include <cstddef>
+#include <span>
+#include <string>
+
+class MappedFile
+{
+public:
+	MappedFile() = default;
+	~MappedFile();
+
+	MappedFile(const MappedFile &) = delete;
+	MappedFile &operator=(const MappedFile &) = delete;
+	MappedFile(MappedFile &&other) noexcept;
+	MappedFile &operator=(MappedFile &&other) noexcept;
+
+	bool open(const std::string &path);
+	void close();
+
+	bool isOpen() const;
+	std::span<const std::byte> data() const;
+
+private:
+	const std::byte *m_data = nullptr;
+	size_t m_size = 0;
+#ifdef _WIN32
+	void *m_file = nullptr;
+	void *m_mapping = nullptr;
+#endif
+};
@@ -0,0 +1,37 @@
+#pragma once
+#include "VertexLayout.h"
+#include <cstddef>
+#include <span>
+#include <vector>
+
+enum class MeshEncoding : uint32_t
+{
+	// Vertex and index buffers as the GPU reads them.
+	Raw = 0,
+	// Both buffers are MeshCodec streams.
+	Compressed = 1
+};
+
+constexpr uint32_t MESH_ENCODING_COUNT = 2;
+
+// Lossless compression for vertex and index buffers, fast enough to decode straight into upload memory.
+// Vertices are coded one byte lane at a time: every byte is delta coded against the same byte of the previous vertex,
+// zigzag coded and packed in groups of 16 with 0, 2, 4 or 8 bits per value.
+// Indices are coded per triangle against FIFOs of recently seen edges and vertices, most triangles take one or two bytes.
+class MeshCodec
+{
+public:
+	static constexpr size_t MAX_VERTEX_STRIDE = 256;
+
+	// stride has to be a multiple of 4 and at most MAX_VERTEX_STRIDE, an empty buffer is returned otherwise.
+	static std::vector<std::byte> encodeVerticies(std::span<const std::byte> verticies, size_t stride);
+	// Triangles may come back rotated. Their order and winding are kept, so index ranges such as LODs stay valid.
+	static std::vector<std::byte> encodeIndices(std::span<const std::byte> indicies, IndexType indexType);
+
+	// Bytes the stream decodes to, 0 for anything that is not an encoded stream or is too short for the size its header claims.
+	static size_t decodedSize(std::span<const std::byte> encoded);
+	// destination must be exactly decodedSize(encoded) bytes. Returns false for a malformed stream.
+	static bool decodeVerticies(std::span<const std::byte> encoded, std::span<std::byte> destination);
+	// Also returns false if an index is not below vertexCount.
+	static bool decodeIndices(std::span<const std::byte> encoded, std::span<std::byte> destination, size_t vertexCount);
+};
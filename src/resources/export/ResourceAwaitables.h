@@ -0,0 +1,40 @@
+#pragma once
+#include "Executor.h"
+#include "ResourceDefs.h"
+#include "ResourceHandle.h"
+#include "ShaderResource.h"
+
+#include <coroutine>
+#include <memory>
+
+class ResourceManagerAPI;
+
+class ShaderAwaitable
+{
+public:
+	ShaderAwaitable(ResourceManagerAPI &resourceManager, ShaderHandle shader, Executor &executor);
+
+	bool await_ready() const;
+	void await_suspend(std::coroutine_handle<> continuation) const;
+	std::shared_ptr<const ShaderResource> await_resume() const;
+
+private:
+	ResourceManagerAPI &m_resourceManager;
+	ShaderHandle m_shader;
+	Executor &m_executor;
+};
+
+class ModelAwaitable
+{
+public:
+	ModelAwaitable(ResourceManagerAPI &resourceManager, ModelHandle model, Executor &executor);
+
+	bool await_ready() const;
+	void await_suspend(std::coroutine_handle<> continuation) const;
+	ModelData await_resume() const;
+
+private:
+	ResourceManagerAPI &m_resourceManager;
+	ModelHandle m_model;
+	Executor &m_executor;
+};
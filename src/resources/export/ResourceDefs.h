@@ -1,16 +1,62 @@
 #pragma once
+#include <atomic>
+#include <span>
 #include <vector>
-#include "Vertex.h"
+#include "Bounds.h"
+#include "MeshCodec.h"
+#include "VertexLayout.h"
 
 
+// A range of the model index buffer. All LODs of a model share its vertex buffer.
+struct MeshLod
+{
+	std::uint32_t firstIndex;
+	std::uint32_t indexCount;
+	// Largest distance the simplified surface deviates from the full mesh, in model space.
+	float error;
+};
+
+// A run of consecutive triangles from the first LOD, small enough to be culled on its own.
+struct Meshlet
+{
+	std::uint32_t firstIndex;
+	std::uint32_t indexCount;
+	// Bounding sphere in model space.
+	glm::vec3 center;
+	float radius;
+	// Every front face normal is within the cone around coneAxis. A coneCutoff of 1 marks a cone too wide to ever be back facing.
+	glm::vec3 coneAxis;
+	float coneCutoff;
+
+	// True when a viewer at eye, in model space, sees only back faces of the meshlet.
+	bool isBackFacing(glm::vec3 eye) const
+	{
+		const auto toCenter = center - eye;
+		return coneCutoff < 1.0F && glm::dot(toCenter, coneAxis) >= coneCutoff * glm::length(toCenter) + radius;
+	}
+};
+
 struct ModelData
 {
-    ModelData(const std::vector<Vertex>& verts, const std::vector<std::uint32_t>& indcs, std::uint32_t& usgCounter) :
+	ModelData() :
+		usageCounter{nullptr}
+	{
+	}
+
+	// Takes over a reference already counted in usgCounter and releases it on destruction.
+	// The model stays resident for as long as the ModelData exists.
+    ModelData(std::span<const std::byte> verts, std::span<const std::byte> indcs, std::span<const MeshLod> meshLods, std::span<const Meshlet> modelMeshlets, VertexLayoutKind vertLayout, const VertexQuantization &quant, IndexType idxType, MeshEncoding meshEncoding, const Bounds &modelBounds, std::atomic<std::uint32_t>& usgCounter) :
 		verticies{verts},
 		indicies{indcs},
-		usageCounter{usgCounter}
+		lods{meshLods},
+		meshlets{modelMeshlets},
+		layout{vertLayout},
+		quantization{quant},
+		indexType{idxType},
+		encoding{meshEncoding},
+		bounds{modelBounds},
+		usageCounter{&usgCounter}
 	{
-		++usageCounter;
 	}
 
 	ModelData(const ModelData&) = delete;
@@ -18,11 +64,62 @@ struct ModelData
 
 	inline ~ModelData()
 	{
-		--usageCounter;
+		if (usageCounter != nullptr)
+		{
+			--*usageCounter;
+		}
+	}
+
+	bool empty() const
+	{
+		return verticies.empty();
+	}
+
+	std::uint32_t indexCount() const
+	{
+		return static_cast<std::uint32_t>(indexBytes() / indexSize(indexType));
+	}
+
+	// Sizes of the buffers once decoded, what has to be allocated for them on the GPU.
+	size_t vertexBytes() const
+	{
+		return encoding == MeshEncoding::Compressed ? MeshCodec::decodedSize(verticies) : verticies.size();
+	}
+
+	size_t indexBytes() const
+	{
+		return encoding == MeshEncoding::Compressed ? MeshCodec::decodedSize(indicies) : indicies.size();
 	}
 
-	const std::vector<Vertex>& verticies;
-	const std::vector<std::uint32_t>& indicies;
+	// Encoded with encoding on top of layout and indexType.
+	const std::span<const std::byte> verticies;
+	const std::span<const std::byte> indicies;
+	// Finest first, the first LOD is the full mesh.
+	const std::span<const MeshLod> lods;
+	const std::span<const Meshlet> meshlets;
+	const VertexLayoutKind layout = VertexLayoutKind::Float;
+	const VertexQuantization quantization;
+	const IndexType indexType = IndexType::Uint32;
+	const MeshEncoding encoding = MeshEncoding::Raw;
+	const Bounds bounds;
 private:
-	std::uint32_t usageCounter;
-};
\ No newline at end of file
+	std::atomic<std::uint32_t> *usageCounter;
+};
+
+enum class LoadStatus {
+	Pending,
+	Loaded,
+	Failed
+};
+
+struct LoadProgress
+{
+	std::uint32_t total;
+	std::uint32_t loaded;
+	std::uint32_t failed;
+
+	bool isFinished() const
+	{
+		return loaded + failed == total;
+	}
+};
@@ -0,0 +1,28 @@
+#pragma once
+#include <cstdint>
+#include <limits>
+
+template<typename Tag>
+struct ResourceHandle
+{
+	static constexpr uint32_t INVALID_INDEX = std::numeric_limits<uint32_t>::max();
+
+	uint32_t index = INVALID_INDEX;
+	// Bumped every time the slot behind index is reused, so handles to a released resource no longer match.
+	uint32_t generation = 0;
+
+	bool isValid() const
+	{
+		return index != INVALID_INDEX;
+	}
+
+	friend bool operator==(const ResourceHandle &lhs, const ResourceHandle &rhs) = default;
+};
+
+struct ModelTag;
+struct ShaderTag;
+struct TextureTag;
+
+using ModelHandle = ResourceHandle<ModelTag>;
+using ShaderHandle = ResourceHandle<ShaderTag>;
+using TextureHandle = ResourceHandle<TextureTag>;
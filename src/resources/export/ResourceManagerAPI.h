@@ -1,18 +1,59 @@
 #pragma once
 #include <memory>
+#include <functional>
+#include <future>
 #include "ShaderResource.h"
+#include "TextureResource.h"
 #include "ResourceDefs.h"
+#include "ResourceHandle.h"
+#include "ResourceAwaitables.h"
+#include <string_view>
 
 class ResourceManagerAPI;
 using ResourceManagerAPIPtr = std::shared_ptr<ResourceManagerAPI>;
+using LoadCallback = std::function<void(const LoadProgress &)>;
+
 class ResourceManagerAPI
 {
 public:
 	virtual ~ResourceManagerAPI() = default;
 
 	virtual void LoadResources() = 0;
-	virtual const ShaderResource& getShader(const std::string &shaderName) const = 0;
+	virtual std::shared_future<LoadProgress> LoadResourcesAsync(LoadCallback onComplete) = 0;
+	virtual LoadProgress getLoadProgress() const = 0;
+	virtual std::shared_future<LoadStatus> getShaderStatus(ShaderHandle shader) const = 0;
+	virtual std::shared_future<LoadStatus> getModelStatus(ModelHandle model) const = 0;
+	virtual std::shared_future<LoadStatus> getTextureStatus(TextureHandle texture) const = 0;
+	virtual void whenShaderReady(ShaderHandle shader, std::function<void(LoadStatus)> callback) = 0;
+	virtual void whenModelReady(ModelHandle model, std::function<void(LoadStatus)> callback) = 0;
+
+	ShaderAwaitable getShaderAsync(ShaderHandle shader, Executor &executor);
+	ShaderAwaitable getShaderAsync(std::string_view shaderName, Executor &executor);
+	ModelAwaitable getModelAsync(ModelHandle model, Executor &executor);
+	ModelAwaitable getModelAsync(std::string_view modelName, Executor &executor);
+
+	virtual ShaderHandle findShader(std::string_view shaderName) const = 0;
+	virtual ModelHandle findModel(std::string_view modelName) const = 0;
+	// Inverse of findModel, empty for an invalid or stale handle.
+	virtual std::string_view getModelName(ModelHandle model) const = 0;
+	// Null for an invalid or stale handle and for a shader that failed to load.
+	// A reload swaps in a new resource, the returned one stays valid for as long as it is held.
+	virtual std::shared_ptr<const ShaderResource> getShader(ShaderHandle shader) const = 0;
+	// Empty for an invalid or stale handle and for a model that failed to load.
+	virtual ModelData getModel(ModelHandle model) = 0;
+	virtual TextureHandle findTexture(std::string_view textureName) const = 0;
+	virtual const TextureResource *getTexture(TextureHandle texture) const = 0;
+
+	virtual std::vector<ShaderHandle> pollShaderChanges() = 0;
+
+	// Unreferenced models are evicted once their CPU memory exceeds the budget and reloaded on the next getModel.
+	virtual void setModelMemoryBudget(size_t bytes) = 0;
+	// Applies to textures loaded by the next LoadResources call.
+	virtual void setTextureQuality(TextureQuality quality) = 0;
+
+	virtual std::shared_ptr<const ShaderResource> getShader(const std::string &shaderName) const = 0;
 	virtual ModelData getModel(const std::string &modelName) = 0;
+	virtual const TextureResource *getTexture(const std::string &textureName) const = 0;
 	virtual void cleanUp() = 0;
 	
 	static ResourceManagerAPIPtr createInstance();
@@ -1,13 +1,20 @@
 #pragma once
 #include "BasicResource.h"
+#include "FileBuffer.h"
+#include <span>
 #include <vector>
 
 class ShaderResource : public BasicResource
 {
 public:
 	ShaderResource(const std::string &name, std::vector<char> shaderCode);
+	ShaderResource(const std::string &name, std::span<const char> mappedShaderCode);
+	ShaderResource(const std::string &name, FileBuffer shaderCode);
 	~ShaderResource() override = default;
 
-	std::vector<char> shader;
+	std::span<const char> code() const;
+
+private:
+	FileBuffer m_shader;
 };
 
@@ -0,0 +1,55 @@
+#pragma once
+#include "BasicResource.h"
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+enum class TextureFormat : std::uint32_t {
+	Rgba8 = 0,
+	Bc1 = 1,
+	Bc3 = 2,
+	Bc7 = 3
+};
+
+// Fast keeps load time cooking cheap with BC1 for opaque and BC3 for transparent images, High encodes everything as BC7.
+enum class TextureQuality {
+	Fast,
+	High
+};
+
+struct MipLevel
+{
+	std::uint32_t width;
+	std::uint32_t height;
+	std::uint64_t offset;
+	std::uint64_t size;
+};
+
+class TextureResource : public BasicResource
+{
+public:
+	// Mips are stored largest first, each one a range of data.
+	TextureResource(std::string textureName, TextureFormat format, std::vector<MipLevel> mips, std::vector<std::byte> data);
+	~TextureResource() override = default;
+	TextureResource(const TextureResource &) = default;
+	TextureResource(TextureResource &&) = default;
+	TextureResource &operator=(const TextureResource &) = default;
+	TextureResource &operator=(TextureResource &&) = default;
+
+	TextureFormat format() const;
+	std::uint32_t width() const;
+	std::uint32_t height() const;
+	std::span<const MipLevel> mips() const;
+	std::span<const std::byte> data() const;
+
+	static bool isBlockCompressed(TextureFormat format);
+	// Bytes per 4x4 block for block compressed formats, bytes per pixel otherwise.
+	static std::uint32_t blockBytes(TextureFormat format);
+	static std::uint64_t levelSize(TextureFormat format, std::uint32_t width, std::uint32_t height);
+
+private:
+	TextureFormat m_format;
+	std::vector<MipLevel> m_mips;
+	std::vector<std::byte> m_data;
+};
@@ -0,0 +1,15 @@
+#pragma once
+#include "Bounds.h"
+#include "VertexLayout.h"
+#include <span>
+#include <vector>
+
+class VertexEncoder
+{
+public:
+	// Centre and half size of the position bounds, used to spread positions over the full snorm16 range.
+	static VertexQuantization computeQuantization(const Aabb &bounds);
+	static std::vector<std::byte> encode(std::span<const Vertex> verticies, VertexLayoutKind layout, const VertexQuantization &quantization);
+	// Inverse of encode, quantized positions and colors come back with their rounding error.
+	static std::vector<Vertex> decode(std::span<const std::byte> encoded, VertexLayoutKind layout, const VertexQuantization &quantization);
+};
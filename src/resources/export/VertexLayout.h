@@ -0,0 +1,84 @@
+#pragma once
+#include "Vertex.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+enum class VertexLayoutKind : uint32_t
+{
+	// Vertex as it is: float position and color, 28 bytes.
+	Float = 0,
+	// QuantizedVertex: snorm16 position relative to the mesh bounds and unorm8 color, 12 bytes.
+	Quantized = 1
+};
+
+constexpr uint32_t VERTEX_LAYOUT_COUNT = 2;
+
+enum class VertexFormat : uint32_t
+{
+	Float32x3,
+	Float32x4,
+	Snorm16x4,
+	Unorm8x4
+};
+
+struct QuantizedVertex
+{
+	// w is padding so the color stays 4 byte aligned.
+	int16_t position[4];
+	uint8_t color[4];
+};
+
+static_assert(sizeof(QuantizedVertex) == 12);
+
+struct VertexAttribute
+{
+	uint32_t location;
+	VertexFormat format;
+	uint32_t offset;
+};
+
+// Describes how one vertex is laid out in the vertex buffer. The renderer builds its vertex input state from this.
+struct VertexLayout
+{
+	std::array<VertexAttribute, 2> attributes;
+	uint32_t stride;
+
+	static constexpr VertexLayout get(VertexLayoutKind kind)
+	{
+		switch (kind)
+		{
+		case VertexLayoutKind::Quantized:
+			return { { { { 0, VertexFormat::Snorm16x4, offsetof(QuantizedVertex, position) },
+			             { 1, VertexFormat::Unorm8x4, offsetof(QuantizedVertex, color) } } },
+			         sizeof(QuantizedVertex) };
+
+		case VertexLayoutKind::Float:
+		default:
+			return { { { { 0, VertexFormat::Float32x3, offsetof(Vertex, postion) },
+			             { 1, VertexFormat::Float32x4, offsetof(Vertex, color) } } },
+			         sizeof(Vertex) };
+		}
+	}
+};
+
+enum class IndexType : uint32_t
+{
+	Uint16 = 0,
+	Uint32 = 1
+};
+
+constexpr uint32_t INDEX_TYPE_COUNT = 2;
+
+constexpr size_t indexSize(IndexType type)
+{
+	return type == IndexType::Uint16 ? sizeof(uint16_t) : sizeof(uint32_t);
+}
+
+// Maps an encoded position back to model space: position = encoded * halfExtent + center.
+// Laid out as two vec4 so it can be pushed to the vertex shader as is.
+struct VertexQuantization
+{
+	glm::vec4 center{ 0.0F, 0.0F, 0.0F, 0.0F };
+	glm::vec4 halfExtent{ 1.0F, 1.0F, 1.0F, 0.0F };
+};
@@ -0,0 +1,49 @@
+#pragma once
+#include "MappedFile.h"
+#include "PackFormat.h"
+#include "ModelResource.h"
+
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class AssetPack
+{
+public:
+	bool open(const std::string &path);
+	void close();
+	bool isOpen() const;
+
+	std::span<const pack::TocEntry> entries() const;
+	static std::string_view entryName(const pack::TocEntry &entry);
+
+	template<typename T>
+	std::span<const T> view(const pack::Blob &blob) const
+	{
+		const auto bytes = m_file.data().subspan(blob.offset, blob.size);
+		return { reinterpret_cast<const T *>(bytes.data()), bytes.size() / sizeof(T) };
+	}
+
+private:
+	bool validate(const std::string &path) const;
+
+	MappedFile m_file;
+	std::span<const pack::TocEntry> m_entries;
+};
+
+class AssetPackWriter
+{
+public:
+	void addShader(const std::string &name, std::span<const char> code);
+	void addModel(const ModelResource &model);
+
+	bool write(const std::string &path) const;
+
+private:
+	pack::TocEntry &addEntry(const std::string &name, pack::EntryType type);
+	pack::Blob appendBlob(std::span<const std::byte> data);
+
+	std::vector<pack::TocEntry> m_entries;
+	std::vector<std::byte> m_blobs;
+};
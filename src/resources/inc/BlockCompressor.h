@@ -0,0 +1,24 @@
+#pragma once
+#include "MipGenerator.h"
+#include "TextureResource.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// CPU encoders for the BC formats. Endpoints come from the principal axis of each block's colours, so quality is
+// close to a range fit encoder while staying cheap enough to run while loading.
+class BlockCompressor
+{
+public:
+	static constexpr std::uint32_t BLOCK_DIMENSION = 4;
+	static constexpr std::uint32_t BLOCK_PIXELS = BLOCK_DIMENSION * BLOCK_DIMENSION;
+
+	// Splits the image into rows of blocks encoded on the shared ThreadPool. Edge blocks repeat the last row and column.
+	static std::vector<std::byte> compress(const Rgba8Image &image, TextureFormat format);
+
+	// Each block is 16 RGBA pixels in row order.
+	static void encodeBc1Block(const std::uint8_t *block, std::byte *output);
+	static void encodeBc3Block(const std::uint8_t *block, std::byte *output);
+	// Mode 6 only: one subset with 7.7.7.7 endpoints, a p-bit per endpoint and 4 bit indices.
+	static void encodeBc7Block(const std::uint8_t *block, std::byte *output);
+};
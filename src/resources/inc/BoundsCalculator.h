@@ -0,0 +1,14 @@
+#pragma once
+#include "Bounds.h"
+#include "Vertex.h"
+#include <span>
+
+class BoundsCalculator
+{
+public:
+	static Bounds compute(std::span<const Vertex> verticies);
+
+	static Aabb computeAabb(std::span<const Vertex> verticies);
+	// Centred on the box with the distance to the farthest vertex as radius.
+	static BoundingSphere computeSphere(std::span<const Vertex> verticies, const Aabb &box);
+};
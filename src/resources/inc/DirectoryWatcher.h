@@ -0,0 +1,21 @@
+#pragma once
+#include <string>
+#include <vector>
+
+class DirectoryWatcher
+{
+public:
+	DirectoryWatcher() = default;
+	~DirectoryWatcher();
+
+	DirectoryWatcher(const DirectoryWatcher &) = delete;
+	DirectoryWatcher &operator=(const DirectoryWatcher &) = delete;
+
+	bool watch(const std::string &directory);
+	void stop();
+
+	std::vector<std::string> pollChangedFiles();
+
+private:
+	int m_fileDescriptor = -1;
+};
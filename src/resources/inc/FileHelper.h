@@ -1,12 +1,21 @@
 #pragma once
+#include "FileBuffer.h"
+#include "LineRange.h"
 #include <vector>
 #include <string>
+#include <utility>
 
 class FileHelper
 {
 public:
+	// Empty if the file can not be opened or read.
 	static std::vector<char> readFileByte(const std::string &path);
 	static std::vector<std::string> readFileLines(const std::string &path);
+	static std::vector<std::pair<std::string, std::string>> readIndexFile(const std::string &path);
+
+	static FileBuffer readFile(const std::string &path);
+	static std::vector<FileBuffer> readFiles(const std::vector<std::string> &paths);
+	static LineRange lines(const FileBuffer &buffer);
 
 };
 
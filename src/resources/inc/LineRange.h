@@ -0,0 +1,45 @@
+#pragma once
+#include <cstddef>
+#include <iterator>
+#include <span>
+#include <string_view>
+
+class LineRange
+{
+public:
+	class iterator
+	{
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = std::string_view;
+		using difference_type = std::ptrdiff_t;
+		using pointer = const std::string_view *;
+		using reference = std::string_view;
+
+		iterator() = default;
+		iterator(std::string_view remaining);
+
+		std::string_view operator*() const;
+		iterator &operator++();
+		iterator operator++(int);
+
+		friend bool operator==(const iterator &lhs, const iterator &rhs)
+		{
+			return lhs.m_remaining.data() == rhs.m_remaining.data() && lhs.m_remaining.size() == rhs.m_remaining.size();
+		}
+
+	private:
+		void findLineEnd();
+
+		std::string_view m_remaining;
+		size_t m_lineLength = 0;
+	};
+
+	explicit LineRange(std::span<const char> text);
+
+	iterator begin() const;
+	iterator end() const;
+
+private:
+	std::string_view m_text;
+};
@@ -0,0 +1,32 @@
+#pragma once
+#include "Vertex.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct MeshStatistics
+{
+	// Average cache miss ratio: vertex shader invocations per triangle (0.5 is ideal, 3.0 is worst).
+	float acmr = 0.0F;
+	// Average transform to vertex ratio: vertex shader invocations per unique vertex (1.0 is ideal).
+	float atvr = 0.0F;
+};
+
+class MeshOptimizer
+{
+public:
+	// Size of the simulated post-transform FIFO cache used for ordering and statistics.
+	static constexpr uint32_t CACHE_SIZE = 16;
+
+	// Runs all passes below in order and logs the statistics before and after.
+	static void optimize(const std::string &name, std::vector<Vertex> &verticies, std::vector<uint32_t> &indices);
+
+	// Tipsify triangle ordering. Returns the first triangle of every cluster the ordering had to restart at.
+	static std::vector<uint32_t> optimizeVertexCache(std::vector<uint32_t> &indices, size_t vertexCount);
+	// Sorts the clusters produced by optimizeVertexCache so that outward facing ones are drawn first.
+	static void optimizeOverdraw(std::vector<uint32_t> &indices, const std::vector<uint32_t> &clusters, const std::vector<Vertex> &verticies);
+	// Renumbers verticies in first use order so that fetches walk the vertex buffer linearly.
+	static void optimizeVertexFetch(std::vector<Vertex> &verticies, std::vector<uint32_t> &indices);
+
+	static MeshStatistics analyze(const std::vector<uint32_t> &indices, size_t vertexCount);
+};
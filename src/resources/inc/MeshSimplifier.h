@@ -0,0 +1,19 @@
+#pragma once
+#include "ResourceDefs.h"
+#include <string>
+#include <vector>
+
+class MeshSimplifier
+{
+public:
+	static constexpr size_t MAX_LOD_COUNT = 4;
+	// Largest surface deviation a LOD may have, relative to the diagonal of the mesh bounds.
+	static constexpr float MAX_RELATIVE_ERROR = 0.02F;
+
+	// Quadric edge collapse down to targetIndexCount, stopping early before a collapse would move the surface
+	// further than maxError. Only existing verticies are kept so the result shares the vertex buffer of the source.
+	static std::vector<uint32_t> simplify(const std::vector<Vertex> &verticies, const std::vector<uint32_t> &indices, size_t targetIndexCount, float maxError, float &resultError);
+
+	// Appends every LOD after the first to indices and returns the table describing where each one lives.
+	static std::vector<MeshLod> generateLods(const std::string &name, const std::vector<Vertex> &verticies, std::vector<uint32_t> &indices);
+};
@@ -0,0 +1,18 @@
+#pragma once
+#include "ResourceDefs.h"
+#include <string>
+#include <vector>
+
+class MeshletBuilder
+{
+public:
+	static constexpr size_t MAX_VERTICES = 64;
+	static constexpr size_t MAX_TRIANGLES = 124;
+	// A triangle facing further away than this from the average normal of the current meshlet starts a new one,
+	// which keeps the normal cones narrow enough to cull.
+	static constexpr float MIN_NORMAL_DOT = 0.5F;
+
+	// Groups the triangles of indices[0, indexCount) into meshlets. The index buffer is left as it is,
+	// so every meshlet is a contiguous range of it and can be drawn with a single drawIndexed.
+	static std::vector<Meshlet> build(const std::string &name, const std::vector<Vertex> &verticies, const std::vector<uint32_t> &indices, size_t indexCount);
+};
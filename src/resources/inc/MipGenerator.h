@@ -0,0 +1,21 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+struct Rgba8Image
+{
+	std::uint32_t width = 0;
+	std::uint32_t height = 0;
+	// Tightly packed rows of 4 byte pixels.
+	std::vector<std::uint8_t> pixels;
+};
+
+class MipGenerator
+{
+public:
+	// Returns the full chain down to 1x1, starting with base.
+	static std::vector<Rgba8Image> generateMips(Rgba8Image base);
+
+	// 2x2 box filter with rounding. Sizes halve rounding down, so an odd last row or column is dropped.
+	static Rgba8Image downsample(const Rgba8Image &source);
+};
@@ -0,0 +1,65 @@
+#pragma once
+#include "ResourceHandle.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <optional>
+
+// Keeps track of which models are resident, who references them and how much memory they take.
+// Unreferenced models are evicted least recently used first once the resident bytes exceed the budget.
+class ModelCache
+{
+public:
+	using EvictFunction = std::function<void(ModelHandle model)>;
+	// Makes an evicted model resident again and returns its size in bytes, or nothing if it could not be loaded.
+	using ReloadFunction = std::function<std::optional<size_t>(ModelHandle model)>;
+
+	static constexpr size_t DEFAULT_BUDGET = 256 * 1024 * 1024;
+
+	ModelCache(EvictFunction evict, ReloadFunction reload, size_t budget = DEFAULT_BUDGET);
+
+	// Sizes the table for handles with an index below indexLimit.
+	// Refused while a model is referenced or being reloaded, their counters would be freed under the ModelData using them.
+	// Returns false then and keeps the table as it is.
+	bool reset(size_t indexLimit);
+	void setBudget(size_t bytes);
+	size_t residentBytes() const;
+	// Models currently held by at least one ModelData.
+	size_t referencedCount() const;
+
+	// Registers a loaded model. Models that can not be reloaded are never evicted and do not count against the budget.
+	// A model is not evicted before it has been acquired once, so loading more than the budget does not throw away fresh loads.
+	void insert(ModelHandle model, size_t bytes, bool evictable);
+	// Takes a reference for a ModelData, reloading the model first if it was evicted. nullptr if that failed.
+	// The reload runs without the lock held, other callers acquiring the same model wait for it.
+	std::atomic<uint32_t> *acquire(ModelHandle model);
+
+private:
+	struct Entry
+	{
+		std::atomic<uint32_t> references{ 0 };
+		size_t bytes = 0;
+		bool resident = false;
+		bool evictable = false;
+		// Being reloaded by an acquire outside the lock.
+		bool loading = false;
+		bool acquired = false;
+		std::list<ModelHandle>::iterator lruPosition;
+	};
+
+	void trim();
+
+	mutable std::mutex m_mutex;
+	std::condition_variable m_loaded;
+	std::deque<Entry> m_entries;
+	// Resident evictable models, most recently used first.
+	std::list<ModelHandle> m_lru;
+	size_t m_budget;
+	size_t m_residentBytes;
+	EvictFunction m_evict;
+	ReloadFunction m_reload;
+};
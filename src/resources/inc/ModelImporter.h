@@ -0,0 +1,18 @@
+#pragma once
+#include "ModelResource.h"
+#include <optional>
+#include <string>
+#include <vector>
+
+struct ModelSource
+{
+	std::string name;
+	std::string path;
+};
+
+class ModelImporter
+{
+public:
+	static std::optional<ModelResource> importObj(const ModelSource &source);
+	static std::vector<ModelResource> importObjs(const std::vector<ModelSource> &sources);
+};
@@ -1,18 +1,54 @@
 #pragma once
 #include "BasicResource.h"
-#include "Vertex.h"
+#include "ResourceDefs.h"
 #include <vector>
 #include <memory>
+#include <span>
 
 class ModelResource : public BasicResource
 {
 public:
-	ModelResource(std::string modelName, std::vector<Vertex> verticies, std::vector<uint32_t> indices);
+	// Without a LOD table the whole index buffer is the only LOD. Models without meshlets are culled as a whole.
+	ModelResource(std::string modelName, std::span<const Vertex> verticies, std::vector<uint32_t> indices, VertexLayoutKind layout = VertexLayoutKind::Float, std::vector<MeshLod> lods = {}, std::vector<Meshlet> meshlets = {});
+	ModelResource(std::string modelName, std::span<const std::byte> mappedVerticies, std::span<const std::byte> mappedIndices, std::span<const MeshLod> mappedLods, std::span<const Meshlet> mappedMeshlets,
+		VertexLayoutKind layout, const VertexQuantization &quantization, IndexType indexType, MeshEncoding encoding, const Bounds &bounds);
 	~ModelResource() override = default;
+	ModelResource(const ModelResource &) = default;
+	ModelResource(ModelResource &&) = default;
+	ModelResource &operator=(const ModelResource &) = default;
+	ModelResource &operator=(ModelResource &&) = default;
 
-	std::vector<Vertex> verticies;
-	std::vector<uint32_t> indicies;
+	std::span<const std::byte> vertexData() const;
+	std::span<const std::byte> indexData() const;
+	std::span<const MeshLod> lodData() const;
+	std::span<const Meshlet> meshletData() const;
+	VertexLayoutKind vertexLayout() const;
+	const VertexQuantization &quantization() const;
+	IndexType indexType() const;
+	// Only mapped data can be compressed, verticies and indicies are always Raw.
+	MeshEncoding encoding() const;
+	const Bounds &bounds() const;
+	size_t indexCount() const;
+	// CPU memory owned by this resource, mapped data is not counted.
+	size_t residentBytes() const;
 
-	std::uint32_t usageCounter{0};
+	// Encoded with vertexLayout().
+	std::vector<std::byte> verticies;
+	// Encoded with indexType(), 16 bit whenever every vertex is addressable with it.
+	std::vector<std::byte> indicies;
+	std::vector<MeshLod> lods;
+	// Cover the first LOD only.
+	std::vector<Meshlet> meshlets;
+
+private:
+	std::span<const std::byte> m_mappedVerticies;
+	std::span<const std::byte> m_mappedIndicies;
+	std::span<const MeshLod> m_mappedLods;
+	std::span<const Meshlet> m_mappedMeshlets;
+	VertexLayoutKind m_layout;
+	VertexQuantization m_quantization;
+	IndexType m_indexType;
+	MeshEncoding m_encoding;
+	Bounds m_bounds;
 };
 
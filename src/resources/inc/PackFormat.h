@@ -0,0 +1,58 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+
+namespace pack {
+constexpr uint32_t MAGIC = 0x4B50414E; // "NAPK"
+constexpr uint32_t VERSION = 8;
+constexpr uint64_t BLOB_ALIGNMENT = 16;
+constexpr size_t MAX_NAME_LENGTH = 64;
+
+enum class EntryType : uint32_t {
+	Shader = 0,
+	Model = 1
+};
+
+struct Blob
+{
+	uint64_t offset;
+	uint64_t size;
+};
+
+struct Header
+{
+	uint32_t magic;
+	uint32_t version;
+	uint32_t entryCount;
+	uint32_t reserved;
+	uint64_t tocOffset;
+	uint64_t padding;
+};
+
+// Shaders keep their SPIR-V in primary, models keep vertices in primary, indices in secondary, MeshLods in tertiary
+// and Meshlets in quaternary.
+// Model vertices are encoded with vertexLayout (a VertexLayoutKind) and decoded with the quantization fields,
+// model indices are encoded with indexType (an IndexType). With meshEncoding (a MeshEncoding) set to Compressed
+// primary and secondary hold MeshCodec streams of them. The bounds fields hold the model space Bounds.
+struct TocEntry
+{
+	char name[MAX_NAME_LENGTH];
+	EntryType type;
+	uint32_t vertexLayout;
+	uint32_t indexType;
+	uint32_t meshEncoding;
+	Blob primary;
+	Blob secondary;
+	Blob tertiary;
+	Blob quaternary;
+	float quantizationCenter[3];
+	float quantizationHalfExtent[3];
+	float boundsMin[3];
+	float boundsMax[3];
+	float sphereCenter[3];
+	float sphereRadius;
+};
+
+static_assert(sizeof(Header) % BLOB_ALIGNMENT == 0);
+static_assert(sizeof(TocEntry) % BLOB_ALIGNMENT == 0);
+}
@@ -1,30 +1,91 @@
 #pragma once
 #include "ResourceManagerAPI.h"
 #include "ModelResource.h"
+#include "AssetPack.h"
+#include "ResourceSlot.h"
+#include "DirectoryWatcher.h"
+#include "ModelCache.h"
+#include "SlotMap.h"
+#include <atomic>
+#include <unordered_map>
 
 class ResourceManager : public ResourceManagerAPI
 {
 public:
 	ResourceManager() = default;
-	~ResourceManager() override = default;
+	~ResourceManager() override;
 
 	void LoadResources() override;
-	const ShaderResource& getShader(const std::string &shaderName) const override;
+	std::shared_future<LoadProgress> LoadResourcesAsync(LoadCallback onComplete) override;
+	LoadProgress getLoadProgress() const override;
+	std::shared_future<LoadStatus> getShaderStatus(ShaderHandle shader) const override;
+	std::shared_future<LoadStatus> getModelStatus(ModelHandle model) const override;
+	std::shared_future<LoadStatus> getTextureStatus(TextureHandle texture) const override;
+	void whenShaderReady(ShaderHandle shader, std::function<void(LoadStatus)> callback) override;
+	void whenModelReady(ModelHandle model, std::function<void(LoadStatus)> callback) override;
+
+	ShaderHandle findShader(std::string_view shaderName) const override;
+	ModelHandle findModel(std::string_view modelName) const override;
+	std::string_view getModelName(ModelHandle model) const override;
+	std::shared_ptr<const ShaderResource> getShader(ShaderHandle shader) const override;
+	ModelData getModel(ModelHandle model) override;
+	TextureHandle findTexture(std::string_view textureName) const override;
+	const TextureResource *getTexture(TextureHandle texture) const override;
+
+	std::vector<ShaderHandle> pollShaderChanges() override;
+
+	void setModelMemoryBudget(size_t bytes) override;
+	void setTextureQuality(TextureQuality quality) override;
+
+	std::shared_ptr<const ShaderResource> getShader(const std::string &shaderName) const override;
 	ModelData getModel(const std::string &modelName) override;
+	const TextureResource *getTexture(const std::string &textureName) const override;
 
 	void cleanUp() override;
 
 
 private:
-	
-	std::vector<ShaderResource> m_shaderModules;
-	std::vector<ModelResource>  m_models;
+	// Shaders are shared so a hot reload can replace one while earlier callers still hold the old code.
+	using ShaderSlot = ResourceSlot<std::shared_ptr<const ShaderResource>>;
+	using ModelSlot = ResourceSlot<ModelResource>;
+	using TextureSlot = ResourceSlot<TextureResource>;
+
+	SlotMap<ShaderSlot, ShaderHandle> m_shaderModules;
+	SlotMap<ModelSlot, ModelHandle>  m_models;
+	SlotMap<TextureSlot, TextureHandle> m_textures;
+	AssetPack m_pack;
+	DirectoryWatcher m_shaderWatcher;
+	ModelCache m_modelCache{ [this](ModelHandle model) { evictModel(model); }, [this](ModelHandle model) { return reloadModel(model); } };
+	std::unordered_map<InternedName, ShaderHandle> m_shaderLookup;
+	std::unordered_map<InternedName, ModelHandle> m_modelLookup;
+	std::unordered_map<InternedName, TextureHandle> m_textureLookup;
+	TextureQuality m_textureQuality = TextureQuality::Fast;
+
+	std::atomic<uint32_t> m_loadedCount{ 0 };
+	std::atomic<uint32_t> m_failedCount{ 0 };
+	std::atomic<uint32_t> m_finishedCount{ 0 };
+	uint32_t m_totalCount{ 0 };
+	LoadCallback m_onLoadComplete;
+	std::promise<LoadProgress> m_loadComplete;
+	std::shared_future<LoadProgress> m_loadFuture;
 
-	void loadShaders();
-	void loadModels();
-	void createShader(const std::string &metaData);
+	void enumerateShaders();
+	void enumerateModels();
+	void enumerateBuiltInModels();
+	void enumerateTextures();
+	void enumeratePack();
+	void indexResources();
+	void scheduleLoads();
+	void loadShaders(const std::vector<ShaderSlot *> &slots);
+	void loadModel(ModelHandle model);
+	void loadTexture(TextureHandle texture);
+	void evictModel(ModelHandle model);
+	std::optional<size_t> reloadModel(ModelHandle model);
+	void finishResource(LoadStatus status);
+	void waitForLoads() const;
 	void unloadShaders();
 	void unloadModels();
+	void unloadTextures();
 
 };
 using ResourceManagerPtr = std::shared_ptr<ResourceManager>;
@@ -0,0 +1,66 @@
+#pragma once
+#include "InternedName.h"
+#include "ResourceDefs.h"
+
+#include <functional>
+#include <future>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+template<typename Resource>
+struct ResourceSlot
+{
+	ResourceSlot(InternedName slotName, std::string path) :
+		name{ slotName },
+		sourcePath{ std::move(path) },
+		ready{ m_loaded.get_future().share() }
+	{
+	}
+
+	void complete(LoadStatus status)
+	{
+		std::vector<std::function<void(LoadStatus)>> callbacks;
+		{
+			std::lock_guard lock(m_mutex);
+			m_status = status;
+			callbacks.swap(m_callbacks);
+		}
+
+		m_loaded.set_value(status);
+		for (auto &callback : callbacks)
+		{
+			callback(status);
+		}
+	}
+
+	void whenReady(std::function<void(LoadStatus)> callback)
+	{
+		LoadStatus status;
+		{
+			std::lock_guard lock(m_mutex);
+			if (m_status == LoadStatus::Pending)
+			{
+				m_callbacks.push_back(std::move(callback));
+				return;
+			}
+			status = m_status;
+		}
+
+		callback(status);
+	}
+
+	InternedName name;
+	std::string sourcePath;
+	std::optional<Resource> resource;
+
+private:
+	std::promise<LoadStatus> m_loaded;
+	std::mutex m_mutex;
+	LoadStatus m_status = LoadStatus::Pending;
+	std::vector<std::function<void(LoadStatus)>> m_callbacks;
+
+public:
+	std::shared_future<LoadStatus> ready;
+};
@@ -0,0 +1,247 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <utility>
+
+// Owns its values and hands out index + generation handles.
+// emplace() and erase() are lock free and may be called from any number of threads, values never move once constructed.
+// A slot's generation is odd while it is occupied and bumped on every erase, so a stale handle is detected by a single compare.
+// get() pointers stay valid until the handle is erased, clear() must not race with anything else.
+template<typename T, typename Handle>
+class SlotMap
+{
+public:
+	static constexpr uint32_t CHUNK_SIZE = 1024;
+	static constexpr uint32_t MAX_CHUNKS = 4096;
+	static constexpr uint32_t CAPACITY = CHUNK_SIZE * MAX_CHUNKS;
+
+	// Generations wrap around, the occupied and free states still alternate since UINT32_MAX is odd and 0 is even.
+	static constexpr uint32_t nextGeneration(uint32_t generation)
+	{
+		return generation + 1;
+	}
+
+	static constexpr bool isOccupied(uint32_t generation)
+	{
+		return (generation & 1U) != 0;
+	}
+
+	SlotMap() = default;
+	SlotMap(const SlotMap &) = delete;
+	SlotMap &operator=(const SlotMap &) = delete;
+
+	~SlotMap()
+	{
+		clear();
+		for (auto &chunk : m_chunks)
+		{
+			delete chunk.load(std::memory_order_relaxed);
+		}
+	}
+
+	template<typename... Args>
+	Handle emplace(Args &&... args)
+	{
+		const auto index = allocateIndex();
+		if (index == Handle::INVALID_INDEX)
+		{
+			assert(false && "SlotMap is full");
+			return Handle{};
+		}
+
+		auto &slot = slotAt(index);
+		new (slot.storage) T(std::forward<Args>(args)...);
+
+		const auto generation = nextGeneration(slot.generation.load(std::memory_order_relaxed));
+		slot.generation.store(generation, std::memory_order_release);
+		m_count.fetch_add(1, std::memory_order_relaxed);
+
+		return Handle{ index, generation };
+	}
+
+	bool erase(Handle handle)
+	{
+		auto *slot = findSlot(handle.index);
+		auto expected = handle.generation;
+		if (slot == nullptr || !isOccupied(expected) || !slot->generation.compare_exchange_strong(expected, nextGeneration(expected), std::memory_order_acq_rel))
+		{
+			return false;
+		}
+
+		value(*slot).~T();
+		releaseIndex(handle.index);
+		m_count.fetch_sub(1, std::memory_order_relaxed);
+
+		return true;
+	}
+
+	T *get(Handle handle)
+	{
+		auto *slot = findSlot(handle.index);
+		return slot != nullptr && isCurrent(*slot, handle) ? &value(*slot) : nullptr;
+	}
+
+	const T *get(Handle handle) const
+	{
+		const auto *slot = findSlot(handle.index);
+		return slot != nullptr && isCurrent(*slot, handle) ? &value(*slot) : nullptr;
+	}
+
+	bool contains(Handle handle) const
+	{
+		return get(handle) != nullptr;
+	}
+
+	size_t size() const
+	{
+		return m_count.load(std::memory_order_relaxed);
+	}
+
+	bool empty() const
+	{
+		return size() == 0;
+	}
+
+	// One past the highest index handed out so far, the size needed by tables indexed with Handle::index.
+	uint32_t indexLimit() const
+	{
+		return std::min(m_nextIndex.load(std::memory_order_acquire), CAPACITY);
+	}
+
+	template<typename Function>
+	void forEach(Function &&function)
+	{
+		for (uint32_t index = 0; index < indexLimit(); ++index)
+		{
+			auto *slot = findSlot(index);
+			const auto generation = slot != nullptr ? slot->generation.load(std::memory_order_acquire) : 0;
+			if (isOccupied(generation))
+			{
+				function(Handle{ index, generation }, value(*slot));
+			}
+		}
+	}
+
+	template<typename Function>
+	void forEach(Function &&function) const
+	{
+		for (uint32_t index = 0; index < indexLimit(); ++index)
+		{
+			const auto *slot = findSlot(index);
+			const auto generation = slot != nullptr ? slot->generation.load(std::memory_order_acquire) : 0;
+			if (isOccupied(generation))
+			{
+				function(Handle{ index, generation }, value(*slot));
+			}
+		}
+	}
+
+	// Generations are kept, so handles from before the clear stay stale.
+	void clear()
+	{
+		forEach([this](Handle handle, T &)
+		{
+			erase(handle);
+		});
+		m_freeHead.store(0, std::memory_order_relaxed);
+		m_nextIndex.store(0, std::memory_order_relaxed);
+	}
+
+private:
+	struct Slot
+	{
+		std::atomic<uint32_t> generation{ 0 };
+		std::atomic<uint32_t> nextFree{ 0 };
+		alignas(T) std::byte storage[sizeof(T)];
+	};
+
+	using Chunk = std::array<Slot, CHUNK_SIZE>;
+
+	static T &value(Slot &slot)
+	{
+		return *std::launder(reinterpret_cast<T *>(slot.storage));
+	}
+
+	static const T &value(const Slot &slot)
+	{
+		return *std::launder(reinterpret_cast<const T *>(slot.storage));
+	}
+
+	static bool isCurrent(const Slot &slot, Handle handle)
+	{
+		return isOccupied(handle.generation) && slot.generation.load(std::memory_order_acquire) == handle.generation;
+	}
+
+	Slot *findSlot(uint32_t index) const
+	{
+		if (index >= CAPACITY)
+		{
+			return nullptr;
+		}
+
+		auto *chunk = m_chunks[index / CHUNK_SIZE].load(std::memory_order_acquire);
+		return chunk != nullptr ? &(*chunk)[index % CHUNK_SIZE] : nullptr;
+	}
+
+	Slot &slotAt(uint32_t index)
+	{
+		auto &chunkPointer = m_chunks[index / CHUNK_SIZE];
+		auto *chunk = chunkPointer.load(std::memory_order_acquire);
+		if (chunk == nullptr)
+		{
+			// Several threads may race to create the chunk, the first one to publish it wins.
+			auto *created = new Chunk();
+			if (chunkPointer.compare_exchange_strong(chunk, created, std::memory_order_acq_rel, std::memory_order_acquire))
+			{
+				chunk = created;
+			}
+			else
+			{
+				delete created;
+			}
+		}
+
+		return (*chunk)[index % CHUNK_SIZE];
+	}
+
+	// The free list head packs an ABA tag in the upper 32 bits and index + 1 in the lower ones, 0 means empty.
+	uint32_t allocateIndex()
+	{
+		auto head = m_freeHead.load(std::memory_order_acquire);
+		while (static_cast<uint32_t>(head) != 0)
+		{
+			const auto index = static_cast<uint32_t>(head) - 1;
+			const auto next = slotAt(index).nextFree.load(std::memory_order_relaxed);
+			const auto newHead = (((head >> 32) + 1) << 32) | next;
+			if (m_freeHead.compare_exchange_weak(head, newHead, std::memory_order_acq_rel, std::memory_order_acquire))
+			{
+				return index;
+			}
+		}
+
+		const auto index = m_nextIndex.fetch_add(1, std::memory_order_acq_rel);
+		return index < CAPACITY ? index : Handle::INVALID_INDEX;
+	}
+
+	void releaseIndex(uint32_t index)
+	{
+		auto &slot = slotAt(index);
+		auto head = m_freeHead.load(std::memory_order_relaxed);
+		uint64_t newHead;
+		do
+		{
+			slot.nextFree.store(static_cast<uint32_t>(head), std::memory_order_relaxed);
+			newHead = (((head >> 32) + 1) << 32) | (uint64_t{ index } + 1);
+		} while (!m_freeHead.compare_exchange_weak(head, newHead, std::memory_order_release, std::memory_order_relaxed));
+	}
+
+	std::array<std::atomic<Chunk *>, MAX_CHUNKS> m_chunks{};
+	std::atomic<uint64_t> m_freeHead{ 0 };
+	std::atomic<uint32_t> m_nextIndex{ 0 };
+	std::atomic<size_t> m_count{ 0 };
+};
@@ -0,0 +1,23 @@
+#pragma once
+#include "MipGenerator.h"
+#include "TextureResource.h"
+#include <optional>
+#include <string>
+
+struct TextureSource
+{
+	std::string name;
+	std::string path;
+};
+
+class TextureImporter
+{
+public:
+	// Decodes any format stb_image understands and cooks it with cook().
+	static std::optional<TextureResource> importImage(const TextureSource &source, TextureQuality quality);
+
+	// Builds the mip chain and block compresses every level.
+	static TextureResource cook(std::string name, Rgba8Image image, TextureQuality quality);
+
+	static TextureFormat chooseFormat(const Rgba8Image &image, TextureQuality quality);
+};
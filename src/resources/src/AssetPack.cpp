@@ -0,0 +1,281 @@
+#include "AssetPack.h"
+#include "LoggerAPI.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+namespace {
+uint64_t alignUp(uint64_t value)
+{
+	return (value + pack::BLOB_ALIGNMENT - 1) & ~(pack::BLOB_ALIGNMENT - 1);
+}
+
+bool blobInBounds(const pack::Blob &blob, uint64_t fileSize)
+{
+	return blob.offset <= fileSize && blob.size <= fileSize - blob.offset && blob.offset % pack::BLOB_ALIGNMENT == 0;
+}
+
+template<typename T>
+std::span<const T> blobView(std::span<const std::byte> bytes, const pack::Blob &blob)
+{
+	const auto data = bytes.subspan(blob.offset, blob.size);
+	return { reinterpret_cast<const T *>(data.data()), data.size() / sizeof(T) };
+}
+
+// LODs and meshlets are index ranges into the entry's index buffer and are drawn without further checks.
+bool indexRangesInBounds(std::span<const std::byte> bytes, const pack::TocEntry &entry)
+{
+	const auto indexData = blobView<std::byte>(bytes, entry.secondary);
+	const auto indexBytes = static_cast<MeshEncoding>(entry.meshEncoding) == MeshEncoding::Compressed ? MeshCodec::decodedSize(indexData) : indexData.size();
+	const auto indexCount = static_cast<uint64_t>(indexBytes / indexSize(static_cast<IndexType>(entry.indexType)));
+
+	const auto inBounds = [indexCount](const auto &range)
+	{
+		return static_cast<uint64_t>(range.firstIndex) + range.indexCount <= indexCount;
+	};
+
+	const auto lods = blobView<MeshLod>(bytes, entry.tertiary);
+	const auto meshlets = blobView<Meshlet>(bytes, entry.quaternary);
+	return std::all_of(lods.begin(), lods.end(), inBounds) && std::all_of(meshlets.begin(), meshlets.end(), inBounds);
+}
+
+// Raw indices are drawn as they are, so each of them has to name one of the entry's vertices.
+// Compressed ones are checked against the vertex count while they are decoded.
+bool rawIndicesInBounds(std::span<const std::byte> bytes, const pack::TocEntry &entry)
+{
+	if (static_cast<MeshEncoding>(entry.meshEncoding) != MeshEncoding::Raw)
+	{
+		return true;
+	}
+
+	const auto stride = VertexLayout::get(static_cast<VertexLayoutKind>(entry.vertexLayout)).stride;
+	const auto indexType = static_cast<IndexType>(entry.indexType);
+	const auto size = indexSize(indexType);
+	if (entry.primary.size % stride != 0 || entry.secondary.size % size != 0)
+	{
+		return false;
+	}
+
+	const auto vertexCount = entry.primary.size / stride;
+	const auto indexData = blobView<std::byte>(bytes, entry.secondary);
+	for (size_t offset = 0; offset < indexData.size(); offset += size)
+	{
+		auto index = uint64_t{ 0 };
+		if (indexType == IndexType::Uint16)
+		{
+			uint16_t value;
+			std::memcpy(&value, indexData.data() + offset, sizeof(value));
+			index = value;
+		}
+		else
+		{
+			uint32_t value;
+			std::memcpy(&value, indexData.data() + offset, sizeof(value));
+			index = value;
+		}
+
+		if (index >= vertexCount)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+}
+
+bool AssetPack::open(const std::string &path)
+{
+	close();
+
+	if (!m_file.open(path))
+	{
+		return false;
+	}
+
+	if (!validate(path))
+	{
+		close();
+		return false;
+	}
+
+	const auto bytes = m_file.data();
+	pack::Header header;
+	std::memcpy(&header, bytes.data(), sizeof(header));
+
+	m_entries = { reinterpret_cast<const pack::TocEntry *>(bytes.data() + header.tocOffset), header.entryCount };
+	LoggerAPI::getLogger()->logInfo("Mapped asset pack " + path + " with " + std::to_string(header.entryCount) + " entries");
+
+	return true;
+}
+
+void AssetPack::close()
+{
+	m_entries = {};
+	m_file.close();
+}
+
+bool AssetPack::isOpen() const
+{
+	return m_file.isOpen();
+}
+
+std::span<const pack::TocEntry> AssetPack::entries() const
+{
+	return m_entries;
+}
+
+std::string_view AssetPack::entryName(const pack::TocEntry &entry)
+{
+	return { entry.name, strnlen(entry.name, pack::MAX_NAME_LENGTH) };
+}
+
+bool AssetPack::validate(const std::string &path) const
+{
+	const auto bytes = m_file.data();
+	const auto fileSize = static_cast<uint64_t>(bytes.size());
+
+	pack::Header header;
+	if (fileSize < sizeof(header))
+	{
+		LoggerAPI::getLogger()->logError("Asset pack " + path + " is truncated");
+		return false;
+	}
+	std::memcpy(&header, bytes.data(), sizeof(header));
+
+	if (header.magic != pack::MAGIC || header.version != pack::VERSION)
+	{
+		LoggerAPI::getLogger()->logError("Asset pack " + path + " has unsupported format");
+		return false;
+	}
+
+	const auto tocSize = static_cast<uint64_t>(header.entryCount) * sizeof(pack::TocEntry);
+	if (!blobInBounds({ header.tocOffset, tocSize }, fileSize))
+	{
+		LoggerAPI::getLogger()->logError("Asset pack " + path + " has corrupted table of contents");
+		return false;
+	}
+
+	const auto *entries = reinterpret_cast<const pack::TocEntry *>(bytes.data() + header.tocOffset);
+	return std::all_of(entries, entries + header.entryCount, [&](const pack::TocEntry &entry)
+	{
+		const bool valid = blobInBounds(entry.primary, fileSize) && blobInBounds(entry.secondary, fileSize) && blobInBounds(entry.tertiary, fileSize) && blobInBounds(entry.quaternary, fileSize) &&
+			(entry.type != pack::EntryType::Model || (entry.vertexLayout < VERTEX_LAYOUT_COUNT && entry.indexType < INDEX_TYPE_COUNT && entry.meshEncoding < MESH_ENCODING_COUNT && indexRangesInBounds(bytes, entry) && rawIndicesInBounds(bytes, entry)));
+		if (!valid)
+		{
+			LoggerAPI::getLogger()->logError("Asset pack " + path + " has corrupted entry " + std::string(entryName(entry)));
+		}
+		return valid;
+	});
+}
+
+void AssetPackWriter::addShader(const std::string &name, std::span<const char> code)
+{
+	auto &entry = addEntry(name, pack::EntryType::Shader);
+	entry.primary = appendBlob(std::as_bytes(code));
+}
+
+void AssetPackWriter::addModel(const ModelResource &model)
+{
+	auto &entry = addEntry(model.name.str(), pack::EntryType::Model);
+	entry.vertexLayout = static_cast<uint32_t>(model.vertexLayout());
+	entry.indexType = static_cast<uint32_t>(model.indexType());
+	entry.meshEncoding = static_cast<uint32_t>(model.encoding());
+
+	// Packs are read far more often than they are written, so meshes are compressed here once.
+	auto verticies = std::vector<std::byte>();
+	auto indices = std::vector<std::byte>();
+	if (model.encoding() == MeshEncoding::Raw)
+	{
+		verticies = MeshCodec::encodeVerticies(model.vertexData(), VertexLayout::get(model.vertexLayout()).stride);
+		indices = MeshCodec::encodeIndices(model.indexData(), model.indexType());
+	}
+
+	if (!verticies.empty() && !indices.empty())
+	{
+		entry.meshEncoding = static_cast<uint32_t>(MeshEncoding::Compressed);
+		entry.primary = appendBlob(verticies);
+		entry.secondary = appendBlob(indices);
+	}
+	else
+	{
+		entry.primary = appendBlob(model.vertexData());
+		entry.secondary = appendBlob(model.indexData());
+	}
+	entry.tertiary = appendBlob(std::as_bytes(model.lodData()));
+	entry.quaternary = appendBlob(std::as_bytes(model.meshletData()));
+
+	const auto &quantization = model.quantization();
+	for (glm::length_t i = 0; i < 3; ++i)
+	{
+		entry.quantizationCenter[i] = quantization.center[i];
+		entry.quantizationHalfExtent[i] = quantization.halfExtent[i];
+	}
+
+	const auto &bounds = model.bounds();
+	for (glm::length_t i = 0; i < 3; ++i)
+	{
+		entry.boundsMin[i] = bounds.box.min[i];
+		entry.boundsMax[i] = bounds.box.max[i];
+		entry.sphereCenter[i] = bounds.sphere.center[i];
+	}
+	entry.sphereRadius = bounds.sphere.radius;
+}
+
+bool AssetPackWriter::write(const std::string &path) const
+{
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	if (!file.is_open())
+	{
+		LoggerAPI::getLogger()->logError("Could not open " + path + " for writing");
+		return false;
+	}
+
+	pack::Header header{};
+	header.magic = pack::MAGIC;
+	header.version = pack::VERSION;
+	header.entryCount = static_cast<uint32_t>(m_entries.size());
+	header.tocOffset = sizeof(pack::Header) + alignUp(m_blobs.size());
+
+	auto entries = m_entries;
+	for (auto &entry : entries)
+	{
+		entry.primary.offset += sizeof(pack::Header);
+		entry.secondary.offset += sizeof(pack::Header);
+		entry.tertiary.offset += sizeof(pack::Header);
+		entry.quaternary.offset += sizeof(pack::Header);
+	}
+
+	const auto padding = std::vector<char>(header.tocOffset - sizeof(pack::Header) - m_blobs.size(), 0);
+
+	file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+	file.write(reinterpret_cast<const char *>(m_blobs.data()), static_cast<std::streamsize>(m_blobs.size()));
+	file.write(padding.data(), static_cast<std::streamsize>(padding.size()));
+	file.write(reinterpret_cast<const char *>(entries.data()), static_cast<std::streamsize>(entries.size() * sizeof(pack::TocEntry)));
+
+	return file.good();
+}
+
+pack::TocEntry &AssetPackWriter::addEntry(const std::string &name, pack::EntryType type)
+{
+	if (name.size() >= pack::MAX_NAME_LENGTH)
+	{
+		LoggerAPI::getLogger()->logWarning("Resource name " + name + " is too long and will be truncated in the pack");
+	}
+
+	auto &entry = m_entries.emplace_back();
+	std::memset(&entry, 0, sizeof(entry));
+	name.copy(entry.name, pack::MAX_NAME_LENGTH - 1);
+	entry.type = type;
+
+	return entry;
+}
+
+pack::Blob AssetPackWriter::appendBlob(std::span<const std::byte> data)
+{
+	const auto offset = alignUp(m_blobs.size());
+	m_blobs.resize(offset + data.size());
+	std::copy(std::begin(data), std::end(data), std::begin(m_blobs) + static_cast<std::ptrdiff_t>(offset));
+
+	return { offset, data.size() };
+}
@@ -0,0 +1,414 @@
+#include "BlockCompressor.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+namespace {
+constexpr std::uint32_t CHANNELS = 4;
+constexpr size_t BLOCK_ROWS_PER_TASK = 8;
+constexpr int POWER_ITERATIONS = 8;
+constexpr std::array<int, 16> BC7_WEIGHTS = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+template<size_t Dimensions>
+using Color = std::array<float, Dimensions>;
+
+// Fits a line through the block's colours and returns the extreme projections onto it, low end first.
+template<size_t Dimensions>
+std::pair<Color<Dimensions>, Color<Dimensions>> findEndpoints(const std::uint8_t *block)
+{
+	auto mean = Color<Dimensions>{};
+	for (std::uint32_t pixel = 0; pixel < BlockCompressor::BLOCK_PIXELS; ++pixel)
+	{
+		for (size_t channel = 0; channel < Dimensions; ++channel)
+		{
+			mean[channel] += block[pixel * CHANNELS + channel];
+		}
+	}
+	for (auto &channel : mean)
+	{
+		channel /= BlockCompressor::BLOCK_PIXELS;
+	}
+
+	float covariance[Dimensions][Dimensions] = {};
+	for (std::uint32_t pixel = 0; pixel < BlockCompressor::BLOCK_PIXELS; ++pixel)
+	{
+		for (size_t row = 0; row < Dimensions; ++row)
+		{
+			for (size_t column = 0; column < Dimensions; ++column)
+			{
+				covariance[row][column] += (block[pixel * CHANNELS + row] - mean[row]) * (block[pixel * CHANNELS + column] - mean[column]);
+			}
+		}
+	}
+
+	auto axis = Color<Dimensions>{};
+	axis.fill(1.0F);
+	for (int iteration = 0; iteration < POWER_ITERATIONS; ++iteration)
+	{
+		auto next = Color<Dimensions>{};
+		auto length = 0.0F;
+		for (size_t row = 0; row < Dimensions; ++row)
+		{
+			for (size_t column = 0; column < Dimensions; ++column)
+			{
+				next[row] += covariance[row][column] * axis[column];
+			}
+			length = std::max(length, std::abs(next[row]));
+		}
+
+		if (length == 0.0F)
+		{
+			// Every pixel has the same colour.
+			return { mean, mean };
+		}
+		for (size_t channel = 0; channel < Dimensions; ++channel)
+		{
+			axis[channel] = next[channel] / length;
+		}
+	}
+
+	auto lengthSquared = 0.0F;
+	for (const auto channel : axis)
+	{
+		lengthSquared += channel * channel;
+	}
+
+	auto low = std::numeric_limits<float>::max();
+	auto high = std::numeric_limits<float>::lowest();
+	for (std::uint32_t pixel = 0; pixel < BlockCompressor::BLOCK_PIXELS; ++pixel)
+	{
+		auto projection = 0.0F;
+		for (size_t channel = 0; channel < Dimensions; ++channel)
+		{
+			projection += (block[pixel * CHANNELS + channel] - mean[channel]) * axis[channel];
+		}
+		low = std::min(low, projection);
+		high = std::max(high, projection);
+	}
+
+	auto result = std::pair<Color<Dimensions>, Color<Dimensions>>();
+	for (size_t channel = 0; channel < Dimensions; ++channel)
+	{
+		result.first[channel] = std::clamp(mean[channel] + axis[channel] * low / lengthSquared, 0.0F, 255.0F);
+		result.second[channel] = std::clamp(mean[channel] + axis[channel] * high / lengthSquared, 0.0F, 255.0F);
+	}
+	return result;
+}
+
+template<size_t Dimensions>
+int distanceSquared(const std::uint8_t *pixel, const std::array<int, CHANNELS> &color)
+{
+	auto distance = 0;
+	for (size_t channel = 0; channel < Dimensions; ++channel)
+	{
+		const auto difference = pixel[channel] - color[channel];
+		distance += difference * difference;
+	}
+	return distance;
+}
+
+std::uint16_t toRgb565(const Color<3> &color)
+{
+	const auto red = static_cast<std::uint16_t>(std::lround(color[0] * 31.0F / 255.0F));
+	const auto green = static_cast<std::uint16_t>(std::lround(color[1] * 63.0F / 255.0F));
+	const auto blue = static_cast<std::uint16_t>(std::lround(color[2] * 31.0F / 255.0F));
+	return static_cast<std::uint16_t>((red << 11) | (green << 5) | blue);
+}
+
+std::array<int, CHANNELS> fromRgb565(std::uint16_t color)
+{
+	const auto red = (color >> 11) & 0x1F;
+	const auto green = (color >> 5) & 0x3F;
+	const auto blue = color & 0x1F;
+	return { (red << 3) | (red >> 2), (green << 2) | (green >> 4), (blue << 3) | (blue >> 2), 255 };
+}
+
+void writeLittleEndian(std::byte *output, std::uint64_t value, size_t bytes)
+{
+	for (size_t i = 0; i < bytes; ++i)
+	{
+		output[i] = static_cast<std::byte>((value >> (i * 8)) & 0xFF);
+	}
+}
+
+// Always uses the four colour palette, BC3 ignores the endpoint order and BC1 gets color0 > color1.
+void encodeColorBlock(const std::uint8_t *block, std::byte *output)
+{
+	const auto [low, high] = findEndpoints<3>(block);
+	auto color0 = toRgb565(high);
+	auto color1 = toRgb565(low);
+	if (color0 < color1)
+	{
+		std::swap(color0, color1);
+	}
+
+	std::uint32_t indices = 0;
+	if (color0 != color1)
+	{
+		const auto endpoint0 = fromRgb565(color0);
+		const auto endpoint1 = fromRgb565(color1);
+		auto palette = std::array<std::array<int, CHANNELS>, 4>{ endpoint0, endpoint1, endpoint0, endpoint1 };
+		for (std::uint32_t channel = 0; channel < 3; ++channel)
+		{
+			palette[2][channel] = (2 * endpoint0[channel] + endpoint1[channel]) / 3;
+			palette[3][channel] = (endpoint0[channel] + 2 * endpoint1[channel]) / 3;
+		}
+
+		for (std::uint32_t pixel = 0; pixel < BlockCompressor::BLOCK_PIXELS; ++pixel)
+		{
+			std::uint32_t best = 0;
+			auto bestDistance = std::numeric_limits<int>::max();
+			for (std::uint32_t index = 0; index < palette.size(); ++index)
+			{
+				const auto distance = distanceSquared<3>(block + pixel * CHANNELS, palette[index]);
+				if (distance < bestDistance)
+				{
+					best = index;
+					bestDistance = distance;
+				}
+			}
+			indices |= best << (pixel * 2);
+		}
+	}
+
+	writeLittleEndian(output, color0, 2);
+	writeLittleEndian(output + 2, color1, 2);
+	writeLittleEndian(output + 4, indices, 4);
+}
+
+void encodeAlphaBlock(const std::uint8_t *block, std::byte *output)
+{
+	int alpha0 = 0;
+	int alpha1 = 255;
+	for (std::uint32_t pixel = 0; pixel < BlockCompressor::BLOCK_PIXELS; ++pixel)
+	{
+		alpha0 = std::max<int>(alpha0, block[pixel * CHANNELS + 3]);
+		alpha1 = std::min<int>(alpha1, block[pixel * CHANNELS + 3]);
+	}
+
+	std::uint64_t indices = 0;
+	if (alpha0 != alpha1)
+	{
+		// alpha0 > alpha1 selects the eight value palette: both endpoints followed by six interpolated values.
+		auto palette = std::array<int, 8>{ alpha0, alpha1 };
+		for (size_t index = 2; index < palette.size(); ++index)
+		{
+			const auto weight = static_cast<int>(index);
+			palette[index] = ((8 - weight) * alpha0 + (weight - 1) * alpha1) / 7;
+		}
+
+		for (std::uint32_t pixel = 0; pixel < BlockCompressor::BLOCK_PIXELS; ++pixel)
+		{
+			const auto alpha = block[pixel * CHANNELS + 3];
+			std::uint64_t best = 0;
+			auto bestDistance = std::numeric_limits<int>::max();
+			for (std::uint64_t index = 0; index < palette.size(); ++index)
+			{
+				const auto distance = std::abs(alpha - palette[index]);
+				if (distance < bestDistance)
+				{
+					best = index;
+					bestDistance = distance;
+				}
+			}
+			indices |= best << (pixel * 3);
+		}
+	}
+
+	output[0] = static_cast<std::byte>(alpha0);
+	output[1] = static_cast<std::byte>(alpha1);
+	writeLittleEndian(output + 2, indices, 6);
+}
+
+class BitWriter
+{
+public:
+	explicit BitWriter(std::byte *output) :
+		m_output(output)
+	{
+		std::fill(m_output, m_output + 16, std::byte{ 0 });
+	}
+
+	void write(std::uint32_t value, std::uint32_t bits)
+	{
+		for (std::uint32_t bit = 0; bit < bits; ++bit, ++m_position)
+		{
+			if ((value >> bit) & 1U)
+			{
+				m_output[m_position / 8] |= static_cast<std::byte>(1U << (m_position % 8));
+			}
+		}
+	}
+
+private:
+	std::byte *m_output;
+	std::uint32_t m_position = 0;
+};
+
+struct Bc7Endpoint
+{
+	std::array<std::uint32_t, CHANNELS> quantized;
+	std::uint32_t pBit;
+
+	std::array<int, CHANNELS> expand() const
+	{
+		auto result = std::array<int, CHANNELS>();
+		for (std::uint32_t channel = 0; channel < CHANNELS; ++channel)
+		{
+			result[channel] = static_cast<int>((quantized[channel] << 1) | pBit);
+		}
+		return result;
+	}
+};
+
+// Picks the p-bit that, shared by all four channels, lands closest to the unquantized endpoint.
+Bc7Endpoint quantizeBc7Endpoint(const Color<4> &color)
+{
+	auto best = Bc7Endpoint();
+	auto bestError = std::numeric_limits<float>::max();
+	for (std::uint32_t pBit = 0; pBit < 2; ++pBit)
+	{
+		auto candidate = Bc7Endpoint{ {}, pBit };
+		auto error = 0.0F;
+		for (std::uint32_t channel = 0; channel < CHANNELS; ++channel)
+		{
+			candidate.quantized[channel] = static_cast<std::uint32_t>(std::clamp(std::lround((color[channel] - static_cast<float>(pBit)) / 2.0F), 0L, 127L));
+			const auto difference = static_cast<float>((candidate.quantized[channel] << 1) | pBit) - color[channel];
+			error += difference * difference;
+		}
+
+		if (error < bestError)
+		{
+			best = candidate;
+			bestError = error;
+		}
+	}
+	return best;
+}
+}
+
+std::vector<std::byte> BlockCompressor::compress(const Rgba8Image &image, TextureFormat format)
+{
+	assert(TextureResource::isBlockCompressed(format));
+	assert(image.pixels.size() == size_t{ image.width } * image.height * CHANNELS);
+
+	const auto blocksWide = (image.width + BLOCK_DIMENSION - 1) / BLOCK_DIMENSION;
+	const auto blocksHigh = (image.height + BLOCK_DIMENSION - 1) / BLOCK_DIMENSION;
+	const auto blockBytes = TextureResource::blockBytes(format);
+
+	auto result = std::vector<std::byte>(TextureResource::levelSize(format, image.width, image.height));
+
+	auto encodeRows = [&](size_t firstRow, size_t endRow)
+	{
+		std::uint8_t block[BLOCK_PIXELS * CHANNELS];
+		for (auto blockY = firstRow; blockY < endRow; ++blockY)
+		{
+			for (std::uint32_t blockX = 0; blockX < blocksWide; ++blockX)
+			{
+				for (std::uint32_t pixel = 0; pixel < BLOCK_PIXELS; ++pixel)
+				{
+					const auto x = std::min(blockX * BLOCK_DIMENSION + pixel % BLOCK_DIMENSION, image.width - 1);
+					const auto y = std::min(static_cast<std::uint32_t>(blockY) * BLOCK_DIMENSION + pixel / BLOCK_DIMENSION, image.height - 1);
+					std::copy_n(image.pixels.data() + (size_t{ y } * image.width + x) * CHANNELS, CHANNELS, block + pixel * CHANNELS);
+				}
+
+				auto *output = result.data() + (blockY * blocksWide + blockX) * blockBytes;
+				switch (format)
+				{
+				case TextureFormat::Bc1:
+					encodeBc1Block(block, output);
+					break;
+				case TextureFormat::Bc3:
+					encodeBc3Block(block, output);
+					break;
+				case TextureFormat::Bc7:
+					encodeBc7Block(block, output);
+					break;
+				case TextureFormat::Rgba8:
+				default:
+					assert(false);
+					break;
+				}
+			}
+		}
+	};
+
+	ThreadPool::shared().parallelFor(blocksHigh, BLOCK_ROWS_PER_TASK, encodeRows);
+
+	return result;
+}
+
+void BlockCompressor::encodeBc1Block(const std::uint8_t *block, std::byte *output)
+{
+	encodeColorBlock(block, output);
+}
+
+void BlockCompressor::encodeBc3Block(const std::uint8_t *block, std::byte *output)
+{
+	encodeAlphaBlock(block, output);
+	encodeColorBlock(block, output + 8);
+}
+
+void BlockCompressor::encodeBc7Block(const std::uint8_t *block, std::byte *output)
+{
+	const auto [low, high] = findEndpoints<4>(block);
+	auto endpoint0 = quantizeBc7Endpoint(low);
+	auto endpoint1 = quantizeBc7Endpoint(high);
+
+	const auto color0 = endpoint0.expand();
+	const auto color1 = endpoint1.expand();
+	auto palette = std::array<std::array<int, CHANNELS>, BC7_WEIGHTS.size()>();
+	for (size_t index = 0; index < BC7_WEIGHTS.size(); ++index)
+	{
+		for (std::uint32_t channel = 0; channel < CHANNELS; ++channel)
+		{
+			palette[index][channel] = ((64 - BC7_WEIGHTS[index]) * color0[channel] + BC7_WEIGHTS[index] * color1[channel] + 32) >> 6;
+		}
+	}
+
+	auto indices = std::array<std::uint32_t, BLOCK_PIXELS>();
+	for (std::uint32_t pixel = 0; pixel < BLOCK_PIXELS; ++pixel)
+	{
+		auto bestDistance = std::numeric_limits<int>::max();
+		for (std::uint32_t index = 0; index < palette.size(); ++index)
+		{
+			const auto distance = distanceSquared<4>(block + pixel * CHANNELS, palette[index]);
+			if (distance < bestDistance)
+			{
+				indices[pixel] = index;
+				bestDistance = distance;
+			}
+		}
+	}
+
+	// The first index is stored without its top bit, so it has to be in the lower half of the palette.
+	if (indices[0] >= 8)
+	{
+		std::swap(endpoint0, endpoint1);
+		for (auto &index : indices)
+		{
+			index = 15 - index;
+		}
+	}
+
+	auto writer = BitWriter(output);
+	writer.write(1U << 6, 7);
+	for (std::uint32_t channel = 0; channel < CHANNELS; ++channel)
+	{
+		writer.write(endpoint0.quantized[channel], 7);
+		writer.write(endpoint1.quantized[channel], 7);
+	}
+	writer.write(endpoint0.pBit, 1);
+	writer.write(endpoint1.pBit, 1);
+
+	writer.write(indices[0], 3);
+	for (std::uint32_t pixel = 1; pixel < BLOCK_PIXELS; ++pixel)
+	{
+		writer.write(indices[pixel], 4);
+	}
+}
@@ -0,0 +1,119 @@
+#include "BoundsCalculator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <xmmintrin.h>
+#define NARNIA_BOUNDS_SSE
+#endif
+
+namespace {
+// The kernels load four floats from the start of each vertex, the fourth one is the red channel and gets ignored.
+static_assert(offsetof(Vertex, postion) == 0 && sizeof(Vertex) >= 4 * sizeof(float));
+
+#ifdef NARNIA_BOUNDS_SSE
+__m128 loadPosition(const Vertex &vertex)
+{
+	return _mm_loadu_ps(reinterpret_cast<const float *>(&vertex));
+}
+
+glm::vec3 toVec3(__m128 value)
+{
+	alignas(16) float lanes[4];
+	_mm_store_ps(lanes, value);
+	return { lanes[0], lanes[1], lanes[2] };
+}
+#endif
+}
+
+Bounds BoundsCalculator::compute(std::span<const Vertex> verticies)
+{
+	auto bounds = Bounds();
+	bounds.box = computeAabb(verticies);
+	bounds.sphere = computeSphere(verticies, bounds.box);
+	return bounds;
+}
+
+Aabb BoundsCalculator::computeAabb(std::span<const Vertex> verticies)
+{
+	if (verticies.empty())
+	{
+		return Aabb();
+	}
+
+	size_t i = 0;
+#ifdef NARNIA_BOUNDS_SSE
+	// Two independent accumulator pairs keep the min and max dependency chains short.
+	auto minimum0 = loadPosition(verticies[0]);
+	auto maximum0 = minimum0;
+	auto minimum1 = minimum0;
+	auto maximum1 = minimum0;
+	for (; i + 4 <= verticies.size(); i += 4)
+	{
+		const auto position0 = loadPosition(verticies[i]);
+		const auto position1 = loadPosition(verticies[i + 1]);
+		const auto position2 = loadPosition(verticies[i + 2]);
+		const auto position3 = loadPosition(verticies[i + 3]);
+
+		minimum0 = _mm_min_ps(minimum0, _mm_min_ps(position0, position1));
+		maximum0 = _mm_max_ps(maximum0, _mm_max_ps(position0, position1));
+		minimum1 = _mm_min_ps(minimum1, _mm_min_ps(position2, position3));
+		maximum1 = _mm_max_ps(maximum1, _mm_max_ps(position2, position3));
+	}
+
+	auto result = Aabb{ toVec3(_mm_min_ps(minimum0, minimum1)), toVec3(_mm_max_ps(maximum0, maximum1)) };
+#else
+	auto result = Aabb{ verticies.front().postion, verticies.front().postion };
+#endif
+
+	for (; i < verticies.size(); ++i)
+	{
+		result.min = glm::min(result.min, verticies[i].postion);
+		result.max = glm::max(result.max, verticies[i].postion);
+	}
+
+	return result;
+}
+
+BoundingSphere BoundsCalculator::computeSphere(std::span<const Vertex> verticies, const Aabb &box)
+{
+	const auto center = box.center();
+	auto radiusSquared = 0.0F;
+
+	size_t i = 0;
+#ifdef NARNIA_BOUNDS_SSE
+	const auto centerX = _mm_set1_ps(center.x);
+	const auto centerY = _mm_set1_ps(center.y);
+	const auto centerZ = _mm_set1_ps(center.z);
+	auto farthest = _mm_setzero_ps();
+	for (; i + 4 <= verticies.size(); i += 4)
+	{
+		// Transposed, each register holds one coordinate of four verticies.
+		auto x = loadPosition(verticies[i]);
+		auto y = loadPosition(verticies[i + 1]);
+		auto z = loadPosition(verticies[i + 2]);
+		auto unused = loadPosition(verticies[i + 3]);
+		_MM_TRANSPOSE4_PS(x, y, z, unused);
+
+		x = _mm_sub_ps(x, centerX);
+		y = _mm_sub_ps(y, centerY);
+		z = _mm_sub_ps(z, centerZ);
+		const auto distanceSquared = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z));
+		farthest = _mm_max_ps(farthest, distanceSquared);
+	}
+
+	alignas(16) float lanes[4];
+	_mm_store_ps(lanes, farthest);
+	radiusSquared = std::max({ lanes[0], lanes[1], lanes[2], lanes[3] });
+#endif
+
+	for (; i < verticies.size(); ++i)
+	{
+		const auto offset = verticies[i].postion - center;
+		radiusSquared = std::max(radiusSquared, glm::dot(offset, offset));
+	}
+
+	return { center, std::sqrt(radiusSquared) };
+}
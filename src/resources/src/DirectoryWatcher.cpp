@@ -0,0 +1,98 @@
+#include "DirectoryWatcher.h"
+#include "LoggerAPI.h"
+
+#include <algorithm>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+DirectoryWatcher::~DirectoryWatcher()
+{
+	stop();
+}
+
+#ifdef __linux__
+bool DirectoryWatcher::watch(const std::string &directory)
+{
+	stop();
+
+	m_fileDescriptor = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if (m_fileDescriptor < 0)
+	{
+		LoggerAPI::getLogger()->logError("Could not initialize inotify");
+		return false;
+	}
+
+	if (inotify_add_watch(m_fileDescriptor, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0)
+	{
+		LoggerAPI::getLogger()->logError("Could not watch directory " + directory);
+		stop();
+		return false;
+	}
+
+	LoggerAPI::getLogger()->logInfo("Watching " + directory + " for changes");
+	return true;
+}
+
+void DirectoryWatcher::stop()
+{
+	if (m_fileDescriptor >= 0)
+	{
+		close(m_fileDescriptor);
+	}
+	m_fileDescriptor = -1;
+}
+
+std::vector<std::string> DirectoryWatcher::pollChangedFiles()
+{
+	auto result = std::vector<std::string>();
+	if (m_fileDescriptor < 0)
+	{
+		return result;
+	}
+
+	alignas(inotify_event) char buffer[4096];
+
+	for (;;)
+	{
+		const auto bytesRead = read(m_fileDescriptor, buffer, sizeof(buffer));
+		if (bytesRead <= 0)
+		{
+			break;
+		}
+
+		for (ssize_t offset = 0; offset < bytesRead;)
+		{
+			const auto *event = reinterpret_cast<const inotify_event *>(buffer + offset);
+			if (event->len > 0)
+			{
+				std::string fileName(event->name);
+				if (std::find(std::begin(result), std::end(result), fileName) == std::end(result))
+				{
+					result.push_back(std::move(fileName));
+				}
+			}
+			offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+		}
+	}
+
+	return result;
+}
+#else
+bool DirectoryWatcher::watch(const std::string &directory)
+{
+	LoggerAPI::getLogger()->logWarning("Watching " + directory + " is not supported on this platform");
+	return false;
+}
+
+void DirectoryWatcher::stop()
+{
+}
+
+std::vector<std::string> DirectoryWatcher::pollChangedFiles()
+{
+	return {};
+}
+#endif
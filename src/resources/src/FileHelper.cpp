@@ -1,46 +1,255 @@
 #include "FileHelper.h"
 #include "LoggerAPI.h"
+#include "MappedFile.h"
 #include <fstream>
 #include <string>
-#include <cassert>
+
+#ifdef NARNIA_HAS_IO_URING
+#include <liburing.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 using std::vector;
 using std::string;
 using std::fstream;
 using std::ifstream;
 
+namespace {
+std::pair<std::string_view, std::string_view> splitIndexLine(std::string_view line)
+{
+	constexpr std::string_view whitespace = " \t";
+
+	const auto nameBegin = line.find_first_not_of(whitespace);
+	if (nameBegin == std::string_view::npos)
+		return {};
+
+	const auto nameEnd = std::min(line.find_first_of(whitespace, nameBegin), line.size());
+	const auto fileBegin = line.find_first_not_of(whitespace, nameEnd);
+	if (fileBegin == std::string_view::npos)
+		return {};
+
+	const auto fileEnd = std::min(line.find_first_of(whitespace, fileBegin), line.size());
+	return { line.substr(nameBegin, nameEnd - nameBegin), line.substr(fileBegin, fileEnd - fileBegin) };
+}
+
+#ifdef NARNIA_HAS_IO_URING
+constexpr unsigned URING_QUEUE_DEPTH = 64;
+
+struct PendingRead
+{
+	int fileDescriptor = -1;
+	std::shared_ptr<vector<char>> buffer;
+	size_t offset = 0;
+	bool failed = false;
+
+	bool isDone() const
+	{
+		return failed || buffer == nullptr || offset == buffer->size();
+	}
+};
+
+bool openForRead(const string &path, PendingRead &read)
+{
+	read.fileDescriptor = ::open(path.c_str(), O_RDONLY);
+	if (read.fileDescriptor < 0)
+		return false;
+
+	struct stat fileStat{};
+	if (fstat(read.fileDescriptor, &fileStat) != 0)
+		return false;
+
+	read.buffer = std::make_shared<vector<char>>(static_cast<size_t>(fileStat.st_size));
+	return true;
+}
+
+bool queueRead(io_uring &ring, PendingRead &read, size_t index)
+{
+	auto *submission = io_uring_get_sqe(&ring);
+	if (submission == nullptr)
+		return false;
+
+	const auto remaining = static_cast<unsigned>(read.buffer->size() - read.offset);
+	io_uring_prep_read(submission, read.fileDescriptor, read.buffer->data() + read.offset, remaining, read.offset);
+	io_uring_sqe_set_data(submission, reinterpret_cast<void *>(index));
+	return true;
+}
+
+bool readFilesUring(const vector<string> &paths, vector<FileBuffer> &result)
+{
+	io_uring ring;
+	if (io_uring_queue_init(URING_QUEUE_DEPTH, &ring, 0) < 0)
+		return false;
+
+	auto reads = vector<PendingRead>(paths.size());
+	auto toQueue = vector<size_t>();
+	toQueue.reserve(paths.size());
+
+	for (size_t i = 0; i < paths.size(); ++i)
+	{
+		if (!openForRead(paths[i], reads[i]))
+		{
+			LoggerAPI::getLogger()->logError("Could not open file " + paths[i]);
+			reads[i].failed = true;
+		}
+		else if (!reads[i].isDone())
+		{
+			toQueue.push_back(i);
+		}
+	}
+
+	size_t inFlight = 0;
+	while (!toQueue.empty() || inFlight != 0)
+	{
+		while (!toQueue.empty() && inFlight < URING_QUEUE_DEPTH && queueRead(ring, reads[toQueue.back()], toQueue.back()))
+		{
+			toQueue.pop_back();
+			++inFlight;
+		}
+
+		io_uring_submit(&ring);
+
+		io_uring_cqe *completion = nullptr;
+		if (io_uring_wait_cqe(&ring, &completion) < 0)
+			break;
+
+		do
+		{
+			const auto index = reinterpret_cast<size_t>(io_uring_cqe_get_data(completion));
+			auto &read = reads[index];
+
+			if (completion->res <= 0)
+			{
+				LoggerAPI::getLogger()->logError("Could not read file " + paths[index]);
+				read.failed = true;
+			}
+			else
+			{
+				read.offset += static_cast<size_t>(completion->res);
+				if (!read.isDone())
+					toQueue.push_back(index);
+			}
+
+			io_uring_cqe_seen(&ring, completion);
+			--inFlight;
+		} while (io_uring_peek_cqe(&ring, &completion) == 0);
+	}
+
+	io_uring_queue_exit(&ring);
+
+	result.clear();
+	result.reserve(reads.size());
+	for (auto &read : reads)
+	{
+		if (read.fileDescriptor >= 0)
+			::close(read.fileDescriptor);
+
+		if (read.failed || read.buffer == nullptr || read.offset != read.buffer->size())
+		{
+			result.emplace_back();
+			continue;
+		}
+
+		const std::span<const char> data = *read.buffer;
+		result.emplace_back(std::move(read.buffer), data);
+	}
+
+	return true;
+}
+#endif
+}
+
 vector<char> FileHelper::readFileByte(const string & path)
 {
 
 	ifstream file(path, std::ios::ate | std::ios::binary);
 
-	assert(file.is_open());
+	if (!file.is_open())
+	{
+		LoggerAPI::getLogger()->logError("Could not open file " + path);
+		return {};
+	}
 
 	const auto fileSize = static_cast<size_t>(file.tellg());
 	auto result = vector<char>(fileSize);
 	file.seekg(0);
-	file.read(result.data(), fileSize);
-	file.close();
+	if (!file.read(result.data(), static_cast<std::streamsize>(fileSize)))
+	{
+		LoggerAPI::getLogger()->logError("Could not read file " + path);
+		return {};
+	}
 
 	return result;
 }
 
 std::vector<string> FileHelper::readFileLines(const string & path)
 {
-	ifstream file(path);
+	const auto file = readFile(path);
 
-	if (!file.is_open())
+	auto result = vector<string>();
+
+	for (const auto line : lines(file))
+	{
+		result.emplace_back(line);
+	}
+
+	return result;
+}
+
+std::vector<std::pair<string, string>> FileHelper::readIndexFile(const string & path)
+{
+	const auto file = readFile(path);
+
+	auto result = vector<std::pair<string, string>>();
+
+	for (const auto line : lines(file))
+	{
+		const auto [name, fileName] = splitIndexLine(line);
+		if (!name.empty())
+		{
+			result.emplace_back(name, fileName);
+		}
+	}
+
+	return result;
+}
+
+FileBuffer FileHelper::readFile(const string & path)
+{
+	auto file = std::make_shared<MappedFile>();
+
+	if (!file->open(path))
 	{
 		LoggerAPI::getLogger()->logError("Could not open file " + path);
-		return vector<string>();
+		return FileBuffer();
 	}
 
-	auto result = vector<string>();
+	const auto bytes = file->data();
+	return FileBuffer(std::move(file), { reinterpret_cast<const char *>(bytes.data()), bytes.size() });
+}
+
+std::vector<FileBuffer> FileHelper::readFiles(const vector<string> & paths)
+{
+	auto result = vector<FileBuffer>();
+
+#ifdef NARNIA_HAS_IO_URING
+	if (readFilesUring(paths, result))
+	{
+		return result;
+	}
+#endif
 
-	for (string line; std::getline(file, line);)
+	result.reserve(paths.size());
+	for (const auto &path : paths)
 	{
-		result.push_back(line);
+		result.push_back(readFile(path));
 	}
 
 	return result;
 }
+
+LineRange FileHelper::lines(const FileBuffer & buffer)
+{
+	return LineRange(buffer.data());
+}
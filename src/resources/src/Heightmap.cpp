@@ -0,0 +1,31 @@
+#include "Heightmap.h"
+#include "LoggerAPI.h"
+
+#include "stb_image.h"
+
+std::optional<Heightmap> Heightmap::load(const std::string &path)
+{
+	int width = 0;
+	int depth = 0;
+	int channels = 0;
+	// Always read 16 bits per sample so 16 bit heightmaps keep their precision, 8 bit ones are scaled up.
+	auto *pixels = stbi_load_16(path.c_str(), &width, &depth, &channels, 1);
+	if (pixels == nullptr)
+	{
+		LoggerAPI::getLogger()->logError("Could not load heightmap " + path + ": " + stbi_failure_reason());
+		return std::nullopt;
+	}
+
+	auto result = Heightmap();
+	result.width = static_cast<uint32_t>(width);
+	result.depth = static_cast<uint32_t>(depth);
+	result.samples.resize(size_t{ result.width } * result.depth);
+	for (size_t i = 0; i < result.samples.size(); ++i)
+	{
+		result.samples[i] = static_cast<float>(pixels[i]) / 65535.0F;
+	}
+	stbi_image_free(pixels);
+
+	LoggerAPI::getLogger()->logInfo("Loaded heightmap " + path + " " + std::to_string(width) + "x" + std::to_string(depth));
+	return result;
+}
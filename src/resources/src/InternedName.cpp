@@ -0,0 +1,81 @@
+#include "InternedName.h"
+
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_set>
+
+namespace {
+struct StringHash
+{
+	using is_transparent = void;
+
+	size_t operator()(std::string_view value) const
+	{
+		return std::hash<std::string_view>{}(value);
+	}
+};
+
+class NameTable
+{
+public:
+	const std::string *intern(std::string_view name)
+	{
+		if (const auto *existing = find(name))
+		{
+			return existing;
+		}
+
+		std::unique_lock lock(m_mutex);
+		return &*m_names.emplace(name).first;
+	}
+
+	const std::string *find(std::string_view name) const
+	{
+		std::shared_lock lock(m_mutex);
+		const auto it = m_names.find(name);
+		return it == std::end(m_names) ? nullptr : &*it;
+	}
+
+private:
+	mutable std::shared_mutex m_mutex;
+	std::unordered_set<std::string, StringHash, std::equal_to<>> m_names;
+};
+
+NameTable &nameTable()
+{
+	static NameTable table;
+	return table;
+}
+
+const std::string EMPTY_NAME;
+}
+
+InternedName::InternedName(std::string_view name) :
+	m_entry{ nameTable().intern(name) }
+{
+}
+
+InternedName::InternedName(const std::string *entry) :
+	m_entry{ entry }
+{
+}
+
+InternedName InternedName::find(std::string_view name)
+{
+	return InternedName(nameTable().find(name));
+}
+
+const std::string &InternedName::str() const
+{
+	return m_entry == nullptr ? EMPTY_NAME : *m_entry;
+}
+
+bool InternedName::isValid() const
+{
+	return m_entry != nullptr;
+}
+
+size_t InternedName::hash() const
+{
+	return std::hash<const std::string *>{}(m_entry);
+}
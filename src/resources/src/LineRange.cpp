@@ -0,0 +1,53 @@
+#include "LineRange.h"
+
+LineRange::iterator::iterator(std::string_view remaining) :
+	m_remaining{ remaining }
+{
+	findLineEnd();
+}
+
+std::string_view LineRange::iterator::operator*() const
+{
+	auto line = m_remaining.substr(0, m_lineLength);
+	if (!line.empty() && line.back() == '\r')
+	{
+		line.remove_suffix(1);
+	}
+	return line;
+}
+
+LineRange::iterator &LineRange::iterator::operator++()
+{
+	const auto consumed = m_lineLength < m_remaining.size() ? m_lineLength + 1 : m_lineLength;
+	m_remaining.remove_prefix(consumed);
+	findLineEnd();
+	return *this;
+}
+
+LineRange::iterator LineRange::iterator::operator++(int)
+{
+	auto previous = *this;
+	++*this;
+	return previous;
+}
+
+void LineRange::iterator::findLineEnd()
+{
+	const auto newLine = m_remaining.find('\n');
+	m_lineLength = newLine == std::string_view::npos ? m_remaining.size() : newLine;
+}
+
+LineRange::LineRange(std::span<const char> text) :
+	m_text{ text.data(), text.size() }
+{
+}
+
+LineRange::iterator LineRange::begin() const
+{
+	return iterator(m_text);
+}
+
+LineRange::iterator LineRange::end() const
+{
+	return iterator(m_text.substr(m_text.size()));
+}
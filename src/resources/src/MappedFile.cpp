@@ -0,0 +1,154 @@
+#include "MappedFile.h"
+#include "LoggerAPI.h"
+
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::~MappedFile()
+{
+	close();
+}
+
+MappedFile::MappedFile(MappedFile &&other) noexcept :
+	m_data{ std::exchange(other.m_data, nullptr) },
+	m_size{ std::exchange(other.m_size, 0) }
+#ifdef _WIN32
+	,
+	m_file{ std::exchange(other.m_file, nullptr) },
+	m_mapping{ std::exchange(other.m_mapping, nullptr) }
+#endif
+{
+}
+
+MappedFile &MappedFile::operator=(MappedFile &&other) noexcept
+{
+	if (this != &other)
+	{
+		close();
+		m_data = std::exchange(other.m_data, nullptr);
+		m_size = std::exchange(other.m_size, 0);
+#ifdef _WIN32
+		m_file = std::exchange(other.m_file, nullptr);
+		m_mapping = std::exchange(other.m_mapping, nullptr);
+#endif
+	}
+	return *this;
+}
+
+#ifdef _WIN32
+bool MappedFile::open(const std::string &path)
+{
+	close();
+
+	m_file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (m_file == INVALID_HANDLE_VALUE)
+	{
+		m_file = nullptr;
+		return false;
+	}
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(m_file, &fileSize) || fileSize.QuadPart == 0)
+	{
+		close();
+		return false;
+	}
+
+	m_mapping = CreateFileMappingA(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (m_mapping == nullptr)
+	{
+		LoggerAPI::getLogger()->logError("Could not create file mapping for " + path);
+		close();
+		return false;
+	}
+
+	m_data = static_cast<const std::byte *>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+	if (m_data == nullptr)
+	{
+		LoggerAPI::getLogger()->logError("Could not map view of " + path);
+		close();
+		return false;
+	}
+
+	m_size = static_cast<size_t>(fileSize.QuadPart);
+	return true;
+}
+
+void MappedFile::close()
+{
+	if (m_data != nullptr)
+		UnmapViewOfFile(m_data);
+	if (m_mapping != nullptr)
+		CloseHandle(m_mapping);
+	if (m_file != nullptr)
+		CloseHandle(m_file);
+
+	m_data = nullptr;
+	m_size = 0;
+	m_mapping = nullptr;
+	m_file = nullptr;
+}
+#else
+bool MappedFile::open(const std::string &path)
+{
+	close();
+
+	const int fileDescriptor = ::open(path.c_str(), O_RDONLY);
+	if (fileDescriptor < 0)
+	{
+		return false;
+	}
+
+	struct stat fileStat{};
+	if (fstat(fileDescriptor, &fileStat) != 0 || fileStat.st_size == 0)
+	{
+		::close(fileDescriptor);
+		return false;
+	}
+
+	const auto size = static_cast<size_t>(fileStat.st_size);
+	void *mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+	::close(fileDescriptor);
+
+	if (mapping == MAP_FAILED)
+	{
+		LoggerAPI::getLogger()->logError("Could not map file " + path);
+		return false;
+	}
+
+	m_data = static_cast<const std::byte *>(mapping);
+	m_size = size;
+	return true;
+}
+
+void MappedFile::close()
+{
+	if (m_data != nullptr)
+	{
+		munmap(const_cast<std::byte *>(m_data), m_size);
+	}
+
+	m_data = nullptr;
+	m_size = 0;
+}
+#endif
+
+bool MappedFile::isOpen() const
+{
+	return m_data != nullptr;
+}
+
+std::span<const std::byte> MappedFile::data() const
+{
+	return { m_data, m_size };
+}
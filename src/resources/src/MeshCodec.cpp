@@ -0,0 +1,651 @@
+#include "MeshCodec.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+namespace {
+constexpr uint32_t VERTEX_MAGIC = 0x5654584E; // "NXTV"
+constexpr uint32_t INDEX_MAGIC = 0x5844494E; // "NIDX"
+
+// Values per bit width group, also the granularity blocks are padded to.
+constexpr size_t GROUP_SIZE = 16;
+// A decoded block has to fit twice into the stack buffers of the decoder.
+constexpr size_t BLOCK_BYTES = 8192;
+constexpr size_t MAX_BLOCK_VERTICES = 256;
+constexpr std::array<uint32_t, 4> GROUP_BITS = { 0, 2, 4, 8 };
+
+// The high nibble of a triangle code picks a cached edge, NO_EDGE means all three vertices follow.
+// With a cached edge the low nibble is NEXT_VERTEX, 1 + a vertex FIFO position or EXPLICIT_VERTEX.
+// Without one its low three bits tell which vertices are NEXT_VERTEX, the others are explicit.
+constexpr uint32_t EDGE_FIFO_SIZE = 15;
+constexpr uint32_t VERTEX_FIFO_SIZE = 14;
+constexpr uint8_t NO_EDGE = 0xF;
+constexpr uint8_t NEXT_VERTEX = 0x0;
+constexpr uint8_t EXPLICIT_VERTEX = 0xF;
+
+struct StreamHeader
+{
+	uint32_t magic;
+	uint32_t count;
+	uint32_t elementSize;
+	uint32_t reserved;
+};
+
+size_t blockVertices(size_t stride)
+{
+	return std::clamp(BLOCK_BYTES / stride / GROUP_SIZE * GROUP_SIZE, GROUP_SIZE, MAX_BLOCK_VERTICES);
+}
+
+// The fewest bytes a stream with this header can be encoded in: one lane header byte per four groups of every lane,
+// or one code per triangle.
+size_t minimumPayload(const StreamHeader &header)
+{
+	const auto count = size_t{ header.count };
+	if (header.magic == INDEX_MAGIC)
+	{
+		return count / 3;
+	}
+
+	const auto blockSize = blockVertices(header.elementSize);
+	const auto laneHeaderSize = [](size_t vertexCount)
+	{
+		return ((vertexCount + GROUP_SIZE - 1) / GROUP_SIZE + 3) / 4;
+	};
+	const auto lastBlock = count % blockSize;
+	return header.elementSize * (count / blockSize * laneHeaderSize(blockSize) + laneHeaderSize(lastBlock));
+}
+
+// Also rejects headers that claim more data than the stream holds, their size would otherwise be trusted for allocations.
+bool readHeader(std::span<const std::byte> encoded, StreamHeader &header)
+{
+	if (encoded.size() < sizeof(StreamHeader))
+	{
+		return false;
+	}
+	std::memcpy(&header, encoded.data(), sizeof(StreamHeader));
+
+	const bool vertexStream = header.magic == VERTEX_MAGIC && header.elementSize != 0 && header.elementSize % 4 == 0 &&
+		header.elementSize <= MeshCodec::MAX_VERTEX_STRIDE;
+	const bool indexStream = header.magic == INDEX_MAGIC && header.count % 3 == 0 &&
+		(header.elementSize == sizeof(uint16_t) || header.elementSize == sizeof(uint32_t));
+	return (vertexStream || indexStream) && minimumPayload(header) <= encoded.size() - sizeof(StreamHeader);
+}
+
+void appendHeader(std::vector<std::byte> &result, uint32_t magic, size_t count, size_t elementSize)
+{
+	const auto header = StreamHeader{ magic, static_cast<uint32_t>(count), static_cast<uint32_t>(elementSize), 0 };
+	result.resize(sizeof(StreamHeader));
+	std::memcpy(result.data(), &header, sizeof(StreamHeader));
+}
+
+uint8_t zigzag(uint8_t delta)
+{
+	return static_cast<uint8_t>((delta << 1) ^ (delta & 0x80 ? 0xFF : 0x00));
+}
+
+uint32_t zigzag(int32_t delta)
+{
+	return (static_cast<uint32_t>(delta) << 1) ^ static_cast<uint32_t>(delta >> 31);
+}
+
+int32_t unzigzag(uint32_t value)
+{
+	return static_cast<int32_t>((value >> 1) ^ (0U - (value & 1U)));
+}
+
+// Packs one lane of a block: 2 bits of width code per group, followed by the groups themselves.
+// Two bit groups put value i into bits 2 * (i / 4) of byte i % 4, four bit groups put it into the nibble i / 8 of byte i % 8,
+// which lets the decoder expand them with whole register shifts.
+void encodeLane(std::vector<std::byte> &result, const uint8_t *deltas, size_t groups)
+{
+	const auto headerOffset = result.size();
+	result.resize(headerOffset + (groups + 3) / 4);
+
+	for (size_t group = 0; group < groups; ++group)
+	{
+		const auto *values = deltas + group * GROUP_SIZE;
+		const auto largest = *std::max_element(values, values + GROUP_SIZE);
+		const uint8_t code = largest == 0 ? 0 : largest < 4 ? 1 : largest < 16 ? 2 : 3;
+		result[headerOffset + group / 4] |= std::byte(code << (group % 4 * 2));
+
+		const auto bits = GROUP_BITS[code];
+		const auto offset = result.size();
+		result.resize(offset + bits * GROUP_SIZE / 8);
+		for (size_t i = 0; i < GROUP_SIZE && bits != 0; ++i)
+		{
+			const auto bytesPerShift = GROUP_SIZE * bits / 8;
+			const auto shift = i / bytesPerShift * bits;
+			result[offset + i % bytesPerShift] |= std::byte(values[i] << shift);
+		}
+	}
+}
+
+// Size of one encoded lane, or 0 if the lane header does not fit into the remaining bytes.
+size_t laneSize(const uint8_t *data, const uint8_t *end, size_t groups)
+{
+	const auto headerSize = (groups + 3) / 4;
+	if (static_cast<size_t>(end - data) < headerSize)
+	{
+		return 0;
+	}
+
+	auto size = headerSize;
+	for (size_t group = 0; group < groups; ++group)
+	{
+		size += GROUP_BITS[(data[group / 4] >> (group % 4 * 2)) & 3U] * GROUP_SIZE / 8;
+	}
+	return size;
+}
+
+#if defined(__SSE2__) || defined(_M_X64)
+__m128i unpackGroup(const uint8_t *data, uint32_t bits)
+{
+	switch (bits)
+	{
+	case 2:
+	{
+		int32_t packed;
+		std::memcpy(&packed, data, sizeof(packed));
+		const auto mask = _mm_set1_epi8(0x03);
+		const auto x = _mm_cvtsi32_si128(packed);
+		const auto v0 = _mm_and_si128(x, mask);
+		const auto v1 = _mm_and_si128(_mm_srli_epi16(x, 2), mask);
+		const auto v2 = _mm_and_si128(_mm_srli_epi16(x, 4), mask);
+		const auto v3 = _mm_and_si128(_mm_srli_epi16(x, 6), mask);
+		return _mm_or_si128(_mm_or_si128(v0, _mm_slli_si128(v1, 4)), _mm_or_si128(_mm_slli_si128(v2, 8), _mm_slli_si128(v3, 12)));
+	}
+	case 4:
+	{
+		const auto mask = _mm_set1_epi8(0x0F);
+		const auto x = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(data));
+		return _mm_or_si128(_mm_and_si128(x, mask), _mm_slli_si128(_mm_and_si128(_mm_srli_epi16(x, 4), mask), 8));
+	}
+	case 8:
+		return _mm_loadu_si128(reinterpret_cast<const __m128i *>(data));
+	default:
+		return _mm_setzero_si128();
+	}
+}
+
+// Undoes zigzag and delta coding of 16 values. previous holds the value before the first one in every byte
+// and is replaced by the last one, staying in a register keeps the dependency between groups short.
+__m128i decodeDeltas(__m128i zigzagged, __m128i &previous)
+{
+	const auto one = _mm_set1_epi8(1);
+	const auto magnitude = _mm_and_si128(_mm_srli_epi16(zigzagged, 1), _mm_set1_epi8(0x7F));
+	auto values = _mm_xor_si128(magnitude, _mm_sub_epi8(_mm_setzero_si128(), _mm_and_si128(zigzagged, one)));
+
+	values = _mm_add_epi8(values, _mm_slli_si128(values, 1));
+	values = _mm_add_epi8(values, _mm_slli_si128(values, 2));
+	values = _mm_add_epi8(values, _mm_slli_si128(values, 4));
+	values = _mm_add_epi8(values, _mm_slli_si128(values, 8));
+	values = _mm_add_epi8(values, previous);
+
+	const auto high = _mm_unpackhi_epi8(values, values);
+	previous = _mm_shuffle_epi32(_mm_unpackhi_epi16(high, high), 0xFF);
+	return values;
+}
+
+const uint8_t *decodeLane(const uint8_t *data, size_t groups, uint8_t *lane, uint8_t &previous)
+{
+	const auto *header = data;
+	data += (groups + 3) / 4;
+	auto last = _mm_set1_epi8(static_cast<char>(previous));
+	for (size_t group = 0; group < groups; ++group)
+	{
+		const auto bits = GROUP_BITS[(header[group / 4] >> (group % 4 * 2)) & 3U];
+		const auto values = decodeDeltas(unpackGroup(data, bits), last);
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(lane + group * GROUP_SIZE), values);
+		data += bits * GROUP_SIZE / 8;
+	}
+	previous = static_cast<uint8_t>(_mm_cvtsi128_si32(last));
+	return data;
+}
+
+// Interleaves the byte lanes back into verticies, four lanes and 16 verticies at a time.
+void transposeLanes(const uint8_t *lanes, size_t laneStride, size_t stride, size_t vertexCount, uint8_t *verticies)
+{
+	alignas(16) uint8_t words[GROUP_SIZE * 4];
+	for (size_t lane = 0; lane < stride; lane += 4)
+	{
+		for (size_t vertex = 0; vertex < vertexCount; vertex += GROUP_SIZE)
+		{
+			const auto *source = lanes + lane * laneStride + vertex;
+			const auto a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source));
+			const auto b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source + laneStride));
+			const auto c = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source + laneStride * 2));
+			const auto d = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source + laneStride * 3));
+
+			const auto abLow = _mm_unpacklo_epi8(a, b);
+			const auto abHigh = _mm_unpackhi_epi8(a, b);
+			const auto cdLow = _mm_unpacklo_epi8(c, d);
+			const auto cdHigh = _mm_unpackhi_epi8(c, d);
+
+			_mm_store_si128(reinterpret_cast<__m128i *>(words), _mm_unpacklo_epi16(abLow, cdLow));
+			_mm_store_si128(reinterpret_cast<__m128i *>(words + 16), _mm_unpackhi_epi16(abLow, cdLow));
+			_mm_store_si128(reinterpret_cast<__m128i *>(words + 32), _mm_unpacklo_epi16(abHigh, cdHigh));
+			_mm_store_si128(reinterpret_cast<__m128i *>(words + 48), _mm_unpackhi_epi16(abHigh, cdHigh));
+
+			for (size_t i = 0; i < GROUP_SIZE; ++i)
+			{
+				std::memcpy(verticies + (vertex + i) * stride + lane, words + i * 4, 4);
+			}
+		}
+	}
+}
+#else
+const uint8_t *decodeLane(const uint8_t *data, size_t groups, uint8_t *lane, uint8_t &previous)
+{
+	const auto *header = data;
+	data += (groups + 3) / 4;
+	for (size_t group = 0; group < groups; ++group)
+	{
+		const auto bits = GROUP_BITS[(header[group / 4] >> (group % 4 * 2)) & 3U];
+		const auto mask = static_cast<uint32_t>((1U << bits) - 1);
+		for (size_t i = 0; i < GROUP_SIZE && bits != 0; ++i)
+		{
+			const auto bytesPerShift = GROUP_SIZE * bits / 8;
+			const auto zigzagged = static_cast<uint32_t>(data[i % bytesPerShift] >> (i / bytesPerShift * bits)) & mask;
+			previous = static_cast<uint8_t>(previous + ((zigzagged >> 1) ^ (0U - (zigzagged & 1U))));
+			lane[group * GROUP_SIZE + i] = previous;
+		}
+		if (bits == 0)
+		{
+			std::fill_n(lane + group * GROUP_SIZE, GROUP_SIZE, previous);
+		}
+		data += bits * GROUP_SIZE / 8;
+	}
+	return data;
+}
+
+void transposeLanes(const uint8_t *lanes, size_t laneStride, size_t stride, size_t vertexCount, uint8_t *verticies)
+{
+	for (size_t vertex = 0; vertex < vertexCount; ++vertex)
+	{
+		for (size_t lane = 0; lane < stride; ++lane)
+		{
+			verticies[vertex * stride + lane] = lanes[lane * laneStride + vertex];
+		}
+	}
+}
+#endif
+
+// Recently used edges and verticies, shared by the index encoder and decoder so both make the same decisions.
+class IndexFifos
+{
+public:
+	// Index 0 is the most recently pushed entry.
+	std::pair<uint32_t, uint32_t> edge(uint32_t index) const
+	{
+		return m_edges[(m_edgeHead + EDGE_FIFO_SIZE - 1 - index) % EDGE_FIFO_SIZE];
+	}
+
+	uint32_t vertex(uint32_t index) const
+	{
+		return m_verticies[(m_vertexHead + VERTEX_FIFO_SIZE - 1 - index) % VERTEX_FIFO_SIZE];
+	}
+
+	// Neighbouring triangles share an edge in the opposite direction, so the edges are stored reversed.
+	void pushTriangle(uint32_t a, uint32_t b, uint32_t c)
+	{
+		pushEdge(b, a);
+		pushEdge(c, b);
+		pushEdge(a, c);
+	}
+
+	void pushVertex(uint32_t vertex)
+	{
+		m_verticies[m_vertexHead] = vertex;
+		m_vertexHead = (m_vertexHead + 1) % VERTEX_FIFO_SIZE;
+		next = std::max(next, vertex + 1);
+		last = vertex;
+	}
+
+	// One past the highest vertex seen so far, the likely third vertex after an optimizeVertexFetch pass.
+	uint32_t next = 0;
+	// Explicit verticies are coded relative to this.
+	uint32_t last = 0;
+
+private:
+	void pushEdge(uint32_t a, uint32_t b)
+	{
+		m_edges[m_edgeHead] = { a, b };
+		m_edgeHead = (m_edgeHead + 1) % EDGE_FIFO_SIZE;
+	}
+
+	std::array<std::pair<uint32_t, uint32_t>, EDGE_FIFO_SIZE> m_edges{};
+	std::array<uint32_t, VERTEX_FIFO_SIZE> m_verticies{};
+	uint32_t m_edgeHead = 0;
+	uint32_t m_vertexHead = 0;
+};
+
+void writeVarint(std::vector<std::byte> &data, uint32_t value)
+{
+	while (value >= 0x80)
+	{
+		data.push_back(std::byte((value & 0x7F) | 0x80));
+		value >>= 7;
+	}
+	data.push_back(std::byte(value));
+}
+
+bool readVarint(const uint8_t *&data, const uint8_t *end, uint32_t &value)
+{
+	value = 0;
+	for (uint32_t shift = 0; shift < 35 && data != end; shift += 7)
+	{
+		const auto byte = *data++;
+		value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+		if ((byte & 0x80) == 0)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+// Codes a vertex that is neither cached nor the next one.
+void writeExplicit(std::vector<std::byte> &data, IndexFifos &fifos, uint32_t vertex)
+{
+	writeVarint(data, zigzag(static_cast<int32_t>(vertex - fifos.last)));
+	fifos.pushVertex(vertex);
+}
+
+bool readExplicit(const uint8_t *&data, const uint8_t *end, IndexFifos &fifos, uint32_t &vertex)
+{
+	uint32_t value;
+	if (!readVarint(data, end, value))
+	{
+		return false;
+	}
+	vertex = fifos.last + static_cast<uint32_t>(unzigzag(value));
+	fifos.pushVertex(vertex);
+	return true;
+}
+
+uint32_t readIndex(std::span<const std::byte> indicies, size_t indexSize, size_t index)
+{
+	if (indexSize == sizeof(uint16_t))
+	{
+		uint16_t value;
+		std::memcpy(&value, indicies.data() + index * sizeof(uint16_t), sizeof(uint16_t));
+		return value;
+	}
+
+	uint32_t value;
+	std::memcpy(&value, indicies.data() + index * sizeof(uint32_t), sizeof(uint32_t));
+	return value;
+}
+
+void writeIndex(std::span<std::byte> indicies, size_t indexSize, size_t index, uint32_t value)
+{
+	if (indexSize == sizeof(uint16_t))
+	{
+		const auto narrow = static_cast<uint16_t>(value);
+		std::memcpy(indicies.data() + index * sizeof(uint16_t), &narrow, sizeof(uint16_t));
+		return;
+	}
+
+	std::memcpy(indicies.data() + index * sizeof(uint32_t), &value, sizeof(uint32_t));
+}
+}
+
+std::vector<std::byte> MeshCodec::encodeVerticies(std::span<const std::byte> verticies, size_t stride)
+{
+	if (stride == 0 || stride % 4 != 0 || stride > MAX_VERTEX_STRIDE || verticies.size() % stride != 0)
+	{
+		return {};
+	}
+
+	const auto count = verticies.size() / stride;
+	const auto blockSize = blockVertices(stride);
+	const auto *bytes = reinterpret_cast<const uint8_t *>(verticies.data());
+
+	auto result = std::vector<std::byte>();
+	appendHeader(result, VERTEX_MAGIC, count, stride);
+
+	auto previous = std::array<uint8_t, MAX_VERTEX_STRIDE>();
+	auto deltas = std::array<uint8_t, MAX_BLOCK_VERTICES>();
+	for (size_t first = 0; first < count; first += blockSize)
+	{
+		const auto blockCount = std::min(blockSize, count - first);
+		const auto groups = (blockCount + GROUP_SIZE - 1) / GROUP_SIZE;
+
+		for (size_t lane = 0; lane < stride; ++lane)
+		{
+			// Padding past the last vertex repeats it, which keeps its deltas at zero.
+			deltas.fill(0);
+			for (size_t vertex = 0; vertex < blockCount; ++vertex)
+			{
+				const auto value = bytes[(first + vertex) * stride + lane];
+				deltas[vertex] = zigzag(static_cast<uint8_t>(value - previous[lane]));
+				previous[lane] = value;
+			}
+			encodeLane(result, deltas.data(), groups);
+		}
+	}
+
+	return result;
+}
+
+std::vector<std::byte> MeshCodec::encodeIndices(std::span<const std::byte> indicies, IndexType indexType)
+{
+	const auto size = indexSize(indexType);
+	const auto count = indicies.size() / size;
+	if (count % 3 != 0)
+	{
+		return {};
+	}
+
+	auto result = std::vector<std::byte>();
+	appendHeader(result, INDEX_MAGIC, count, size);
+
+	const auto triangleCount = count / 3;
+	const auto codesOffset = result.size();
+	result.resize(codesOffset + triangleCount);
+	auto data = std::vector<std::byte>();
+	auto fifos = IndexFifos();
+
+	for (size_t triangle = 0; triangle < triangleCount; ++triangle)
+	{
+		const auto a = readIndex(indicies, size, triangle * 3);
+		const auto b = readIndex(indicies, size, triangle * 3 + 1);
+		const auto c = readIndex(indicies, size, triangle * 3 + 2);
+
+		auto code = uint8_t{ NO_EDGE << 4 };
+		auto rotated = std::array<uint32_t, 3>{ a, b, c };
+		for (uint32_t edge = 0; edge < EDGE_FIFO_SIZE && code >> 4 == NO_EDGE; ++edge)
+		{
+			for (const auto &rotation : { std::array<uint32_t, 3>{ a, b, c }, std::array<uint32_t, 3>{ b, c, a }, std::array<uint32_t, 3>{ c, a, b } })
+			{
+				if (fifos.edge(edge) == std::pair(rotation[0], rotation[1]))
+				{
+					code = static_cast<uint8_t>(edge << 4);
+					rotated = rotation;
+					break;
+				}
+			}
+		}
+
+		if (code >> 4 != NO_EDGE)
+		{
+			const auto third = rotated[2];
+			auto cached = VERTEX_FIFO_SIZE;
+			for (uint32_t i = 0; i < VERTEX_FIFO_SIZE && cached == VERTEX_FIFO_SIZE; ++i)
+			{
+				cached = fifos.vertex(i) == third ? i : cached;
+			}
+
+			if (third == fifos.next)
+			{
+				code |= NEXT_VERTEX;
+				fifos.pushVertex(third);
+			}
+			else if (cached != VERTEX_FIFO_SIZE)
+			{
+				code |= static_cast<uint8_t>(cached + 1);
+			}
+			else
+			{
+				code |= EXPLICIT_VERTEX;
+				writeExplicit(data, fifos, third);
+			}
+		}
+		else
+		{
+			for (uint32_t i = 0; i < 3; ++i)
+			{
+				if (rotated[i] == fifos.next)
+				{
+					code |= static_cast<uint8_t>(1U << i);
+					fifos.pushVertex(rotated[i]);
+				}
+				else
+				{
+					writeExplicit(data, fifos, rotated[i]);
+				}
+			}
+		}
+
+		result[codesOffset + triangle] = std::byte(code);
+		fifos.pushTriangle(rotated[0], rotated[1], rotated[2]);
+	}
+
+	result.insert(result.end(), data.begin(), data.end());
+	return result;
+}
+
+size_t MeshCodec::decodedSize(std::span<const std::byte> encoded)
+{
+	auto header = StreamHeader();
+	return readHeader(encoded, header) ? size_t{ header.count } * header.elementSize : 0;
+}
+
+bool MeshCodec::decodeVerticies(std::span<const std::byte> encoded, std::span<std::byte> destination)
+{
+	auto header = StreamHeader();
+	if (!readHeader(encoded, header) || header.magic != VERTEX_MAGIC || destination.size() != size_t{ header.count } * header.elementSize)
+	{
+		return false;
+	}
+
+	const auto vertexStride = size_t{ header.elementSize };
+	const auto count = size_t{ header.count };
+	const auto blockSize = blockVertices(vertexStride);
+	const auto *data = reinterpret_cast<const uint8_t *>(encoded.data()) + sizeof(StreamHeader);
+	const auto *end = reinterpret_cast<const uint8_t *>(encoded.data()) + encoded.size();
+	auto *output = reinterpret_cast<uint8_t *>(destination.data());
+
+	alignas(16) uint8_t lanes[BLOCK_BYTES];
+	alignas(16) uint8_t verticies[BLOCK_BYTES];
+	auto previous = std::array<uint8_t, MAX_VERTEX_STRIDE>();
+	for (size_t first = 0; first < count; first += blockSize)
+	{
+		const auto blockCount = std::min(blockSize, count - first);
+		const auto groups = (blockCount + GROUP_SIZE - 1) / GROUP_SIZE;
+		const auto paddedCount = groups * GROUP_SIZE;
+
+		const auto largestLane = (groups + 3) / 4 + paddedCount;
+		for (size_t lane = 0; lane < vertexStride; ++lane)
+		{
+			// Only near the end of the stream a lane has to be measured before it is read.
+			const auto remaining = static_cast<size_t>(end - data);
+			if (remaining < largestLane)
+			{
+				const auto size = laneSize(data, end, groups);
+				if (size == 0 || size > remaining)
+				{
+					return false;
+				}
+			}
+			data = decodeLane(data, groups, lanes + lane * paddedCount, previous[lane]);
+		}
+
+		// The transpose scatters small stores over the block, the destination is often write combined upload memory
+		// which only takes sequential writes well.
+		transposeLanes(lanes, paddedCount, vertexStride, paddedCount, verticies);
+		std::memcpy(output + first * vertexStride, verticies, blockCount * vertexStride);
+	}
+
+	return true;
+}
+
+bool MeshCodec::decodeIndices(std::span<const std::byte> encoded, std::span<std::byte> destination, size_t vertexCount)
+{
+	auto header = StreamHeader();
+	if (!readHeader(encoded, header) || header.magic != INDEX_MAGIC || destination.size() != size_t{ header.count } * header.elementSize)
+	{
+		return false;
+	}
+
+	const auto size = size_t{ header.elementSize };
+	const auto triangleCount = size_t{ header.count } / 3;
+
+	const auto *codes = reinterpret_cast<const uint8_t *>(encoded.data()) + sizeof(StreamHeader);
+	const auto *data = codes + triangleCount;
+	const auto *end = reinterpret_cast<const uint8_t *>(encoded.data()) + encoded.size();
+	auto fifos = IndexFifos();
+
+	for (size_t triangle = 0; triangle < triangleCount; ++triangle)
+	{
+		const auto code = codes[triangle];
+		const auto edgeIndex = static_cast<uint32_t>(code >> 4);
+		const auto low = static_cast<uint32_t>(code & 0x0F);
+		auto vertices = std::array<uint32_t, 3>();
+
+		if (edgeIndex != NO_EDGE)
+		{
+			const auto edge = fifos.edge(edgeIndex);
+			vertices[0] = edge.first;
+			vertices[1] = edge.second;
+
+			if (low == NEXT_VERTEX)
+			{
+				vertices[2] = fifos.next;
+				fifos.pushVertex(vertices[2]);
+			}
+			else if (low != EXPLICIT_VERTEX)
+			{
+				vertices[2] = fifos.vertex(low - 1);
+			}
+			else if (!readExplicit(data, end, fifos, vertices[2]))
+			{
+				return false;
+			}
+		}
+		else
+		{
+			for (uint32_t i = 0; i < 3; ++i)
+			{
+				if ((low & (1U << i)) != 0)
+				{
+					vertices[i] = fifos.next;
+					fifos.pushVertex(vertices[i]);
+				}
+				else if (!readExplicit(data, end, fifos, vertices[i]))
+				{
+					return false;
+				}
+			}
+		}
+
+		for (uint32_t i = 0; i < 3; ++i)
+		{
+			// Explicit verticies are relative to the previous one and can point anywhere in a corrupted stream.
+			if (vertices[i] >= vertexCount)
+			{
+				return false;
+			}
+			writeIndex(destination, size, triangle * 3 + i, vertices[i]);
+		}
+		fifos.pushTriangle(vertices[0], vertices[1], vertices[2]);
+	}
+
+	return true;
+}
@@ -0,0 +1,297 @@
+#include "MeshOptimizer.h"
+#include "LoggerAPI.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <limits>
+
+namespace {
+constexpr uint32_t NO_VERTEX = std::numeric_limits<uint32_t>::max();
+
+struct Cluster
+{
+	uint32_t begin;
+	uint32_t end;
+	glm::vec3 center;
+	glm::vec3 normal;
+	float sortKey;
+};
+
+std::string formatStatistics(const MeshStatistics &before, const MeshStatistics &after)
+{
+	char buffer[128];
+	std::snprintf(buffer, sizeof(buffer), "ACMR %.3f -> %.3f, ATVR %.3f -> %.3f",
+		static_cast<double>(before.acmr), static_cast<double>(after.acmr),
+		static_cast<double>(before.atvr), static_cast<double>(after.atvr));
+	return buffer;
+}
+}
+
+void MeshOptimizer::optimize(const std::string &name, std::vector<Vertex> &verticies, std::vector<uint32_t> &indices)
+{
+	if (indices.empty() || indices.size() % 3 != 0)
+	{
+		LoggerAPI::getLogger()->logWarning("Skipping optimization of model " + name + ": index count is not a multiple of 3");
+		return;
+	}
+
+	const auto before = analyze(indices, verticies.size());
+
+	const auto clusters = optimizeVertexCache(indices, verticies.size());
+	optimizeOverdraw(indices, clusters, verticies);
+	optimizeVertexFetch(verticies, indices);
+
+	const auto after = analyze(indices, verticies.size());
+
+	LoggerAPI::getLogger()->logInfo("Optimized model " + name + " (" + std::to_string(clusters.size()) + " clusters): " + formatStatistics(before, after));
+}
+
+std::vector<uint32_t> MeshOptimizer::optimizeVertexCache(std::vector<uint32_t> &indices, size_t vertexCount)
+{
+	// Sander, Nehab, Barczak - "Fast Triangle Reordering for Vertex Locality and Reduced Overdraw".
+	const auto triangleCount = static_cast<uint32_t>(indices.size() / 3);
+	auto clusters = std::vector<uint32_t>();
+	if (triangleCount == 0)
+	{
+		return clusters;
+	}
+
+	auto liveTriangles = std::vector<uint32_t>(vertexCount, 0);
+	for (const auto index : indices)
+	{
+		++liveTriangles[index];
+	}
+
+	// Vertex to triangle adjacency, stored as one flat array indexed through per vertex offsets.
+	auto adjacencyOffsets = std::vector<uint32_t>(vertexCount + 1, 0);
+	for (size_t vertex = 0; vertex < vertexCount; ++vertex)
+	{
+		adjacencyOffsets[vertex + 1] = adjacencyOffsets[vertex] + liveTriangles[vertex];
+	}
+
+	auto adjacency = std::vector<uint32_t>(indices.size());
+	auto fillOffsets = std::vector<uint32_t>(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+	for (uint32_t triangle = 0; triangle < triangleCount; ++triangle)
+	{
+		for (uint32_t corner = 0; corner < 3; ++corner)
+		{
+			adjacency[fillOffsets[indices[3 * triangle + corner]]++] = triangle;
+		}
+	}
+
+	auto cacheTime = std::vector<uint32_t>(vertexCount, 0);
+	auto emitted = std::vector<bool>(triangleCount, false);
+	auto deadEnds = std::vector<uint32_t>();
+	auto candidates = std::vector<uint32_t>();
+	auto result = std::vector<uint32_t>();
+	deadEnds.reserve(indices.size());
+	result.reserve(indices.size());
+
+	uint32_t time = CACHE_SIZE + 1;
+	size_t cursor = 0;
+
+	const auto nextVertex = [&]() -> uint32_t
+	{
+		// Prefer the candidate that stays in the cache the longest while still having triangles to emit.
+		auto best = NO_VERTEX;
+		auto bestPriority = -1;
+		for (const auto candidate : candidates)
+		{
+			if (liveTriangles[candidate] == 0)
+			{
+				continue;
+			}
+
+			auto priority = 0;
+			if (time - cacheTime[candidate] + 2 * liveTriangles[candidate] <= CACHE_SIZE)
+			{
+				priority = static_cast<int>(time - cacheTime[candidate]);
+			}
+
+			if (priority > bestPriority)
+			{
+				best = candidate;
+				bestPriority = priority;
+			}
+		}
+		if (best != NO_VERTEX)
+		{
+			return best;
+		}
+
+		// Dead end: everything around the fan is done, start a new cluster.
+		clusters.push_back(static_cast<uint32_t>(result.size() / 3));
+
+		while (!deadEnds.empty())
+		{
+			const auto vertex = deadEnds.back();
+			deadEnds.pop_back();
+			if (liveTriangles[vertex] > 0)
+			{
+				return vertex;
+			}
+		}
+
+		for (; cursor < vertexCount; ++cursor)
+		{
+			if (liveTriangles[cursor] > 0)
+			{
+				return static_cast<uint32_t>(cursor);
+			}
+		}
+
+		clusters.pop_back();
+		return NO_VERTEX;
+	};
+
+	clusters.push_back(0);
+	auto fanning = indices[0];
+	while (fanning != NO_VERTEX)
+	{
+		candidates.clear();
+		for (auto adjacent = adjacencyOffsets[fanning]; adjacent < adjacencyOffsets[fanning + 1]; ++adjacent)
+		{
+			const auto triangle = adjacency[adjacent];
+			if (emitted[triangle])
+			{
+				continue;
+			}
+			emitted[triangle] = true;
+
+			for (uint32_t corner = 0; corner < 3; ++corner)
+			{
+				const auto vertex = indices[3 * triangle + corner];
+				result.push_back(vertex);
+				deadEnds.push_back(vertex);
+				candidates.push_back(vertex);
+				--liveTriangles[vertex];
+
+				if (time - cacheTime[vertex] > CACHE_SIZE)
+				{
+					cacheTime[vertex] = time++;
+				}
+			}
+		}
+
+		fanning = nextVertex();
+	}
+
+	indices.swap(result);
+	return clusters;
+}
+
+void MeshOptimizer::optimizeOverdraw(std::vector<uint32_t> &indices, const std::vector<uint32_t> &clusters, const std::vector<Vertex> &verticies)
+{
+	if (clusters.size() < 2)
+	{
+		return;
+	}
+
+	const auto triangleCount = static_cast<uint32_t>(indices.size() / 3);
+	auto sorted = std::vector<Cluster>();
+	sorted.reserve(clusters.size());
+
+	auto meshCenter = glm::vec3{ 0.0F, 0.0F, 0.0F };
+	auto meshArea = 0.0F;
+
+	for (size_t i = 0; i < clusters.size(); ++i)
+	{
+		auto cluster = Cluster{ clusters[i], i + 1 < clusters.size() ? clusters[i + 1] : triangleCount, {0.0F, 0.0F, 0.0F}, {0.0F, 0.0F, 0.0F}, 0.0F };
+		auto clusterArea = 0.0F;
+
+		for (auto triangle = cluster.begin; triangle < cluster.end; ++triangle)
+		{
+			const auto &p0 = verticies[indices[3 * triangle + 0]].postion;
+			const auto &p1 = verticies[indices[3 * triangle + 1]].postion;
+			const auto &p2 = verticies[indices[3 * triangle + 2]].postion;
+
+			// The unnormalized cross product weights each triangle by its area.
+			const auto normal = glm::cross(p1 - p0, p2 - p0);
+			const auto area = glm::length(normal);
+
+			cluster.center += (p0 + p1 + p2) * (area / 3.0F);
+			cluster.normal += normal;
+			clusterArea += area;
+		}
+
+		meshCenter += cluster.center;
+		meshArea += clusterArea;
+		if (clusterArea > 0.0F)
+		{
+			cluster.center /= clusterArea;
+		}
+
+		sorted.push_back(cluster);
+	}
+
+	if (meshArea > 0.0F)
+	{
+		meshCenter /= meshArea;
+	}
+
+	// Clusters far out along their own normal are likely to occlude the rest, so they go first.
+	for (auto &cluster : sorted)
+	{
+		const auto normalLength = glm::length(cluster.normal);
+		cluster.sortKey = normalLength > 0.0F ? glm::dot(cluster.center - meshCenter, cluster.normal / normalLength) : 0.0F;
+	}
+
+	std::stable_sort(sorted.begin(), sorted.end(), [](const Cluster &lhs, const Cluster &rhs)
+	{
+		return lhs.sortKey > rhs.sortKey;
+	});
+
+	auto result = std::vector<uint32_t>();
+	result.reserve(indices.size());
+	for (const auto &cluster : sorted)
+	{
+		result.insert(result.end(), indices.begin() + 3 * cluster.begin, indices.begin() + 3 * cluster.end);
+	}
+
+	indices.swap(result);
+}
+
+void MeshOptimizer::optimizeVertexFetch(std::vector<Vertex> &verticies, std::vector<uint32_t> &indices)
+{
+	auto remap = std::vector<uint32_t>(verticies.size(), NO_VERTEX);
+	auto result = std::vector<Vertex>();
+	result.reserve(verticies.size());
+
+	for (auto &index : indices)
+	{
+		if (remap[index] == NO_VERTEX)
+		{
+			remap[index] = static_cast<uint32_t>(result.size());
+			result.push_back(verticies[index]);
+		}
+		index = remap[index];
+	}
+
+	verticies.swap(result);
+}
+
+MeshStatistics MeshOptimizer::analyze(const std::vector<uint32_t> &indices, size_t vertexCount)
+{
+	auto result = MeshStatistics();
+	if (indices.empty() || vertexCount == 0)
+	{
+		return result;
+	}
+
+	// Time only advances on a miss, so a vertex is still in the FIFO while fewer than CACHE_SIZE misses followed it.
+	auto insertedAt = std::vector<uint32_t>(vertexCount, 0);
+	uint32_t time = CACHE_SIZE + 1;
+	for (const auto index : indices)
+	{
+		if (time - insertedAt[index] > CACHE_SIZE)
+		{
+			insertedAt[index] = time++;
+		}
+	}
+	const auto misses = time - (CACHE_SIZE + 1);
+
+	result.acmr = static_cast<float>(misses) / static_cast<float>(indices.size() / 3);
+	result.atvr = static_cast<float>(misses) / static_cast<float>(vertexCount);
+
+	return result;
+}
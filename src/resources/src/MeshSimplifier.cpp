@@ -0,0 +1,345 @@
+#include "MeshSimplifier.h"
+#include "BoundsCalculator.h"
+#include "LoggerAPI.h"
+#include "MeshOptimizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <unordered_map>
+
+namespace {
+// Each LOD aims at half the triangles of the previous one and is dropped if it can not get below this fraction.
+constexpr float MIN_LOD_REDUCTION = 0.85F;
+
+// Sum of squared distances to a set of planes, stored as the upper half of the symmetric 4x4 matrix.
+struct Quadric
+{
+	float a2 = 0.0F, ab = 0.0F, ac = 0.0F, ad = 0.0F;
+	float b2 = 0.0F, bc = 0.0F, bd = 0.0F;
+	float c2 = 0.0F, cd = 0.0F;
+	float d2 = 0.0F;
+	float weight = 0.0F;
+
+	void addPlane(const glm::vec3 &normal, float distance, float planeWeight)
+	{
+		a2 += normal.x * normal.x * planeWeight;
+		ab += normal.x * normal.y * planeWeight;
+		ac += normal.x * normal.z * planeWeight;
+		ad += normal.x * distance * planeWeight;
+		b2 += normal.y * normal.y * planeWeight;
+		bc += normal.y * normal.z * planeWeight;
+		bd += normal.y * distance * planeWeight;
+		c2 += normal.z * normal.z * planeWeight;
+		cd += normal.z * distance * planeWeight;
+		d2 += distance * distance * planeWeight;
+		weight += planeWeight;
+	}
+
+	void add(const Quadric &other)
+	{
+		a2 += other.a2; ab += other.ab; ac += other.ac; ad += other.ad;
+		b2 += other.b2; bc += other.bc; bd += other.bd;
+		c2 += other.c2; cd += other.cd;
+		d2 += other.d2;
+		weight += other.weight;
+	}
+
+	// Area weighted mean squared distance of p to the planes.
+	float error(const glm::vec3 &p) const
+	{
+		const auto sum = a2 * p.x * p.x + 2.0F * ab * p.x * p.y + 2.0F * ac * p.x * p.z + 2.0F * ad * p.x
+			+ b2 * p.y * p.y + 2.0F * bc * p.y * p.z + 2.0F * bd * p.y
+			+ c2 * p.z * p.z + 2.0F * cd * p.z
+			+ d2;
+		return weight > 0.0F ? std::max(sum, 0.0F) / weight : 0.0F;
+	}
+};
+
+struct Collapse
+{
+	uint32_t from;
+	uint32_t to;
+	float cost;
+};
+
+uint64_t edgeKey(uint32_t a, uint32_t b)
+{
+	return a < b ? (uint64_t{ a } << 32) | b : (uint64_t{ b } << 32) | a;
+}
+
+// Open borders and attribute seams (one position shared by several verticies) must stay where they are,
+// collapsing them would tear holes into the surface.
+std::vector<bool> findLockedVerticies(const std::vector<Vertex> &verticies, const std::vector<uint32_t> &indices)
+{
+	auto locked = std::vector<bool>(verticies.size(), false);
+
+	auto edgeUse = std::unordered_map<uint64_t, uint32_t>();
+	edgeUse.reserve(indices.size());
+	for (size_t i = 0; i < indices.size(); i += 3)
+	{
+		for (size_t corner = 0; corner < 3; ++corner)
+		{
+			++edgeUse[edgeKey(indices[i + corner], indices[i + (corner + 1) % 3])];
+		}
+	}
+	for (const auto &[key, count] : edgeUse)
+	{
+		if (count == 1)
+		{
+			locked[static_cast<uint32_t>(key >> 32)] = true;
+			locked[static_cast<uint32_t>(key)] = true;
+		}
+	}
+
+	auto byPosition = std::vector<uint32_t>(verticies.size());
+	for (uint32_t vertex = 0; vertex < verticies.size(); ++vertex)
+	{
+		byPosition[vertex] = vertex;
+	}
+	const auto positionLess = [&](uint32_t lhs, uint32_t rhs)
+	{
+		const auto &a = verticies[lhs].postion;
+		const auto &b = verticies[rhs].postion;
+		return a.x != b.x ? a.x < b.x : a.y != b.y ? a.y < b.y : a.z < b.z;
+	};
+	std::sort(byPosition.begin(), byPosition.end(), positionLess);
+	for (size_t i = 1; i < byPosition.size(); ++i)
+	{
+		if (verticies[byPosition[i - 1]].postion == verticies[byPosition[i]].postion)
+		{
+			locked[byPosition[i - 1]] = true;
+			locked[byPosition[i]] = true;
+		}
+	}
+
+	return locked;
+}
+
+glm::vec3 triangleNormal(const glm::vec3 &p0, const glm::vec3 &p1, const glm::vec3 &p2)
+{
+	return glm::cross(p1 - p0, p2 - p0);
+}
+}
+
+std::vector<uint32_t> MeshSimplifier::simplify(const std::vector<Vertex> &verticies, const std::vector<uint32_t> &indices, size_t targetIndexCount, float maxError, float &resultError)
+{
+	resultError = 0.0F;
+	auto result = indices;
+	const auto vertexCount = verticies.size();
+	const auto maxCost = maxError * maxError;
+
+	const auto locked = findLockedVerticies(verticies, indices);
+
+	auto quadrics = std::vector<Quadric>(vertexCount);
+	for (size_t i = 0; i < indices.size(); i += 3)
+	{
+		const auto &p0 = verticies[indices[i + 0]].postion;
+		const auto &p1 = verticies[indices[i + 1]].postion;
+		const auto &p2 = verticies[indices[i + 2]].postion;
+
+		const auto normal = triangleNormal(p0, p1, p2);
+		const auto area = glm::length(normal);
+		if (area <= 0.0F)
+		{
+			continue;
+		}
+
+		const auto unitNormal = normal / area;
+		const auto distance = -glm::dot(unitNormal, p0);
+		for (size_t corner = 0; corner < 3; ++corner)
+		{
+			quadrics[indices[i + corner]].addPlane(unitNormal, distance, area);
+		}
+	}
+
+	auto adjacencyOffsets = std::vector<uint32_t>(vertexCount + 1);
+	auto adjacency = std::vector<uint32_t>();
+	auto collapseTarget = std::vector<uint32_t>(vertexCount);
+	auto touched = std::vector<bool>(vertexCount);
+	auto edges = std::vector<uint64_t>();
+	auto collapses = std::vector<Collapse>();
+
+	// Every pass collapses a set of independent edges, cheapest first, then compacts the index buffer.
+	while (result.size() > targetIndexCount)
+	{
+		std::fill(adjacencyOffsets.begin(), adjacencyOffsets.end(), 0);
+		for (const auto index : result)
+		{
+			++adjacencyOffsets[index + 1];
+		}
+		for (size_t vertex = 0; vertex < vertexCount; ++vertex)
+		{
+			adjacencyOffsets[vertex + 1] += adjacencyOffsets[vertex];
+		}
+		adjacency.resize(result.size());
+		auto fillOffsets = std::vector<uint32_t>(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+		for (size_t i = 0; i < result.size(); ++i)
+		{
+			adjacency[fillOffsets[result[i]]++] = static_cast<uint32_t>(i / 3);
+		}
+
+		edges.clear();
+		for (size_t i = 0; i < result.size(); i += 3)
+		{
+			for (size_t corner = 0; corner < 3; ++corner)
+			{
+				edges.push_back(edgeKey(result[i + corner], result[i + (corner + 1) % 3]));
+			}
+		}
+		std::sort(edges.begin(), edges.end());
+		edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+		collapses.clear();
+		for (const auto edge : edges)
+		{
+			const auto a = static_cast<uint32_t>(edge >> 32);
+			const auto b = static_cast<uint32_t>(edge);
+
+			auto combined = quadrics[a];
+			combined.add(quadrics[b]);
+
+			const auto costToB = locked[a] ? std::numeric_limits<float>::max() : combined.error(verticies[b].postion);
+			const auto costToA = locked[b] ? std::numeric_limits<float>::max() : combined.error(verticies[a].postion);
+			const auto collapse = costToB <= costToA ? Collapse{ a, b, costToB } : Collapse{ b, a, costToA };
+
+			if (collapse.cost <= maxCost)
+			{
+				collapses.push_back(collapse);
+			}
+		}
+		std::sort(collapses.begin(), collapses.end(), [](const Collapse &lhs, const Collapse &rhs)
+		{
+			return lhs.cost < rhs.cost;
+		});
+
+		for (uint32_t vertex = 0; vertex < vertexCount; ++vertex)
+		{
+			collapseTarget[vertex] = vertex;
+		}
+		std::fill(touched.begin(), touched.end(), false);
+
+		const auto trianglesToRemove = (result.size() - targetIndexCount) / 3;
+		size_t trianglesRemoved = 0;
+		size_t collapsed = 0;
+
+		for (const auto &collapse : collapses)
+		{
+			if (touched[collapse.from] || touched[collapse.to])
+			{
+				continue;
+			}
+
+			// Reject the collapse if any surviving triangle around the moved vertex would flip over.
+			const auto &target = verticies[collapse.to].postion;
+			auto flips = false;
+			size_t removed = 0;
+			for (auto adjacent = adjacencyOffsets[collapse.from]; adjacent < adjacencyOffsets[collapse.from + 1] && !flips; ++adjacent)
+			{
+				const auto *triangle = &result[3 * adjacency[adjacent]];
+				if (triangle[0] == collapse.to || triangle[1] == collapse.to || triangle[2] == collapse.to)
+				{
+					++removed;
+					continue;
+				}
+
+				glm::vec3 moved[3];
+				for (size_t corner = 0; corner < 3; ++corner)
+				{
+					moved[corner] = triangle[corner] == collapse.from ? target : verticies[triangle[corner]].postion;
+				}
+				const auto before = triangleNormal(verticies[triangle[0]].postion, verticies[triangle[1]].postion, verticies[triangle[2]].postion);
+				const auto after = triangleNormal(moved[0], moved[1], moved[2]);
+				flips = glm::dot(before, after) <= 0.0F;
+			}
+			if (flips)
+			{
+				continue;
+			}
+
+			collapseTarget[collapse.from] = collapse.to;
+			quadrics[collapse.to].add(quadrics[collapse.from]);
+			resultError = std::max(resultError, collapse.cost);
+			++collapsed;
+
+			// Neighbours keep their positions for the rest of the pass so the flip checks above stay valid.
+			for (const auto vertex : { collapse.from, collapse.to })
+			{
+				for (auto adjacent = adjacencyOffsets[vertex]; adjacent < adjacencyOffsets[vertex + 1]; ++adjacent)
+				{
+					const auto *triangle = &result[3 * adjacency[adjacent]];
+					touched[triangle[0]] = touched[triangle[1]] = touched[triangle[2]] = true;
+				}
+			}
+
+			trianglesRemoved += removed;
+			if (trianglesRemoved >= trianglesToRemove)
+			{
+				break;
+			}
+		}
+
+		if (collapsed == 0)
+		{
+			break;
+		}
+
+		size_t write = 0;
+		for (size_t read = 0; read < result.size(); read += 3)
+		{
+			const auto i0 = collapseTarget[result[read + 0]];
+			const auto i1 = collapseTarget[result[read + 1]];
+			const auto i2 = collapseTarget[result[read + 2]];
+			if (i0 == i1 || i1 == i2 || i0 == i2)
+			{
+				continue;
+			}
+
+			result[write++] = i0;
+			result[write++] = i1;
+			result[write++] = i2;
+		}
+		result.resize(write);
+	}
+
+	resultError = std::sqrt(resultError);
+	return result;
+}
+
+std::vector<MeshLod> MeshSimplifier::generateLods(const std::string &name, const std::vector<Vertex> &verticies, std::vector<uint32_t> &indices)
+{
+	auto lods = std::vector<MeshLod>{ { 0, static_cast<uint32_t>(indices.size()), 0.0F } };
+	if (verticies.empty() || indices.empty())
+	{
+		return lods;
+	}
+
+	const auto bounds = BoundsCalculator::computeAabb(verticies);
+	const auto maxError = MAX_RELATIVE_ERROR * glm::length(bounds.max - bounds.min);
+
+	// Every LOD is simplified from the full mesh so its error is measured against the original surface.
+	const auto source = indices;
+	auto summary = std::to_string(source.size() / 3);
+
+	while (lods.size() < MAX_LOD_COUNT)
+	{
+		const auto previousCount = lods.back().indexCount;
+		const auto targetCount = previousCount / 6 * 3;
+
+		auto error = 0.0F;
+		auto lod = simplify(verticies, source, targetCount, maxError, error);
+		if (static_cast<float>(lod.size()) > static_cast<float>(previousCount) * MIN_LOD_REDUCTION)
+		{
+			break;
+		}
+
+		MeshOptimizer::optimizeVertexCache(lod, verticies.size());
+
+		lods.push_back({ static_cast<uint32_t>(indices.size()), static_cast<uint32_t>(lod.size()), std::max(error, lods.back().error) });
+		indices.insert(indices.end(), lod.begin(), lod.end());
+		summary += ", " + std::to_string(lod.size() / 3);
+	}
+
+	LoggerAPI::getLogger()->logInfo("Generated " + std::to_string(lods.size()) + " LODs for model " + name + " (" + summary + " triangles)");
+	return lods;
+}
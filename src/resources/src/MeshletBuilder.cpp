@@ -0,0 +1,147 @@
+#include "MeshletBuilder.h"
+#include "LoggerAPI.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+// Below this the cone is so wide that no view direction sees only back faces.
+constexpr float MIN_CONE_DOT = 0.1F;
+
+glm::vec3 triangleNormal(const std::vector<Vertex> &verticies, const uint32_t *triangle)
+{
+	const auto &a = verticies[triangle[0]].postion;
+	const auto &b = verticies[triangle[1]].postion;
+	const auto &c = verticies[triangle[2]].postion;
+
+	// Front faces are clockwise on screen, with y down and z into it their normal points back at the viewer.
+	const auto normal = glm::cross(c - a, b - a);
+	const auto length = glm::length(normal);
+	return length > 0.0F ? normal / length : glm::vec3(0.0F);
+}
+
+Meshlet finishMeshlet(const std::vector<Vertex> &verticies, const std::vector<uint32_t> &indices, const std::vector<glm::vec3> &normals, size_t firstIndex, size_t endIndex)
+{
+	auto meshlet = Meshlet();
+	meshlet.firstIndex = static_cast<uint32_t>(firstIndex);
+	meshlet.indexCount = static_cast<uint32_t>(endIndex - firstIndex);
+
+	auto minimum = verticies[indices[firstIndex]].postion;
+	auto maximum = minimum;
+	for (auto i = firstIndex; i < endIndex; ++i)
+	{
+		minimum = glm::min(minimum, verticies[indices[i]].postion);
+		maximum = glm::max(maximum, verticies[indices[i]].postion);
+	}
+
+	meshlet.center = (minimum + maximum) * 0.5F;
+	auto radiusSquared = 0.0F;
+	for (auto i = firstIndex; i < endIndex; ++i)
+	{
+		const auto offset = verticies[indices[i]].postion - meshlet.center;
+		radiusSquared = std::max(radiusSquared, glm::dot(offset, offset));
+	}
+	meshlet.radius = std::sqrt(radiusSquared);
+
+	auto normalSum = glm::vec3(0.0F);
+	for (auto triangle = firstIndex / 3; triangle < endIndex / 3; ++triangle)
+	{
+		normalSum += normals[triangle];
+	}
+
+	const auto length = glm::length(normalSum);
+	meshlet.coneAxis = length > 0.0F ? normalSum / length : glm::vec3(0.0F, 0.0F, 1.0F);
+	meshlet.coneCutoff = 1.0F;
+	if (length == 0.0F)
+	{
+		return meshlet;
+	}
+
+	auto minDot = 1.0F;
+	for (auto triangle = firstIndex / 3; triangle < endIndex / 3; ++triangle)
+	{
+		// Degenerate triangles are never rasterized, so they do not widen the cone.
+		if (normals[triangle] != glm::vec3(0.0F))
+		{
+			minDot = std::min(minDot, glm::dot(meshlet.coneAxis, normals[triangle]));
+		}
+	}
+
+	if (minDot > MIN_CONE_DOT)
+	{
+		// Sine of the cone half angle, the back facing test compares the view direction against the cone widened by 90 degrees.
+		meshlet.coneCutoff = std::sqrt(1.0F - minDot * minDot);
+	}
+
+	return meshlet;
+}
+}
+
+std::vector<Meshlet> MeshletBuilder::build(const std::string &name, const std::vector<Vertex> &verticies, const std::vector<uint32_t> &indices, size_t indexCount)
+{
+	auto meshlets = std::vector<Meshlet>();
+	const auto triangleCount = indexCount / 3;
+	if (triangleCount == 0)
+	{
+		return meshlets;
+	}
+
+	auto normals = std::vector<glm::vec3>(triangleCount);
+	for (size_t triangle = 0; triangle < triangleCount; ++triangle)
+	{
+		normals[triangle] = triangleNormal(verticies, &indices[triangle * 3]);
+	}
+
+	// Holds the meshlet that last referenced each vertex, so counting new verticies needs no per meshlet reset.
+	auto owner = std::vector<uint32_t>(verticies.size(), std::numeric_limits<uint32_t>::max());
+	auto current = uint32_t{ 0 };
+	auto firstTriangle = size_t{ 0 };
+	auto vertexCount = size_t{ 0 };
+	auto normalSum = glm::vec3(0.0F);
+
+	const auto countNewVerticies = [&](const uint32_t *triangle)
+	{
+		size_t count = 0;
+		for (size_t corner = 0; corner < 3; ++corner)
+		{
+			const auto isRepeat = std::find(triangle, triangle + corner, triangle[corner]) != triangle + corner;
+			if (owner[triangle[corner]] != current && !isRepeat)
+			{
+				++count;
+			}
+		}
+		return count;
+	};
+
+	for (size_t triangle = 0; triangle < triangleCount; ++triangle)
+	{
+		const auto *corners = &indices[triangle * 3];
+		const auto trianglesInMeshlet = triangle - firstTriangle;
+
+		const auto isFull = vertexCount + countNewVerticies(corners) > MAX_VERTICES || trianglesInMeshlet + 1 > MAX_TRIANGLES;
+		const auto averageLength = glm::length(normalSum);
+		const auto diverges = averageLength > 0.0F && normals[triangle] != glm::vec3(0.0F) && glm::dot(normalSum / averageLength, normals[triangle]) < MIN_NORMAL_DOT;
+
+		if (trianglesInMeshlet > 0 && (isFull || diverges))
+		{
+			meshlets.push_back(finishMeshlet(verticies, indices, normals, firstTriangle * 3, triangle * 3));
+			++current;
+			firstTriangle = triangle;
+			vertexCount = 0;
+			normalSum = glm::vec3(0.0F);
+		}
+
+		vertexCount += countNewVerticies(corners);
+		for (size_t corner = 0; corner < 3; ++corner)
+		{
+			owner[corners[corner]] = current;
+		}
+		normalSum += normals[triangle];
+	}
+	meshlets.push_back(finishMeshlet(verticies, indices, normals, firstTriangle * 3, triangleCount * 3));
+
+	LoggerAPI::getLogger()->logInfo("Split " + name + " into " + std::to_string(meshlets.size()) + " meshlets of " + std::to_string(triangleCount) + " triangles");
+
+	return meshlets;
+}
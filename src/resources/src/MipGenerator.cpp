@@ -0,0 +1,128 @@
+#include "MipGenerator.h"
+
+#include <algorithm>
+#include <cassert>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+namespace {
+constexpr std::uint32_t CHANNELS = 4;
+
+void averageQuadScalar(const std::uint8_t *row0, const std::uint8_t *row1, std::uint32_t column0, std::uint32_t column1, std::uint8_t *destination)
+{
+	for (std::uint32_t channel = 0; channel < CHANNELS; ++channel)
+	{
+		const auto sum = row0[column0 * CHANNELS + channel] + row0[column1 * CHANNELS + channel] + row1[column0 * CHANNELS + channel] + row1[column1 * CHANNELS + channel];
+		destination[channel] = static_cast<std::uint8_t>((sum + 2) / 4);
+	}
+}
+
+#if defined(__AVX2__)
+// Sums horizontal pixel pairs of 8 source pixels from each row, giving 16 bit sums for 4 destination pixels
+// ordered [0, 1 | 2, 3] across the two 128 bit lanes.
+__m256i sumPairs(const std::uint8_t *row0, const std::uint8_t *row1)
+{
+	const auto zero = _mm256_setzero_si256();
+	const auto top = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(row0));
+	const auto bottom = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(row1));
+
+	const auto low = _mm256_add_epi16(_mm256_unpacklo_epi8(top, zero), _mm256_unpacklo_epi8(bottom, zero));
+	const auto high = _mm256_add_epi16(_mm256_unpackhi_epi8(top, zero), _mm256_unpackhi_epi8(bottom, zero));
+	const auto sum = _mm256_add_epi16(_mm256_unpacklo_epi64(low, high), _mm256_unpackhi_epi64(low, high));
+
+	return _mm256_srli_epi16(_mm256_add_epi16(sum, _mm256_set1_epi16(2)), 2);
+}
+
+// Processes 8 destination pixels per iteration and returns how many were written.
+std::uint32_t downsampleRow(const std::uint8_t *row0, const std::uint8_t *row1, std::uint32_t width, std::uint8_t *destination)
+{
+	std::uint32_t x = 0;
+	for (; x + 8 <= width; x += 8)
+	{
+		const auto first = sumPairs(row0 + x * 2 * CHANNELS, row1 + x * 2 * CHANNELS);
+		const auto second = sumPairs(row0 + (x * 2 + 8) * CHANNELS, row1 + (x * 2 + 8) * CHANNELS);
+
+		// Packing works per lane, which interleaves the halves as [0, 1, 4, 5 | 2, 3, 6, 7].
+		const auto packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(first, second), _MM_SHUFFLE(3, 1, 2, 0));
+		_mm256_storeu_si256(reinterpret_cast<__m256i *>(destination + x * CHANNELS), packed);
+	}
+	return x;
+}
+#elif defined(__SSE2__) || defined(_M_X64)
+// Sums horizontal pixel pairs of 4 source pixels from each row, giving 16 bit sums for 2 destination pixels.
+__m128i sumPairs(const std::uint8_t *row0, const std::uint8_t *row1)
+{
+	const auto zero = _mm_setzero_si128();
+	const auto top = _mm_loadu_si128(reinterpret_cast<const __m128i *>(row0));
+	const auto bottom = _mm_loadu_si128(reinterpret_cast<const __m128i *>(row1));
+
+	const auto low = _mm_add_epi16(_mm_unpacklo_epi8(top, zero), _mm_unpacklo_epi8(bottom, zero));
+	const auto high = _mm_add_epi16(_mm_unpackhi_epi8(top, zero), _mm_unpackhi_epi8(bottom, zero));
+	const auto sum = _mm_add_epi16(_mm_unpacklo_epi64(low, high), _mm_unpackhi_epi64(low, high));
+
+	return _mm_srli_epi16(_mm_add_epi16(sum, _mm_set1_epi16(2)), 2);
+}
+
+// Processes 4 destination pixels per iteration and returns how many were written.
+std::uint32_t downsampleRow(const std::uint8_t *row0, const std::uint8_t *row1, std::uint32_t width, std::uint8_t *destination)
+{
+	std::uint32_t x = 0;
+	for (; x + 4 <= width; x += 4)
+	{
+		const auto first = sumPairs(row0 + x * 2 * CHANNELS, row1 + x * 2 * CHANNELS);
+		const auto second = sumPairs(row0 + (x * 2 + 4) * CHANNELS, row1 + (x * 2 + 4) * CHANNELS);
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(destination + x * CHANNELS), _mm_packus_epi16(first, second));
+	}
+	return x;
+}
+#else
+std::uint32_t downsampleRow(const std::uint8_t *, const std::uint8_t *, std::uint32_t, std::uint8_t *)
+{
+	return 0;
+}
+#endif
+}
+
+std::vector<Rgba8Image> MipGenerator::generateMips(Rgba8Image base)
+{
+	auto mips = std::vector<Rgba8Image>();
+	mips.push_back(std::move(base));
+
+	while (mips.back().width > 1 || mips.back().height > 1)
+	{
+		mips.push_back(downsample(mips.back()));
+	}
+
+	return mips;
+}
+
+Rgba8Image MipGenerator::downsample(const Rgba8Image &source)
+{
+	assert(source.pixels.size() == size_t{ source.width } * source.height * CHANNELS);
+
+	auto result = Rgba8Image();
+	result.width = std::max<std::uint32_t>(1, source.width / 2);
+	result.height = std::max<std::uint32_t>(1, source.height / 2);
+	result.pixels.resize(size_t{ result.width } * result.height * CHANNELS);
+
+	const auto sourceStride = size_t{ source.width } * CHANNELS;
+	for (std::uint32_t y = 0; y < result.height; ++y)
+	{
+		const auto *row0 = source.pixels.data() + std::min(y * 2, source.height - 1) * sourceStride;
+		const auto *row1 = source.pixels.data() + std::min(y * 2 + 1, source.height - 1) * sourceStride;
+		auto *destination = result.pixels.data() + size_t{ y } * result.width * CHANNELS;
+
+		// A single column source has no pairs to vectorize.
+		auto x = source.width > 1 ? downsampleRow(row0, row1, result.width, destination) : 0;
+		for (; x < result.width; ++x)
+		{
+			averageQuadScalar(row0, row1, std::min(x * 2, source.width - 1), std::min(x * 2 + 1, source.width - 1), destination + x * CHANNELS);
+		}
+	}
+
+	return result;
+}
@@ -0,0 +1,132 @@
+#include "ModelCache.h"
+
+#include <algorithm>
+#include <cassert>
+
+ModelCache::ModelCache(EvictFunction evict, ReloadFunction reload, size_t budget) :
+	m_budget(budget),
+	m_residentBytes(0),
+	m_evict(std::move(evict)),
+	m_reload(std::move(reload))
+{
+}
+
+bool ModelCache::reset(size_t indexLimit)
+{
+	std::lock_guard lock(m_mutex);
+
+	const auto inUse = std::any_of(m_entries.begin(), m_entries.end(), [](const Entry &entry) { return entry.references != 0 || entry.loading; });
+	if (inUse)
+	{
+		return false;
+	}
+
+	m_lru.clear();
+	m_entries.clear();
+	for (size_t i = 0; i < indexLimit; ++i)
+	{
+		m_entries.emplace_back();
+	}
+	m_residentBytes = 0;
+	return true;
+}
+
+void ModelCache::setBudget(size_t bytes)
+{
+	std::lock_guard lock(m_mutex);
+
+	m_budget = bytes;
+	trim();
+}
+
+size_t ModelCache::residentBytes() const
+{
+	std::lock_guard lock(m_mutex);
+	return m_residentBytes;
+}
+
+size_t ModelCache::referencedCount() const
+{
+	std::lock_guard lock(m_mutex);
+	return static_cast<size_t>(std::count_if(m_entries.begin(), m_entries.end(), [](const Entry &entry) { return entry.references != 0; }));
+}
+
+void ModelCache::insert(ModelHandle model, size_t bytes, bool evictable)
+{
+	std::lock_guard lock(m_mutex);
+	assert(model.index < m_entries.size());
+
+	auto &entry = m_entries[model.index];
+	entry.resident = true;
+	entry.evictable = evictable;
+	entry.acquired = false;
+	if (!evictable)
+	{
+		return;
+	}
+
+	entry.bytes = bytes;
+	entry.lruPosition = m_lru.insert(m_lru.begin(), model);
+	m_residentBytes += bytes;
+
+	trim();
+}
+
+std::atomic<uint32_t> *ModelCache::acquire(ModelHandle model)
+{
+	auto lock = std::unique_lock(m_mutex);
+	assert(model.index < m_entries.size());
+
+	auto &entry = m_entries[model.index];
+	m_loaded.wait(lock, [&entry]() { return !entry.loading; });
+
+	if (!entry.resident)
+	{
+		// Reloading imports the model from disk, holding the lock for that would stall every other model.
+		entry.loading = true;
+		lock.unlock();
+		const auto bytes = m_reload(model);
+		lock.lock();
+		entry.loading = false;
+		m_loaded.notify_all();
+
+		if (!bytes)
+		{
+			return nullptr;
+		}
+
+		entry.resident = true;
+		entry.bytes = *bytes;
+		entry.lruPosition = m_lru.insert(m_lru.begin(), model);
+		m_residentBytes += *bytes;
+	}
+	else if (entry.evictable)
+	{
+		m_lru.splice(m_lru.begin(), m_lru, entry.lruPosition);
+	}
+
+	++entry.references;
+	entry.acquired = true;
+	trim();
+
+	return &entry.references;
+}
+
+void ModelCache::trim()
+{
+	for (auto it = m_lru.end(); it != m_lru.begin() && m_residentBytes > m_budget;)
+	{
+		--it;
+		auto &entry = m_entries[it->index];
+		if (entry.references != 0 || !entry.acquired)
+		{
+			continue;
+		}
+
+		m_evict(*it);
+		entry.resident = false;
+		m_residentBytes -= entry.bytes;
+		entry.bytes = 0;
+		it = m_lru.erase(it);
+	}
+}
@@ -0,0 +1,176 @@
+#include "ModelImporter.h"
+#include "LoggerAPI.h"
+#include "MeshOptimizer.h"
+#include "MeshSimplifier.h"
+#include "MeshletBuilder.h"
+#include "tiny_obj_loader.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <unordered_map>
+
+namespace {
+const glm::vec4 DEFAULT_COLOR = { 1.0F, 1.0F, 1.0F, 1.0F };
+
+struct VertexHash
+{
+	size_t operator()(const Vertex &vertex) const
+	{
+		const float components[] = {
+			vertex.postion.x, vertex.postion.y, vertex.postion.z,
+			vertex.color.x, vertex.color.y, vertex.color.z, vertex.color.w
+		};
+
+		size_t hash = 14695981039346656037ULL;
+		for (const auto component : components)
+		{
+			uint32_t bits;
+			std::memcpy(&bits, &component, sizeof(bits));
+			hash = (hash ^ bits) * 1099511628211ULL;
+		}
+		return hash;
+	}
+};
+
+struct VertexEqual
+{
+	bool operator()(const Vertex &lhs, const Vertex &rhs) const
+	{
+		return lhs.postion == rhs.postion && lhs.color == rhs.color;
+	}
+};
+
+// Empty when the face refers to a vertex the file does not have.
+std::optional<Vertex> readVertex(const tinyobj::attrib_t &attrib, const tinyobj::index_t &index)
+{
+	if (index.vertex_index < 0 || static_cast<size_t>(index.vertex_index) >= attrib.vertices.size() / 3)
+	{
+		return std::nullopt;
+	}
+	const auto vertexIndex = static_cast<size_t>(index.vertex_index);
+
+	Vertex result;
+	result.postion = {
+		attrib.vertices[3 * vertexIndex + 0],
+		attrib.vertices[3 * vertexIndex + 1],
+		attrib.vertices[3 * vertexIndex + 2]
+	};
+
+	if (attrib.colors.size() == attrib.vertices.size())
+	{
+		result.color = {
+			attrib.colors[3 * vertexIndex + 0],
+			attrib.colors[3 * vertexIndex + 1],
+			attrib.colors[3 * vertexIndex + 2],
+			1.0F
+		};
+	}
+	else
+	{
+		result.color = DEFAULT_COLOR;
+	}
+
+	return result;
+}
+}
+
+std::optional<ModelResource> ModelImporter::importObj(const ModelSource &source)
+{
+	tinyobj::attrib_t attrib;
+	std::vector<tinyobj::shape_t> shapes;
+	std::vector<tinyobj::material_t> materials;
+	std::string error;
+
+	if (!tinyobj::LoadObj(&attrib, &shapes, &materials, &error, source.path.c_str()))
+	{
+		LoggerAPI::getLogger()->logError("Could not load model " + source.path + ": " + error);
+		return std::nullopt;
+	}
+
+	if (!error.empty())
+	{
+		LoggerAPI::getLogger()->logWarning(source.path + ": " + error);
+	}
+
+	size_t indexCount = 0;
+	for (const auto &shape : shapes)
+	{
+		indexCount += shape.mesh.indices.size();
+	}
+
+	std::vector<Vertex> verticies;
+	std::vector<uint32_t> indices;
+	indices.reserve(indexCount);
+
+	std::unordered_map<Vertex, uint32_t, VertexHash, VertexEqual> uniqueVerticies;
+	uniqueVerticies.reserve(indexCount);
+
+	for (const auto &shape : shapes)
+	{
+		for (const auto &index : shape.mesh.indices)
+		{
+			const auto vertex = readVertex(attrib, index);
+			if (!vertex)
+			{
+				LoggerAPI::getLogger()->logError("Could not load model " + source.path + ": vertex index " + std::to_string(index.vertex_index) + " is out of range");
+				return std::nullopt;
+			}
+
+			const auto [it, inserted] = uniqueVerticies.try_emplace(*vertex, static_cast<uint32_t>(verticies.size()));
+			if (inserted)
+			{
+				verticies.push_back(*vertex);
+			}
+			indices.push_back(it->second);
+		}
+	}
+
+	MeshOptimizer::optimize(source.name, verticies, indices);
+	auto lods = MeshSimplifier::generateLods(source.name, verticies, indices);
+	auto meshlets = MeshletBuilder::build(source.name, verticies, indices, lods.front().indexCount);
+
+	return ModelResource(source.name, verticies, std::move(indices), VertexLayoutKind::Quantized, std::move(lods), std::move(meshlets));
+}
+
+std::vector<ModelResource> ModelImporter::importObjs(const std::vector<ModelSource> &sources)
+{
+	auto imported = std::vector<std::optional<ModelResource>>(sources.size());
+	std::atomic<size_t> nextSource{ 0 };
+
+	const auto worker = [&]()
+	{
+		for (auto i = nextSource++; i < sources.size(); i = nextSource++)
+		{
+			imported[i] = importObj(sources[i]);
+		}
+	};
+
+	const auto hardwareThreads = std::max(1U, std::thread::hardware_concurrency());
+	const auto threadCount = std::min(static_cast<size_t>(hardwareThreads), sources.size());
+
+	std::vector<std::thread> workers;
+	workers.reserve(threadCount);
+	for (size_t i = 0; i < threadCount; ++i)
+	{
+		workers.emplace_back(worker);
+	}
+
+	for (auto &thread : workers)
+	{
+		thread.join();
+	}
+
+	auto result = std::vector<ModelResource>();
+	result.reserve(sources.size());
+	for (auto &model : imported)
+	{
+		if (model)
+		{
+			result.push_back(std::move(*model));
+		}
+	}
+
+	return result;
+}
@@ -1,8 +1,125 @@
 #include "ModelResource.h"
+#include "BoundsCalculator.h"
+#include "VertexEncoder.h"
 
-ModelResource::ModelResource(std::string modelName, std::vector<Vertex> verticies, std::vector<uint32_t> indices) :
+#include <cstring>
+#include <limits>
+
+namespace {
+IndexType chooseIndexType(size_t vertexCount)
+{
+	return vertexCount <= size_t{ std::numeric_limits<uint16_t>::max() } + 1 ? IndexType::Uint16 : IndexType::Uint32;
+}
+
+std::vector<std::byte> encodeIndices(const std::vector<uint32_t> &indices, IndexType type)
+{
+	auto result = std::vector<std::byte>(indices.size() * indexSize(type));
+
+	if (type == IndexType::Uint32)
+	{
+		std::memcpy(result.data(), indices.data(), result.size());
+		return result;
+	}
+
+	for (size_t i = 0; i < indices.size(); ++i)
+	{
+		const auto index = static_cast<uint16_t>(indices[i]);
+		std::memcpy(result.data() + i * sizeof(uint16_t), &index, sizeof(uint16_t));
+	}
+
+	return result;
+}
+}
+
+ModelResource::ModelResource(std::string modelName, std::span<const Vertex> verticies, std::vector<uint32_t> indices, VertexLayoutKind layout, std::vector<MeshLod> lods, std::vector<Meshlet> meshlets) :
 	BasicResource(std::move(modelName)),
-	verticies(std::move(verticies)),
-	indicies(std::move(indices))
+	lods(std::move(lods)),
+	meshlets(std::move(meshlets)),
+	m_layout(layout),
+	m_indexType(chooseIndexType(verticies.size())),
+	m_encoding(MeshEncoding::Raw),
+	m_bounds(BoundsCalculator::compute(verticies))
+{
+	if (m_layout != VertexLayoutKind::Float)
+	{
+		m_quantization = VertexEncoder::computeQuantization(m_bounds.box);
+	}
+	this->verticies = VertexEncoder::encode(verticies, m_layout, m_quantization);
+	indicies = encodeIndices(indices, m_indexType);
+
+	if (this->lods.empty())
+	{
+		this->lods.push_back({ 0, static_cast<uint32_t>(indices.size()), 0.0F });
+	}
+}
+
+ModelResource::ModelResource(std::string modelName, std::span<const std::byte> mappedVerticies, std::span<const std::byte> mappedIndices, std::span<const MeshLod> mappedLods, std::span<const Meshlet> mappedMeshlets,
+	VertexLayoutKind layout, const VertexQuantization &quantization, IndexType indexType, MeshEncoding encoding, const Bounds &bounds) :
+	BasicResource(std::move(modelName)),
+	m_mappedVerticies(mappedVerticies),
+	m_mappedIndicies(mappedIndices),
+	m_mappedLods(mappedLods),
+	m_mappedMeshlets(mappedMeshlets),
+	m_layout(layout),
+	m_quantization(quantization),
+	m_indexType(indexType),
+	m_encoding(encoding),
+	m_bounds(bounds)
+{
+}
+
+std::span<const std::byte> ModelResource::vertexData() const
+{
+	return m_mappedVerticies.empty() ? std::span<const std::byte>(verticies) : m_mappedVerticies;
+}
+
+std::span<const std::byte> ModelResource::indexData() const
+{
+	return m_mappedIndicies.empty() ? std::span<const std::byte>(indicies) : m_mappedIndicies;
+}
+
+std::span<const MeshLod> ModelResource::lodData() const
+{
+	return m_mappedLods.empty() ? std::span<const MeshLod>(lods) : m_mappedLods;
+}
+
+std::span<const Meshlet> ModelResource::meshletData() const
+{
+	return m_mappedMeshlets.empty() ? std::span<const Meshlet>(meshlets) : m_mappedMeshlets;
+}
+
+VertexLayoutKind ModelResource::vertexLayout() const
+{
+	return m_layout;
+}
+
+const VertexQuantization &ModelResource::quantization() const
+{
+	return m_quantization;
+}
+
+IndexType ModelResource::indexType() const
+{
+	return m_indexType;
+}
+
+MeshEncoding ModelResource::encoding() const
+{
+	return m_encoding;
+}
+
+const Bounds &ModelResource::bounds() const
+{
+	return m_bounds;
+}
+
+size_t ModelResource::indexCount() const
+{
+	const auto bytes = m_encoding == MeshEncoding::Compressed ? MeshCodec::decodedSize(indexData()) : indexData().size();
+	return bytes / indexSize(m_indexType);
+}
+
+size_t ModelResource::residentBytes() const
 {
+	return sizeof(ModelResource) + verticies.capacity() + indicies.capacity() + lods.capacity() * sizeof(MeshLod) + meshlets.capacity() * sizeof(Meshlet);
 }
@@ -0,0 +1,59 @@
+#include "AssetPack.h"
+#include "FileHelper.h"
+#include "LoggerAPI.h"
+#include "ModelImporter.h"
+
+#include <iostream>
+
+namespace {
+const std::string CONFIG_FILE = "index.lst";
+
+void cookShaders(AssetPackWriter &writer, const std::string &shadersPath)
+{
+	for (const auto &[name, fileName] : FileHelper::readIndexFile(shadersPath + CONFIG_FILE))
+	{
+		const auto code = FileHelper::readFile(shadersPath + fileName);
+		writer.addShader(name, code.data());
+	}
+}
+
+void cookModels(AssetPackWriter &writer, const std::string &modelsPath)
+{
+	auto sources = std::vector<ModelSource>();
+	for (const auto &[name, fileName] : FileHelper::readIndexFile(modelsPath + CONFIG_FILE))
+	{
+		sources.push_back({ name, modelsPath + fileName });
+	}
+
+	for (const auto &model : ModelImporter::importObjs(sources))
+	{
+		writer.addModel(model);
+	}
+}
+}
+
+int main(int argc, char *argv[])
+{
+	if (argc != 4)
+	{
+		std::cout << "Usage: packCooker <shaders dir> <models dir> <output pack>\n";
+		return 1;
+	}
+
+	const auto shadersPath = std::string(argv[1]) + "/";
+	const auto modelsPath = std::string(argv[2]) + "/";
+	const auto outputPath = std::string(argv[3]);
+
+	auto writer = AssetPackWriter();
+	cookShaders(writer, shadersPath);
+	cookModels(writer, modelsPath);
+
+	if (!writer.write(outputPath))
+	{
+		std::cout << "Failed to write " << outputPath << "\n";
+		return 1;
+	}
+
+	LoggerAPI::getLogger()->logInfo("Cooked asset pack " + outputPath);
+	return 0;
+}
@@ -0,0 +1,93 @@
+#include "ResourceAwaitables.h"
+#include "ResourceManagerAPI.h"
+
+#include <chrono>
+
+namespace {
+bool isReady(const std::shared_future<LoadStatus> &status)
+{
+	return status.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+std::function<void(LoadStatus)> resumeOn(Executor &executor, std::coroutine_handle<> continuation)
+{
+	return [&executor, continuation](LoadStatus)
+	{
+		executor.post([continuation]() { continuation.resume(); });
+	};
+}
+}
+
+ShaderAwaitable ResourceManagerAPI::getShaderAsync(ShaderHandle shader, Executor &executor)
+{
+	return ShaderAwaitable(*this, shader, executor);
+}
+
+ShaderAwaitable ResourceManagerAPI::getShaderAsync(std::string_view shaderName, Executor &executor)
+{
+	return ShaderAwaitable(*this, findShader(shaderName), executor);
+}
+
+ModelAwaitable ResourceManagerAPI::getModelAsync(ModelHandle model, Executor &executor)
+{
+	return ModelAwaitable(*this, model, executor);
+}
+
+ModelAwaitable ResourceManagerAPI::getModelAsync(std::string_view modelName, Executor &executor)
+{
+	return ModelAwaitable(*this, findModel(modelName), executor);
+}
+
+ShaderAwaitable::ShaderAwaitable(ResourceManagerAPI &resourceManager, ShaderHandle shader, Executor &executor) :
+	m_resourceManager{ resourceManager },
+	m_shader{ shader },
+	m_executor{ executor }
+{
+}
+
+bool ShaderAwaitable::await_ready() const
+{
+	return !m_shader.isValid() || isReady(m_resourceManager.getShaderStatus(m_shader));
+}
+
+void ShaderAwaitable::await_suspend(std::coroutine_handle<> continuation) const
+{
+	m_resourceManager.whenShaderReady(m_shader, resumeOn(m_executor, continuation));
+}
+
+std::shared_ptr<const ShaderResource> ShaderAwaitable::await_resume() const
+{
+	if (!m_shader.isValid() || m_resourceManager.getShaderStatus(m_shader).get() != LoadStatus::Loaded)
+	{
+		return nullptr;
+	}
+
+	return m_resourceManager.getShader(m_shader);
+}
+
+ModelAwaitable::ModelAwaitable(ResourceManagerAPI &resourceManager, ModelHandle model, Executor &executor) :
+	m_resourceManager{ resourceManager },
+	m_model{ model },
+	m_executor{ executor }
+{
+}
+
+bool ModelAwaitable::await_ready() const
+{
+	return !m_model.isValid() || isReady(m_resourceManager.getModelStatus(m_model));
+}
+
+void ModelAwaitable::await_suspend(std::coroutine_handle<> continuation) const
+{
+	m_resourceManager.whenModelReady(m_model, resumeOn(m_executor, continuation));
+}
+
+ModelData ModelAwaitable::await_resume() const
+{
+	if (!m_model.isValid() || m_resourceManager.getModelStatus(m_model).get() != LoadStatus::Loaded)
+	{
+		return ModelData();
+	}
+
+	return m_resourceManager.getModel(m_model);
+}
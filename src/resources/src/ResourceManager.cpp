@@ -1,13 +1,20 @@
 #include "ResourceManager.h"
 #include "FileHelper.h"
+#include "ModelImporter.h"
+#include "TextureImporter.h"
+#include "AssetPack.h"
 #include "LoggerAPI.h"
+#include "ThreadPool.h"
 
-#include <sstream>
 #include <algorithm>
+#include <filesystem>
 
 namespace{
 const std::string SHADERS_PATH = "./Shaders/";
+const std::string MODELS_PATH = "./Models/";
+const std::string TEXTURES_PATH = "./Textures/";
 const std::string CONFIG_FILE = "index.lst";
+const std::string PACK_PATH = "./assets.pak";
 
 
 ModelResource createRectangleModel()
@@ -22,7 +29,7 @@ ModelResource createRectangleModel()
 	std::vector<uint32_t> indices = {
 		0, 1, 2, 1, 0, 3
 	};
-	return ModelResource("rectangle", std::move(verticies), std::move(indices));
+	return ModelResource("rectangle", verticies, std::move(indices));
 }
 
 ModelResource createTriangleModel()
@@ -36,7 +43,30 @@ ModelResource createTriangleModel()
 	std::vector<uint32_t> indices = {
 		0, 1, 2
 	};
-	return ModelResource("triangle", std::move(verticies), std::move(indices));
+	return ModelResource("triangle", verticies, std::move(indices));
+}
+
+// Stale handles report Failed rather than dereferencing a slot that is gone.
+std::shared_future<LoadStatus> failedStatus()
+{
+	auto promise = std::promise<LoadStatus>();
+	promise.set_value(LoadStatus::Failed);
+	return promise.get_future().share();
+}
+
+// A load that throws still has to complete its slot, everything waiting for the slot would wait forever otherwise.
+template<typename Load>
+LoadStatus guardedLoad(const std::string &name, Load &&load)
+{
+	try
+	{
+		return load();
+	}
+	catch (const std::exception &error)
+	{
+		LoggerAPI::getLogger()->logError("Could not load " + name + ": " + error.what());
+		return LoadStatus::Failed;
+	}
 }
 }
 
@@ -45,75 +75,551 @@ ResourceManagerAPIPtr ResourceManagerAPI::createInstance()
 	return std::make_shared<ResourceManager>();
 }
 
+ResourceManager::~ResourceManager()
+{
+	waitForLoads();
+}
+
 void ResourceManager::LoadResources()
 {
-	loadShaders();
-	loadModels();
+	LoadResourcesAsync({}).wait();
 }
 
-const ShaderResource& ResourceManager::getShader(const std::string & shaderName) const
+std::shared_future<LoadProgress> ResourceManager::LoadResourcesAsync(LoadCallback onComplete)
 {
-	auto it = find_if(std::begin(m_shaderModules), std::end(m_shaderModules), [&shaderName](const auto& shader)
+	assert(m_shaderModules.empty() && m_models.empty() && m_textures.empty());
+
+	m_onLoadComplete = std::move(onComplete);
+	m_loadComplete = std::promise<LoadProgress>();
+	m_loadFuture = m_loadComplete.get_future().share();
+
+	enumerateBuiltInModels();
+
+	if (m_pack.open(PACK_PATH))
 	{
-		return shader.name == shaderName;
-	});
+		enumeratePack();
+	}
+	else
+	{
+		enumerateShaders();
+		enumerateModels();
+		m_shaderWatcher.watch(SHADERS_PATH);
+	}
+
+	// Textures are not cooked into the pack, so they always come from loose files.
+	enumerateTextures();
 
-	assert(it != std::end(m_shaderModules));
-	return *it;
+	indexResources();
+	scheduleLoads();
+
+	return m_loadFuture;
 }
 
-ModelData ResourceManager::getModel(const std::string & modelName)
+LoadProgress ResourceManager::getLoadProgress() const
 {
-	auto it = std::find_if(begin(m_models), end(m_models), [&modelName](const ModelResource &model)
+	return { m_totalCount, m_loadedCount.load(), m_failedCount.load() };
+}
+
+std::shared_future<LoadStatus> ResourceManager::getShaderStatus(ShaderHandle shader) const
+{
+	const auto *slot = m_shaderModules.get(shader);
+	return slot == nullptr ? failedStatus() : slot->ready;
+}
+
+std::shared_future<LoadStatus> ResourceManager::getModelStatus(ModelHandle model) const
+{
+	const auto *slot = m_models.get(model);
+	return slot == nullptr ? failedStatus() : slot->ready;
+}
+
+std::shared_future<LoadStatus> ResourceManager::getTextureStatus(TextureHandle texture) const
+{
+	const auto *slot = m_textures.get(texture);
+	return slot == nullptr ? failedStatus() : slot->ready;
+}
+
+void ResourceManager::whenShaderReady(ShaderHandle shader, std::function<void(LoadStatus)> callback)
+{
+	auto *slot = m_shaderModules.get(shader);
+	if (slot == nullptr)
 	{
-		return model.name == modelName;
-	});
+		callback(LoadStatus::Failed);
+		return;
+	}
+
+	slot->whenReady(std::move(callback));
+}
+
+void ResourceManager::whenModelReady(ModelHandle model, std::function<void(LoadStatus)> callback)
+{
+	auto *slot = m_models.get(model);
+	if (slot == nullptr)
+	{
+		callback(LoadStatus::Failed);
+		return;
+	}
+
+	slot->whenReady(std::move(callback));
+}
+
+ShaderHandle ResourceManager::findShader(std::string_view shaderName) const
+{
+	const auto it = m_shaderLookup.find(InternedName::find(shaderName));
+	return it == std::end(m_shaderLookup) ? ShaderHandle{} : it->second;
+}
+
+ModelHandle ResourceManager::findModel(std::string_view modelName) const
+{
+	const auto it = m_modelLookup.find(InternedName::find(modelName));
+	return it == std::end(m_modelLookup) ? ModelHandle{} : it->second;
+}
+
+std::string_view ResourceManager::getModelName(ModelHandle model) const
+{
+	const auto *slot = m_models.get(model);
+	return slot == nullptr ? std::string_view() : std::string_view(slot->name.str());
+}
+
+std::shared_ptr<const ShaderResource> ResourceManager::getShader(ShaderHandle shader) const
+{
+	const auto *shaderSlot = m_shaderModules.get(shader);
+	if (shaderSlot == nullptr)
+	{
+		LoggerAPI::getLogger()->logError("Stale or invalid shader handle " + std::to_string(shader.index));
+		return nullptr;
+	}
+
+	const auto &slot = *shaderSlot;
+	if (slot.ready.get() != LoadStatus::Loaded || !slot.resource)
+	{
+		LoggerAPI::getLogger()->logError("Shader " + slot.name.str() + " failed to load");
+		return nullptr;
+	}
+
+	return *slot.resource;
+}
+
+ModelData ResourceManager::getModel(ModelHandle model)
+{
+	auto *modelSlot = m_models.get(model);
+	if (modelSlot == nullptr)
+	{
+		LoggerAPI::getLogger()->logError("Stale or invalid model handle " + std::to_string(model.index));
+		return ModelData();
+	}
+
+	auto &slot = *modelSlot;
+	if (slot.ready.get() != LoadStatus::Loaded)
+	{
+		LoggerAPI::getLogger()->logError("Model " + slot.name.str() + " failed to load");
+		return ModelData();
+	}
+
+	auto *references = m_modelCache.acquire(model);
+	if (references == nullptr || !slot.resource)
+	{
+		LoggerAPI::getLogger()->logError("Model " + slot.name.str() + " could not be reloaded");
+		return ModelData();
+	}
+
+	auto &resource = *slot.resource;
+	return ModelData(resource.vertexData(), resource.indexData(), resource.lodData(), resource.meshletData(), resource.vertexLayout(), resource.quantization(), resource.indexType(), resource.encoding(), resource.bounds(), *references);
+}
+
+TextureHandle ResourceManager::findTexture(std::string_view textureName) const
+{
+	const auto it = m_textureLookup.find(InternedName::find(textureName));
+	return it == std::end(m_textureLookup) ? TextureHandle{} : it->second;
+}
 
-	assert(it != std::end(m_models));
+const TextureResource *ResourceManager::getTexture(TextureHandle texture) const
+{
+	const auto *textureSlot = m_textures.get(texture);
+	if (textureSlot == nullptr)
+	{
+		LoggerAPI::getLogger()->logError("Stale or invalid texture handle " + std::to_string(texture.index));
+		return nullptr;
+	}
 
-	return ModelData(it->verticies, it->indicies, it->usageCounter);
+	const auto &slot = *textureSlot;
+	if (slot.ready.get() != LoadStatus::Loaded || !slot.resource)
+	{
+		LoggerAPI::getLogger()->logError("Texture " + slot.name.str() + " failed to load");
+		return nullptr;
+	}
+
+	return &*slot.resource;
+}
+
+std::vector<ShaderHandle> ResourceManager::pollShaderChanges()
+{
+	auto result = std::vector<ShaderHandle>();
+
+	for (const auto &fileName : m_shaderWatcher.pollChangedFiles())
+	{
+		const auto path = SHADERS_PATH + fileName;
+
+		m_shaderModules.forEach([&](ShaderHandle handle, ShaderSlot &slot)
+		{
+			if (slot.sourcePath != path || !slot.resource)
+			{
+				return;
+			}
+
+			auto code = FileHelper::readFile(path);
+			if (code.empty())
+			{
+				LoggerAPI::getLogger()->logError("Could not reload shader " + slot.name.str());
+				return;
+			}
+
+			slot.resource = std::make_shared<const ShaderResource>(slot.name.str(), std::move(code));
+			result.push_back(handle);
+			LoggerAPI::getLogger()->logInfo("Reloaded shader " + slot.name.str());
+		});
+	}
+
+	return result;
+}
+
+void ResourceManager::setModelMemoryBudget(size_t bytes)
+{
+	m_modelCache.setBudget(bytes);
+}
+
+void ResourceManager::setTextureQuality(TextureQuality quality)
+{
+	m_textureQuality = quality;
+}
+
+std::shared_ptr<const ShaderResource> ResourceManager::getShader(const std::string & shaderName) const
+{
+	return getShader(findShader(shaderName));
+}
+
+ModelData ResourceManager::getModel(const std::string & modelName)
+{
+	return getModel(findModel(modelName));
+}
+
+const TextureResource *ResourceManager::getTexture(const std::string & textureName) const
+{
+	return getTexture(findTexture(textureName));
 }
 
 void ResourceManager::cleanUp()
 {
+	m_shaderWatcher.stop();
+	waitForLoads();
 	unloadShaders();
 	unloadModels();
+	unloadTextures();
+	m_pack.close();
 }
 
-void ResourceManager::loadShaders()
+void ResourceManager::enumerateShaders()
 {
-	auto configFile = FileHelper::readFileLines(SHADERS_PATH + CONFIG_FILE);
+	for (const auto &[name, fileName] : FileHelper::readIndexFile(SHADERS_PATH + CONFIG_FILE))
+	{
+		m_shaderModules.emplace(InternedName(name), SHADERS_PATH + fileName);
+	}
+}
+
+void ResourceManager::enumerateModels()
+{
+	for (const auto &[name, fileName] : FileHelper::readIndexFile(MODELS_PATH + CONFIG_FILE))
+	{
+		m_models.emplace(InternedName(name), MODELS_PATH + fileName);
+	}
+}
+
+void ResourceManager::enumerateTextures()
+{
+	// Unlike shaders and models, a project does not need any textures.
+	if (!std::filesystem::exists(TEXTURES_PATH + CONFIG_FILE))
+	{
+		return;
+	}
+
+	for (const auto &[name, fileName] : FileHelper::readIndexFile(TEXTURES_PATH + CONFIG_FILE))
+	{
+		m_textures.emplace(InternedName(name), TEXTURES_PATH + fileName);
+	}
+}
+
+void ResourceManager::enumerateBuiltInModels()
+{
+	for (auto model : { createRectangleModel(), createTriangleModel() })
+	{
+		const auto handle = m_models.emplace(model.name, std::string());
+		m_models.get(handle)->resource = std::move(model);
+	}
+}
+
+void ResourceManager::enumeratePack()
+{
+	for (const auto &entry : m_pack.entries())
+	{
+		auto name = std::string(AssetPack::entryName(entry));
+
+		switch (entry.type)
+		{
+		case pack::EntryType::Shader:
+		{
+			auto &slot = *m_shaderModules.get(m_shaderModules.emplace(InternedName(name), std::string()));
+			slot.resource = std::make_shared<const ShaderResource>(name, m_pack.view<char>(entry.primary));
+			break;
+		}
+
+		case pack::EntryType::Model:
+		{
+			auto &slot = *m_models.get(m_models.emplace(InternedName(name), std::string()));
+			auto quantization = VertexQuantization();
+			quantization.center = { entry.quantizationCenter[0], entry.quantizationCenter[1], entry.quantizationCenter[2], 0.0F };
+			quantization.halfExtent = { entry.quantizationHalfExtent[0], entry.quantizationHalfExtent[1], entry.quantizationHalfExtent[2], 0.0F };
+
+			auto bounds = Bounds();
+			bounds.box.min = { entry.boundsMin[0], entry.boundsMin[1], entry.boundsMin[2] };
+			bounds.box.max = { entry.boundsMax[0], entry.boundsMax[1], entry.boundsMax[2] };
+			bounds.sphere.center = { entry.sphereCenter[0], entry.sphereCenter[1], entry.sphereCenter[2] };
+			bounds.sphere.radius = entry.sphereRadius;
+
+			slot.resource.emplace(std::move(name), m_pack.view<std::byte>(entry.primary), m_pack.view<std::byte>(entry.secondary), m_pack.view<MeshLod>(entry.tertiary), m_pack.view<Meshlet>(entry.quaternary),
+				static_cast<VertexLayoutKind>(entry.vertexLayout), quantization, static_cast<IndexType>(entry.indexType), static_cast<MeshEncoding>(entry.meshEncoding), bounds);
+			break;
+		}
+
+		default:
+			LoggerAPI::getLogger()->logWarning("Skipping unknown pack entry " + name);
+			break;
+		}
+	}
+}
+
+void ResourceManager::indexResources()
+{
+	m_shaderLookup.clear();
+	m_shaderLookup.reserve(m_shaderModules.size());
+	m_shaderModules.forEach([this](ShaderHandle handle, const ShaderSlot &slot)
+	{
+		m_shaderLookup.insert_or_assign(slot.name, handle);
+	});
+
+	m_modelLookup.clear();
+	m_modelLookup.reserve(m_models.size());
+	m_models.forEach([this](ModelHandle handle, const ModelSlot &slot)
+	{
+		m_modelLookup.insert_or_assign(slot.name, handle);
+	});
+
+	m_textureLookup.clear();
+	m_textureLookup.reserve(m_textures.size());
+	m_textures.forEach([this](TextureHandle handle, const TextureSlot &slot)
+	{
+		m_textureLookup.insert_or_assign(slot.name, handle);
+	});
+}
+
+void ResourceManager::scheduleLoads()
+{
+	m_loadedCount = 0;
+	m_failedCount = 0;
+	m_finishedCount = 0;
+	m_totalCount = static_cast<uint32_t>(m_shaderModules.size() + m_models.size() + m_textures.size());
+	// Loads start with no models, so nothing can hold a reference that would make this fail.
+	m_modelCache.reset(m_models.indexLimit());
+
+	if (m_totalCount == 0)
+	{
+		finishResource(LoadStatus::Loaded);
+		return;
+	}
+
+	auto &pool = ThreadPool::shared();
+
+	auto pendingShaders = std::vector<ShaderSlot *>();
+	m_shaderModules.forEach([&](ShaderHandle, ShaderSlot &slot)
+	{
+		if (slot.resource)
+		{
+			slot.complete(LoadStatus::Loaded);
+			finishResource(LoadStatus::Loaded);
+			return;
+		}
+		pendingShaders.push_back(&slot);
+	});
+
+	if (!pendingShaders.empty())
+	{
+		pool.post([this, pendingShaders]() { loadShaders(pendingShaders); });
+	}
+
+	m_models.forEach([&](ModelHandle handle, ModelSlot &slot)
+	{
+		if (slot.resource)
+		{
+			// Built in and packed models have nothing to reload from, so they stay resident.
+			m_modelCache.insert(handle, slot.resource->residentBytes(), false);
+			slot.complete(LoadStatus::Loaded);
+			finishResource(LoadStatus::Loaded);
+			return;
+		}
+		pool.post([this, handle]() { loadModel(handle); });
+	});
+
+	m_textures.forEach([&](TextureHandle handle, TextureSlot &)
+	{
+		pool.post([this, handle]() { loadTexture(handle); });
+	});
+}
+
+void ResourceManager::loadShaders(const std::vector<ShaderSlot *> &slots)
+{
+	auto paths = std::vector<std::string>();
+	paths.reserve(slots.size());
+	for (const auto *slot : slots)
+	{
+		paths.push_back(slot->sourcePath);
+	}
 
-	for (const auto &line : configFile)
+	auto files = std::vector<FileBuffer>();
+	guardedLoad("shaders", [&]()
 	{
-		createShader(line);
+		files = FileHelper::readFiles(paths);
+		return LoadStatus::Loaded;
+	});
+	files.resize(slots.size());
+
+	for (size_t i = 0; i < slots.size(); ++i)
+	{
+		auto &slot = *slots[i];
+		const auto status = guardedLoad(slot.name.str(), [&]()
+		{
+			if (files[i].empty())
+			{
+				return LoadStatus::Failed;
+			}
+			slot.resource = std::make_shared<const ShaderResource>(slot.name.str(), std::move(files[i]));
+			return LoadStatus::Loaded;
+		});
+
+		slot.complete(status);
+		finishResource(status);
 	}
 }
 
-void ResourceManager::loadModels()
+void ResourceManager::loadModel(ModelHandle model)
 {
-	m_models.push_back(createRectangleModel());
-	m_models.push_back(createTriangleModel());
+	auto &slot = *m_models.get(model);
+	const auto status = guardedLoad(slot.name.str(), [&]()
+	{
+		slot.resource = ModelImporter::importObj({ slot.name.str(), slot.sourcePath });
+		return slot.resource ? LoadStatus::Loaded : LoadStatus::Failed;
+	});
+
+	if (slot.resource)
+	{
+		m_modelCache.insert(model, slot.resource->residentBytes(), true);
+	}
+
+	slot.complete(status);
+	finishResource(status);
 }
 
-void ResourceManager::createShader(const std::string & metaData)
+void ResourceManager::loadTexture(TextureHandle texture)
 {
-	std::string name;
-	std::string fileName;
-	std::stringstream stream(metaData);
+	auto &slot = *m_textures.get(texture);
+	const auto status = guardedLoad(slot.name.str(), [&]()
+	{
+		slot.resource = TextureImporter::importImage({ slot.name.str(), slot.sourcePath }, m_textureQuality);
+		return slot.resource ? LoadStatus::Loaded : LoadStatus::Failed;
+	});
 
-	stream >> name >> fileName;
+	slot.complete(status);
+	finishResource(status);
+}
 
-	m_shaderModules.emplace_back(name, FileHelper::readFileByte(SHADERS_PATH + fileName));
+void ResourceManager::evictModel(ModelHandle model)
+{
+	auto &slot = *m_models.get(model);
+	slot.resource.reset();
+	LoggerAPI::getLogger()->logInfo("Evicted model " + slot.name.str());
 }
 
+std::optional<size_t> ResourceManager::reloadModel(ModelHandle model)
+{
+	auto &slot = *m_models.get(model);
+	slot.resource = ModelImporter::importObj({ slot.name.str(), slot.sourcePath });
+	if (!slot.resource)
+	{
+		return std::nullopt;
+	}
+
+	LoggerAPI::getLogger()->logInfo("Reloaded model " + slot.name.str());
+	return slot.resource->residentBytes();
+}
+
+void ResourceManager::finishResource(LoadStatus status)
+{
+	if (m_totalCount != 0)
+	{
+		auto &counter = status == LoadStatus::Loaded ? m_loadedCount : m_failedCount;
+		++counter;
+
+		if (++m_finishedCount != m_totalCount)
+		{
+			return;
+		}
+	}
+
+	const auto progress = getLoadProgress();
+	LoggerAPI::getLogger()->logInfo("Loaded " + std::to_string(progress.loaded) + " of " + std::to_string(progress.total) + " resources");
+
+	if (m_onLoadComplete)
+	{
+		m_onLoadComplete(progress);
+	}
+	m_loadComplete.set_value(progress);
+}
+
+void ResourceManager::waitForLoads() const
+{
+	m_shaderModules.forEach([](ShaderHandle, const ShaderSlot &slot)
+	{
+		slot.ready.wait();
+	});
+
+	m_models.forEach([](ModelHandle, const ModelSlot &slot)
+	{
+		slot.ready.wait();
+	});
+
+	m_textures.forEach([](TextureHandle, const TextureSlot &slot)
+	{
+		slot.ready.wait();
+	});
+}
 
 void ResourceManager::unloadShaders()
 {
+	m_shaderLookup.clear();
 	m_shaderModules.clear();
 }
 
 void ResourceManager::unloadModels()
 {
+	// A ModelData still alive points into the slots and the cache's counters, both have to outlive it.
+	if (!m_modelCache.reset(0))
+	{
+		LoggerAPI::getLogger()->logError(std::to_string(m_modelCache.referencedCount()) + " models are still in use, they are not unloaded");
+		return;
+	}
+	m_modelLookup.clear();
 	m_models.clear();
 }
+
+void ResourceManager::unloadTextures()
+{
+	m_textureLookup.clear();
+	m_textures.clear();
+}
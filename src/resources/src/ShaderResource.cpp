@@ -2,7 +2,25 @@
 
 
 ShaderResource::ShaderResource(const std::string &name, std::vector<char> shaderCode) :
+	BasicResource(name)
+{
+	auto owner = std::make_shared<const std::vector<char>>(std::move(shaderCode));
+	m_shader = FileBuffer(owner, *owner);
+}
+
+ShaderResource::ShaderResource(const std::string &name, std::span<const char> mappedShaderCode) :
 	BasicResource(name),
-	shader{std::move(shaderCode)}
+	m_shader{nullptr, mappedShaderCode}
+{
+}
+
+ShaderResource::ShaderResource(const std::string &name, FileBuffer shaderCode) :
+	BasicResource(name),
+	m_shader{std::move(shaderCode)}
+{
+}
+
+std::span<const char> ShaderResource::code() const
 {
-}
\ No newline at end of file
+	return m_shader.data();
+}
@@ -0,0 +1,83 @@
+#include "TextureImporter.h"
+#include "BlockCompressor.h"
+#include "LoggerAPI.h"
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+
+namespace {
+constexpr int RGBA_CHANNELS = 4;
+constexpr std::uint8_t OPAQUE_ALPHA = 255;
+
+const char *formatName(TextureFormat format)
+{
+	switch (format)
+	{
+	case TextureFormat::Bc1:
+		return "BC1";
+	case TextureFormat::Bc3:
+		return "BC3";
+	case TextureFormat::Bc7:
+		return "BC7";
+	case TextureFormat::Rgba8:
+	default:
+		return "RGBA8";
+	}
+}
+}
+
+std::optional<TextureResource> TextureImporter::importImage(const TextureSource &source, TextureQuality quality)
+{
+	int width = 0;
+	int height = 0;
+	int channels = 0;
+	auto *pixels = stbi_load(source.path.c_str(), &width, &height, &channels, RGBA_CHANNELS);
+	if (pixels == nullptr)
+	{
+		LoggerAPI::getLogger()->logError("Could not load texture " + source.path + ": " + stbi_failure_reason());
+		return std::nullopt;
+	}
+
+	auto image = Rgba8Image();
+	image.width = static_cast<std::uint32_t>(width);
+	image.height = static_cast<std::uint32_t>(height);
+	image.pixels.assign(pixels, pixels + size_t{ image.width } * image.height * RGBA_CHANNELS);
+	stbi_image_free(pixels);
+
+	return cook(source.name, std::move(image), quality);
+}
+
+TextureResource TextureImporter::cook(std::string name, Rgba8Image image, TextureQuality quality)
+{
+	const auto format = chooseFormat(image, quality);
+
+	auto mips = std::vector<MipLevel>();
+	auto data = std::vector<std::byte>();
+	for (const auto &level : MipGenerator::generateMips(std::move(image)))
+	{
+		auto encoded = BlockCompressor::compress(level, format);
+		mips.push_back({ level.width, level.height, data.size(), encoded.size() });
+		data.insert(data.end(), encoded.begin(), encoded.end());
+	}
+
+	LoggerAPI::getLogger()->logInfo("Cooked texture " + name + " " + std::to_string(mips.front().width) + "x" + std::to_string(mips.front().height)
+		+ " with " + std::to_string(mips.size()) + " mips as " + formatName(format));
+
+	return TextureResource(std::move(name), format, std::move(mips), std::move(data));
+}
+
+TextureFormat TextureImporter::chooseFormat(const Rgba8Image &image, TextureQuality quality)
+{
+	if (quality == TextureQuality::High)
+	{
+		return TextureFormat::Bc7;
+	}
+
+	auto opaque = true;
+	for (size_t i = 3; i < image.pixels.size() && opaque; i += RGBA_CHANNELS)
+	{
+		opaque = image.pixels[i] == OPAQUE_ALPHA;
+	}
+
+	return opaque ? TextureFormat::Bc1 : TextureFormat::Bc3;
+}
@@ -0,0 +1,70 @@
+#include "TextureResource.h"
+
+#include <cassert>
+
+TextureResource::TextureResource(std::string textureName, TextureFormat format, std::vector<MipLevel> mips, std::vector<std::byte> data) :
+	BasicResource(std::move(textureName)),
+	m_format(format),
+	m_mips(std::move(mips)),
+	m_data(std::move(data))
+{
+	assert(!m_mips.empty());
+	assert(m_mips.back().offset + m_mips.back().size <= m_data.size());
+}
+
+TextureFormat TextureResource::format() const
+{
+	return m_format;
+}
+
+std::uint32_t TextureResource::width() const
+{
+	return m_mips.front().width;
+}
+
+std::uint32_t TextureResource::height() const
+{
+	return m_mips.front().height;
+}
+
+std::span<const MipLevel> TextureResource::mips() const
+{
+	return m_mips;
+}
+
+std::span<const std::byte> TextureResource::data() const
+{
+	return m_data;
+}
+
+bool TextureResource::isBlockCompressed(TextureFormat format)
+{
+	return format != TextureFormat::Rgba8;
+}
+
+std::uint32_t TextureResource::blockBytes(TextureFormat format)
+{
+	switch (format)
+	{
+	case TextureFormat::Bc1:
+		return 8;
+	case TextureFormat::Bc3:
+	case TextureFormat::Bc7:
+		return 16;
+	case TextureFormat::Rgba8:
+	default:
+		return 4;
+	}
+}
+
+std::uint64_t TextureResource::levelSize(TextureFormat format, std::uint32_t width, std::uint32_t height)
+{
+	if (!isBlockCompressed(format))
+	{
+		return std::uint64_t{ width } * height * blockBytes(format);
+	}
+
+	const auto blocksWide = (width + 3) / 4;
+	const auto blocksHigh = (height + 3) / 4;
+	return std::uint64_t{ blocksWide } * blocksHigh * blockBytes(format);
+}
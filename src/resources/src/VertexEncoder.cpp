@@ -0,0 +1,99 @@
+#include "VertexEncoder.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+int16_t encodeSnorm16(float value)
+{
+	return static_cast<int16_t>(std::lround(std::clamp(value, -1.0F, 1.0F) * 32767.0F));
+}
+
+uint8_t encodeUnorm8(float value)
+{
+	return static_cast<uint8_t>(std::lround(std::clamp(value, 0.0F, 1.0F) * 255.0F));
+}
+
+float decodeSnorm16(int16_t value)
+{
+	return std::max(static_cast<float>(value) / 32767.0F, -1.0F);
+}
+
+float decodeUnorm8(uint8_t value)
+{
+	return static_cast<float>(value) / 255.0F;
+}
+
+float componentScale(float halfExtent)
+{
+	// A flat axis has no extent, any scale decodes it back to the centre.
+	return halfExtent > 0.0F ? 1.0F / halfExtent : 0.0F;
+}
+}
+
+VertexQuantization VertexEncoder::computeQuantization(const Aabb &bounds)
+{
+	auto result = VertexQuantization();
+	const auto center = bounds.center();
+	const auto halfExtent = bounds.halfExtent();
+	result.center = { center.x, center.y, center.z, 0.0F };
+	result.halfExtent = { halfExtent.x, halfExtent.y, halfExtent.z, 0.0F };
+
+	return result;
+}
+
+std::vector<std::byte> VertexEncoder::encode(std::span<const Vertex> verticies, VertexLayoutKind layout, const VertexQuantization &quantization)
+{
+	auto result = std::vector<std::byte>(verticies.size() * VertexLayout::get(layout).stride);
+
+	if (layout == VertexLayoutKind::Float)
+	{
+		std::memcpy(result.data(), verticies.data(), result.size());
+		return result;
+	}
+
+	const auto scale = glm::vec3(componentScale(quantization.halfExtent.x), componentScale(quantization.halfExtent.y), componentScale(quantization.halfExtent.z));
+	const auto center = glm::vec3(quantization.center.x, quantization.center.y, quantization.center.z);
+
+	for (size_t i = 0; i < verticies.size(); ++i)
+	{
+		const auto position = (verticies[i].postion - center) * scale;
+		const auto &color = verticies[i].color;
+
+		const auto encoded = QuantizedVertex{
+			{ encodeSnorm16(position.x), encodeSnorm16(position.y), encodeSnorm16(position.z), 0 },
+			{ encodeUnorm8(color.x), encodeUnorm8(color.y), encodeUnorm8(color.z), encodeUnorm8(color.w) }
+		};
+		std::memcpy(result.data() + i * sizeof(QuantizedVertex), &encoded, sizeof(QuantizedVertex));
+	}
+
+	return result;
+}
+
+std::vector<Vertex> VertexEncoder::decode(std::span<const std::byte> encoded, VertexLayoutKind layout, const VertexQuantization &quantization)
+{
+	const auto count = encoded.size() / VertexLayout::get(layout).stride;
+	auto result = std::vector<Vertex>(count);
+
+	if (layout == VertexLayoutKind::Float)
+	{
+		std::memcpy(result.data(), encoded.data(), count * sizeof(Vertex));
+		return result;
+	}
+
+	const auto halfExtent = glm::vec3(quantization.halfExtent.x, quantization.halfExtent.y, quantization.halfExtent.z);
+	const auto center = glm::vec3(quantization.center.x, quantization.center.y, quantization.center.z);
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		auto vertex = QuantizedVertex();
+		std::memcpy(&vertex, encoded.data() + i * sizeof(QuantizedVertex), sizeof(QuantizedVertex));
+
+		const auto position = glm::vec3(decodeSnorm16(vertex.position[0]), decodeSnorm16(vertex.position[1]), decodeSnorm16(vertex.position[2]));
+		result[i].postion = position * halfExtent + center;
+		result[i].color = { decodeUnorm8(vertex.color[0]), decodeUnorm8(vertex.color[1]), decodeUnorm8(vertex.color[2]), decodeUnorm8(vertex.color[3]) };
+	}
+
+	return result;
+}
@@ -3,6 +3,17 @@
 
 layout(location = 0) in vec3 inPos;
 layout(location = 1) in vec4 inColor;
+// Objects are only translated, every instance of a mesh has its own position.
+layout(location = 2) in vec3 inInstancePosition;
+layout(location = 3) in uint inObjectId;
+
+// Quantized meshes store positions in [-1, 1] relative to their bounds, float meshes get an identity transform.
+// The view projection is pushed once per command buffer, the dequantization once per draw.
+layout(push_constant) uniform PushConstants {
+    vec4 center;
+    vec4 halfExtent;
+    mat4 viewProjection;
+} constants;
 
 layout(location = 0) out vec4 outColor;
 
@@ -11,6 +22,7 @@ out gl_PerVertex {
 };
 
 void main() {
-    gl_Position = vec4(inPos, 1.0);
+    vec3 position = inPos * constants.halfExtent.xyz + constants.center.xyz + inInstancePosition;
+    gl_Position = constants.viewProjection * vec4(position, 1.0);
 	outColor = inColor;
 }
\ No newline at end of file
@@ -0,0 +1,110 @@
+#include <catch2/catch.hpp>
+
+#include "AssetPack.h"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+namespace {
+std::string tempPath(const std::string &name)
+{
+  return (std::filesystem::temp_directory_path() / name).string();
+}
+
+uint64_t alignUp(uint64_t value)
+{
+  return (value + pack::BLOB_ALIGNMENT - 1) & ~(pack::BLOB_ALIGNMENT - 1);
+}
+
+// A pack with one uncompressed model, written by hand since the writer compresses every model it can.
+void writeRawPack(const std::string &path, size_t vertexCount, const std::vector<std::byte> &indices, IndexType indexType)
+{
+  auto bytes = std::vector<std::byte>(sizeof(pack::Header));
+  const auto appendBlob = [&bytes](std::span<const std::byte> data) {
+    const auto offset = alignUp(bytes.size());
+    bytes.resize(offset + data.size());
+    std::copy(data.begin(), data.end(), bytes.begin() + static_cast<std::ptrdiff_t>(offset));
+    return pack::Blob{ offset, data.size() };
+  };
+
+  auto entry = pack::TocEntry();
+  std::memset(&entry, 0, sizeof(entry));
+  std::strcpy(entry.name, "raw");
+  entry.type = pack::EntryType::Model;
+  entry.vertexLayout = static_cast<uint32_t>(VertexLayoutKind::Float);
+  entry.indexType = static_cast<uint32_t>(indexType);
+  entry.meshEncoding = static_cast<uint32_t>(MeshEncoding::Raw);
+  entry.primary = appendBlob(std::vector<std::byte>(vertexCount * VertexLayout::get(VertexLayoutKind::Float).stride));
+  entry.secondary = appendBlob(indices);
+
+  auto header = pack::Header();
+  std::memset(&header, 0, sizeof(header));
+  header.magic = pack::MAGIC;
+  header.version = pack::VERSION;
+  header.entryCount = 1;
+  header.tocOffset = alignUp(bytes.size());
+  bytes.resize(header.tocOffset + sizeof(entry));
+  std::memcpy(bytes.data(), &header, sizeof(header));
+  std::memcpy(bytes.data() + header.tocOffset, &entry, sizeof(entry));
+
+  auto file = std::ofstream(path, std::ios::binary | std::ios::trunc);
+  file.write(reinterpret_cast<const char *>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+}
+
+template<typename Index>
+std::vector<std::byte> indexBytes(const std::vector<Index> &indices)
+{
+  auto result = std::vector<std::byte>(indices.size() * sizeof(Index));
+  std::memcpy(result.data(), indices.data(), result.size());
+  return result;
+}
+}// namespace
+
+TEST_CASE("Raw models with indices inside their verticies are accepted", "[AssetPack]")
+{
+  const auto path = tempPath("narnia_pack_raw.pak");
+  auto assetPack = AssetPack();
+
+  writeRawPack(path, 4, indexBytes<uint16_t>({ 0, 1, 2, 2, 1, 3 }), IndexType::Uint16);
+  REQUIRE(assetPack.open(path));
+  REQUIRE(assetPack.entries().size() == 1);
+  assetPack.close();
+
+  writeRawPack(path, 4, indexBytes<uint32_t>({ 0, 1, 2, 2, 1, 3 }), IndexType::Uint32);
+  REQUIRE(assetPack.open(path));
+  assetPack.close();
+  std::filesystem::remove(path);
+}
+
+TEST_CASE("Raw models with indices past their verticies are rejected", "[AssetPack]")
+{
+  const auto path = tempPath("narnia_pack_raw_corrupted.pak");
+  auto assetPack = AssetPack();
+
+  SECTION("16 bit index one past the last vertex")
+  {
+    writeRawPack(path, 4, indexBytes<uint16_t>({ 0, 1, 2, 2, 1, 4 }), IndexType::Uint16);
+  }
+
+  SECTION("32 bit index far outside the mesh")
+  {
+    writeRawPack(path, 4, indexBytes<uint32_t>({ 0, 1, 0x80000000, 2, 1, 3 }), IndexType::Uint32);
+  }
+
+  SECTION("Index buffer ending in part of an index")
+  {
+    auto indices = indexBytes<uint32_t>({ 0, 1, 2 });
+    indices.resize(indices.size() - 2);
+    writeRawPack(path, 4, indices, IndexType::Uint32);
+  }
+
+  SECTION("Indices with no verticies")
+  {
+    writeRawPack(path, 0, indexBytes<uint16_t>({ 0, 0, 0 }), IndexType::Uint16);
+  }
+
+  REQUIRE_FALSE(assetPack.open(path));
+  REQUIRE_FALSE(assetPack.isOpen());
+  std::filesystem::remove(path);
+}
@@ -0,0 +1,83 @@
+#include <catch2/catch.hpp>
+
+#include "BoundsCalculator.h"
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace {
+std::vector<Vertex> makeBox(glm::vec3 min, glm::vec3 max)
+{
+  auto verticies = std::vector<Vertex>();
+  for (int corner = 0; corner < 8; ++corner) {
+    const auto position = glm::vec3(corner & 1 ? max.x : min.x, corner & 2 ? max.y : min.y, corner & 4 ? max.z : min.z);
+    verticies.push_back({ position, { 1.0F, 1.0F, 1.0F, 1.0F } });
+  }
+  return verticies;
+}
+}// namespace
+
+TEST_CASE("A box's corners give back the box", "[BoundsCalculator]")
+{
+  const auto bounds = BoundsCalculator::compute(makeBox({ -1.0F, -2.0F, -3.0F }, { 3.0F, 2.0F, 1.0F }));
+
+  REQUIRE(bounds.box.min == glm::vec3(-1.0F, -2.0F, -3.0F));
+  REQUIRE(bounds.box.max == glm::vec3(3.0F, 2.0F, 1.0F));
+  REQUIRE(bounds.sphere.center == glm::vec3(1.0F, 0.0F, -1.0F));
+  // Every corner is as far from the centre, half the diagonal.
+  REQUIRE(bounds.sphere.radius == Approx(std::sqrt(12.0F)));
+}
+
+TEST_CASE("A single vertex has an empty box around it", "[BoundsCalculator]")
+{
+  const auto verticies = std::vector<Vertex>{ { { 5.0F, -6.0F, 7.0F }, { 0.0F, 0.0F, 0.0F, 1.0F } } };
+  const auto bounds = BoundsCalculator::compute(verticies);
+
+  REQUIRE(bounds.box.min == glm::vec3(5.0F, -6.0F, 7.0F));
+  REQUIRE(bounds.box.max == glm::vec3(5.0F, -6.0F, 7.0F));
+  REQUIRE(bounds.sphere.radius == 0.0F);
+}
+
+TEST_CASE("No verticies give empty bounds at the origin", "[BoundsCalculator]")
+{
+  const auto bounds = BoundsCalculator::compute({});
+
+  REQUIRE(bounds.box.min == glm::vec3(0.0F));
+  REQUIRE(bounds.box.max == glm::vec3(0.0F));
+  REQUIRE(bounds.sphere.radius == 0.0F);
+}
+
+TEST_CASE("Extremes are found in any position of the array", "[BoundsCalculator]")
+{
+  // Counts around the four verticies processed at once, so the extremes also land in the remainder.
+  const auto count = GENERATE(size_t{ 2 }, size_t{ 3 }, size_t{ 4 }, size_t{ 5 }, size_t{ 7 }, size_t{ 8 }, size_t{ 13 }, size_t{ 64 });
+  const auto extreme = GENERATE_COPY(range(size_t{ 0 }, count));
+
+  // Points inside the unit cube with one vertex far outside it, red is large to show it does not leak into the box.
+  auto random = std::mt19937(static_cast<uint32_t>(count * 100 + extreme));
+  auto unit = std::uniform_real_distribution<float>(-1.0F, 1.0F);
+  auto verticies = std::vector<Vertex>(count);
+  for (auto &vertex : verticies) {
+    vertex = { { unit(random), unit(random), unit(random) }, { 100.0F, 0.0F, 0.0F, 1.0F } };
+  }
+  verticies[extreme].postion = { -10.0F, 20.0F, -30.0F };
+
+  auto expectedMin = verticies.front().postion;
+  auto expectedMax = verticies.front().postion;
+  auto farthest = 0.0F;
+  for (const auto &vertex : verticies) {
+    expectedMin = glm::min(expectedMin, vertex.postion);
+    expectedMax = glm::max(expectedMax, vertex.postion);
+  }
+  const auto center = (expectedMin + expectedMax) * 0.5F;
+  for (const auto &vertex : verticies) {
+    farthest = std::max(farthest, glm::length(vertex.postion - center));
+  }
+
+  const auto bounds = BoundsCalculator::compute(verticies);
+  REQUIRE(bounds.box.min == expectedMin);
+  REQUIRE(bounds.box.max == expectedMax);
+  REQUIRE(bounds.sphere.center == center);
+  REQUIRE(bounds.sphere.radius == Approx(farthest));
+}
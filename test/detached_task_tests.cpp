@@ -0,0 +1,107 @@
+#include <catch2/catch.hpp>
+
+#include "DetachedTask.h"
+
+#include <vector>
+
+namespace {
+// Suspends every time and keeps the handle, so a test decides when a task goes on.
+struct ManualResume
+{
+  bool await_ready() const { return false; }
+  void await_suspend(std::coroutine_handle<> continuation) const { suspended->push_back(continuation); }
+  void await_resume() const {}
+
+  std::vector<std::coroutine_handle<>> *suspended;
+};
+
+// Counts how often it was destroyed, a frame that is destroyed takes its locals with it.
+struct Local
+{
+  explicit Local(int &destroyed) : count(&destroyed) {}
+  Local(const Local &) = delete;
+  Local &operator=(const Local &) = delete;
+  ~Local() { ++*count; }
+
+  int *count;
+};
+
+DetachedTask waitOnce(std::vector<std::coroutine_handle<>> &suspended, int &destroyed, bool &finished)
+{
+  const auto local = Local(destroyed);
+  co_await ManualResume{ &suspended };
+  finished = true;
+}
+
+DetachedTask finishAtOnce(bool &finished)
+{
+  finished = true;
+  co_return;
+}
+}// namespace
+
+TEST_CASE("Tasks that finish without suspending are not kept", "[DetachedTask]")
+{
+  auto scope = TaskScope();
+  auto finished = false;
+  scope.spawn(finishAtOnce(finished));
+  REQUIRE(finished);
+  REQUIRE(scope.suspendedCount() == 0);
+}
+
+TEST_CASE("A resumed task forgets its scope when it finishes", "[DetachedTask]")
+{
+  auto scope = TaskScope();
+  auto suspended = std::vector<std::coroutine_handle<>>();
+  auto destroyed = 0;
+  auto finished = false;
+
+  scope.spawn(waitOnce(suspended, destroyed, finished));
+  REQUIRE(suspended.size() == 1);
+  REQUIRE(scope.suspendedCount() == 1);
+  REQUIRE_FALSE(finished);
+
+  suspended.front().resume();
+  REQUIRE(finished);
+  REQUIRE(destroyed == 1);
+  REQUIRE(scope.suspendedCount() == 0);
+
+  // Already gone, so there is nothing left to destroy twice.
+  scope.destroyAll();
+  REQUIRE(destroyed == 1);
+}
+
+TEST_CASE("Suspended tasks are destroyed with their locals", "[DetachedTask]")
+{
+  auto suspended = std::vector<std::coroutine_handle<>>();
+  auto destroyed = 0;
+  auto finished = false;
+  {
+    auto scope = TaskScope();
+    for (int i = 0; i < 3; ++i) {
+      scope.spawn(waitOnce(suspended, destroyed, finished));
+    }
+    REQUIRE(scope.suspendedCount() == 3);
+
+    suspended[1].resume();
+    REQUIRE(destroyed == 1);
+    REQUIRE(scope.suspendedCount() == 2);
+
+    scope.destroyAll();
+    REQUIRE(destroyed == 3);
+    REQUIRE(scope.suspendedCount() == 0);
+
+    scope.spawn(waitOnce(suspended, destroyed, finished));
+  }
+  // The scope destroys what is left when it goes away.
+  REQUIRE(destroyed == 4);
+}
+
+TEST_CASE("Tasks that are never spawned do not run", "[DetachedTask]")
+{
+  auto finished = false;
+  {
+    const auto task = finishAtOnce(finished);
+  }
+  REQUIRE_FALSE(finished);
+}
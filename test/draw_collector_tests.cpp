@@ -0,0 +1,100 @@
+#include <catch2/catch.hpp>
+
+#include "DrawCollector.h"
+
+namespace {
+// An object drawing ranges of the mesh placed at firstIndex.
+RenderableObjectPtr makeObject(uint32_t firstIndex, std::vector<DrawRange> ranges, glm::vec3 position = {})
+{
+  auto object = std::make_shared<RenderableObject>("object", position);
+  object->geometry.firstIndex = firstIndex;
+  object->drawRanges = std::move(ranges);
+  object->uploadToken = 1;
+  return object;
+}
+
+const auto everythingUploaded = [](UploadToken) { return true; };
+}// namespace
+
+TEST_CASE("Objects sharing a mesh and its visible ranges are drawn as instances", "[DrawCollector]")
+{
+  auto scene = Scene();
+  const auto full = std::vector<DrawRange>{ { 0, 300 } };
+  const auto coarse = std::vector<DrawRange>{ { 300, 60 } };
+  scene.renderableObjects = { makeObject(0, full, { 1.0F, 0.0F, 0.0F }), makeObject(1000, full), makeObject(0, coarse),
+    makeObject(0, full, { 2.0F, 0.0F, 0.0F }) };
+  scene.renderableObjects[1]->objectId = 7;
+
+  auto instances = std::vector<InstanceData>();
+  const auto draws = DrawCollector::collect(scene, everythingUploaded, instances);
+
+  // The two full detail objects of the first mesh share a draw, a different LOD or mesh draws on its own.
+  REQUIRE(draws.size() == 3);
+  REQUIRE(instances.size() == 4);
+  REQUIRE(draws[0].object->drawRanges == full);
+  REQUIRE(draws[0].object->geometry.firstIndex == 0);
+  REQUIRE(draws[0].instanceCount == 2);
+  REQUIRE(draws[1].object->drawRanges == coarse);
+  REQUIRE(draws[1].instanceCount == 1);
+  REQUIRE(draws[2].object->geometry.firstIndex == 1000);
+  REQUIRE(draws[2].instanceCount == 1);
+
+  // Every draw reads its own instances, the objects' positions in the order they are drawn.
+  auto next = uint32_t{ 0 };
+  for (const auto &draw : draws) {
+    REQUIRE(draw.firstInstance == next);
+    next += draw.instanceCount;
+  }
+  REQUIRE(instances[0].position.x + instances[1].position.x == 3.0F);
+  REQUIRE(instances[3].objectId == 7);
+}
+
+TEST_CASE("Draws are ordered by vertex layout", "[DrawCollector]")
+{
+  auto scene = Scene();
+  const auto ranges = std::vector<DrawRange>{ { 0, 3 } };
+  scene.renderableObjects = { makeObject(0, ranges), makeObject(10, ranges), makeObject(20, ranges) };
+  scene.renderableObjects[0]->vertexLayout = VertexLayoutKind::Quantized;
+  scene.renderableObjects[2]->vertexLayout = VertexLayoutKind::Quantized;
+
+  auto instances = std::vector<InstanceData>();
+  const auto draws = DrawCollector::collect(scene, everythingUploaded, instances);
+  REQUIRE(draws.size() == 3);
+  REQUIRE(draws[0].object->vertexLayout == VertexLayoutKind::Float);
+  REQUIRE(draws[1].object->vertexLayout == VertexLayoutKind::Quantized);
+  REQUIRE(draws[2].object->vertexLayout == VertexLayoutKind::Quantized);
+}
+
+TEST_CASE("Culled, pending and batched objects are not drawn on their own", "[DrawCollector]")
+{
+  auto scene = Scene();
+  const auto ranges = std::vector<DrawRange>{ { 0, 3 } };
+  auto culled = makeObject(0, {});
+  auto pending = makeObject(0, ranges);
+  pending->uploadToken = 2;
+  auto batched = makeObject(0, ranges);
+  batched->setStatic(true);
+  batched->inStaticBatch = true;
+  // Static, but its batch is not swapped in yet.
+  auto waiting = makeObject(0, ranges, { 5.0F, 0.0F, 0.0F });
+  waiting->setStatic(true);
+  scene.renderableObjects = { culled, pending, batched, waiting };
+
+  auto batch = makeObject(40, ranges);
+  auto chunk = makeObject(80, ranges);
+  scene.staticBatches[static_cast<size_t>(VertexLayoutKind::Float)] = { batch };
+  scene.terrainChunks = { chunk };
+
+  auto instances = std::vector<InstanceData>();
+  const auto draws = DrawCollector::collect(scene, [](UploadToken token) { return token <= 1; }, instances);
+
+  REQUIRE(draws.size() == 3);
+  REQUIRE(draws[0].object == waiting.get());
+  // Batches and chunks are placed by their vertices, so they are drawn once at the origin.
+  REQUIRE(draws[1].object == batch.get());
+  REQUIRE(draws[2].object == chunk.get());
+  REQUIRE(instances.size() == 3);
+  REQUIRE(instances[0].position.x == 5.0F);
+  REQUIRE(instances[1].position == glm::vec3(0.0F));
+  REQUIRE(instances[2].position == glm::vec3(0.0F));
+}
@@ -0,0 +1,245 @@
+#pragma once
+// Just enough of vulkan.hpp for the UploadQueue, backed by a simulated transfer queue.
+// Submitted command buffers only run when a test executes them or something waits for their fence, so copies read
+// the staging memory as late as a real GPU could, and fences and semaphores signal in submission order.
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace vk {
+using DeviceSize = uint64_t;
+
+enum class Result { eSuccess, eNotReady };
+
+struct Buffer
+{
+  int id = 0;
+  explicit operator bool() const { return id != 0; }
+};
+
+enum class CommandPoolCreateFlagBits : uint32_t { eTransient = 1, eResetCommandBuffer = 2 };
+struct CommandPoolCreateFlags
+{
+  uint32_t mask = 0;
+};
+inline CommandPoolCreateFlags operator|(CommandPoolCreateFlagBits lhs, CommandPoolCreateFlagBits rhs)
+{
+  return { static_cast<uint32_t>(lhs) | static_cast<uint32_t>(rhs) };
+}
+struct CommandPoolCreateInfo
+{
+  CommandPoolCreateInfo(CommandPoolCreateFlags, uint32_t) {}
+};
+struct CommandPool
+{
+  int id = 0;
+};
+
+enum class CommandBufferLevel { ePrimary };
+struct CommandBufferAllocateInfo
+{
+  CommandBufferAllocateInfo &setCommandPool(CommandPool) { return *this; }
+  CommandBufferAllocateInfo &setLevel(CommandBufferLevel) { return *this; }
+  CommandBufferAllocateInfo &setCommandBufferCount(uint32_t) { return *this; }
+};
+enum class CommandBufferUsageFlagBits { eOneTimeSubmit };
+struct CommandBufferBeginInfo
+{
+  CommandBufferBeginInfo &setFlags(CommandBufferUsageFlagBits) { return *this; }
+};
+struct CommandBufferResetFlags
+{
+};
+
+struct BufferCopy
+{
+  BufferCopy(DeviceSize source, DeviceSize destination, DeviceSize copySize) : srcOffset(source), dstOffset(destination), size(copySize) {}
+  DeviceSize srcOffset;
+  DeviceSize dstOffset;
+  DeviceSize size;
+};
+
+namespace fake {
+  // A copy from a buffer, or an inline update when source is 0.
+  struct Command
+  {
+    int source;
+    int destination;
+    DeviceSize sourceOffset;
+    DeviceSize destinationOffset;
+    DeviceSize size;
+    std::vector<std::byte> data;
+  };
+
+  struct Recording
+  {
+    std::vector<Command> commands;
+    bool recording = false;
+  };
+
+  struct Submission
+  {
+    std::vector<Command> commands;
+    int fence;
+    int semaphore;
+  };
+
+  // Misuse the validation layers would catch, counted so tests can require none.
+  struct Errors
+  {
+    int recordingTwice = 0;
+    int notRecording = 0;
+    int badUpdate = 0;
+    int submittingSignaledFence = 0;
+    int signalingSignaledSemaphore = 0;
+    int waitingForever = 0;
+
+    int total() const
+    {
+      return recordingTwice + notRecording + badUpdate + submittingSignaledFence + signalingSignaledSemaphore + waitingForever;
+    }
+  };
+
+  struct Device
+  {
+    std::map<int, std::byte *> memory;
+    std::deque<Submission> pending;
+    std::map<int, bool> signaled;
+    // Nothing waits for semaphores here, a test resets them once it has looked at them.
+    std::map<int, bool> semaphores;
+    int nextFence = 1;
+    int executed = 0;
+    Errors errors;
+
+    // Runs the oldest submission and signals its fence, returns false if nothing was submitted.
+    bool executeOldest()
+    {
+      if (pending.empty()) {
+        return false;
+      }
+
+      const auto submission = pending.front();
+      pending.pop_front();
+      for (const auto &command : submission.commands) {
+        auto *destination = memory.at(command.destination) + command.destinationOffset;
+        const auto *source = command.source == 0 ? command.data.data() : memory.at(command.source) + command.sourceOffset;
+        std::memcpy(destination, source, command.size);
+      }
+      if (submission.fence != 0) {
+        signaled[submission.fence] = true;
+      }
+      if (submission.semaphore != 0) {
+        errors.signalingSignaledSemaphore += semaphores[submission.semaphore];
+        semaphores[submission.semaphore] = true;
+      }
+      ++executed;
+      return true;
+    }
+  };
+
+  // One simulated device per test, it is reset by constructing a new one.
+  inline std::unique_ptr<Device> device = std::make_unique<Device>();
+}// namespace fake
+
+struct CommandBuffer
+{
+  std::shared_ptr<fake::Recording> recording;
+
+  explicit operator bool() const { return recording != nullptr; }
+
+  void begin(const CommandBufferBeginInfo *)
+  {
+    fake::device->errors.recordingTwice += recording->recording;
+    recording->recording = true;
+    recording->commands.clear();
+  }
+  void end() { recording->recording = false; }
+  void copyBuffer(Buffer source, Buffer destination, uint32_t, const BufferCopy *region)
+  {
+    fake::device->errors.notRecording += !recording->recording;
+    recording->commands.push_back({ source.id, destination.id, region->srcOffset, region->dstOffset, region->size, {} });
+  }
+  void updateBuffer(Buffer destination, DeviceSize offset, DeviceSize size, const void *data)
+  {
+    fake::device->errors.notRecording += !recording->recording;
+    fake::device->errors.badUpdate += size > 65536 || offset % 4 != 0 || size % 4 != 0;
+    const auto *bytes = static_cast<const std::byte *>(data);
+    recording->commands.push_back({ 0, destination.id, 0, offset, size, { bytes, bytes + size } });
+  }
+  void reset(CommandBufferResetFlags) { recording->commands.clear(); }
+};
+
+struct Fence
+{
+  int id = 0;
+};
+struct FenceCreateInfo
+{
+};
+
+struct Semaphore
+{
+  int id = 0;
+};
+
+struct SubmitInfo
+{
+  const CommandBuffer *commandBuffer = nullptr;
+  const Semaphore *signalSemaphore = nullptr;
+  SubmitInfo &setCommandBufferCount(uint32_t) { return *this; }
+  SubmitInfo &setPCommandBuffers(const CommandBuffer *buffers)
+  {
+    commandBuffer = buffers;
+    return *this;
+  }
+  SubmitInfo &setSignalSemaphoreCount(uint32_t) { return *this; }
+  SubmitInfo &setPSignalSemaphores(const Semaphore *semaphores)
+  {
+    signalSemaphore = semaphores;
+    return *this;
+  }
+};
+
+struct Queue
+{
+  // Submissions without command buffers or without a fence are allowed, as in Vulkan.
+  void submit(uint32_t, const SubmitInfo *info, Fence fence) const
+  {
+    if (fence.id != 0) {
+      fake::device->errors.submittingSignaledFence += fake::device->signaled[fence.id];
+    }
+    auto commands = info->commandBuffer != nullptr ? info->commandBuffer->recording->commands : std::vector<fake::Command>();
+    const auto semaphore = info->signalSemaphore != nullptr ? info->signalSemaphore->id : 0;
+    fake::device->pending.push_back({ std::move(commands), fence.id, semaphore });
+  }
+};
+
+struct Device
+{
+  CommandPool createCommandPool(const CommandPoolCreateInfo &) const { return { 1 }; }
+  void destroyCommandPool(CommandPool) const {}
+  void allocateCommandBuffers(const CommandBufferAllocateInfo *, CommandBuffer *buffers) const
+  {
+    buffers->recording = std::make_shared<fake::Recording>();
+  }
+  Fence createFence(const FenceCreateInfo &) const { return { fake::device->nextFence++ }; }
+  void destroyFence(Fence) const {}
+  void resetFences(uint32_t, const Fence *fences) const { fake::device->signaled[fences->id] = false; }
+  Result getFenceStatus(Fence fence) const { return fake::device->signaled[fence.id] ? Result::eSuccess : Result::eNotReady; }
+  // The queue is only ever behind, waiting runs it until the fence signals.
+  Result waitForFences(uint32_t, const Fence *fences, bool, uint64_t) const
+  {
+    while (!fake::device->signaled[fences->id]) {
+      if (!fake::device->executeOldest()) {
+        ++fake::device->errors.waitingForever;
+        break;
+      }
+    }
+    return Result::eSuccess;
+  }
+};
+}// namespace vk
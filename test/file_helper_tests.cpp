@@ -0,0 +1,34 @@
+#include <catch2/catch.hpp>
+
+#include "FileHelper.h"
+
+#include <filesystem>
+#include <fstream>
+
+TEST_CASE("Missing files read as empty", "[FileHelper]")
+{
+  const auto path = (std::filesystem::temp_directory_path() / "narnia_missing_file.bin").string();
+  std::filesystem::remove(path);
+
+  REQUIRE(FileHelper::readFileByte(path).empty());
+  REQUIRE(FileHelper::readFile(path).empty());
+
+  const auto files = FileHelper::readFiles({ path, path });
+  REQUIRE(files.size() == 2);
+  REQUIRE(files[0].empty());
+  REQUIRE(files[1].empty());
+}
+
+TEST_CASE("Files are read whole", "[FileHelper]")
+{
+  const auto path = (std::filesystem::temp_directory_path() / "narnia_file_helper.bin").string();
+  {
+    auto file = std::ofstream(path, std::ios::binary);
+    file << "first line\nsecond";
+  }
+
+  const auto bytes = FileHelper::readFileByte(path);
+  REQUIRE(std::string(bytes.begin(), bytes.end()) == "first line\nsecond");
+  REQUIRE(FileHelper::readFileLines(path) == std::vector<std::string>{ "first line", "second" });
+  std::filesystem::remove(path);
+}
@@ -0,0 +1,121 @@
+#include <catch2/catch.hpp>
+
+#include "GeometryBuffer.h"
+
+#include <map>
+#include <random>
+#include <vector>
+
+namespace {
+struct LiveMesh
+{
+  GeometryRange range;
+  uint64_t vertexBytes;
+  uint64_t indexBytes;
+};
+
+// Ranges of one buffer, by start, must not overlap.
+bool disjoint(const std::map<uint64_t, uint64_t> &ranges)
+{
+  auto end = uint64_t{ 0 };
+  for (const auto &[offset, size] : ranges) {
+    if (offset < end) {
+      return false;
+    }
+    end = offset + size;
+  }
+  return true;
+}
+}// namespace
+
+TEST_CASE("Vertex ranges start at a multiple of their stride", "[GeometryBuffer]")
+{
+  // Powers of two and strides that are not, which the allocator can not simply align to.
+  const auto stride = GENERATE(uint32_t{ 12 }, uint32_t{ 16 }, uint32_t{ 20 }, uint32_t{ 28 }, uint32_t{ 36 });
+  auto buffer = GeometryBuffer(1 << 16, 1 << 16);
+
+  // A range of another stride in front shifts the free space off any multiple of this one.
+  REQUIRE(buffer.allocate(7 * 4, 4, 6 * 2, 2).isValid());
+
+  for (uint32_t i = 0; i < 50; ++i) {
+    const auto vertexBytes = uint64_t{ stride } * (1 + i % 13);
+    const auto range = buffer.allocate(vertexBytes, stride, 3 * 4, 4);
+    REQUIRE(range.isValid());
+    REQUIRE(range.vertexByteOffset % stride == 0);
+    REQUIRE(range.vertexByteOffset == uint64_t{ static_cast<uint32_t>(range.vertexOffset) } * stride);
+    REQUIRE(range.vertexByteOffset + vertexBytes <= buffer.vertexCapacity());
+  }
+}
+
+TEST_CASE("Mixed layouts and index types keep their ranges aligned and apart", "[GeometryBuffer]")
+{
+  auto random = std::mt19937(3);
+  auto buffer = GeometryBuffer(1000, 1000);
+  auto live = std::vector<LiveMesh>();
+
+  for (int step = 0; step < 5000; ++step) {
+    if (!live.empty() && random() % 3 == 0) {
+      const auto index = random() % live.size();
+      buffer.free(live[index].range);
+      live.erase(live.begin() + static_cast<std::ptrdiff_t>(index));
+      continue;
+    }
+
+    const auto stride = random() % 2 == 0 ? uint32_t{ 28 } : uint32_t{ 12 };
+    const auto indexSize = random() % 2 == 0 ? uint32_t{ 2 } : uint32_t{ 4 };
+    const auto vertexBytes = uint64_t{ stride } * (random() % 50 + 1);
+    const auto indexBytes = uint64_t{ indexSize } * 3 * (random() % 20 + 1);
+
+    auto range = buffer.allocate(vertexBytes, stride, indexBytes, indexSize);
+    if (!range.isValid()) {
+      // As the GPU does: grow by doubling with room for the alignment, offsets of earlier ranges stay.
+      buffer.grow(buffer.vertexCapacity() * 2 + vertexBytes + stride, buffer.indexCapacity() * 2 + indexBytes + 4);
+      range = buffer.allocate(vertexBytes, stride, indexBytes, indexSize);
+    }
+    REQUIRE(range.isValid());
+
+    REQUIRE(range.vertexByteOffset % stride == 0);
+    REQUIRE(range.vertexByteOffset == uint64_t{ static_cast<uint32_t>(range.vertexOffset) } * stride);
+    REQUIRE(range.vertexByteOffset + vertexBytes <= buffer.vertexCapacity());
+    // Index ranges can be streamed with vkCmdUpdateBuffer, which writes whole words.
+    REQUIRE(range.indexByteOffset % 4 == 0);
+    REQUIRE(range.indexByteOffset == uint64_t{ range.firstIndex } * indexSize);
+    REQUIRE(range.indexByteOffset + indexBytes <= buffer.indexCapacity());
+    live.push_back({ range, vertexBytes, indexBytes });
+  }
+
+  auto vertexRanges = std::map<uint64_t, uint64_t>();
+  auto indexRanges = std::map<uint64_t, uint64_t>();
+  for (const auto &mesh : live) {
+    vertexRanges.emplace(mesh.range.vertexByteOffset, mesh.vertexBytes);
+    indexRanges.emplace(mesh.range.indexByteOffset, mesh.indexBytes);
+  }
+  REQUIRE(vertexRanges.size() == live.size());
+  REQUIRE(disjoint(vertexRanges));
+  REQUIRE(disjoint(indexRanges));
+  REQUIRE(buffer.rangeCount() == live.size());
+
+  for (const auto &mesh : live) {
+    buffer.free(mesh.range);
+  }
+  REQUIRE(buffer.rangeCount() == 0);
+  REQUIRE(buffer.usedBytes() == 0);
+}
+
+TEST_CASE("A failed allocation takes no space", "[GeometryBuffer]")
+{
+  auto buffer = GeometryBuffer(1024, 64);
+
+  // The vertices fit but the indices do not, the vertex range must be handed back.
+  REQUIRE_FALSE(buffer.allocate(512, 16, 128, 4).isValid());
+  REQUIRE(buffer.usedBytes() == 0);
+  REQUIRE(buffer.rangeCount() == 0);
+
+  const auto range = buffer.allocate(1024 - 15, 16, 64, 4);
+  REQUIRE(range.isValid());
+  buffer.free(range);
+
+  // Ranges that do not own space are ignored.
+  buffer.free(GeometryRange());
+  REQUIRE(buffer.usedBytes() == 0);
+}
@@ -0,0 +1,100 @@
+#include <catch2/catch.hpp>
+
+#include "MeshCache.h"
+
+#include <vector>
+
+namespace {
+// Uploads hand out consecutive ranges and can be made to fail, what was uploaded and freed is recorded.
+struct Harness
+{
+  Harness()
+    : cache(
+      [this](const ModelData &, vk::IndexType indexType, UploadToken &uploadToken) {
+        indexTypes.push_back(indexType);
+        if (failUploads) {
+          return GeometryRange();
+        }
+        auto range = GeometryRange();
+        range.vertexNode = nextNode;
+        range.indexNode = nextNode;
+        range.firstIndex = nextNode * 100;
+        uploadToken = nextNode++;
+        return range;
+      },
+      [this](const GeometryRange &geometry) { freed.push_back(geometry.vertexNode); })
+  {
+  }
+
+  ModelData model(IndexType indexType) { return { verticies, indicies, {}, {}, VertexLayoutKind::Float, {}, indexType, MeshEncoding::Raw, {}, usage }; }
+
+  std::vector<std::byte> verticies = std::vector<std::byte>(28 * 3);
+  std::vector<std::byte> indicies = std::vector<std::byte>(3 * sizeof(uint32_t));
+  std::atomic<uint32_t> usage{ 0 };
+  std::vector<vk::IndexType> indexTypes;
+  std::vector<uint32_t> freed;
+  uint32_t nextNode = 1;
+  bool failUploads = false;
+  MeshCache cache;
+};
+}// namespace
+
+TEST_CASE("Objects of a model share one upload", "[MeshCache]")
+{
+  auto harness = Harness();
+  const auto handle = ModelHandle{ 3, 1 };
+
+  const auto *first = harness.cache.acquire(handle, harness.model(IndexType::Uint32));
+  const auto *second = harness.cache.acquire(handle, harness.model(IndexType::Uint32));
+  REQUIRE(first != nullptr);
+  REQUIRE(second == first);
+  REQUIRE(harness.indexTypes.size() == 1);
+  REQUIRE(first->references == 2);
+  REQUIRE(first->uploadToken == 1);
+
+  // The mesh stays until its last user releases it.
+  harness.cache.release(handle);
+  REQUIRE(harness.freed.empty());
+  harness.cache.release(handle);
+  REQUIRE(harness.freed == std::vector<uint32_t>{ 1 });
+
+  // Once freed the next acquire uploads it again.
+  const auto *again = harness.cache.acquire(handle, harness.model(IndexType::Uint32));
+  REQUIRE(again != nullptr);
+  REQUIRE(again->geometry.vertexNode == 2);
+  REQUIRE(harness.indexTypes.size() == 2);
+}
+
+TEST_CASE("A reused handle slot gets a mesh of its own", "[MeshCache]")
+{
+  auto harness = Harness();
+
+  const auto *old = harness.cache.acquire(ModelHandle{ 0, 0 }, harness.model(IndexType::Uint16));
+  const auto *reused = harness.cache.acquire(ModelHandle{ 0, 1 }, harness.model(IndexType::Uint32));
+  REQUIRE(old != nullptr);
+  REQUIRE(reused != nullptr);
+  REQUIRE(reused != old);
+  REQUIRE(harness.indexTypes == std::vector<vk::IndexType>{ vk::IndexType::eUint16, vk::IndexType::eUint32 });
+}
+
+TEST_CASE("A failed upload is not cached", "[MeshCache]")
+{
+  auto harness = Harness();
+  const auto handle = ModelHandle{ 1, 0 };
+
+  harness.failUploads = true;
+  REQUIRE(harness.cache.acquire(handle, harness.model(IndexType::Uint32)) == nullptr);
+  REQUIRE(harness.cache.acquire(handle, harness.model(IndexType::Uint32)) == nullptr);
+  REQUIRE(harness.indexTypes.size() == 2);
+
+  // Nothing was kept, so releasing frees nothing and the next acquire tries again.
+  harness.cache.release(handle);
+  REQUIRE(harness.freed.empty());
+
+  harness.failUploads = false;
+  const auto *mesh = harness.cache.acquire(handle, harness.model(IndexType::Uint32));
+  REQUIRE(mesh != nullptr);
+  REQUIRE(mesh->references == 1);
+  harness.cache.release(handle);
+  REQUIRE(harness.freed == std::vector<uint32_t>{ 1 });
+}
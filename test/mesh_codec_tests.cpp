@@ -0,0 +1,198 @@
+#include <catch2/catch.hpp>
+
+#include "MeshCodec.h"
+
+#include <cstring>
+#include <random>
+
+namespace {
+// Smooth values in the low bytes and noise in the high ones, so every bit width of the vertex coder is used.
+std::vector<std::byte> makeVerticies(size_t count, size_t stride)
+{
+  auto random = std::mt19937(11);
+  auto result = std::vector<std::byte>(count * stride);
+  for (size_t vertex = 0; vertex < count; ++vertex) {
+    for (size_t lane = 0; lane < stride; ++lane) {
+      const auto smooth = static_cast<uint8_t>(vertex / (lane + 1));
+      result[vertex * stride + lane] = std::byte(lane % 4 == 3 ? static_cast<uint8_t>(random()) : smooth);
+    }
+  }
+  return result;
+}
+
+// A strip of quads followed by triangles with random far apart verticies, which need explicit coding.
+template<typename Index>
+std::vector<std::byte> makeIndices(uint32_t vertexCount)
+{
+  auto indices = std::vector<Index>();
+  for (uint32_t i = 0; i + 3 < vertexCount / 2; i += 2) {
+    indices.insert(indices.end(), { Index(i), Index(i + 1), Index(i + 2), Index(i + 2), Index(i + 1), Index(i + 3) });
+  }
+  auto random = std::mt19937(5);
+  for (int i = 0; i < 300; ++i) {
+    indices.push_back(Index(random() % vertexCount));
+  }
+
+  auto result = std::vector<std::byte>(indices.size() * sizeof(Index));
+  std::memcpy(result.data(), indices.data(), result.size());
+  return result;
+}
+
+std::vector<std::byte> withHeaderCount(std::vector<std::byte> encoded, uint32_t count)
+{
+  std::memcpy(encoded.data() + sizeof(uint32_t), &count, sizeof(count));
+  return encoded;
+}
+}// namespace
+
+TEST_CASE("Verticies survive a round trip", "[MeshCodec]")
+{
+  const auto stride = GENERATE(size_t{ 4 }, size_t{ 16 }, size_t{ 28 }, size_t{ 256 });
+  // Counts around the group size and across several blocks, with partial ones at the end.
+  const auto count = GENERATE(size_t{ 0 }, size_t{ 1 }, size_t{ 15 }, size_t{ 17 }, size_t{ 1000 });
+
+  const auto verticies = makeVerticies(count, stride);
+  const auto encoded = MeshCodec::encodeVerticies(verticies, stride);
+  REQUIRE(MeshCodec::decodedSize(encoded) == verticies.size());
+
+  auto decoded = std::vector<std::byte>(verticies.size());
+  REQUIRE(MeshCodec::decodeVerticies(encoded, decoded));
+  REQUIRE(decoded == verticies);
+}
+
+TEST_CASE("Indices survive a round trip with their triangles in order", "[MeshCodec]")
+{
+  constexpr uint32_t VERTEX_COUNT = 2000;
+  const auto [indices, indexType, indexSize] = GENERATE(
+    std::make_tuple(makeIndices<uint16_t>(VERTEX_COUNT), IndexType::Uint16, sizeof(uint16_t)),
+    std::make_tuple(makeIndices<uint32_t>(VERTEX_COUNT), IndexType::Uint32, sizeof(uint32_t)));
+
+  const auto encoded = MeshCodec::encodeIndices(indices, indexType);
+  REQUIRE(MeshCodec::decodedSize(encoded) == indices.size());
+
+  auto decoded = std::vector<std::byte>(indices.size());
+  REQUIRE(MeshCodec::decodeIndices(encoded, decoded, VERTEX_COUNT));
+
+  // Triangles may be rotated, but keep their place and winding.
+  const auto read = [indexSize = indexSize](const std::vector<std::byte> &data, size_t i) {
+    auto value = uint32_t{ 0 };
+    std::memcpy(&value, data.data() + i * indexSize, indexSize);
+    return value;
+  };
+  for (size_t triangle = 0; triangle < indices.size() / indexSize / 3; ++triangle) {
+    const auto a = read(indices, triangle * 3);
+    const auto b = read(indices, triangle * 3 + 1);
+    const auto c = read(indices, triangle * 3 + 2);
+    const auto x = read(decoded, triangle * 3);
+    const auto y = read(decoded, triangle * 3 + 1);
+    const auto z = read(decoded, triangle * 3 + 2);
+    const bool sameTriangle = (x == a && y == b && z == c) || (x == b && y == c && z == a) || (x == c && y == a && z == b);
+    REQUIRE(sameTriangle);
+  }
+}
+
+TEST_CASE("Indices outside the mesh are rejected", "[MeshCodec]")
+{
+  const auto indices = makeIndices<uint32_t>(500);
+  const auto encoded = MeshCodec::encodeIndices(indices, IndexType::Uint32);
+
+  auto decoded = std::vector<std::byte>(indices.size());
+  REQUIRE(MeshCodec::decodeIndices(encoded, decoded, 500));
+  REQUIRE_FALSE(MeshCodec::decodeIndices(encoded, decoded, 499));
+}
+
+TEST_CASE("Truncated streams are rejected", "[MeshCodec]")
+{
+  const auto verticies = makeVerticies(700, 16);
+  const auto indices = makeIndices<uint16_t>(700);
+  const auto encodedVerticies = MeshCodec::encodeVerticies(verticies, 16);
+  const auto encodedIndices = MeshCodec::encodeIndices(indices, IndexType::Uint16);
+
+  auto decodedVerticies = std::vector<std::byte>(verticies.size());
+  auto decodedIndices = std::vector<std::byte>(indices.size());
+  for (size_t size = 0; size < encodedVerticies.size(); ++size) {
+    const auto truncated = std::span(encodedVerticies).first(size);
+    // Short streams either have their size rejected or fail while decoding.
+    if (MeshCodec::decodedSize(truncated) == verticies.size()) {
+      REQUIRE_FALSE(MeshCodec::decodeVerticies(truncated, decodedVerticies));
+    }
+  }
+  for (size_t size = 0; size < encodedIndices.size(); ++size) {
+    const auto truncated = std::span(encodedIndices).first(size);
+    if (MeshCodec::decodedSize(truncated) == indices.size()) {
+      REQUIRE_FALSE(MeshCodec::decodeIndices(truncated, decodedIndices, 700));
+    }
+  }
+}
+
+TEST_CASE("Headers claiming more data than the stream holds are rejected", "[MeshCodec]")
+{
+  const auto verticies = makeVerticies(100, 16);
+  const auto encodedVerticies = MeshCodec::encodeVerticies(verticies, 16);
+  const auto encodedIndices = MeshCodec::encodeIndices(makeIndices<uint16_t>(100), IndexType::Uint16);
+
+  const auto hugeVerticies = withHeaderCount(encodedVerticies, UINT32_MAX);
+  const auto hugeIndices = withHeaderCount(encodedIndices, 0xFFFFFFF0);
+  REQUIRE(MeshCodec::decodedSize(hugeVerticies) == 0);
+  REQUIRE(MeshCodec::decodedSize(hugeIndices) == 0);
+
+  auto nothing = std::vector<std::byte>();
+  REQUIRE_FALSE(MeshCodec::decodeVerticies(hugeVerticies, nothing));
+  REQUIRE_FALSE(MeshCodec::decodeIndices(hugeIndices, nothing, 100));
+}
+
+TEST_CASE("Malformed streams are rejected", "[MeshCodec]")
+{
+  const auto verticies = makeVerticies(64, 8);
+  const auto encoded = MeshCodec::encodeVerticies(verticies, 8);
+  auto decoded = std::vector<std::byte>(verticies.size());
+
+  SECTION("Unknown magic")
+  {
+    auto corrupted = encoded;
+    corrupted[0] ^= std::byte{ 0xFF };
+    REQUIRE(MeshCodec::decodedSize(corrupted) == 0);
+    REQUIRE_FALSE(MeshCodec::decodeVerticies(corrupted, decoded));
+  }
+
+  SECTION("Vertex stride that is not a multiple of 4")
+  {
+    auto corrupted = encoded;
+    const auto stride = uint32_t{ 6 };
+    std::memcpy(corrupted.data() + 2 * sizeof(uint32_t), &stride, sizeof(stride));
+    REQUIRE(MeshCodec::decodedSize(corrupted) == 0);
+    REQUIRE_FALSE(MeshCodec::decodeVerticies(corrupted, decoded));
+  }
+
+  SECTION("Index stream passed as verticies")
+  {
+    const auto indices = MeshCodec::encodeIndices(makeIndices<uint32_t>(64), IndexType::Uint32);
+    REQUIRE_FALSE(MeshCodec::decodeVerticies(indices, decoded));
+    REQUIRE_FALSE(MeshCodec::decodeIndices(encoded, decoded, 64));
+  }
+
+  SECTION("Destination of the wrong size")
+  {
+    auto shorter = std::vector<std::byte>(verticies.size() - 8);
+    REQUIRE_FALSE(MeshCodec::decodeVerticies(encoded, shorter));
+  }
+
+  SECTION("Random damage never decodes out of bounds")
+  {
+    auto random = std::mt19937(3);
+    const auto indices = makeIndices<uint16_t>(64);
+    const auto encodedIndices = MeshCodec::encodeIndices(indices, IndexType::Uint16);
+    auto decodedIndices = std::vector<std::byte>(indices.size());
+    for (int round = 0; round < 1000; ++round) {
+      auto corrupted = encodedIndices;
+      corrupted[16 + random() % (corrupted.size() - 16)] = std::byte(random());
+      if (MeshCodec::decodeIndices(corrupted, decodedIndices, 64)) {
+        for (size_t i = 0; i < decodedIndices.size(); i += sizeof(uint16_t)) {
+          auto value = uint16_t{ 0 };
+          std::memcpy(&value, decodedIndices.data() + i, sizeof(value));
+          REQUIRE(value < 64);
+        }
+      }
+    }
+  }
+}
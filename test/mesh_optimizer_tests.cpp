@@ -0,0 +1,111 @@
+#include <catch2/catch.hpp>
+
+#include "MeshOptimizer.h"
+
+#include <algorithm>
+#include <array>
+#include <random>
+
+namespace {
+// A grid of quads with its triangles shuffled, so every pass has something to reorder.
+void makeShuffledGrid(uint32_t size, std::vector<Vertex> &verticies, std::vector<uint32_t> &indices)
+{
+  for (uint32_t y = 0; y <= size; ++y) {
+    for (uint32_t x = 0; x <= size; ++x) {
+      verticies.push_back({ { static_cast<float>(x), static_cast<float>(y), 0.0F }, { 1.0F, 1.0F, 1.0F, 1.0F } });
+    }
+  }
+
+  auto triangles = std::vector<std::array<uint32_t, 3>>();
+  for (uint32_t y = 0; y < size; ++y) {
+    for (uint32_t x = 0; x < size; ++x) {
+      const auto corner = y * (size + 1) + x;
+      triangles.push_back({ corner, corner + size + 1, corner + 1 });
+      triangles.push_back({ corner + 1, corner + size + 1, corner + size + 2 });
+    }
+  }
+
+  std::shuffle(triangles.begin(), triangles.end(), std::mt19937(7));
+  for (const auto &triangle : triangles) {
+    indices.insert(indices.end(), triangle.begin(), triangle.end());
+  }
+}
+
+using Corner = std::array<float, 3>;
+using Triangle = std::array<Corner, 3>;
+
+// Triangles by position, rotated to start at their smallest corner so the winding is kept but not the start.
+std::vector<Triangle> trianglesOf(const std::vector<Vertex> &verticies, const std::vector<uint32_t> &indices)
+{
+  auto result = std::vector<Triangle>();
+  for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+    auto triangle = Triangle();
+    for (size_t corner = 0; corner < 3; ++corner) {
+      const auto &position = verticies[indices[i + corner]].postion;
+      triangle[corner] = { position.x, position.y, position.z };
+    }
+    std::rotate(triangle.begin(), std::min_element(triangle.begin(), triangle.end()), triangle.end());
+    result.push_back(triangle);
+  }
+
+  std::sort(result.begin(), result.end());
+  return result;
+}
+}// namespace
+
+TEST_CASE("Optimizing keeps every triangle and its winding", "[MeshOptimizer]")
+{
+  auto verticies = std::vector<Vertex>();
+  auto indices = std::vector<uint32_t>();
+  makeShuffledGrid(16, verticies, indices);
+
+  const auto originalVertexCount = verticies.size();
+  const auto originalIndexCount = indices.size();
+  const auto originalTriangles = trianglesOf(verticies, indices);
+
+  MeshOptimizer::optimize("grid", verticies, indices);
+
+  REQUIRE(verticies.size() == originalVertexCount);
+  REQUIRE(indices.size() == originalIndexCount);
+  REQUIRE(std::all_of(indices.begin(), indices.end(), [&](uint32_t index) { return index < verticies.size(); }));
+  REQUIRE(trianglesOf(verticies, indices) == originalTriangles);
+}
+
+TEST_CASE("Vertex cache ordering is a permutation of the triangles and does not get worse", "[MeshOptimizer]")
+{
+  auto verticies = std::vector<Vertex>();
+  auto indices = std::vector<uint32_t>();
+  makeShuffledGrid(32, verticies, indices);
+
+  const auto before = MeshOptimizer::analyze(indices, verticies.size());
+  const auto originalTriangles = trianglesOf(verticies, indices);
+
+  const auto clusters = MeshOptimizer::optimizeVertexCache(indices, verticies.size());
+
+  REQUIRE_FALSE(clusters.empty());
+  REQUIRE(std::is_sorted(clusters.begin(), clusters.end()));
+  REQUIRE(clusters.back() < indices.size() / 3);
+  REQUIRE(trianglesOf(verticies, indices) == originalTriangles);
+  REQUIRE(MeshOptimizer::analyze(indices, verticies.size()).acmr <= before.acmr);
+}
+
+TEST_CASE("Vertex fetch ordering numbers verticies in first use order", "[MeshOptimizer]")
+{
+  auto verticies = std::vector<Vertex>();
+  auto indices = std::vector<uint32_t>();
+  makeShuffledGrid(8, verticies, indices);
+
+  const auto originalTriangles = trianglesOf(verticies, indices);
+
+  MeshOptimizer::optimizeVertexFetch(verticies, indices);
+
+  auto nextNew = uint32_t{ 0 };
+  for (const auto index : indices) {
+    REQUIRE(index <= nextNew);
+    if (index == nextNew) {
+      ++nextNew;
+    }
+  }
+  REQUIRE(nextNew == verticies.size());
+  REQUIRE(trianglesOf(verticies, indices) == originalTriangles);
+}
@@ -0,0 +1,59 @@
+#include <catch2/catch.hpp>
+
+#include "MeshletBuilder.h"
+
+namespace {
+// Front faces are clockwise on screen. Seen from a viewer looking along +z with y down, (0, 0), (1, 0), (0, 1) is clockwise.
+void addQuad(glm::vec3 corner, bool facesViewer, std::vector<Vertex> &verticies, std::vector<uint32_t> &indices)
+{
+  const auto first = static_cast<uint32_t>(verticies.size());
+  for (const auto offset : { glm::vec3(0.0F, 0.0F, 0.0F), glm::vec3(1.0F, 0.0F, 0.0F), glm::vec3(0.0F, 1.0F, 0.0F), glm::vec3(1.0F, 1.0F, 0.0F) }) {
+    verticies.push_back({ corner + offset, { 1.0F, 1.0F, 1.0F, 1.0F } });
+  }
+
+  const auto quad = facesViewer ? std::vector<uint32_t>{ 0, 1, 2, 2, 1, 3 } : std::vector<uint32_t>{ 0, 2, 1, 2, 3, 1 };
+  for (const auto index : quad) {
+    indices.push_back(first + index);
+  }
+}
+}// namespace
+
+TEST_CASE("Meshlet cones point out of front faces", "[MeshletBuilder]")
+{
+  auto verticies = std::vector<Vertex>();
+  auto indices = std::vector<uint32_t>();
+  addQuad({ -3.0F, 0.0F, 0.0F }, true, verticies, indices);
+  addQuad({ 3.0F, 0.0F, 0.0F }, false, verticies, indices);
+
+  const auto meshlets = MeshletBuilder::build("quads", verticies, indices, indices.size());
+
+  // Opposite normals never share a meshlet.
+  REQUIRE(meshlets.size() == 2);
+  const auto &front = meshlets[0];
+  const auto &back = meshlets[1];
+  REQUIRE(front.coneCutoff < 1.0F);
+  REQUIRE(back.coneCutoff < 1.0F);
+  REQUIRE(front.coneAxis.z < 0.0F);
+  REQUIRE(back.coneAxis.z > 0.0F);
+
+  const auto viewer = glm::vec3(0.0F, 0.0F, -5.0F);
+  REQUIRE_FALSE(front.isBackFacing(viewer));
+  REQUIRE(back.isBackFacing(viewer));
+
+  const auto behind = glm::vec3(0.0F, 0.0F, 5.0F);
+  REQUIRE(front.isBackFacing(behind));
+  REQUIRE_FALSE(back.isBackFacing(behind));
+}
+
+TEST_CASE("Meshlets seen edge on are not culled", "[MeshletBuilder]")
+{
+  auto verticies = std::vector<Vertex>();
+  auto indices = std::vector<uint32_t>();
+  addQuad({ 0.0F, 0.0F, 0.0F }, true, verticies, indices);
+
+  const auto meshlets = MeshletBuilder::build("quad", verticies, indices, indices.size());
+  REQUIRE(meshlets.size() == 1);
+
+  // In the plane of the quad, its bounding sphere keeps it from being culled.
+  REQUIRE_FALSE(meshlets[0].isBackFacing(glm::vec3(10.5F, 0.5F, 0.0F)));
+}
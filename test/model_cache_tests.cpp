@@ -0,0 +1,123 @@
+#include <catch2/catch.hpp>
+
+#include "ModelCache.h"
+
+#include <vector>
+
+namespace {
+constexpr size_t MODEL_BYTES = 100;
+
+ModelHandle handle(uint32_t index)
+{
+  return { index, 0 };
+}
+
+// A cache over models of MODEL_BYTES each that records what it evicts and reloads.
+struct Harness
+{
+  explicit Harness(size_t budget)
+    : cache([this](ModelHandle model) { evicted.push_back(model.index); },
+      [this](ModelHandle model) -> std::optional<size_t> {
+        reloaded.push_back(model.index);
+        return failReload ? std::nullopt : std::optional<size_t>(MODEL_BYTES);
+      },
+      budget)
+  {
+  }
+
+  // References are normally released by ModelData, the tests drop them by hand.
+  static void release(std::atomic<uint32_t> *references) { --*references; }
+
+  std::vector<uint32_t> evicted;
+  std::vector<uint32_t> reloaded;
+  bool failReload = false;
+  ModelCache cache;
+};
+}// namespace
+
+TEST_CASE("Reset is refused while a model is referenced", "[ModelCache]")
+{
+  auto harness = Harness(ModelCache::DEFAULT_BUDGET);
+  REQUIRE(harness.cache.reset(4));
+  harness.cache.insert(handle(0), MODEL_BYTES, true);
+  harness.cache.insert(handle(1), MODEL_BYTES, false);
+
+  auto *first = harness.cache.acquire(handle(0));
+  auto *second = harness.cache.acquire(handle(1));
+  REQUIRE(first != nullptr);
+  REQUIRE(second != nullptr);
+  REQUIRE(harness.cache.referencedCount() == 2);
+
+  // The counters stay where they are, the references taken from them are still good.
+  REQUIRE_FALSE(harness.cache.reset(0));
+  REQUIRE(harness.cache.residentBytes() == MODEL_BYTES);
+  Harness::release(first);
+  REQUIRE_FALSE(harness.cache.reset(0));
+  Harness::release(second);
+
+  REQUIRE(harness.cache.referencedCount() == 0);
+  REQUIRE(harness.cache.reset(0));
+  REQUIRE(harness.cache.residentBytes() == 0);
+}
+
+TEST_CASE("Unreferenced models are evicted least recently used first", "[ModelCache]")
+{
+  auto harness = Harness(3 * MODEL_BYTES);
+  REQUIRE(harness.cache.reset(5));
+  for (uint32_t i = 0; i < 3; ++i) {
+    harness.cache.insert(handle(i), MODEL_BYTES, true);
+    Harness::release(harness.cache.acquire(handle(i)));
+  }
+  // Model 0 is used again, so 1 is now the least recently used.
+  Harness::release(harness.cache.acquire(handle(0)));
+  REQUIRE(harness.evicted.empty());
+
+  harness.cache.insert(handle(3), MODEL_BYTES, true);
+  Harness::release(harness.cache.acquire(handle(3)));
+  REQUIRE(harness.evicted == std::vector<uint32_t>{ 1 });
+  REQUIRE(harness.cache.residentBytes() == 3 * MODEL_BYTES);
+
+  // Acquiring an evicted model reloads it, which pushes out the next one.
+  auto *reloaded = harness.cache.acquire(handle(1));
+  REQUIRE(reloaded != nullptr);
+  REQUIRE(harness.reloaded == std::vector<uint32_t>{ 1 });
+  REQUIRE(harness.evicted == std::vector<uint32_t>{ 1, 2 });
+  Harness::release(reloaded);
+}
+
+TEST_CASE("Referenced, fresh and resident-only models are never evicted", "[ModelCache]")
+{
+  auto harness = Harness(MODEL_BYTES);
+  REQUIRE(harness.cache.reset(4));
+
+  harness.cache.insert(handle(0), MODEL_BYTES, true);
+  auto *held = harness.cache.acquire(handle(0));
+  harness.cache.insert(handle(1), MODEL_BYTES, false);
+  // Not acquired yet, a load past the budget does not throw away what was just loaded.
+  harness.cache.insert(handle(2), MODEL_BYTES, true);
+  REQUIRE(harness.evicted.empty());
+  REQUIRE(harness.cache.residentBytes() == 2 * MODEL_BYTES);
+
+  // Shrinking the budget only evicts what is no longer held.
+  harness.cache.setBudget(0);
+  REQUIRE(harness.evicted.empty());
+  Harness::release(held);
+  harness.cache.setBudget(0);
+  REQUIRE(harness.evicted == std::vector<uint32_t>{ 0 });
+}
+
+TEST_CASE("A failed reload hands out no reference", "[ModelCache]")
+{
+  auto harness = Harness(0);
+  REQUIRE(harness.cache.reset(1));
+  harness.cache.insert(handle(0), MODEL_BYTES, true);
+  Harness::release(harness.cache.acquire(handle(0)));
+  // Releasing does not trim, the next change to the cache does.
+  harness.cache.setBudget(0);
+  REQUIRE(harness.evicted == std::vector<uint32_t>{ 0 });
+
+  harness.failReload = true;
+  REQUIRE(harness.cache.acquire(handle(0)) == nullptr);
+  REQUIRE(harness.cache.referencedCount() == 0);
+  REQUIRE(harness.cache.reset(0));
+}
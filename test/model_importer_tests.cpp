@@ -0,0 +1,36 @@
+#include <catch2/catch.hpp>
+
+#include "ModelImporter.h"
+
+#include <filesystem>
+#include <fstream>
+
+namespace {
+ModelSource writeObj(const std::string &fileName, const std::string &contents)
+{
+  const auto path = (std::filesystem::temp_directory_path() / fileName).string();
+  auto file = std::ofstream(path, std::ios::trunc);
+  file << contents;
+  return { "model", path };
+}
+}// namespace
+
+TEST_CASE("Faces within the vertex list are imported", "[ModelImporter]")
+{
+  const auto source = writeObj("narnia_quad.obj", "v 0 0 0\nv 1 0 0\nv 0 1 0\nv 1 1 0\nf 1 2 3\nf 3 2 4\n");
+  const auto model = ModelImporter::importObj(source);
+  std::filesystem::remove(source.path);
+
+  REQUIRE(model.has_value());
+  REQUIRE(model->indexCount() == 6);
+}
+
+TEST_CASE("Faces referring to verticies the file does not have are rejected", "[ModelImporter]")
+{
+  const auto face = GENERATE(std::string("f 1 2 5\n"), std::string("f 1 2 100000\n"), std::string("f -5 1 2\n"));
+  const auto source = writeObj("narnia_bad_face.obj", "v 0 0 0\nv 1 0 0\nv 0 1 0\nv 1 1 0\n" + face);
+  const auto model = ModelImporter::importObj(source);
+  std::filesystem::remove(source.path);
+
+  REQUIRE_FALSE(model.has_value());
+}
@@ -0,0 +1,177 @@
+#include <catch2/catch.hpp>
+
+#include "SceneSnapshot.h"
+
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+namespace {
+std::string tempPath(const std::string &name)
+{
+  return (std::filesystem::temp_directory_path() / name).string();
+}
+
+std::vector<char> readBytes(const std::string &path)
+{
+  auto file = std::ifstream(path, std::ios::binary);
+  return { std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>() };
+}
+
+void writeBytes(const std::string &path, const std::vector<char> &bytes)
+{
+  auto file = std::ofstream(path, std::ios::binary | std::ios::trunc);
+  file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+}
+
+// Three objects, two of them sharing a model, written to path.
+void writeScene(const std::string &path)
+{
+  auto writer = SceneSnapshotWriter();
+  writer.addObject("tree", "pine", { 1.0F, 2.0F, 3.0F }, true);
+  writer.addObject("rock", "boulder", { -4.5F, 0.0F, 1e6F }, false);
+  writer.addObject("second tree", "pine", { 0.0F, -7.25F, 0.5F }, true);
+  REQUIRE(writer.write(path));
+}
+
+scenefile::Header readHeader(const std::vector<char> &bytes)
+{
+  auto header = scenefile::Header();
+  std::memcpy(&header, bytes.data(), sizeof(header));
+  return header;
+}
+
+std::vector<char> withHeader(std::vector<char> bytes, const scenefile::Header &header)
+{
+  std::memcpy(bytes.data(), &header, sizeof(header));
+  return bytes;
+}
+}// namespace
+
+TEST_CASE("Scenes survive a round trip", "[SceneSnapshot]")
+{
+  const auto path = tempPath("narnia_scene_round_trip.nsc");
+  writeScene(path);
+
+  auto snapshot = SceneSnapshot();
+  REQUIRE(snapshot.open(path));
+  REQUIRE(snapshot.isOpen());
+  REQUIRE(snapshot.objectCount() == 3);
+
+  REQUIRE(snapshot.models().size() == 2);
+  REQUIRE(SceneSnapshot::modelName(snapshot.models()[0]) == "pine");
+  REQUIRE(SceneSnapshot::modelName(snapshot.models()[1]) == "boulder");
+  REQUIRE(snapshot.objectModels()[0] == 0);
+  REQUIRE(snapshot.objectModels()[1] == 1);
+  REQUIRE(snapshot.objectModels()[2] == 0);
+
+  REQUIRE(snapshot.objectName(0) == "tree");
+  REQUIRE(snapshot.objectName(1) == "rock");
+  REQUIRE(snapshot.objectName(2) == "second tree");
+  REQUIRE(snapshot.objectFlags()[0] == scenefile::OBJECT_STATIC);
+  REQUIRE(snapshot.objectFlags()[1] == 0);
+  REQUIRE(snapshot.objectFlags()[2] == scenefile::OBJECT_STATIC);
+
+  // Positions are stored as they are, so they come back bit for bit.
+  REQUIRE(snapshot.positions()[1].x == -4.5F);
+  REQUIRE(snapshot.positions()[1].z == 1e6F);
+  REQUIRE(snapshot.positions()[2].y == -7.25F);
+
+  snapshot.close();
+  REQUIRE_FALSE(snapshot.isOpen());
+  REQUIRE(snapshot.objectCount() == 0);
+  std::filesystem::remove(path);
+}
+
+TEST_CASE("Model names longer than a scene holds are truncated", "[SceneSnapshot]")
+{
+  const auto path = tempPath("narnia_scene_long_name.nsc");
+  const auto longName = std::string(scenefile::MAX_NAME_LENGTH + 10, 'm');
+  auto writer = SceneSnapshotWriter();
+  writer.addObject("object", longName, {}, false);
+  REQUIRE(writer.write(path));
+
+  auto snapshot = SceneSnapshot();
+  REQUIRE(snapshot.open(path));
+  REQUIRE(SceneSnapshot::modelName(snapshot.models()[0]) == longName.substr(0, scenefile::MAX_NAME_LENGTH - 1));
+  snapshot.close();
+  std::filesystem::remove(path);
+}
+
+TEST_CASE("Truncated scenes are rejected", "[SceneSnapshot]")
+{
+  const auto path = tempPath("narnia_scene_truncated.nsc");
+  writeScene(path);
+  const auto bytes = readBytes(path);
+
+  // The names are the last array and reach the end of the file, so every cut loses part of an array.
+  auto snapshot = SceneSnapshot();
+  for (size_t size = 0; size < bytes.size(); ++size) {
+    writeBytes(path, { bytes.begin(), bytes.begin() + static_cast<std::ptrdiff_t>(size) });
+    REQUIRE_FALSE(snapshot.open(path));
+    REQUIRE_FALSE(snapshot.isOpen());
+  }
+  std::filesystem::remove(path);
+}
+
+TEST_CASE("Corrupted scenes are rejected", "[SceneSnapshot]")
+{
+  const auto path = tempPath("narnia_scene_corrupted.nsc");
+  writeScene(path);
+  const auto bytes = readBytes(path);
+  const auto header = readHeader(bytes);
+  auto snapshot = SceneSnapshot();
+
+  auto corrupted = bytes;
+  SECTION("Unknown magic")
+  {
+    auto changed = header;
+    changed.magic ^= 0xFF;
+    corrupted = withHeader(bytes, changed);
+  }
+
+  SECTION("Newer version")
+  {
+    auto changed = header;
+    changed.version = scenefile::VERSION + 1;
+    corrupted = withHeader(bytes, changed);
+  }
+
+  SECTION("Object count past the end of the file")
+  {
+    auto changed = header;
+    changed.objectCount = 0xFFFFFFFF;
+    corrupted = withHeader(bytes, changed);
+  }
+
+  SECTION("Array that is not aligned")
+  {
+    auto changed = header;
+    changed.positionsOffset += 4;
+    corrupted = withHeader(bytes, changed);
+  }
+
+  SECTION("Object with a model that is not in the scene")
+  {
+    const auto model = uint32_t{ 2 };
+    std::memcpy(corrupted.data() + header.objectModelsOffset + sizeof(uint32_t), &model, sizeof(model));
+  }
+
+  SECTION("Name outside the names array")
+  {
+    const auto range = scenefile::NameRange{ static_cast<uint32_t>(header.namesSize) - 2, 3 };
+    std::memcpy(corrupted.data() + header.nameRangesOffset, &range, sizeof(range));
+  }
+
+  writeBytes(path, corrupted);
+  REQUIRE_FALSE(snapshot.open(path));
+  REQUIRE_FALSE(snapshot.isOpen());
+
+  // The writer's own file still opens, only the damage is rejected.
+  writeBytes(path, bytes);
+  REQUIRE(snapshot.open(path));
+  snapshot.close();
+  std::filesystem::remove(path);
+}
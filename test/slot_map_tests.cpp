@@ -0,0 +1,155 @@
+#include <catch2/catch.hpp>
+
+#include "ResourceHandle.h"
+#include "SlotMap.h"
+
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+using Handle = ResourceHandle<struct SlotMapTestTag>;
+using StringMap = SlotMap<std::string, Handle>;
+}// namespace
+
+TEST_CASE("Emplaced values are found by their handle until erased", "[SlotMap]")
+{
+  auto map = StringMap();
+
+  const auto first = map.emplace("first");
+  const auto second = map.emplace("second");
+
+  REQUIRE(map.size() == 2);
+  REQUIRE(*map.get(first) == "first");
+  REQUIRE(*map.get(second) == "second");
+
+  REQUIRE(map.erase(first));
+  REQUIRE(map.size() == 1);
+  REQUIRE(map.get(first) == nullptr);
+  REQUIRE_FALSE(map.contains(first));
+  REQUIRE(*map.get(second) == "second");
+}
+
+TEST_CASE("Stale handles do not match a reused slot", "[SlotMap]")
+{
+  auto map = StringMap();
+
+  const auto stale = map.emplace("old");
+  REQUIRE(map.erase(stale));
+
+  const auto reused = map.emplace("new");
+  REQUIRE(reused.index == stale.index);
+  REQUIRE(reused.generation != stale.generation);
+
+  REQUIRE(map.get(stale) == nullptr);
+  REQUIRE_FALSE(map.erase(stale));
+  REQUIRE(*map.get(reused) == "new");
+  REQUIRE(map.size() == 1);
+}
+
+TEST_CASE("Invalid and never issued handles are rejected", "[SlotMap]")
+{
+  auto map = StringMap();
+  const auto handle = map.emplace("value");
+
+  REQUIRE(map.get(Handle{}) == nullptr);
+  REQUIRE_FALSE(map.erase(Handle{}));
+  REQUIRE(map.get(Handle{ handle.index, 0 }) == nullptr);
+  REQUIRE(map.get(Handle{ handle.index + 1, 1 }) == nullptr);
+  REQUIRE(map.get(Handle{ StringMap::CAPACITY, 1 }) == nullptr);
+}
+
+TEST_CASE("Clear keeps generations so old handles stay stale", "[SlotMap]")
+{
+  auto map = StringMap();
+  const auto before = map.emplace("before");
+
+  map.clear();
+  REQUIRE(map.empty());
+
+  const auto after = map.emplace("after");
+  REQUIRE(after.index == before.index);
+  REQUIRE(map.get(before) == nullptr);
+  REQUIRE(*map.get(after) == "after");
+}
+
+TEST_CASE("Generations alternate between occupied and free across the wrap", "[SlotMap]")
+{
+  STATIC_REQUIRE_FALSE(StringMap::isOccupied(0));
+  STATIC_REQUIRE(StringMap::isOccupied(StringMap::nextGeneration(0)));
+  STATIC_REQUIRE(StringMap::isOccupied(UINT32_MAX));
+  STATIC_REQUIRE(StringMap::nextGeneration(UINT32_MAX) == 0);
+  STATIC_REQUIRE_FALSE(StringMap::isOccupied(StringMap::nextGeneration(UINT32_MAX)));
+
+  // Every reuse of a slot hands out a handle no earlier one compares equal to.
+  auto map = StringMap();
+  auto generations = std::set<uint32_t>();
+  auto handle = map.emplace("value");
+  for (int i = 0; i < 10000; ++i) {
+    REQUIRE(StringMap::isOccupied(handle.generation));
+    REQUIRE(generations.insert(handle.generation).second);
+    REQUIRE(map.erase(handle));
+    handle = map.emplace("value");
+  }
+}
+
+TEST_CASE("Concurrent emplace and erase keep every live value reachable", "[SlotMap]")
+{
+  constexpr int THREAD_COUNT = 8;
+  constexpr int ROUNDS = 2000;
+  constexpr int LIVE_PER_THREAD = 16;
+
+  auto map = StringMap();
+  auto survivors = std::vector<std::vector<Handle>>(THREAD_COUNT);
+  auto failures = std::vector<int>(THREAD_COUNT, 0);
+
+  auto threads = std::vector<std::thread>();
+  for (int thread = 0; thread < THREAD_COUNT; ++thread) {
+    threads.emplace_back([&, thread]() {
+      auto live = std::vector<std::pair<Handle, std::string>>();
+      for (int round = 0; round < ROUNDS; ++round) {
+        auto value = std::to_string(thread) + ":" + std::to_string(round);
+        live.emplace_back(map.emplace(value), value);
+
+        if (live.size() > LIVE_PER_THREAD) {
+          const auto [handle, expected] = live.front();
+          const auto *stored = map.get(handle);
+          failures[thread] += stored == nullptr || *stored != expected;
+          failures[thread] += !map.erase(handle);
+          failures[thread] += map.get(handle) != nullptr;
+          live.erase(live.begin());
+        }
+      }
+
+      for (const auto &[handle, expected] : live) {
+        const auto *stored = map.get(handle);
+        failures[thread] += stored == nullptr || *stored != expected;
+        survivors[thread].push_back(handle);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  for (const auto count : failures) {
+    REQUIRE(count == 0);
+  }
+  REQUIRE(map.size() == THREAD_COUNT * LIVE_PER_THREAD);
+
+  // Live handles must not share a slot.
+  auto indices = std::set<uint32_t>();
+  for (const auto &handles : survivors) {
+    for (const auto &handle : handles) {
+      REQUIRE(indices.insert(handle.index).second);
+    }
+  }
+
+  auto visited = size_t{ 0 };
+  map.forEach([&](Handle handle, const std::string &) {
+    REQUIRE(indices.count(handle.index) == 1);
+    ++visited;
+  });
+  REQUIRE(visited == map.size());
+}
@@ -0,0 +1,151 @@
+#include <catch2/catch.hpp>
+
+#include "StaticBatcher.h"
+#include "VertexEncoder.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+struct StoredModel
+{
+  std::vector<std::byte> verticies;
+  std::vector<std::byte> indicies;
+  VertexLayoutKind layout;
+  VertexQuantization quantization;
+  Bounds bounds;
+};
+
+// Hands out models kept in memory, everything the batcher does not use is left empty.
+class FakeResourceManager : public ResourceManagerAPI
+{
+public:
+  ModelHandle add(StoredModel model)
+  {
+    m_models.push_back(std::move(model));
+    return { static_cast<uint32_t>(m_models.size() - 1), 0 };
+  }
+
+  ModelData getModel(ModelHandle model) override
+  {
+    if (!model.isValid() || model.index >= m_models.size()) {
+      return {};
+    }
+    const auto &stored = m_models[model.index];
+    ++m_usage;
+    return { stored.verticies, stored.indicies, {}, {}, stored.layout, stored.quantization, IndexType::Uint16, MeshEncoding::Raw, stored.bounds, m_usage };
+  }
+
+  uint32_t usage() const { return m_usage; }
+
+  void LoadResources() override {}
+  std::shared_future<LoadProgress> LoadResourcesAsync(LoadCallback) override { return {}; }
+  LoadProgress getLoadProgress() const override { return {}; }
+  std::shared_future<LoadStatus> getShaderStatus(ShaderHandle) const override { return {}; }
+  std::shared_future<LoadStatus> getModelStatus(ModelHandle) const override { return {}; }
+  std::shared_future<LoadStatus> getTextureStatus(TextureHandle) const override { return {}; }
+  void whenShaderReady(ShaderHandle, std::function<void(LoadStatus)>) override {}
+  void whenModelReady(ModelHandle, std::function<void(LoadStatus)>) override {}
+  ShaderHandle findShader(std::string_view) const override { return {}; }
+  ModelHandle findModel(std::string_view) const override { return {}; }
+  std::string_view getModelName(ModelHandle) const override { return {}; }
+  std::shared_ptr<const ShaderResource> getShader(ShaderHandle) const override { return nullptr; }
+  TextureHandle findTexture(std::string_view) const override { return {}; }
+  const TextureResource *getTexture(TextureHandle) const override { return nullptr; }
+  std::vector<ShaderHandle> pollShaderChanges() override { return {}; }
+  void setModelMemoryBudget(size_t) override {}
+  void setTextureQuality(TextureQuality) override {}
+  std::shared_ptr<const ShaderResource> getShader(const std::string &) const override { return nullptr; }
+  ModelData getModel(const std::string &) override { return {}; }
+  const TextureResource *getTexture(const std::string &) const override { return nullptr; }
+  void cleanUp() override {}
+
+private:
+  std::vector<StoredModel> m_models;
+  std::atomic<uint32_t> m_usage{ 0 };
+};
+
+// A lopsided box of about a unit, its corners do not fall on round snorm16 values.
+StoredModel makeBox(VertexLayoutKind layout)
+{
+  auto verticies = std::vector<Vertex>();
+  for (int corner = 0; corner < 8; ++corner) {
+    const auto x = corner & 1 ? 0.613F : -0.387F;
+    const auto y = corner & 2 ? 0.291F : -0.709F;
+    const auto z = corner & 4 ? 0.457F : -0.543F;
+    verticies.push_back({ { x, y, z }, { 0.25F, 0.5F, 0.75F, 1.0F } });
+  }
+  const auto box = Aabb{ { -0.387F, -0.709F, -0.543F }, { 0.613F, 0.291F, 0.457F } };
+
+  const auto indices = std::vector<uint16_t>{ 0, 1, 3, 0, 3, 2, 4, 6, 7, 4, 7, 5, 0, 4, 5, 0, 5, 1, 2, 3, 7, 2, 7, 6,
+    0, 2, 6, 0, 6, 4, 1, 5, 7, 1, 7, 3 };
+  auto indexBytes = std::vector<std::byte>(indices.size() * sizeof(uint16_t));
+  std::memcpy(indexBytes.data(), indices.data(), indexBytes.size());
+
+  const auto quantization = layout == VertexLayoutKind::Quantized ? VertexEncoder::computeQuantization(box) : VertexQuantization();
+  return { VertexEncoder::encode(verticies, layout, quantization), std::move(indexBytes), layout, quantization, { box, { box.center(), 1.0F } } };
+}
+
+float largestExtent(const Aabb &box)
+{
+  const auto extent = box.max - box.min;
+  return std::max({ extent.x, extent.y, extent.z });
+}
+}// namespace
+
+TEST_CASE("Quantized batches of far apart objects keep their precision", "[StaticBatcher]")
+{
+  auto resources = FakeResourceManager();
+  const auto box = makeBox(VertexLayoutKind::Quantized);
+  const auto model = resources.add(box);
+
+  // Two groups thousands of units apart, given in mixed order.
+  const auto positions = std::vector<glm::vec3>{ { 0.0F, 0.0F, 0.0F }, { 2000.0F, -1500.0F, 800.0F }, { 10.0F, 0.0F, 3.0F },
+    { 2012.0F, -1490.0F, 805.0F }, { 0.0F, 20.0F, 5.0F }, { 1995.0F, -1500.0F, 790.0F } };
+  auto members = std::vector<RenderableObjectPtr>();
+  for (const auto &position : positions) {
+    members.push_back(std::make_shared<RenderableObject>("box", position));
+    members.back()->model = model;
+  }
+
+  const auto batches = StaticBatcher::build(VertexLayoutKind::Quantized, members, resources);
+  REQUIRE(resources.usage() == 0);
+  // Each group fits into one batch, the two do not share one.
+  REQUIRE(batches.size() == 2);
+
+  const auto modelVerticies = VertexEncoder::decode(box.verticies, box.layout, box.quantization);
+  for (const auto &batch : batches) {
+    REQUIRE(batch.members.size() == 3);
+    REQUIRE(largestExtent(batch.bounds.box) <= StaticBatcher::MAX_QUANTIZED_BATCH_EXTENT);
+
+    const auto batchVerticies = VertexEncoder::decode(batch.verticies, VertexLayoutKind::Quantized, batch.quantization);
+    REQUIRE(batchVerticies.size() == modelVerticies.size() * batch.members.size());
+
+    // A snorm16 step across the batch, and the rounding of floats this far from the origin.
+    const auto tolerance = StaticBatcher::MAX_QUANTIZED_BATCH_EXTENT / 65534.0F + 0.001F;
+    for (size_t member = 0; member < batch.members.size(); ++member) {
+      for (size_t i = 0; i < modelVerticies.size(); ++i) {
+        const auto expected = modelVerticies[i].postion + batch.members[member]->m_position;
+        const auto error = glm::abs(batchVerticies[member * modelVerticies.size() + i].postion - expected);
+        REQUIRE(std::max({ error.x, error.y, error.z }) <= tolerance);
+      }
+    }
+  }
+}
+
+TEST_CASE("Float batches are not split by their extent", "[StaticBatcher]")
+{
+  auto resources = FakeResourceManager();
+  const auto model = resources.add(makeBox(VertexLayoutKind::Float));
+
+  auto members = std::vector<RenderableObjectPtr>();
+  for (int i = 0; i < 4; ++i) {
+    members.push_back(std::make_shared<RenderableObject>("box", glm::vec3(static_cast<float>(i) * 1000.0F, 0.0F, 0.0F)));
+    members.back()->model = model;
+  }
+
+  const auto batches = StaticBatcher::build(VertexLayoutKind::Float, members, resources);
+  REQUIRE(batches.size() == 1);
+  REQUIRE(batches.front().members.size() == members.size());
+  REQUIRE(batches.front().indexCount == 4 * 36);
+}
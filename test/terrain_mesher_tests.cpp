@@ -0,0 +1,150 @@
+#include <catch2/catch.hpp>
+
+#include "TerrainMesher.h"
+
+#include <cstring>
+#include <set>
+#include <utility>
+
+namespace {
+struct GridPoint
+{
+  int x;
+  int z;
+};
+
+struct Triangle
+{
+  GridPoint a;
+  GridPoint b;
+  GridPoint c;
+};
+
+TerrainSettings makeSettings()
+{
+  auto settings = TerrainSettings();
+  settings.chunkQuads = 8;
+  settings.lodCount = 3;
+  return settings;
+}
+
+// The triangles of one variant, in grid coordinates of the chunk.
+std::vector<Triangle> triangles(const TerrainIndices &indices, const TerrainSettings &settings, uint32_t lod, uint32_t mask)
+{
+  REQUIRE(indices.indexType == IndexType::Uint16);
+  const auto &variant = indices.variants[lod * TerrainMesher::STITCH_MASK_COUNT + mask];
+  const auto row = static_cast<int>(settings.chunkQuads + 1);
+  const auto point = [&](uint32_t i) {
+    auto value = uint16_t{ 0 };
+    std::memcpy(&value, indices.indicies.data() + (variant.firstIndex + i) * sizeof(uint16_t), sizeof(value));
+    REQUIRE(value < row * row);
+    return GridPoint{ value % row, value / row };
+  };
+
+  auto result = std::vector<Triangle>();
+  for (uint32_t i = 0; i < variant.indexCount; i += 3) {
+    result.push_back({ point(i), point(i + 1), point(i + 2) });
+  }
+  return result;
+}
+
+// Twice the signed area on the ground plane, negative for clockwise seen from above.
+int doubleArea(const Triangle &triangle)
+{
+  return (triangle.b.z - triangle.a.z) * (triangle.c.x - triangle.a.x) - (triangle.b.x - triangle.a.x) * (triangle.c.z - triangle.a.z);
+}
+
+// Triangle edges lying on one side of the chunk, as ranges along that side.
+std::set<std::pair<int, int>> sideEdges(const std::vector<Triangle> &chunk, bool alongX, int line)
+{
+  auto result = std::set<std::pair<int, int>>();
+  const auto addEdge = [&](GridPoint from, GridPoint to) {
+    const auto onLine = alongX ? from.z == line && to.z == line : from.x == line && to.x == line;
+    if (onLine) {
+      const auto first = alongX ? from.x : from.z;
+      const auto second = alongX ? to.x : to.z;
+      result.insert({ std::min(first, second), std::max(first, second) });
+    }
+  };
+  for (const auto &triangle : chunk) {
+    addEdge(triangle.a, triangle.b);
+    addEdge(triangle.b, triangle.c);
+    addEdge(triangle.c, triangle.a);
+  }
+  return result;
+}
+
+struct Side
+{
+  uint32_t stitch;
+  bool alongX;
+  // Where the side is in this chunk and where the same line is in the neighbour across it.
+  int line;
+  int neighbourLine;
+};
+}// namespace
+
+TEST_CASE("Every variant covers its chunk once with clockwise triangles", "[TerrainMesher]")
+{
+  const auto settings = makeSettings();
+  const auto indices = TerrainMesher::buildIndices(settings);
+  REQUIRE(indices.variants.size() == settings.lodCount * TerrainMesher::STITCH_MASK_COUNT);
+
+  const auto lod = GENERATE(0U, 1U, 2U);
+  const auto mask = GENERATE(range(0U, TerrainMesher::STITCH_MASK_COUNT));
+  auto area = 0;
+  for (const auto &triangle : triangles(indices, settings, lod, mask)) {
+    // Collapsed triangles are left out, so none of them has zero area.
+    REQUIRE(doubleArea(triangle) < 0);
+    area -= doubleArea(triangle);
+  }
+  REQUIRE(area == static_cast<int>(2 * settings.chunkQuads * settings.chunkQuads));
+}
+
+TEST_CASE("Stitched sides match the coarser neighbour's edge", "[TerrainMesher]")
+{
+  const auto settings = makeSettings();
+  const auto indices = TerrainMesher::buildIndices(settings);
+  const auto quads = static_cast<int>(settings.chunkQuads);
+
+  const auto lod = GENERATE(0U, 1U);
+  const auto side = GENERATE_COPY(Side{ TerrainMesher::STITCH_NEGATIVE_Z, true, 0, quads }, Side{ TerrainMesher::STITCH_POSITIVE_Z, true, quads, 0 },
+    Side{ TerrainMesher::STITCH_NEGATIVE_X, false, 0, quads }, Side{ TerrainMesher::STITCH_POSITIVE_X, false, quads, 0 });
+  // The other sides stitched or not must not change this one.
+  const auto otherSides = GENERATE(0U, 15U);
+  const auto mask = side.stitch | otherSides;
+
+  const auto fine = sideEdges(triangles(indices, settings, lod, mask), side.alongX, side.line);
+  const auto coarse = sideEdges(triangles(indices, settings, lod + 1, 0), side.alongX, side.neighbourLine);
+  REQUIRE(fine == coarse);
+  REQUIRE(coarse.size() == settings.chunkQuads >> (lod + 1));
+
+  // Unstitched, the side keeps every vertex of its own LOD and would leave T-junctions.
+  const auto unstitched = sideEdges(triangles(indices, settings, lod, mask & ~side.stitch), side.alongX, side.line);
+  REQUIRE(unstitched.size() == settings.chunkQuads >> lod);
+}
+
+TEST_CASE("Neighbours at the same LOD share their edge", "[TerrainMesher]")
+{
+  const auto settings = makeSettings();
+  const auto indices = TerrainMesher::buildIndices(settings);
+  const auto quads = static_cast<int>(settings.chunkQuads);
+
+  for (uint32_t lod = 0; lod < settings.lodCount; ++lod) {
+    const auto chunk = triangles(indices, settings, lod, 0);
+    REQUIRE(sideEdges(chunk, true, 0) == sideEdges(chunk, true, quads));
+    REQUIRE(sideEdges(chunk, false, 0) == sideEdges(chunk, false, quads));
+  }
+}
+
+TEST_CASE("The coarsest LOD is never stitched", "[TerrainMesher]")
+{
+  const auto settings = makeSettings();
+  const auto indices = TerrainMesher::buildIndices(settings);
+  const auto lastLod = settings.lodCount - 1;
+
+  const auto &unstitched = indices.variants[lastLod * TerrainMesher::STITCH_MASK_COUNT];
+  for (uint32_t mask = 1; mask < TerrainMesher::STITCH_MASK_COUNT; ++mask) {
+    REQUIRE(indices.variants[lastLod * TerrainMesher::STITCH_MASK_COUNT + mask].indexCount == unstitched.indexCount);
+  }
+}
@@ -0,0 +1,353 @@
+#include <catch2/catch.hpp>
+
+#include "BlockCompressor.h"
+#include "MipGenerator.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <random>
+
+namespace {
+constexpr std::uint32_t CHANNELS = 4;
+
+using Block = std::array<std::uint8_t, BlockCompressor::BLOCK_PIXELS * CHANNELS>;
+using EncodedBc1 = std::array<std::byte, 8>;
+using EncodedBc7 = std::array<std::byte, 16>;
+
+std::uint32_t readBits(const std::byte *data, std::uint32_t &position, std::uint32_t bits)
+{
+  auto value = std::uint32_t{ 0 };
+  for (std::uint32_t bit = 0; bit < bits; ++bit, ++position) {
+    value |= ((std::to_integer<std::uint32_t>(data[position / 8]) >> (position % 8)) & 1U) << bit;
+  }
+  return value;
+}
+
+std::array<int, 3> expand565(std::uint32_t color)
+{
+  const auto red = static_cast<int>((color >> 11) & 0x1F);
+  const auto green = static_cast<int>((color >> 5) & 0x3F);
+  const auto blue = static_cast<int>(color & 0x1F);
+  return { (red << 3) | (red >> 2), (green << 2) | (green >> 4), (blue << 3) | (blue >> 2) };
+}
+
+// Reference decoders written from the format specifications, independent of the encoder.
+Block decodeBc1(const EncodedBc1 &encoded)
+{
+  auto position = std::uint32_t{ 0 };
+  const auto color0 = readBits(encoded.data(), position, 16);
+  const auto color1 = readBits(encoded.data(), position, 16);
+  const auto endpoint0 = expand565(color0);
+  const auto endpoint1 = expand565(color1);
+
+  auto palette = std::array<std::array<int, CHANNELS>, 4>();
+  for (size_t channel = 0; channel < 3; ++channel) {
+    palette[0][channel] = endpoint0[channel];
+    palette[1][channel] = endpoint1[channel];
+    if (color0 > color1) {
+      palette[2][channel] = (2 * endpoint0[channel] + endpoint1[channel]) / 3;
+      palette[3][channel] = (endpoint0[channel] + 2 * endpoint1[channel]) / 3;
+    } else {
+      palette[2][channel] = (endpoint0[channel] + endpoint1[channel]) / 2;
+      palette[3][channel] = 0;
+    }
+  }
+  palette[0][3] = palette[1][3] = palette[2][3] = 255;
+  palette[3][3] = color0 > color1 ? 255 : 0;
+
+  auto result = Block();
+  for (std::uint32_t pixel = 0; pixel < BlockCompressor::BLOCK_PIXELS; ++pixel) {
+    const auto &color = palette[readBits(encoded.data(), position, 2)];
+    for (size_t channel = 0; channel < CHANNELS; ++channel) {
+      result[pixel * CHANNELS + channel] = static_cast<std::uint8_t>(color[channel]);
+    }
+  }
+  return result;
+}
+
+// Mode 6 only, which is the only mode the encoder writes.
+Block decodeBc7(const EncodedBc7 &encoded)
+{
+  constexpr std::array<int, 16> WEIGHTS = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+  auto position = std::uint32_t{ 0 };
+  REQUIRE(readBits(encoded.data(), position, 7) == 1U << 6);
+
+  auto endpoints = std::array<std::array<int, CHANNELS>, 2>();
+  for (size_t channel = 0; channel < CHANNELS; ++channel) {
+    endpoints[0][channel] = static_cast<int>(readBits(encoded.data(), position, 7));
+    endpoints[1][channel] = static_cast<int>(readBits(encoded.data(), position, 7));
+  }
+  for (auto &endpoint : endpoints) {
+    const auto pBit = static_cast<int>(readBits(encoded.data(), position, 1));
+    for (auto &channel : endpoint) {
+      channel = (channel << 1) | pBit;
+    }
+  }
+
+  auto result = Block();
+  for (std::uint32_t pixel = 0; pixel < BlockCompressor::BLOCK_PIXELS; ++pixel) {
+    const auto weight = WEIGHTS[readBits(encoded.data(), position, pixel == 0 ? 3 : 4)];
+    for (size_t channel = 0; channel < CHANNELS; ++channel) {
+      result[pixel * CHANNELS + channel] = static_cast<std::uint8_t>(((64 - weight) * endpoints[0][channel] + weight * endpoints[1][channel] + 32) >> 6);
+    }
+  }
+  return result;
+}
+
+struct BlockError
+{
+  int maximum = 0;
+  double rms = 0.0;
+};
+
+// Largest difference between two pixels of the block in any channel.
+int channelRange(const Block &block, size_t channels)
+{
+  auto result = 0;
+  for (size_t channel = 0; channel < channels; ++channel) {
+    auto low = 255;
+    auto high = 0;
+    for (std::uint32_t pixel = 0; pixel < BlockCompressor::BLOCK_PIXELS; ++pixel) {
+      low = std::min<int>(low, block[pixel * CHANNELS + channel]);
+      high = std::max<int>(high, block[pixel * CHANNELS + channel]);
+    }
+    result = std::max(result, high - low);
+  }
+  return result;
+}
+
+BlockError compare(const Block &expected, const Block &actual, size_t channels)
+{
+  auto result = BlockError();
+  auto sum = 0.0;
+  for (std::uint32_t pixel = 0; pixel < BlockCompressor::BLOCK_PIXELS; ++pixel) {
+    for (size_t channel = 0; channel < channels; ++channel) {
+      const auto difference = std::abs(expected[pixel * CHANNELS + channel] - actual[pixel * CHANNELS + channel]);
+      result.maximum = std::max(result.maximum, difference);
+      sum += difference * difference;
+    }
+  }
+  result.rms = std::sqrt(sum / static_cast<double>(BlockCompressor::BLOCK_PIXELS * channels));
+  return result;
+}
+
+Block solidBlock(std::mt19937 &random)
+{
+  auto color = std::array<std::uint8_t, CHANNELS>();
+  for (auto &channel : color) {
+    channel = static_cast<std::uint8_t>(random() & 0xFF);
+  }
+
+  auto block = Block();
+  for (std::uint32_t pixel = 0; pixel < BlockCompressor::BLOCK_PIXELS; ++pixel) {
+    std::copy(color.begin(), color.end(), block.begin() + pixel * CHANNELS);
+  }
+  return block;
+}
+
+// Colours spread along one line, what a smooth gradient looks like inside a block.
+Block gradientBlock(std::mt19937 &random)
+{
+  auto from = std::array<float, CHANNELS>();
+  auto to = std::array<float, CHANNELS>();
+  for (size_t channel = 0; channel < CHANNELS; ++channel) {
+    from[channel] = static_cast<float>(random() & 0xFF);
+    to[channel] = static_cast<float>(random() & 0xFF);
+  }
+
+  auto block = Block();
+  for (std::uint32_t pixel = 0; pixel < BlockCompressor::BLOCK_PIXELS; ++pixel) {
+    const auto t = static_cast<float>(random() % 1001) / 1000.0F;
+    for (size_t channel = 0; channel < CHANNELS; ++channel) {
+      block[pixel * CHANNELS + channel] = static_cast<std::uint8_t>(std::lround(from[channel] + (to[channel] - from[channel]) * t));
+    }
+  }
+  return block;
+}
+
+Block noiseBlock(std::mt19937 &random)
+{
+  auto block = Block();
+  for (auto &value : block) {
+    value = static_cast<std::uint8_t>(random() & 0xFF);
+  }
+  return block;
+}
+
+Rgba8Image noiseImage(std::uint32_t width, std::uint32_t height, std::mt19937 &random)
+{
+  auto image = Rgba8Image();
+  image.width = width;
+  image.height = height;
+  image.pixels.resize(size_t{ width } * height * CHANNELS);
+  for (auto &value : image.pixels) {
+    value = static_cast<std::uint8_t>(random() & 0xFF);
+  }
+  return image;
+}
+
+// The plain 2x2 box filter MipGenerator::downsample documents, one pixel at a time.
+Rgba8Image downsampleReference(const Rgba8Image &source)
+{
+  auto result = Rgba8Image();
+  result.width = std::max<std::uint32_t>(1, source.width / 2);
+  result.height = std::max<std::uint32_t>(1, source.height / 2);
+  result.pixels.resize(size_t{ result.width } * result.height * CHANNELS);
+
+  const auto at = [&](std::uint32_t x, std::uint32_t y, size_t channel) {
+    x = std::min(x, source.width - 1);
+    y = std::min(y, source.height - 1);
+    return static_cast<int>(source.pixels[(size_t{ y } * source.width + x) * CHANNELS + channel]);
+  };
+
+  for (std::uint32_t y = 0; y < result.height; ++y) {
+    for (std::uint32_t x = 0; x < result.width; ++x) {
+      for (size_t channel = 0; channel < CHANNELS; ++channel) {
+        const auto sum = at(x * 2, y * 2, channel) + at(x * 2 + 1, y * 2, channel) + at(x * 2, y * 2 + 1, channel) + at(x * 2 + 1, y * 2 + 1, channel);
+        result.pixels[(size_t{ y } * result.width + x) * CHANNELS + channel] = static_cast<std::uint8_t>((sum + 2) / 4);
+      }
+    }
+  }
+  return result;
+}
+}// namespace
+
+TEST_CASE("BC1 blocks decode within the error of their palette", "[BlockCompressor]")
+{
+  auto random = std::mt19937(14);
+
+  for (int i = 0; i < 200; ++i) {
+    const auto block = solidBlock(random);
+    auto encoded = EncodedBc1();
+    BlockCompressor::encodeBc1Block(block.data(), encoded.data());
+    // Only the 5:6:5 rounding of the endpoint is lost.
+    REQUIRE(compare(block, decodeBc1(encoded), 3).maximum <= 4);
+  }
+
+  for (int i = 0; i < 200; ++i) {
+    const auto block = gradientBlock(random);
+    auto encoded = EncodedBc1();
+    BlockCompressor::encodeBc1Block(block.data(), encoded.data());
+    // Colours on a line are at most half a palette step, a sixth of the range, from an entry.
+    const auto error = compare(block, decodeBc1(encoded), 3);
+    REQUIRE(error.maximum <= channelRange(block, 3) / 6 + 8);
+  }
+
+  auto totalRms = 0.0;
+  for (int i = 0; i < 200; ++i) {
+    const auto block = noiseBlock(random);
+    auto encoded = EncodedBc1();
+    BlockCompressor::encodeBc1Block(block.data(), encoded.data());
+    totalRms += compare(block, decodeBc1(encoded), 3).rms;
+  }
+  REQUIRE(totalRms / 200.0 <= 64.0);
+}
+
+TEST_CASE("BC1 blocks always use the opaque four colour palette", "[BlockCompressor]")
+{
+  auto random = std::mt19937(1);
+  for (int i = 0; i < 200; ++i) {
+    const auto block = i % 2 == 0 ? gradientBlock(random) : noiseBlock(random);
+    auto encoded = EncodedBc1();
+    BlockCompressor::encodeBc1Block(block.data(), encoded.data());
+
+    const auto decoded = decodeBc1(encoded);
+    for (std::uint32_t pixel = 0; pixel < BlockCompressor::BLOCK_PIXELS; ++pixel) {
+      REQUIRE(decoded[pixel * CHANNELS + 3] == 255);
+    }
+  }
+}
+
+TEST_CASE("BC7 blocks decode within the error of their palette", "[BlockCompressor]")
+{
+  auto random = std::mt19937(7);
+
+  for (int i = 0; i < 200; ++i) {
+    const auto block = solidBlock(random);
+    auto encoded = EncodedBc7();
+    BlockCompressor::encodeBc7Block(block.data(), encoded.data());
+    // Endpoints keep 7 bits per channel plus a p-bit shared by all four channels.
+    REQUIRE(compare(block, decodeBc7(encoded), CHANNELS).maximum <= 2);
+  }
+
+  for (int i = 0; i < 200; ++i) {
+    const auto block = gradientBlock(random);
+    auto encoded = EncodedBc7();
+    BlockCompressor::encodeBc7Block(block.data(), encoded.data());
+    // Sixteen palette entries leave at most half of a fifteenth of the range.
+    const auto error = compare(block, decodeBc7(encoded), CHANNELS);
+    REQUIRE(error.maximum <= channelRange(block, CHANNELS) / 30 + 4);
+  }
+
+  auto totalRms = 0.0;
+  for (int i = 0; i < 200; ++i) {
+    const auto block = noiseBlock(random);
+    auto encoded = EncodedBc7();
+    BlockCompressor::encodeBc7Block(block.data(), encoded.data());
+    totalRms += compare(block, decodeBc7(encoded), CHANNELS).rms;
+  }
+  REQUIRE(totalRms / 200.0 <= 64.0);
+}
+
+TEST_CASE("Compressing an image encodes every block in place", "[BlockCompressor]")
+{
+  auto random = std::mt19937(3);
+  // Not a multiple of the block size, so the edge blocks repeat the last row and column.
+  const auto image = noiseImage(37, 19, random);
+
+  const auto compressed = BlockCompressor::compress(image, TextureFormat::Bc7);
+  REQUIRE(compressed.size() == TextureResource::levelSize(TextureFormat::Bc7, image.width, image.height));
+
+  const auto blocksWide = (image.width + 3) / 4;
+  const auto blocksHigh = (image.height + 3) / 4;
+  for (std::uint32_t blockY = 0; blockY < blocksHigh; ++blockY) {
+    for (std::uint32_t blockX = 0; blockX < blocksWide; ++blockX) {
+      auto block = Block();
+      for (std::uint32_t pixel = 0; pixel < BlockCompressor::BLOCK_PIXELS; ++pixel) {
+        const auto x = std::min(blockX * 4 + pixel % 4, image.width - 1);
+        const auto y = std::min(blockY * 4 + pixel / 4, image.height - 1);
+        std::copy_n(image.pixels.begin() + static_cast<std::ptrdiff_t>((size_t{ y } * image.width + x) * CHANNELS), CHANNELS, block.begin() + pixel * CHANNELS);
+      }
+
+      auto expected = EncodedBc7();
+      BlockCompressor::encodeBc7Block(block.data(), expected.data());
+      const auto offset = static_cast<std::ptrdiff_t>((size_t{ blockY } * blocksWide + blockX) * expected.size());
+      REQUIRE(std::equal(expected.begin(), expected.end(), compressed.begin() + offset));
+    }
+  }
+}
+
+TEST_CASE("Vectorized mip downsampling matches the scalar box filter", "[MipGenerator]")
+{
+  auto random = std::mt19937(5);
+
+  // Widths around the 4 and 8 pixel vector steps, odd sizes and single rows and columns.
+  const auto sizes = std::vector<std::pair<std::uint32_t, std::uint32_t>>{
+    { 64, 64 }, { 37, 19 }, { 17, 33 }, { 16, 1 }, { 1, 16 }, { 9, 9 }, { 2, 2 }, { 1, 1 }, { 255, 3 }
+  };
+  for (const auto &[width, height] : sizes) {
+    const auto image = noiseImage(width, height, random);
+    const auto downsampled = MipGenerator::downsample(image);
+    const auto expected = downsampleReference(image);
+
+    INFO(width << "x" << height);
+    REQUIRE(downsampled.width == expected.width);
+    REQUIRE(downsampled.height == expected.height);
+    REQUIRE(downsampled.pixels == expected.pixels);
+  }
+}
+
+TEST_CASE("Mip chains halve down to one pixel", "[MipGenerator]")
+{
+  auto random = std::mt19937(9);
+  const auto mips = MipGenerator::generateMips(noiseImage(40, 10, random));
+
+  REQUIRE(mips.size() == 6);
+  REQUIRE(mips.back().width == 1);
+  REQUIRE(mips.back().height == 1);
+  for (size_t level = 1; level < mips.size(); ++level) {
+    REQUIRE(mips[level].pixels == downsampleReference(mips[level - 1]).pixels);
+  }
+}
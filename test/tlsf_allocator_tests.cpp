@@ -0,0 +1,144 @@
+#include <catch2/catch.hpp>
+
+#include "TlsfAllocator.h"
+
+#include <map>
+#include <random>
+#include <vector>
+
+namespace {
+struct LiveRange
+{
+  TlsfAllocator::Allocation allocation;
+  uint64_t size;
+};
+
+// Every live range is inside the space and no two of them overlap.
+bool rangesAreDisjoint(const std::vector<LiveRange> &live, uint64_t size)
+{
+  auto byOffset = std::map<uint64_t, uint64_t>();
+  for (const auto &range : live) {
+    if (!byOffset.emplace(range.allocation.offset, range.size).second) {
+      return false;
+    }
+  }
+
+  auto end = uint64_t{ 0 };
+  for (const auto &[offset, rangeSize] : byOffset) {
+    if (offset < end || offset + rangeSize > size) {
+      return false;
+    }
+    end = offset + rangeSize;
+  }
+  return true;
+}
+}// namespace
+
+TEST_CASE("Random allocations stay aligned and disjoint while the space grows", "[TlsfAllocator]")
+{
+  auto random = std::mt19937_64(1);
+  auto allocator = TlsfAllocator(1 << 20);
+  auto live = std::vector<LiveRange>();
+
+  for (int step = 0; step < 50000; ++step) {
+    const auto action = random() % 100;
+    if (action < 55 || live.empty()) {
+      const auto size = 1 + random() % (random() % 4 == 0 ? 1 << 16 : 4096);
+      const auto alignment = uint64_t{ 1 } << (random() % 9);
+      const auto allocation = allocator.allocate(size, alignment);
+      if (allocation.node == TlsfAllocator::INVALID_NODE) {
+        // A fit is only guaranteed once a range covers the aligned request rounded up to the next size class.
+        const auto padded = size + alignment - 1;
+        REQUIRE(allocator.largestFreeRange() < padded + padded / 32);
+        continue;
+      }
+      REQUIRE(allocation.offset % alignment == 0);
+      live.push_back({ allocation, size });
+    } else if (action < 99) {
+      const auto index = random() % live.size();
+      allocator.free(live[index].allocation.node);
+      live[index] = live.back();
+      live.pop_back();
+    } else {
+      allocator.grow(allocator.size() + (random() % 8) * 4096);
+    }
+
+    if (step % 1000 == 0) {
+      REQUIRE(rangesAreDisjoint(live, allocator.size()));
+      REQUIRE(allocator.allocationCount() == live.size());
+    }
+  }
+  REQUIRE(rangesAreDisjoint(live, allocator.size()));
+
+  // With everything freed the neighbours have to be merged back into one range.
+  for (const auto &range : live) {
+    allocator.free(range.allocation.node);
+  }
+  REQUIRE(allocator.allocationCount() == 0);
+  REQUIRE(allocator.usedBytes() == 0);
+  REQUIRE(allocator.largestFreeRange() == allocator.size());
+
+  const auto whole = allocator.allocate(allocator.size(), 1);
+  REQUIRE(whole.node != TlsfAllocator::INVALID_NODE);
+  REQUIRE(whole.offset == 0);
+}
+
+TEST_CASE("Freed neighbours coalesce in any order", "[TlsfAllocator]")
+{
+  constexpr uint64_t SIZE = 64 * 1024;
+  auto allocator = TlsfAllocator(SIZE);
+
+  auto nodes = std::vector<uint32_t>();
+  for (int i = 0; i < 64; ++i) {
+    const auto allocation = allocator.allocate(1024, 1);
+    REQUIRE(allocation.node != TlsfAllocator::INVALID_NODE);
+    nodes.push_back(allocation.node);
+  }
+  REQUIRE(allocator.largestFreeRange() == 0);
+  REQUIRE(allocator.allocate(1, 1).node == TlsfAllocator::INVALID_NODE);
+
+  // Every other range first, so each later free merges with a neighbour on both sides.
+  for (size_t i = 0; i < nodes.size(); i += 2) {
+    allocator.free(nodes[i]);
+  }
+  REQUIRE(allocator.largestFreeRange() == 1024);
+  for (size_t i = 1; i < nodes.size(); i += 2) {
+    allocator.free(nodes[i]);
+  }
+  REQUIRE(allocator.largestFreeRange() == SIZE);
+}
+
+TEST_CASE("Growing extends the free range at the end", "[TlsfAllocator]")
+{
+  auto allocator = TlsfAllocator(4096);
+  const auto first = allocator.allocate(1024, 1);
+  REQUIRE(first.node != TlsfAllocator::INVALID_NODE);
+
+  allocator.grow(8192);
+  REQUIRE(allocator.size() == 8192);
+  REQUIRE(allocator.largestFreeRange() == 8192 - 1024);
+
+  const auto second = allocator.allocate(8192 - 1024, 1);
+  REQUIRE(second.node != TlsfAllocator::INVALID_NODE);
+  REQUIRE(second.offset == 1024);
+
+  allocator.free(first.node);
+  allocator.free(second.node);
+  REQUIRE(allocator.largestFreeRange() == 8192);
+}
+
+TEST_CASE("Aligned allocations keep the space before them usable", "[TlsfAllocator]")
+{
+  auto allocator = TlsfAllocator(4096);
+  const auto small = allocator.allocate(3, 1);
+  const auto aligned = allocator.allocate(100, 256);
+
+  REQUIRE(small.offset == 0);
+  REQUIRE(aligned.offset == 256);
+  REQUIRE(allocator.usedBytes() == 103);
+
+  // The gap between the two is still free.
+  const auto gap = allocator.allocate(200, 1);
+  REQUIRE(gap.node != TlsfAllocator::INVALID_NODE);
+  REQUIRE(gap.offset + 200 <= 256);
+}
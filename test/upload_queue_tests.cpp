@@ -0,0 +1,261 @@
+#include <catch2/catch.hpp>
+
+#include "UploadQueue.h"
+
+#include <algorithm>
+#include <random>
+
+namespace {
+constexpr int STAGING_BUFFER = 1;
+constexpr int DESTINATION_BUFFER = 2;
+constexpr vk::DeviceSize RING_SIZE = 4096;
+
+// A queue over a fresh simulated device with a small ring, and the destination buffer its uploads go to.
+struct Harness
+{
+  explicit Harness(size_t destinationSize) : ring(RING_SIZE), destination(destinationSize), expected(destinationSize)
+  {
+    vk::fake::device = std::make_unique<vk::fake::Device>();
+    vk::fake::device->memory[STAGING_BUFFER] = ring.data();
+    vk::fake::device->memory[DESTINATION_BUFFER] = destination.data();
+    queue.init(vk::Device(), vk::Queue(), 0, vk::Buffer{ STAGING_BUFFER }, ring.data(), RING_SIZE);
+  }
+
+  ~Harness() { queue.cleanUp(); }
+
+  Harness(const Harness &) = delete;
+  Harness &operator=(const Harness &) = delete;
+
+  // Stages random bytes and copies them to offset, what the destination has to end up holding is kept in expected.
+  void stageCopy(vk::DeviceSize offset, vk::DeviceSize size, std::mt19937 &random)
+  {
+    const auto region = queue.stage(size, 16);
+    REQUIRE(region.data != nullptr);
+    REQUIRE(region.offset % 16 == 0);
+    REQUIRE(region.offset + size <= RING_SIZE);
+    for (vk::DeviceSize i = 0; i < size; ++i) {
+      region.data[i] = std::byte(random());
+      expected[offset + i] = region.data[i];
+    }
+    queue.copy(region.offset, vk::Buffer{ DESTINATION_BUFFER }, offset, size);
+  }
+
+  bool arrived(vk::DeviceSize offset, vk::DeviceSize size) const
+  {
+    return std::equal(destination.begin() + static_cast<std::ptrdiff_t>(offset), destination.begin() + static_cast<std::ptrdiff_t>(offset + size), expected.begin() + static_cast<std::ptrdiff_t>(offset));
+  }
+
+  std::vector<std::byte> ring;
+  std::vector<std::byte> destination;
+  std::vector<std::byte> expected;
+  UploadQueue queue;
+};
+
+struct Upload
+{
+  UploadToken token;
+  vk::DeviceSize offset;
+  vk::DeviceSize size;
+};
+}// namespace
+
+TEST_CASE("Uploads arrive intact while the queue runs frames behind", "[UploadQueue]")
+{
+  auto harness = Harness(1 << 22);
+  auto random = std::mt19937(5);
+  auto uploads = std::vector<Upload>();
+  auto verified = size_t{ 0 };
+  auto offset = vk::DeviceSize{ 0 };
+
+  for (int frame = 0; frame < 2000; ++frame) {
+    const auto count = random() % 5;
+    for (uint32_t i = 0; i < count; ++i) {
+      // Mostly small uploads, some that take half the ring and a few that take all of it.
+      auto size = vk::DeviceSize{ random() % 2 == 0 ? random() % 64 + 1 : random() % (RING_SIZE / 2) + 1 };
+      if (random() % 50 == 0) {
+        size = RING_SIZE;
+      }
+
+      if (random() % 4 == 0) {
+        size = (size + 3) / 4 * 4;
+        offset = (offset + 3) / 4 * 4;
+        auto data = std::vector<std::byte>(size);
+        for (auto &byte : data) {
+          byte = std::byte(random());
+        }
+        std::copy(data.begin(), data.end(), harness.expected.begin() + static_cast<std::ptrdiff_t>(offset));
+        harness.queue.update(vk::Buffer{ DESTINATION_BUFFER }, offset, data);
+      } else {
+        harness.stageCopy(offset, size, random);
+      }
+
+      uploads.push_back({ harness.queue.latestToken(), offset, size });
+      offset += size;
+    }
+
+    harness.queue.submit();
+    harness.queue.poll();
+
+    // The simulated queue gets through zero to two batches a frame, so it falls behind and the ring wraps.
+    for (auto executions = random() % 3; executions > 0; --executions) {
+      vk::fake::device->executeOldest();
+    }
+
+    // A token may only count as complete once its data is there. Staging space reused too early would show up here.
+    for (; verified < uploads.size() && harness.queue.isComplete(uploads[verified].token); ++verified) {
+      REQUIRE(harness.arrived(uploads[verified].offset, uploads[verified].size));
+    }
+  }
+
+  harness.queue.waitIdle();
+  REQUIRE(harness.queue.isComplete(uploads.back().token));
+  REQUIRE(harness.arrived(0, offset));
+  REQUIRE(vk::fake::device->errors.total() == 0);
+}
+
+TEST_CASE("A full ring waits for the oldest batch and reuses its space", "[UploadQueue]")
+{
+  auto harness = Harness(RING_SIZE * 4);
+  auto random = std::mt19937(7);
+
+  harness.stageCopy(0, RING_SIZE / 2, random);
+  harness.queue.submit();
+  const auto first = harness.queue.latestToken();
+  harness.stageCopy(RING_SIZE, RING_SIZE / 2, random);
+  harness.queue.submit();
+  REQUIRE(vk::fake::device->executed == 0);
+  REQUIRE_FALSE(harness.queue.isComplete(first));
+
+  // No room left until the first batch is done, staging has to run it and take over its half of the ring.
+  harness.stageCopy(RING_SIZE * 2, RING_SIZE / 2, random);
+  REQUIRE(vk::fake::device->executed == 1);
+  REQUIRE(harness.queue.isComplete(first));
+  REQUIRE(harness.arrived(0, RING_SIZE / 2));
+
+  harness.queue.waitIdle();
+  REQUIRE(harness.arrived(RING_SIZE, RING_SIZE / 2));
+  REQUIRE(harness.arrived(RING_SIZE * 2, RING_SIZE / 2));
+  REQUIRE(vk::fake::device->errors.total() == 0);
+}
+
+TEST_CASE("A region that does not fit before the end of the ring starts over at its beginning", "[UploadQueue]")
+{
+  auto harness = Harness(RING_SIZE * 4);
+  auto random = std::mt19937(9);
+
+  harness.stageCopy(0, RING_SIZE - 100, random);
+  harness.queue.submit();
+  vk::fake::device->executeOldest();
+  harness.queue.poll();
+
+  // The ring is empty again, so the next region may start at 0 and stay whole.
+  const auto region = harness.queue.stage(200, 16);
+  REQUIRE(region.data == harness.ring.data());
+  REQUIRE(region.offset == 0);
+
+  // Once space is held, a region that would cross the end skips the rest of the lap.
+  const auto wrapped = harness.queue.stage(RING_SIZE - 300, 16);
+  REQUIRE(wrapped.data != nullptr);
+  REQUIRE(wrapped.offset == 208);
+  REQUIRE(harness.queue.stage(RING_SIZE + 1, 16).data == nullptr);
+  harness.queue.waitIdle();
+}
+
+TEST_CASE("Tokens complete in order and only after their batch", "[UploadQueue]")
+{
+  auto harness = Harness(RING_SIZE * 4);
+  auto random = std::mt19937(11);
+
+  REQUIRE(harness.queue.isComplete(0));
+  REQUIRE(harness.queue.latestToken() == 0);
+
+  auto tokens = std::vector<UploadToken>();
+  for (int batch = 0; batch < 5; ++batch) {
+    harness.stageCopy(static_cast<vk::DeviceSize>(batch) * 64, 32, random);
+    const auto collecting = harness.queue.latestToken();
+    // The token of the batch being collected stays the same until it is submitted.
+    harness.stageCopy(static_cast<vk::DeviceSize>(batch) * 64 + 32, 32, random);
+    REQUIRE(harness.queue.latestToken() == collecting);
+    REQUIRE_FALSE(harness.queue.isComplete(collecting));
+
+    harness.queue.submit();
+    REQUIRE(harness.queue.latestToken() == collecting);
+    REQUIRE((tokens.empty() || collecting > tokens.back()));
+    tokens.push_back(collecting);
+  }
+
+  // Submitting with nothing recorded makes no new batch.
+  harness.queue.submit();
+  REQUIRE(harness.queue.latestToken() == tokens.back());
+
+  for (size_t executed = 0; executed < tokens.size(); ++executed) {
+    vk::fake::device->executeOldest();
+    REQUIRE(harness.queue.poll());
+    for (size_t i = 0; i < tokens.size(); ++i) {
+      REQUIRE(harness.queue.isComplete(tokens[i]) == (i <= executed));
+    }
+  }
+  REQUIRE_FALSE(harness.queue.poll());
+  REQUIRE(vk::fake::device->errors.total() == 0);
+}
+
+TEST_CASE("A semaphore covers every batch submitted before it", "[UploadQueue]")
+{
+  auto harness = Harness(RING_SIZE * 4);
+  auto random = std::mt19937(13);
+
+  // Nothing was submitted yet, so a frame has nothing to wait for.
+  REQUIRE_FALSE(harness.queue.submitAndSignal(vk::Semaphore{ 1 }));
+  REQUIRE(harness.queue.signaledToken() == 0);
+
+  // The batch being collected carries the semaphore itself.
+  harness.stageCopy(0, 64, random);
+  REQUIRE(harness.queue.submitAndSignal(vk::Semaphore{ 1 }));
+  const auto first = harness.queue.latestToken();
+  REQUIRE(harness.queue.signaledToken() == first);
+  REQUIRE(vk::fake::device->pending.size() == 1);
+  REQUIRE_FALSE(harness.queue.submitAndSignal(vk::Semaphore{ 2 }));
+
+  // Batches that went out on their own, like those of a full ring, are covered by an empty submission.
+  harness.stageCopy(64, 64, random);
+  harness.queue.submit();
+  const auto second = harness.queue.latestToken();
+  REQUIRE(harness.queue.signaledToken() == first);
+  REQUIRE(harness.queue.submitAndSignal(vk::Semaphore{ 2 }));
+  REQUIRE(harness.queue.signaledToken() == second);
+  REQUIRE(vk::fake::device->pending.size() == 3);
+
+  // No semaphore signals before the copies submitted ahead of it have run.
+  vk::fake::device->executeOldest();
+  REQUIRE(vk::fake::device->semaphores[1]);
+  REQUIRE(harness.arrived(0, 64));
+  vk::fake::device->executeOldest();
+  REQUIRE_FALSE(vk::fake::device->semaphores[2]);
+  vk::fake::device->executeOldest();
+  REQUIRE(vk::fake::device->semaphores[2]);
+  REQUIRE(harness.arrived(64, 64));
+
+  harness.queue.waitIdle();
+  REQUIRE(vk::fake::device->errors.total() == 0);
+}
+
+TEST_CASE("Copies from buffers other than the ring go out with the batch", "[UploadQueue]")
+{
+  constexpr int SOURCE_BUFFER = 3;
+  auto harness = Harness(RING_SIZE);
+  auto source = std::vector<std::byte>(256);
+  for (size_t i = 0; i < source.size(); ++i) {
+    source[i] = std::byte(i);
+  }
+  vk::fake::device->memory[SOURCE_BUFFER] = source.data();
+
+  harness.queue.copy(vk::Buffer{ SOURCE_BUFFER }, 16, vk::Buffer{ DESTINATION_BUFFER }, 100, 128);
+  std::copy(source.begin() + 16, source.begin() + 16 + 128, harness.expected.begin() + 100);
+  const auto token = harness.queue.latestToken();
+  REQUIRE(token != 0);
+
+  harness.queue.waitIdle();
+  REQUIRE(harness.queue.isComplete(token));
+  REQUIRE(harness.arrived(100, 128));
+  REQUIRE(vk::fake::device->errors.total() == 0);
+}